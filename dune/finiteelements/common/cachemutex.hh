@@ -0,0 +1,80 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+#ifndef DUNE_CACHEMUTEX_HH
+#define DUNE_CACHEMUTEX_HH
+
+#if HAVE_PTHREAD_H
+#include <pthread.h>
+#endif
+
+/** \file
+    \brief Mutex for the caches that are filled on first use and shared between threads
+ */
+
+namespace Dune
+{
+
+  /**@ingroup LocalBasisInterface
+         \brief Mutex protecting a cache that is filled on first use
+
+         Uses POSIX threads if configure found pthread.h.  Otherwise
+         locking does nothing, and the caches are only safe to use from a
+         single thread.  Lock it with a CacheMutex::Lock for the duration
+         of a lookup, including the insertion of a missing entry.
+
+         \nosubgrouping
+   */
+  class CacheMutex
+  {
+  public:
+    CacheMutex ()
+    {
+#if HAVE_PTHREAD_H
+      pthread_mutex_init(&mutex,0);
+#endif
+    }
+
+    ~CacheMutex ()
+    {
+#if HAVE_PTHREAD_H
+      pthread_mutex_destroy(&mutex);
+#endif
+    }
+
+    //! \brief Holds the mutex from construction to destruction
+    class Lock
+    {
+    public:
+      explicit Lock (CacheMutex& m_)
+        : m(m_)
+      {
+#if HAVE_PTHREAD_H
+        pthread_mutex_lock(&m.mutex);
+#endif
+      }
+
+      ~Lock ()
+      {
+#if HAVE_PTHREAD_H
+        pthread_mutex_unlock(&m.mutex);
+#endif
+      }
+
+    private:
+      Lock (const Lock&);
+      Lock& operator= (const Lock&);
+
+      CacheMutex& m;
+    };
+
+  private:
+    CacheMutex (const CacheMutex&);
+    CacheMutex& operator= (const CacheMutex&);
+
+#if HAVE_PTHREAD_H
+    pthread_mutex_t mutex;
+#endif
+  };
+
+}
+#endif
@@ -3,6 +3,7 @@
 #ifndef DUNE_LOCALBASIS_HH
 #define DUNE_LOCALBASIS_HH
 
+#include <cassert>
 #include <iostream>
 #include <vector>
 
@@ -10,6 +11,8 @@
 #include <dune/common/fixedarray.hh>
 #include <dune/common/fvector.hh>
 
+#include "localbasisjet.hh"
+
 namespace Dune
 {
 
@@ -116,6 +119,45 @@ namespace Dune
       asImp().evaluateFunction(in,out);
     }
 #endif
+
+#ifndef DUNE_VIRTUAL_SHAPEFUNCTIONS
+    /** \brief Evaluate all basis function at given position into caller-provided storage
+
+            Same as evaluateFunction() with a std::vector, but writes the
+            values to out[0],...,out[size()-1] without allocating memory.
+            Implementations additionally accept a FieldVector or an array of
+            their compile-time size N.
+
+       \param [out] out The result
+       \param capacity Number of entries available in out, at least size()
+     */
+    inline void evaluateFunction (const typename Traits::DomainType& in,
+                                  typename Traits::RangeType* out,
+                                  unsigned int capacity) const
+    {
+      asImp().evaluateFunction(in,out,capacity);
+    }
+#endif
+
+    /** \brief Evaluate all basis function at a list of positions
+
+            Evaluates all shape functions at each of the given positions,
+            e.g. all points of a quadrature rule.  The values are stored
+            point-major in a single vector, i.e. out[p*size()+i] is the value
+            of shape function i at position in[p].  With virtual shape
+            functions this costs a single virtual call for all positions.
+     */
+#if DUNE_VIRTUAL_SHAPEFUNCTIONS
+    virtual void evaluateFunctionBatched (const std::vector<typename Traits::DomainType>& in,
+                                          std::vector<typename Traits::RangeType>& out) const = 0;
+#else
+    inline void evaluateFunctionBatched (const std::vector<typename Traits::DomainType>& in,
+                                         std::vector<typename Traits::RangeType>& out) const
+    {
+      asImp().evaluateFunctionBatched(in,out);
+    }
+#endif
+
     /*! \brief Polynomial order of the shape functions
 
        \todo Gurke!
@@ -223,6 +265,81 @@ namespace Dune
     }
 #endif
 
+    /** \brief Evaluate all shape functions and their jacobians at given position.
+
+            Yields the same results as evaluateFunction() followed by
+            evaluateJacobian(), but subexpressions that are shared between
+            the values and the derivatives are computed only once.
+
+       \param [out] values The values of all shape functions
+       \param [out] jacobians The jacobians of all shape functions
+     */
+#if DUNE_VIRTUAL_SHAPEFUNCTIONS
+    virtual void
+    evaluateFunctionAndJacobian(const typename Traits::DomainType& in,             // position
+                                std::vector<typename Traits::RangeType>& values,
+                                std::vector<typename Traits::JacobianType>& jacobians) const = 0;
+#else
+    inline void
+    evaluateFunctionAndJacobian(const typename Traits::DomainType& in,             // position
+                                std::vector<typename Traits::RangeType>& values,
+                                std::vector<typename Traits::JacobianType>& jacobians) const
+    {
+      asImp().evaluateFunctionAndJacobian(in,values,jacobians);
+    }
+#endif
+
+#ifndef DUNE_VIRTUAL_SHAPEFUNCTIONS
+    /** \brief Evaluate jacobian of all shape functions at given position into caller-provided storage
+
+       \param [out] out The result
+       \param capacity Number of entries available in out, at least size()
+     */
+    inline void
+    evaluateJacobian(const typename Traits::DomainType& in,             // position
+                     typename Traits::JacobianType* out,             // return value
+                     unsigned int capacity) const
+    {
+      asImp().evaluateJacobian(in,out,capacity);
+    }
+
+    /** \brief Evaluate all shape functions and their jacobians at given position into caller-provided storage
+
+       \param [out] values The values of all shape functions
+       \param [out] jacobians The jacobians of all shape functions
+       \param capacity Number of entries available in values and jacobians, at least size()
+     */
+    inline void
+    evaluateFunctionAndJacobian(const typename Traits::DomainType& in,             // position
+                                typename Traits::RangeType* values,
+                                typename Traits::JacobianType* jacobians,
+                                unsigned int capacity) const
+    {
+      asImp().evaluateFunctionAndJacobian(in,values,jacobians,capacity);
+    }
+#endif
+
+    /** \brief Evaluate jacobian of all shape functions at a list of positions
+
+            The Jacobians are stored point-major, i.e. out[p*size()+i] is the
+            Jacobian of shape function i at position in[p].  With virtual
+            shape functions this costs a single virtual call for all positions.
+
+       \param [out] out The result
+     */
+#if DUNE_VIRTUAL_SHAPEFUNCTIONS
+    virtual void
+    evaluateJacobianBatched(const std::vector<typename Traits::DomainType>& in,             // positions
+                            std::vector<typename Traits::JacobianType>& out) const = 0;
+#else
+    inline void
+    evaluateJacobianBatched(const std::vector<typename Traits::DomainType>& in,             // positions
+                            std::vector<typename Traits::JacobianType>& out) const                          // return value
+    {
+      asImp().evaluateJacobianBatched(in,out);
+    }
+#endif
+
 #ifndef DUNE_VIRTUAL_SHAPEFUNCTIONS
   private:
     Imp& asImp () {return static_cast<Imp &> (*this);}
@@ -264,10 +381,199 @@ namespace Dune
       asImp().evaluate(directions,in,out);
     }
 
+    /** \brief Evaluate all shape functions and their partial derivatives up to order k
+
+        Computes the jets of all shape functions in one pass, which is
+        cheaper than one call of evaluate() per derivative.
+
+        \tparam k Highest order of the derivatives, 0 to 3
+     */
+    template<int k>
+    inline void evaluateJet (const typename Traits::DomainType& in,
+                             std::vector<LocalBasisJet<Traits,k> >& out) const
+    {
+      asImp().template evaluateJet<k>(in,out);
+    }
+
+    //! \brief Evaluate the jets of all shape functions into caller-provided storage with room for \a capacity values
+    template<int k>
+    inline void evaluateJet (const typename Traits::DomainType& in,
+                             LocalBasisJet<Traits,k>* out,
+                             unsigned int capacity) const
+    {
+      asImp().template evaluateJet<k>(in,out,capacity);
+    }
+
   private:
     Imp& asImp () {return static_cast<Imp &> (*this);}
     const Imp& asImp () const {return static_cast<const Imp &>(*this);}
   };
 
+
+
+  /**@ingroup LocalBasisImplementation
+         \brief Evaluation entry points of a local basis, forwarded to its kernels
+
+         Implements all the ways to evaluate a local basis -- into a
+         std::vector, into caller-provided storage, into a FieldVector or an
+         array of the compile-time size, and batched over a list of
+         positions -- in terms of the kernels of the implementation, which
+         write the values or Jacobians of all shape functions at one position
+         to consecutive entries:
+
+         - <tt>evaluateFunctionAt(in,RangeType* out)</tt>
+         - <tt>evaluateJacobianAt(in,JacobianType* out)</tt>
+         - <tt>evaluateFunctionAndJacobianAt(in,RangeType* values,JacobianType* jacobians)</tt>,
+           optional: only bases whose values and Jacobians share
+           subexpressions provide it, the others get both kernels called
+           one after the other
+
+         The kernels may be private if the implementation declares this
+         class a friend.  The implementation still provides size() and
+         order().
+
+         Template parameters:
+
+         - <tt>T</tt>: Instance of C1LocalBasisTraits providing type information.
+         - <tt>Imp</tt>: Implementation of the kernels used via Barton-Nackman
+         - <tt>n</tt>: Number of shape functions
+         - <tt>Interface</tt>: Interface class to derive from
+
+         \nosubgrouping
+   */
+  template<class T, class Imp, int n,
+#if DUNE_VIRTUAL_SHAPEFUNCTIONS
+      class Interface = C1LocalBasisInterface<T>
+#else
+      class Interface = C1LocalBasisInterface<T,Imp>
+#endif
+      >
+  class C1LocalBasisForwarder
+    : public Interface
+  {
+  public:
+    //! \brief Export type traits
+    typedef T Traits;
+
+    //! \brief Evaluate all shape functions
+    inline void evaluateFunction (const typename Traits::DomainType& in,
+                                  std::vector<typename Traits::RangeType>& out) const
+    {
+      out.resize(n);
+      asImp().evaluateFunctionAt(in,&out[0]);
+    }
+
+    //! \brief Evaluate all shape functions into caller-provided storage with room for \a capacity >= n values
+    inline void evaluateFunction (const typename Traits::DomainType& in,
+                                  typename Traits::RangeType* out,
+                                  unsigned int capacity) const
+    {
+      assert(capacity >= (unsigned int)n);
+      asImp().evaluateFunctionAt(in,out);
+    }
+
+    //! \brief Evaluate all shape functions into a fixed-size vector
+    inline void evaluateFunction (const typename Traits::DomainType& in,
+                                  Dune::FieldVector<typename Traits::RangeType,n>& out) const
+    {
+      asImp().evaluateFunctionAt(in,&out[0]);
+    }
+
+    //! \brief Evaluate all shape functions into a fixed-size array
+    inline void evaluateFunction (const typename Traits::DomainType& in,
+                                  Dune::array<typename Traits::RangeType,n>& out) const
+    {
+      asImp().evaluateFunctionAt(in,&out[0]);
+    }
+
+    //! \brief Evaluate all shape functions at a list of positions
+    inline void evaluateFunctionBatched (const std::vector<typename Traits::DomainType>& in,
+                                         std::vector<typename Traits::RangeType>& out) const
+    {
+      out.resize(in.size()*n);
+      for (size_t p=0; p<in.size(); p++)
+        asImp().evaluateFunctionAt(in[p],&out[p*n]);
+    }
+
+    //! \brief Evaluate Jacobian of all shape functions
+    inline void
+    evaluateJacobian (const typename Traits::DomainType& in,         // position
+                      std::vector<typename Traits::JacobianType>& out) const      // return value
+    {
+      out.resize(n);
+      asImp().evaluateJacobianAt(in,&out[0]);
+    }
+
+    //! \brief Evaluate Jacobian of all shape functions into caller-provided storage with room for \a capacity >= n values
+    inline void
+    evaluateJacobian (const typename Traits::DomainType& in,       // position
+                      typename Traits::JacobianType* out,       // return value
+                      unsigned int capacity) const
+    {
+      assert(capacity >= (unsigned int)n);
+      asImp().evaluateJacobianAt(in,out);
+    }
+
+    //! \brief Evaluate Jacobian of all shape functions into a fixed-size vector
+    inline void
+    evaluateJacobian (const typename Traits::DomainType& in,       // position
+                      Dune::FieldVector<typename Traits::JacobianType,n>& out) const      // return value
+    {
+      asImp().evaluateJacobianAt(in,&out[0]);
+    }
+
+    //! \brief Evaluate Jacobian of all shape functions into a fixed-size array
+    inline void
+    evaluateJacobian (const typename Traits::DomainType& in,       // position
+                      Dune::array<typename Traits::JacobianType,n>& out) const      // return value
+    {
+      asImp().evaluateJacobianAt(in,&out[0]);
+    }
+
+    //! \brief Evaluate Jacobian of all shape functions at a list of positions
+    inline void
+    evaluateJacobianBatched (const std::vector<typename Traits::DomainType>& in,         // positions
+                             std::vector<typename Traits::JacobianType>& out) const      // return value
+    {
+      out.resize(in.size()*n);
+      for (size_t p=0; p<in.size(); p++)
+        asImp().evaluateJacobianAt(in[p],&out[p*n]);
+    }
+
+    //! \brief Evaluate all shape functions and their Jacobians
+    inline void
+    evaluateFunctionAndJacobian (const typename Traits::DomainType& in,         // position
+                                 std::vector<typename Traits::RangeType>& values,
+                                 std::vector<typename Traits::JacobianType>& jacobians) const
+    {
+      values.resize(n);
+      jacobians.resize(n);
+      asImp().evaluateFunctionAndJacobianAt(in,&values[0],&jacobians[0]);
+    }
+
+    //! \brief Evaluate all shape functions and their Jacobians into caller-provided storage with room for \a capacity >= n values each
+    inline void
+    evaluateFunctionAndJacobian (const typename Traits::DomainType& in,         // position
+                                 typename Traits::RangeType* values,
+                                 typename Traits::JacobianType* jacobians,
+                                 unsigned int capacity) const
+    {
+      assert(capacity >= (unsigned int)n);
+      asImp().evaluateFunctionAndJacobianAt(in,values,jacobians);
+    }
+
+  private:
+    //! \brief Called if Imp has no fused kernel
+    inline void evaluateFunctionAndJacobianAt (const typename Traits::DomainType& in,
+                                               typename Traits::RangeType* values,
+                                               typename Traits::JacobianType* jacobians) const
+    {
+      asImp().evaluateFunctionAt(in,values);
+      asImp().evaluateJacobianAt(in,jacobians);
+    }
+
+    const Imp& asImp () const {return static_cast<const Imp &>(*this);}
+  };
+
 }
 #endif
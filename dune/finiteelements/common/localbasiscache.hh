@@ -0,0 +1,205 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+#ifndef DUNE_LOCALBASISCACHE_HH
+#define DUNE_LOCALBASISCACHE_HH
+
+#include <map>
+#include <utility>
+#include <vector>
+
+#include <dune/common/geometrytype.hh>
+#include <dune/grid/common/quadraturerules.hh>
+
+#include "localbasis.hh"
+
+namespace Dune
+{
+
+  /**@ingroup LocalBasisInterface
+         \brief Values and Jacobians of a local basis at the points of a quadrature rule
+
+         All values are stored point-major, i.e. entry q*size()+i belongs to
+         shape function i at quadrature point q.  This is the layout of
+         evaluateFunctionBatched() and evaluateJacobianBatched().
+
+         \tparam LB Local basis that has been tabulated
+
+         \nosubgrouping
+   */
+  template<class LB>
+  class LocalBasisTable
+  {
+  public:
+    //! \brief Export type traits of the local basis
+    typedef typename LB::Traits Traits;
+
+    //! \brief Tabulate the basis at the points of the given quadrature rule
+    LocalBasisTable (const LB& lb,
+                     const QuadratureRule<typename Traits::DomainFieldType,Traits::dimDomain>& quad)
+      : n(lb.size())
+    {
+      positions_.reserve(quad.size());
+      weights_.reserve(quad.size());
+      for (size_t q=0; q<quad.size(); q++)
+      {
+        positions_.push_back(quad[q].position());
+        weights_.push_back(quad[q].weight());
+      }
+      lb.evaluateFunctionBatched(positions_,values_);
+      lb.evaluateJacobianBatched(positions_,jacobians_);
+    }
+
+    /** \brief Tabulate the basis at arbitrary points
+
+       Used for points that are not those of a quadrature rule on the
+       reference element, e.g. face quadrature points mapped into it.
+     */
+    LocalBasisTable (const LB& lb,
+                     const std::vector<typename Traits::DomainType>& positions,
+                     const std::vector<typename Traits::DomainFieldType>& weights)
+      : n(lb.size()), positions_(positions), weights_(weights)
+    {
+      lb.evaluateFunctionBatched(positions_,values_);
+      lb.evaluateJacobianBatched(positions_,jacobians_);
+    }
+
+    //! \brief Number of shape functions
+    unsigned int size () const
+    {
+      return n;
+    }
+
+    //! \brief Number of quadrature points
+    unsigned int numPoints () const
+    {
+      return positions_.size();
+    }
+
+    //! \brief Position of quadrature point q on the reference element
+    const typename Traits::DomainType& position (unsigned int q) const
+    {
+      return positions_[q];
+    }
+
+    //! \brief Weight of quadrature point q
+    typename Traits::DomainFieldType weight (unsigned int q) const
+    {
+      return weights_[q];
+    }
+
+    //! \brief Value of shape function i at quadrature point q
+    const typename Traits::RangeType& value (unsigned int q, unsigned int i) const
+    {
+      return values_[q*n+i];
+    }
+
+    //! \brief Jacobian of shape function i at quadrature point q
+    const typename Traits::JacobianType& jacobian (unsigned int q, unsigned int i) const
+    {
+      return jacobians_[q*n+i];
+    }
+
+    //! \brief All quadrature points
+    const std::vector<typename Traits::DomainType>& positions () const
+    {
+      return positions_;
+    }
+
+    //! \brief All quadrature weights
+    const std::vector<typename Traits::DomainFieldType>& weights () const
+    {
+      return weights_;
+    }
+
+    //! \brief Values of all shape functions at all quadrature points
+    const std::vector<typename Traits::RangeType>& values () const
+    {
+      return values_;
+    }
+
+    //! \brief Jacobians of all shape functions at all quadrature points
+    const std::vector<typename Traits::JacobianType>& jacobians () const
+    {
+      return jacobians_;
+    }
+
+  private:
+    unsigned int n;
+    std::vector<typename Traits::DomainType> positions_;
+    std::vector<typename Traits::DomainFieldType> weights_;
+    std::vector<typename Traits::RangeType> values_;
+    std::vector<typename Traits::JacobianType> jacobians_;
+  };
+
+
+
+  /**@ingroup LocalBasisInterface
+         \brief Tabulates a local basis once per geometry type and quadrature order
+
+         The first request for a pair (GeometryType, order) evaluates the
+         basis at all points of QuadratureRules::rule(gt,order) and keeps the
+         result.  Later requests return a reference to the same table, which
+         stays valid as long as the cache exists.
+
+         A cache belongs to one basis object, since bases such as the
+         RT02D variants differ between objects of the same type, and the
+         bases have no common way to tell their variant.  Two caches of equal
+         bases therefore tabulate twice.  To share the tables of one
+         (basis, variant, geometry type, order) among all users, take the
+         element from LocalFiniteElementRegistry: it creates each element
+         and variant once, and SharedLocalFiniteElement::table() returns the
+         tables of the cache kept next to it.  The cache itself is not
+         thread-safe.
+
+         \tparam LB Local basis to tabulate, must provide evaluateFunctionBatched()
+                    and evaluateJacobianBatched()
+
+         \nosubgrouping
+   */
+  template<class LB>
+  class LocalBasisCache
+  {
+  public:
+    //! \brief Export type traits of the local basis
+    typedef typename LB::Traits Traits;
+
+    //! \brief Type of the cached tables
+    typedef LocalBasisTable<LB> TableType;
+
+    //! \brief Create a cache for the given basis, which must outlive the cache
+    explicit LocalBasisCache (const LB& lb_)
+      : lb(lb_)
+    {}
+
+    //! \brief The basis that is tabulated
+    const LB& localBasis () const
+    {
+      return lb;
+    }
+
+    //! \brief Values and Jacobians at the points of the quadrature rule of given type and order
+    const TableType& table (const GeometryType& gt, int order) const
+    {
+      const Key key(std::make_pair(int(gt.basicType()),int(gt.dim())),order);
+      typename Map::iterator it = tables.find(key);
+      if (it == tables.end())
+      {
+        typedef typename Traits::DomainFieldType DF;
+        const QuadratureRule<DF,Traits::dimDomain>& quad =
+          QuadratureRules<DF,Traits::dimDomain>::rule(gt,order);
+        // the table is complete before it is inserted, so that an exception leaves the cache unchanged
+        it = tables.insert(std::make_pair(key,TableType(lb,quad))).first;
+      }
+      return it->second;
+    }
+
+  private:
+    typedef std::pair<std::pair<int,int>,int> Key;
+    typedef std::map<Key,TableType> Map;
+
+    const LB& lb;
+    mutable Map tables;
+  };
+
+}
+#endif
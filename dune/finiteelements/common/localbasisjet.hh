@@ -0,0 +1,323 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+#ifndef DUNE_LOCALBASISJET_HH
+#define DUNE_LOCALBASISJET_HH
+
+#include <dune/common/fixedarray.hh>
+#include <dune/common/fmatrix.hh>
+#include <dune/common/fvector.hh>
+
+#include "tensorproductlayout.hh"
+
+namespace Dune
+{
+
+  /**@ingroup LocalBasisInterface
+         \brief Value and partial derivatives up to order k of one shape function at one point
+
+         LocalBasisJet<T,0> holds the value, and LocalBasisJet<T,k> adds the
+         partial derivatives of order k to LocalBasisJet<T,k-1>, up to
+         k=3.  For component c of the shape function, the members are
+
+         - value[c]
+         - jacobian[c][i], the derivative in direction i
+         - hessian[c][i][j], the second derivative in directions i and j
+         - thirdDerivative[c][i][j][l], the third derivative in directions i, j and l
+
+         All symmetric entries of the derivatives are stored.  The bases
+         that implement CkLocalBasisInterface, and some C1 bases such as
+         Pk2DLocalBasis, provide evaluateJet<k>(), which computes the jets
+         of all shape functions in one pass.
+
+         \tparam T Traits of the local basis
+         \tparam k Highest order of the derivatives, 0 to 3
+   */
+  template<class T, int k>
+  struct LocalBasisJet;
+
+  template<class T>
+  struct LocalBasisJet<T,0>
+  {
+    //! \brief Traits of the local basis
+    typedef T Traits;
+
+    //! \brief The value
+    typename Traits::RangeType value;
+  };
+
+  template<class T>
+  struct LocalBasisJet<T,1> : public LocalBasisJet<T,0>
+  {
+    //! \brief The first derivatives
+    typename T::JacobianType jacobian;
+  };
+
+  template<class T>
+  struct LocalBasisJet<T,2> : public LocalBasisJet<T,1>
+  {
+    //! \brief Type of the second derivatives
+    typedef FieldVector<FieldMatrix<typename T::RangeFieldType,T::dimDomain,T::dimDomain>,T::dimRange> HessianType;
+
+    //! \brief The second derivatives
+    HessianType hessian;
+  };
+
+  template<class T>
+  struct LocalBasisJet<T,3> : public LocalBasisJet<T,2>
+  {
+    //! \brief Type of the third derivatives
+    typedef FieldVector<FieldVector<FieldMatrix<typename T::RangeFieldType,T::dimDomain,T::dimDomain>,
+            T::dimDomain>,T::dimRange> ThirdDerivativeType;
+
+    //! \brief The third derivatives
+    ThirdDerivativeType thirdDerivative;
+  };
+
+  namespace LocalBasisJetImp
+  {
+
+    /* Store the derivatives of a scalar shape function in its jet.  The
+       function object partial is called as partial(r,directions) and
+       returns the partial derivative in the r directions directions[0] <=
+       ... <= directions[r-1].  Each overload fills the orders below its
+       own through the base class of the jet. */
+
+    template<class T, class Partial>
+    void fill (const Partial& partial, LocalBasisJet<T,0>& jet)
+    {
+      const int directions[1] = {0};
+      jet.value[0] = partial(0,directions);
+    }
+
+    template<class T, class Partial>
+    void fill (const Partial& partial, LocalBasisJet<T,1>& jet)
+    {
+      fill(partial,static_cast<LocalBasisJet<T,0>&>(jet));
+      for (int i=0; i<T::dimDomain; i++)
+        jet.jacobian[0][i] = partial(1,&i);
+    }
+
+    template<class T, class Partial>
+    void fill (const Partial& partial, LocalBasisJet<T,2>& jet)
+    {
+      fill(partial,static_cast<LocalBasisJet<T,1>&>(jet));
+      int directions[2];
+      for (directions[0]=0; directions[0]<T::dimDomain; directions[0]++)
+        for (directions[1]=directions[0]; directions[1]<T::dimDomain; directions[1]++)
+        {
+          const typename T::RangeFieldType h = partial(2,directions);
+          jet.hessian[0][directions[0]][directions[1]] = h;
+          jet.hessian[0][directions[1]][directions[0]] = h;
+        }
+    }
+
+    template<class T, class Partial>
+    void fill (const Partial& partial, LocalBasisJet<T,3>& jet)
+    {
+      fill(partial,static_cast<LocalBasisJet<T,2>&>(jet));
+      static const int permutation[6][3] = {{0,1,2},{0,2,1},{1,0,2},{1,2,0},{2,0,1},{2,1,0}};
+      int d[3];
+      for (d[0]=0; d[0]<T::dimDomain; d[0]++)
+        for (d[1]=d[0]; d[1]<T::dimDomain; d[1]++)
+          for (d[2]=d[1]; d[2]<T::dimDomain; d[2]++)
+          {
+            const typename T::RangeFieldType t = partial(3,d);
+            for (int p=0; p<6; p++)
+              jet.thirdDerivative[0][d[permutation[p][0]]][d[permutation[p][1]]][d[permutation[p][2]]] = t;
+          }
+    }
+
+    //! \brief The derivative of all components in the given directions, as CkLocalBasisInterface::evaluate() returns it
+    template<class T>
+    typename T::RangeType derivative (const LocalBasisJet<T,0>& jet, const Dune::array<int,0>& directions)
+    {
+      return jet.value;
+    }
+
+    template<class T>
+    typename T::RangeType derivative (const LocalBasisJet<T,1>& jet, const Dune::array<int,1>& directions)
+    {
+      typename T::RangeType out;
+      for (int c=0; c<T::dimRange; c++)
+        out[c] = jet.jacobian[c][directions[0]];
+      return out;
+    }
+
+    template<class T>
+    typename T::RangeType derivative (const LocalBasisJet<T,2>& jet, const Dune::array<int,2>& directions)
+    {
+      typename T::RangeType out;
+      for (int c=0; c<T::dimRange; c++)
+        out[c] = jet.hessian[c][directions[0]][directions[1]];
+      return out;
+    }
+
+    template<class T>
+    typename T::RangeType derivative (const LocalBasisJet<T,3>& jet, const Dune::array<int,3>& directions)
+    {
+      typename T::RangeType out;
+      for (int c=0; c<T::dimRange; c++)
+        out[c] = jet.thirdDerivative[c][directions[0]][directions[1]][directions[2]];
+      return out;
+    }
+
+    /** \brief Partial derivatives of a product f_0(x_0) ... f_{dim-1}(x_{dim-1})
+
+        factor[d][s] is the s-th derivative of f_d at x_d, for s up to the
+        order of the jet.
+     */
+    template<class R, int dim>
+    struct TensorProductPartial
+    {
+      R operator() (int r, const int* directions) const
+      {
+        int alpha[dim];
+        for (int d=0; d<dim; d++)
+          alpha[d] = 0;
+        for (int s=0; s<r; s++)
+          alpha[directions[s]]++;
+
+        R product = factor[0][alpha[0]];
+        for (int d=1; d<dim; d++)
+          product *= factor[d][alpha[d]];
+        return product;
+      }
+
+      const R* factor[dim];
+    };
+
+    /* For tensor products the value, the gradient and the Hessian follow
+       from the products of all factors but one or two, which avoids
+       forming each partial derivative separately.  The third derivatives
+       use the general overload. */
+
+    template<class T, class R, int dim>
+    void fill (const TensorProductPartial<R,dim>& partial, LocalBasisJet<T,0>& jet)
+    {
+      R product = partial.factor[0][0];
+      for (int d=1; d<dim; d++)
+        product *= partial.factor[d][0];
+      jet.value[0] = product;
+    }
+
+    template<class T, class R, int dim>
+    void fill (const TensorProductPartial<R,dim>& partial, LocalBasisJet<T,1>& jet)
+    {
+      // others[d] is the product of the values of all factors but d
+      R others[dim];
+      R product = 1;
+      for (int d=0; d<dim; d++)
+      {
+        others[d] = product;
+        product *= partial.factor[d][0];
+      }
+      product = 1;
+      for (int d=dim-1; d>=0; d--)
+      {
+        others[d] *= product;
+        product *= partial.factor[d][0];
+      }
+
+      jet.value[0] = product;
+      for (int d=0; d<dim; d++)
+        jet.jacobian[0][d] = others[d]*partial.factor[d][1];
+    }
+
+    template<class T, class R, int dim>
+    void fill (const TensorProductPartial<R,dim>& partial, LocalBasisJet<T,2>& jet)
+    {
+      fill(partial,static_cast<LocalBasisJet<T,1>&>(jet));
+      for (int i=0; i<dim; i++)
+      {
+        R product = 1;
+        for (int d=0; d<dim; d++)
+          if (d != i)
+            product *= partial.factor[d][0];
+        jet.hessian[0][i][i] = product*partial.factor[i][2];
+
+        for (int j=i+1; j<dim; j++)
+        {
+          R mixed = partial.factor[i][1]*partial.factor[j][1];
+          for (int d=0; d<dim; d++)
+            if (d != i && d != j)
+              mixed *= partial.factor[d][0];
+          jet.hessian[0][i][j] = mixed;
+          jet.hessian[0][j][i] = mixed;
+        }
+      }
+    }
+
+    /** \brief The Lagrange polynomials of order k with the nodes 0, 1/k, ..., 1
+
+        f[a][s] is the s-th derivative of the polynomial of node a/k at t,
+        for s up to r.
+     */
+    template<class R, int k, int r>
+    void lagrangeFactors (R t, R f[k+1][r+1])
+    {
+      for (int a=0; a<=k; a++)
+      {
+        // coefficients of the monomials t^i of prod_{b!=a} (kt-b)/(a-b)
+        R c[k+1];
+        c[0] = 1;
+        for (int i=1; i<=k; i++)
+          c[i] = 0;
+        for (int b=0; b<=k; b++)
+        {
+          if (b == a)
+            continue;
+          for (int i=k; i>0; i--)
+            c[i] = (k*c[i-1] - b*c[i])/(a-b);
+          c[0] = -b*c[0]/(a-b);
+        }
+
+        // Horner scheme for the derivatives
+        for (int s=0; s<=r; s++)
+        {
+          R value = 0;
+          for (int i=k; i>=s; i--)
+          {
+            R factor = 1;
+            for (int j=i-s+1; j<=i; j++)
+              factor *= j;
+            value = value*t + factor*c[i];
+          }
+          f[a][s] = value;
+        }
+      }
+    }
+
+    /** \brief Jets of a local basis of tensor products of one-dimensional Lagrange polynomials
+
+        \tparam LB Local basis with a specialization of TensorProductLayout
+     */
+    template<class LB, int r>
+    void tensorProductJet (const typename LB::Traits::DomainType& x,
+                           LocalBasisJet<typename LB::Traits,r>* out)
+    {
+      typedef TensorProductLayout<LB> Layout;
+      typedef typename LB::Traits::RangeFieldType R;
+      const int dim = Layout::dim;
+      const int k = Layout::k;
+
+      R f[dim][k+1][r+1];
+      for (int d=0; d<dim; d++)
+        lagrangeFactors<R,k,r>(x[d],f[d]);
+
+      unsigned int size = 1;
+      for (int d=0; d<dim; d++)
+        size *= k+1;
+
+      TensorProductPartial<R,dim> partial;
+      for (unsigned int l=0; l<size; l++)
+      {
+        for (int d=0, m=l; d<dim; d++, m/=k+1)
+          partial.factor[d] = f[d][m%(k+1)];
+        fill(partial,out[Layout::index(l)]);
+      }
+    }
+
+  }
+
+}
+#endif
@@ -3,6 +3,7 @@
 #ifndef DUNE_LOCALCOEFFICIENTS_HH
 #define DUNE_LOCALCOEFFICIENTS_HH
 
+#include <cassert>
 #include <iostream>
 #include <vector>
 
@@ -59,6 +60,116 @@ namespace Dune
     }
   };
 
+  /**@ingroup LocalLayoutInterface
+         \brief A LocalKey packed into one unsigned int of 32 bits
+
+         The index takes bits 0 to 15, the subentity bits 16 to 27 and the
+         codimension bits 28 to 31, so DOF-map loops read four bytes per
+         key instead of the twelve of a LocalKey.
+
+         \nosubgrouping
+   */
+  class PackedLocalKey
+  {
+  public:
+    //! \brief Standard constructor for uninitialized local index
+    PackedLocalKey ()
+    {}
+
+    //! \brief Pack all components of key
+    explicit PackedLocalKey (const LocalKey& key)
+    {
+      assert(key.subentity() < (1u<<12) && key.codim() < (1u<<4) && key.index() < (1u<<16));
+      bits = (key.codim()<<28) | (key.subentity()<<16) | key.index();
+    }
+
+    //! \brief Return number of associated subentity
+    unsigned int subentity () const
+    {
+      return (bits>>16) & 0xfff;
+    }
+
+    //! \brief Return codim of associated entity
+    unsigned int codim () const
+    {
+      return bits>>28;
+    }
+
+    //! \brief Return offset within subentity
+    unsigned int index () const
+    {
+      return bits & 0xffff;
+    }
+
+    //! \brief The unpacked key
+    LocalKey localKey () const
+    {
+      return LocalKey(subentity(),codim(),index());
+    }
+
+  private:
+    unsigned int bits;
+  };
+
+  /**@ingroup LocalLayoutInterface
+         \brief Local keys in static storage, shared by all objects of a coefficient class
+
+         The keys of all variants are computed by Generator::fill(v,keys),
+         which writes the n keys of variant v, when the table is first used.
+         They are then kept read-only for the rest of the program, so
+         constructing a coefficient object only stores pointers into the
+         table.  The table is a function-local static object, whose
+         initialization g++ guards against concurrent first use.
+
+         \tparam Generator Class providing static void fill(int,LocalKey*),
+                           usually the coefficient class itself
+         \tparam n Number of keys of each variant
+         \tparam variants Number of variants
+
+         \nosubgrouping
+   */
+  template<class Generator, int n, int variants = 1>
+  class LocalKeyTable
+  {
+  public:
+    //! \brief The keys of variant v
+    static const LocalKey* keys (int v = 0)
+    {
+      assert(0 <= v && v < variants);
+      return storage().keys[v];
+    }
+
+    //! \brief The packed keys of variant v
+    static const PackedLocalKey* packedKeys (int v = 0)
+    {
+      assert(0 <= v && v < variants);
+      return storage().packedKeys[v];
+    }
+
+  private:
+    struct Storage
+    {
+      Storage ()
+      {
+        for (int v=0; v<variants; v++)
+        {
+          Generator::fill(v,keys[v]);
+          for (int i=0; i<n; i++)
+            packedKeys[v][i] = PackedLocalKey(keys[v][i]);
+        }
+      }
+
+      LocalKey keys[variants][n];
+      PackedLocalKey packedKeys[variants][n];
+    };
+
+    static const Storage& storage ()
+    {
+      static const Storage table;
+      return table;
+    }
+  };
+
   /**@ingroup LocalLayoutInterface
          \brief Layout description corresponding to a local basis
 
@@ -0,0 +1,294 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+#ifndef DUNE_LOCALFACECACHE_HH
+#define DUNE_LOCALFACECACHE_HH
+
+#include <algorithm>
+#include <map>
+#include <utility>
+#include <vector>
+
+#include <dune/common/exceptions.hh>
+#include <dune/common/fvector.hh>
+#include <dune/common/geometrytype.hh>
+#include <dune/grid/common/quadraturerules.hh>
+
+#include "localbasiscache.hh"
+
+namespace Dune
+{
+
+  /**@ingroup LocalBasisInterface
+         \brief Maps points of the reference face into the reference element, for all faces and orientations
+
+         The faces are numbered as the subentities of codimension 1 of the
+         reference elements: face 2d+b of a cube is the face x_d=b, face f
+         of a triangle or tetrahedron lies opposite vertex f.  The vertices
+         of a face are the vertices of the element on it, in ascending
+         order, and the reference face is mapped affinely such that its
+         vertices go to these in order.
+
+         An orientation permutes the vertices of the reference face before
+         this map.  With orientation o, vertex r of the reference face takes
+         the role of vertex permutation(o,r) of the face.  Faces of
+         dimension 0 have one orientation, edges two, triangles the six
+         permutations of their vertices and quadrilaterals the eight
+         symmetries of the square.  On a face shared by two elements, the
+         orientation is chosen such that the points of a face quadrature
+         rule match those of the neighbour.
+
+         Only simplices and cubes are supported.
+
+         \tparam ctype Type of the coordinates
+         \tparam dim Dimension of the reference element
+
+         \nosubgrouping
+   */
+  template<class ctype, int dim>
+  class LocalFaceMapping
+  {
+  public:
+    //! \brief Coordinates on the reference element
+    typedef FieldVector<ctype,dim> GlobalType;
+
+    //! \brief Coordinates on the reference face
+    typedef FieldVector<ctype,dim-1> LocalType;
+
+    //! \brief Number of faces of the reference element
+    static int faces (const GeometryType& gt)
+    {
+      check(gt);
+      return gt.isCube() ? 2*dim : dim+1;
+    }
+
+    //! \brief Type of the faces of the reference element
+    static GeometryType faceType (const GeometryType& gt)
+    {
+      check(gt);
+      return GeometryType(gt.basicType(),dim-1);
+    }
+
+    //! \brief Number of orientations of each face
+    static int orientations (const GeometryType& gt)
+    {
+      check(gt);
+      switch (dim)
+      {
+      case 1 : return 1;
+      case 2 : return 2;
+      default : return gt.isCube() ? 8 : 6;
+      }
+    }
+
+    //! \brief Number of vertices of each face
+    static int faceVertices (const GeometryType& gt)
+    {
+      check(gt);
+      return gt.isCube() ? (1<<(dim-1)) : dim;
+    }
+
+    //! \brief Vertex of the face that vertex r of the reference face is mapped to with orientation o
+    static int permutation (const GeometryType& gt, int o, int r)
+    {
+      static const int line[2][2] = {{0,1},{1,0}};
+      static const int triangle[6][3] = {{0,1,2},{0,2,1},{1,0,2},{1,2,0},{2,0,1},{2,1,0}};
+
+      if (dim == 1)
+        return r;
+      if (dim == 2)
+        return line[o][r];
+      if (!gt.isCube())
+        return triangle[o][r];
+
+      // bit 2 of o swaps the axes of the quadrilateral, bits 0 and 1 flip them
+      int x = r&1, y = r>>1;
+      if (o&4)
+        std::swap(x,y);
+      return (x^(o&1)) + 2*(y^((o>>1)&1));
+    }
+
+    //! \brief Number of the j-th vertex of face f in the reference element
+    static int faceVertex (const GeometryType& gt, int f, int j)
+    {
+      check(gt);
+      if (gt.isCube())
+      {
+        // insert the fixed bit f%2 at position f/2 into j
+        const int d = f/2;
+        const int low = j & ((1<<d)-1);
+        return low | ((f%2)<<d) | ((j>>d)<<(d+1));
+      }
+      return (j<f) ? j : j+1;
+    }
+
+    //! \brief Position of vertex v of the reference element
+    static GlobalType vertex (const GeometryType& gt, int v)
+    {
+      check(gt);
+      GlobalType x(ctype(0));
+      if (gt.isCube())
+        for (int d=0; d<dim; d++)
+          x[d] = (v>>d)&1;
+      else if (v > 0)
+        x[v-1] = 1;
+      return x;
+    }
+
+    //! \brief Map the point local of the reference face into the reference element, on face f with orientation o
+    static GlobalType global (const GeometryType& gt, int f, int o, const LocalType& local)
+    {
+      const LocalType y = orient(gt,o,local);
+
+      const GlobalType origin = vertex(gt,faceVertex(gt,f,0));
+      GlobalType x = origin;
+      for (int j=0; j<dim-1; j++)
+      {
+        // the neighbours of face vertex 0 along the axes of the reference face
+        GlobalType edge = vertex(gt,faceVertex(gt,f,gt.isCube() ? (1<<j) : j+1));
+        edge -= origin;
+        x.axpy(y[j],edge);
+      }
+      return x;
+    }
+
+  private:
+    //! \brief Apply the vertex permutation o to a point of the reference face
+    static LocalType orient (const GeometryType& gt, int o, const LocalType& local)
+    {
+      LocalType y = local;
+      if (dim == 3 && gt.isCube())
+      {
+        // the same symmetry of the square, acting on coordinates
+        if (o&4)
+          std::swap(y[0],y[1]);
+        if (o&1)
+          y[0] = 1-y[0];
+        if (o&2)
+          y[1] = 1-y[1];
+        return y;
+      }
+
+      // barycentric coordinates lambda of the reference face are moved to
+      // the vertices permutation(o,r)
+      ctype lambda[dim];
+      lambda[0] = 1;
+      for (int r=1; r<dim; r++)
+      {
+        lambda[r] = local[r-1];
+        lambda[0] -= local[r-1];
+      }
+      ctype mu[dim];
+      for (int r=0; r<dim; r++)
+        mu[permutation(gt,o,r)] = lambda[r];
+      for (int j=0; j<dim-1; j++)
+        y[j] = mu[j+1];
+      return y;
+    }
+
+    static void check (const GeometryType& gt)
+    {
+      if (gt.dim() != dim || !(gt.isSimplex() || gt.isCube()))
+        DUNE_THROW(NotImplemented, "LocalFaceMapping only supports simplices and cubes of dimension " << dim);
+    }
+  };
+
+
+
+  /**@ingroup LocalBasisInterface
+         \brief Tabulates a local basis at face quadrature points, for all faces and orientations
+
+         The first request for a pair (GeometryType, order) maps the points
+         of QuadratureRules<DF,dim-1>::rule(faceType,order) into the
+         reference element with LocalFaceMapping, for every face and every
+         orientation, and tabulates the basis there.  Each table is a
+         LocalBasisTable, i.e. contiguous and point-major, whose positions
+         are in the coordinates of the element and whose weights are those
+         of the face rule.  Its points are in the order of the face rule.
+         Later requests return references to the same tables, which stay
+         valid as long as the cache exists.
+
+         As LocalBasisCache, a cache belongs to one basis object and is
+         not thread-safe.
+
+         \tparam LB Local basis to tabulate, must provide evaluateFunctionBatched()
+                    and evaluateJacobianBatched()
+
+         \nosubgrouping
+   */
+  template<class LB>
+  class LocalFaceCache
+  {
+  public:
+    //! \brief Export type traits of the local basis
+    typedef typename LB::Traits Traits;
+
+    //! \brief Type of the cached tables
+    typedef LocalBasisTable<LB> TableType;
+
+    //! \brief The mapping of face points into the reference element
+    typedef LocalFaceMapping<typename Traits::DomainFieldType,Traits::dimDomain> MappingType;
+
+    //! \brief Create a cache for the given basis, which must outlive the cache
+    explicit LocalFaceCache (const LB& lb_)
+      : lb(lb_)
+    {}
+
+    //! \brief The basis that is tabulated
+    const LB& localBasis () const
+    {
+      return lb;
+    }
+
+    //! \brief Values and Jacobians at the points of the face rule of given order on face f with orientation o
+    const TableType& table (const GeometryType& gt, int face, int orientation, int order) const
+    {
+      const std::vector<TableType>& faceTables = tables(gt,order);
+      return faceTables[face*MappingType::orientations(gt)+orientation];
+    }
+
+    //! \brief The tables of all faces and orientations, entry f*orientations+o belongs to face f and orientation o
+    const std::vector<TableType>& tables (const GeometryType& gt, int order) const
+    {
+      const Key key(std::make_pair(int(gt.basicType()),int(gt.dim())),order);
+      typename Map::iterator it = cache.find(key);
+      if (it == cache.end())
+      {
+        typedef typename Traits::DomainFieldType DF;
+        const int dim = Traits::dimDomain;
+        const QuadratureRule<DF,dim-1>& quad =
+          QuadratureRules<DF,dim-1>::rule(MappingType::faceType(gt),order);
+
+        std::vector<typename Traits::DomainType> positions(quad.size(),typename Traits::DomainType(DF(0)));
+        std::vector<DF> weights(quad.size());
+        for (size_t q=0; q<quad.size(); q++)
+          weights[q] = quad[q].weight();
+
+        const int faces = MappingType::faces(gt);
+        const int orientations = MappingType::orientations(gt);
+        std::vector<TableType> faceTables;
+        faceTables.reserve(faces*orientations);
+        for (int f=0; f<faces; f++)
+          for (int o=0; o<orientations; o++)
+          {
+            for (size_t q=0; q<quad.size(); q++)
+              positions[q] = MappingType::global(gt,f,o,quad[q].position());
+            faceTables.push_back(TableType(lb,positions,weights));
+          }
+
+        // insert only the complete tables, so that an exception leaves the cache unchanged
+        it = cache.insert(std::make_pair(key,std::vector<TableType>())).first;
+        it->second.swap(faceTables);
+      }
+      return it->second;
+    }
+
+  private:
+    typedef std::pair<std::pair<int,int>,int> Key;
+    typedef std::map<Key,std::vector<TableType> > Map;
+
+    const LB& lb;
+    mutable Map cache;
+  };
+
+}
+#endif
@@ -0,0 +1,84 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+#ifndef DUNE_LOCALFINITEELEMENTVARIANTS_HH
+#define DUNE_LOCALFINITEELEMENTVARIANTS_HH
+
+#include <cassert>
+
+namespace Dune
+{
+
+  /** \brief The edges of a triangle that run against the global vertex ids
+
+      Edge e of the reference triangle lies opposite vertex e and runs
+      from the lower to the higher of its two local vertices.  Bit e of
+      the result is set if the global id of its first vertex is larger
+      than that of its second one.  Two triangles sharing an edge
+      then agree on its direction once they flip the edges given here.
+
+      \param ids Global ids of the vertices 0, 1 and 2, any type with
+                 operator[] whose entries can be compared
+   */
+  template<class IdVector>
+  unsigned int triangleEdgeFlips (const IdVector& ids)
+  {
+    return (ids[1] > ids[2] ? 1u : 0u)
+           | (ids[0] > ids[2] ? 2u : 0u)
+           | (ids[0] > ids[1] ? 4u : 0u);
+  }
+
+  /**@ingroup LocalBasisInterface
+         \brief All orientation variants of a local finite element, created once
+
+         A conforming discretization needs the variant of a local finite
+         element that matches its neighbours, e.g. Pk2DLocalFiniteElement
+         with flipped edges.  Instead of one finite element object per grid
+         element, an object of this class holds each of the FE::variants
+         variants once.  Grid elements then refer to them by reference or
+         by their variant number.  element() chooses the variant from the
+         global ids of the vertices of a grid element, using FE::variant(),
+         which takes one table lookup per element.
+
+         \tparam FE Local finite element with a constructor from the
+                    variant number, a static member variant() computing it
+                    from global vertex ids, and the enum value variants
+
+         \nosubgrouping
+   */
+  template<class FE>
+  class LocalFiniteElementVariants
+  {
+  public:
+    //! \brief Type of the local finite elements
+    typedef FE FiniteElementType;
+
+    //! \brief Number of variants
+    enum {size = FE::variants};
+
+    //! \brief Create all variants
+    LocalFiniteElementVariants ()
+    {
+      for (int v=0; v<size; v++)
+        elements[v] = FE(v);
+    }
+
+    //! \brief The variant with the given number
+    const FE& variant (unsigned int v) const
+    {
+      assert(v < (unsigned int) size);
+      return elements[v];
+    }
+
+    //! \brief The variant for a grid element with the given global vertex ids
+    template<class IdVector>
+    const FE& element (const IdVector& globalVertexIds) const
+    {
+      return elements[FE::variant(globalVertexIds)];
+    }
+
+  private:
+    FE elements[size];
+  };
+
+}
+#endif
@@ -0,0 +1,125 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+#ifndef DUNE_LOCALFUNCTION_HH
+#define DUNE_LOCALFUNCTION_HH
+
+#include <vector>
+
+namespace Dune
+{
+
+  /**@ingroup LocalBasisInterface
+         \brief Evaluates u = sum_i c_i phi_i and its Jacobian for a local basis
+
+         This default implementation evaluates all shape functions into
+         storage on the stack and sums them up.  Bases that can do better
+         specialize this class and compute u and its Jacobian directly,
+         without ever forming the values of the single shape functions.
+
+         \tparam LB Local basis, must export its number of shape functions as LB::N
+
+         \nosubgrouping
+   */
+  template<class LB>
+  class LocalFunctionEvaluator
+  {
+  public:
+    //! \brief Export type traits of the local basis
+    typedef typename LB::Traits Traits;
+
+    //! \brief Value of the function with coefficients c[0],...,c[N-1] at position in
+    template<class C>
+    static void evaluateFunction (const LB& lb,
+                                  const typename Traits::DomainType& in,
+                                  const C* c,
+                                  typename Traits::RangeType& value)
+    {
+      typename Traits::RangeType values[LB::N];
+      lb.evaluateFunction(in,values,LB::N);
+
+      value = 0;
+      for (int i=0; i<LB::N; i++)
+        value.axpy(c[i],values[i]);
+    }
+
+    //! \brief Value and Jacobian of the function with coefficients c[0],...,c[N-1] at position in
+    template<class C>
+    static void evaluateFunctionAndJacobian (const LB& lb,
+                                             const typename Traits::DomainType& in,
+                                             const C* c,
+                                             typename Traits::RangeType& value,
+                                             typename Traits::JacobianType& jacobian)
+    {
+      typename Traits::RangeType values[LB::N];
+      typename Traits::JacobianType jacobians[LB::N];
+      lb.evaluateFunctionAndJacobian(in,values,jacobians,LB::N);
+
+      value = 0;
+      for (int r=0; r<Traits::dimRange; r++)
+        jacobian[r] = 0;
+      for (int i=0; i<LB::N; i++)
+      {
+        value.axpy(c[i],values[i]);
+        for (int r=0; r<Traits::dimRange; r++)
+          jacobian[r].axpy(c[i],jacobians[i][r]);
+      }
+    }
+  };
+
+
+
+  /**@ingroup LocalBasisInterface
+         \brief A finite element function on the reference element
+
+         Combines a local basis with a vector of coefficients and evaluates
+         u = sum_i c_i phi_i and its Jacobian through LocalFunctionEvaluator.
+         Since it provides evaluate(), it can itself be passed to a local
+         interpolation.  Basis and coefficients are stored by reference.
+
+         \tparam LB Local basis
+         \tparam C  Type of the coefficients
+
+         \nosubgrouping
+   */
+  template<class LB, class C = typename LB::Traits::RangeFieldType>
+  class LocalFunction
+  {
+  public:
+    //! \brief Export type traits of the local basis
+    typedef typename LB::Traits Traits;
+
+    //! \brief Construct from a basis and coefficients, which must contain lb.size() entries
+    LocalFunction (const LB& lb_, const std::vector<C>& coefficients_)
+      : lb(lb_), coefficients(coefficients_)
+    {}
+
+    //! \brief Evaluate the function
+    void evaluate (const typename Traits::DomainType& in,
+                   typename Traits::RangeType& out) const
+    {
+      LocalFunctionEvaluator<LB>::evaluateFunction(lb,in,&coefficients[0],out);
+    }
+
+    //! \brief Evaluate the Jacobian of the function
+    void evaluateJacobian (const typename Traits::DomainType& in,
+                           typename Traits::JacobianType& out) const
+    {
+      typename Traits::RangeType value;
+      LocalFunctionEvaluator<LB>::evaluateFunctionAndJacobian(lb,in,&coefficients[0],value,out);
+    }
+
+    //! \brief Evaluate the function and its Jacobian
+    void evaluateFunctionAndJacobian (const typename Traits::DomainType& in,
+                                      typename Traits::RangeType& value,
+                                      typename Traits::JacobianType& jacobian) const
+    {
+      LocalFunctionEvaluator<LB>::evaluateFunctionAndJacobian(lb,in,&coefficients[0],value,jacobian);
+    }
+
+  private:
+    const LB& lb;
+    const std::vector<C>& coefficients;
+  };
+
+}
+#endif
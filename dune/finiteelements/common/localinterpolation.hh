@@ -21,6 +21,18 @@ namespace Dune
       asImp().interpolate(f,out);
     }
 
+    /** \brief determine coefficients interpolating a given function
+
+        Writes the coefficients to caller-provided storage, which must have
+        room for all coefficients of the finite element.  No memory is
+        allocated.
+     */
+    template<typename F, typename C>
+    void interpolate (const F& f, C* out) const
+    {
+      asImp().interpolate(f,out);
+    }
+
   private:
     Imp& asImp () {return static_cast<Imp &> (*this);}
     const Imp& asImp () const {return static_cast<const Imp &>(*this);}
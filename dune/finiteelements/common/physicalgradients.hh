@@ -0,0 +1,184 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+#ifndef DUNE_PHYSICALGRADIENTS_HH
+#define DUNE_PHYSICALGRADIENTS_HH
+
+#include <cassert>
+#include <vector>
+
+#include <dune/common/fvector.hh>
+#include <dune/common/fmatrix.hh>
+
+#include "localbasiscache.hh"
+
+namespace Dune
+{
+
+  /**@ingroup LocalBasisInterface
+         \brief Transforms tabulated reference gradients to many elements at once
+
+         Given the Jacobians of a local basis at the points of a quadrature
+         rule, as stored in a LocalBasisTable, and the inverse transposed
+         Jacobians J^{-T} of the geometries of a batch of elements, this
+         computes the gradients J^{-T} grad phi_i(x_q) on all elements.
+
+         The result is stored element-major, each element in the point-major
+         layout of the table, i.e. entry (e*numPoints()+q)*size()+i belongs
+         to shape function i at quadrature point q on element e.
+
+         There are two kernels:
+         - affine() for geometries with a constant Jacobian, such as
+           simplices.  Blocks of elements share one pass over the reference
+           gradients, with the matrices of the block kept in registers.
+         - multilinear() for geometries whose Jacobian varies over the
+           element, such as Q1 geometries of quadrilaterals and hexahedra.
+           Every matrix is loaded once and applied to all shape functions
+           at its quadrature point.
+
+         \tparam LB Local basis that has been tabulated
+         \tparam dimworld Dimension of the world, the number of rows of J^{-T}
+
+         \nosubgrouping
+   */
+  template<class LB, int dimworld = LB::Traits::dimDomain>
+  class PhysicalGradients
+  {
+  public:
+    //! \brief Export type traits of the local basis
+    typedef typename LB::Traits Traits;
+
+    //! \brief The table of reference gradients
+    typedef LocalBasisTable<LB> TableType;
+
+    //! \brief Inverse transposed Jacobian of a geometry, as returned by Geometry::jacobianInverseTransposed()
+    typedef FieldMatrix<typename Traits::DomainFieldType,dimworld,Traits::dimDomain>
+    JacobianInverseTransposedType;
+
+    //! \brief Physical gradients of all components of one shape function
+    typedef FieldVector<FieldVector<typename Traits::RangeFieldType,dimworld>,Traits::dimRange>
+    GradientType;
+
+    //! \brief Number of elements that share one pass over the reference gradients in affine()
+    enum {blockSize = 4};
+
+    /** \brief Gradients on elements with constant Jacobians
+
+       \param table Reference gradients
+       \param jit jit[e] is J^{-T} of element e
+       \param out Physical gradients, resized to jit.size()*numPoints()*size()
+     */
+    static void affine (const TableType& table,
+                        const std::vector<JacobianInverseTransposedType>& jit,
+                        std::vector<GradientType>& out)
+    {
+      out.resize(jit.size()*table.numPoints()*table.size());
+      if (!jit.empty())
+        affine(table,&jit[0],jit.size(),&out[0]);
+    }
+
+    //! \brief Gradients on elements with constant Jacobians into caller-provided storage for elements*numPoints()*size() gradients
+    static void affine (const TableType& table,
+                        const JacobianInverseTransposedType* jit,
+                        unsigned int elements,
+                        GradientType* out)
+    {
+      const unsigned int stride = table.numPoints()*table.size();
+      const typename Traits::JacobianType* ref = &table.jacobians()[0];
+
+      unsigned int e = 0;
+      for (; e+blockSize<=elements; e+=blockSize)
+        affineBlock<blockSize>(ref,stride,jit+e,out+e*stride);
+      for (; e<elements; e++)
+        affineBlock<1>(ref,stride,jit+e,out+e*stride);
+    }
+
+    /** \brief Gradients on elements with a Jacobian per quadrature point
+
+       \param table Reference gradients
+       \param jit jit[e*numPoints()+q] is J^{-T} of element e at quadrature point q
+       \param out Physical gradients, resized to jit.size()*size()
+     */
+    static void multilinear (const TableType& table,
+                             const std::vector<JacobianInverseTransposedType>& jit,
+                             std::vector<GradientType>& out)
+    {
+      assert(jit.size() % table.numPoints() == 0);
+      out.resize(jit.size()*table.size());
+      if (!jit.empty())
+        multilinear(table,&jit[0],jit.size()/table.numPoints(),&out[0]);
+    }
+
+    //! \brief Gradients on elements with a Jacobian per quadrature point into caller-provided storage for elements*numPoints()*size() gradients
+    static void multilinear (const TableType& table,
+                             const JacobianInverseTransposedType* jit,
+                             unsigned int elements,
+                             GradientType* out)
+    {
+      typedef typename Traits::DomainFieldType DF;
+      typedef typename Traits::RangeFieldType RF;
+      const int dim = Traits::dimDomain;
+      const unsigned int n = table.size();
+      const unsigned int points = table.numPoints();
+
+      for (unsigned int e=0; e<elements; e++)
+      {
+        const typename Traits::JacobianType* ref = &table.jacobians()[0];
+        for (unsigned int q=0; q<points; q++, jit++, ref+=n, out+=n)
+        {
+          DF a[dimworld][dim];
+          for (int w=0; w<dimworld; w++)
+            for (int d=0; d<dim; d++)
+              a[w][d] = (*jit)[w][d];
+
+          for (unsigned int i=0; i<n; i++)
+            for (int r=0; r<Traits::dimRange; r++)
+              for (int w=0; w<dimworld; w++)
+              {
+                RF sum = 0;
+                for (int d=0; d<dim; d++)
+                  sum += a[w][d]*ref[i][r][d];
+                out[i][r][w] = sum;
+              }
+        }
+      }
+    }
+
+  private:
+    //! \brief Apply the matrices of B elements during one pass over the reference gradients
+    template<int B>
+    static void affineBlock (const typename Traits::JacobianType* ref,
+                             unsigned int stride,
+                             const JacobianInverseTransposedType* jit,
+                             GradientType* out)
+    {
+      typedef typename Traits::DomainFieldType DF;
+      typedef typename Traits::RangeFieldType RF;
+      const int dim = Traits::dimDomain;
+
+      DF a[B][dimworld][dim];
+      for (int b=0; b<B; b++)
+        for (int w=0; w<dimworld; w++)
+          for (int d=0; d<dim; d++)
+            a[b][w][d] = jit[b][w][d];
+
+      for (unsigned int k=0; k<stride; k++)
+        for (int r=0; r<Traits::dimRange; r++)
+        {
+          RF g[dim];
+          for (int d=0; d<dim; d++)
+            g[d] = ref[k][r][d];
+
+          for (int b=0; b<B; b++)
+            for (int w=0; w<dimworld; w++)
+            {
+              RF sum = 0;
+              for (int d=0; d<dim; d++)
+                sum += a[b][w][d]*g[d];
+              out[b*stride+k][r][w] = sum;
+            }
+        }
+    }
+  };
+
+}
+#endif
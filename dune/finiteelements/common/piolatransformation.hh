@@ -0,0 +1,491 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+#ifndef DUNE_PIOLATRANSFORMATION_HH
+#define DUNE_PIOLATRANSFORMATION_HH
+
+#include <cassert>
+#include <vector>
+
+#include <dune/common/fmatrix.hh>
+#include <dune/common/static_assert.hh>
+
+#include "localbasiscache.hh"
+
+namespace Dune
+{
+
+  namespace PiolaImp
+  {
+
+    /** \brief The curl of vector fields and its covariant Piola transformation
+
+        With M = J^{-T}, the curl of M phi is K curl phi, where K is det M
+        in 2d, where the curl is a scalar, and the cofactor matrix of M,
+        i.e. J / det J, in 3d.
+     */
+    template<int dim>
+    struct Curl;
+
+    template<>
+    struct Curl<2>
+    {
+      enum {size = 1};
+
+      template<class JacobianType, class RF>
+      static void reference (const JacobianType& j, RF* c)
+      {
+        c[0] = j[1][0] - j[0][1];
+      }
+
+      template<class M, class DF>
+      static void matrix (const M& m, DF k[1][1])
+      {
+        k[0][0] = m[0][0]*m[1][1] - m[0][1]*m[1][0];
+      }
+    };
+
+    template<>
+    struct Curl<3>
+    {
+      enum {size = 3};
+
+      template<class JacobianType, class RF>
+      static void reference (const JacobianType& j, RF* c)
+      {
+        c[0] = j[2][1] - j[1][2];
+        c[1] = j[0][2] - j[2][0];
+        c[2] = j[1][0] - j[0][1];
+      }
+
+      template<class M, class DF>
+      static void matrix (const M& m, DF k[3][3])
+      {
+        for (int i=0; i<3; i++)
+          for (int j=0; j<3; j++)
+            k[i][j] = m[(i+1)%3][(j+1)%3]*m[(i+2)%3][(j+2)%3]
+                      - m[(i+1)%3][(j+2)%3]*m[(i+2)%3][(j+1)%3];
+      }
+    };
+
+  }
+
+  /**@ingroup LocalBasisInterface
+         \brief Transforms tabulated H(div) shape functions to many elements at once
+
+         Given the values and Jacobians of a vector-valued local basis at the
+         points of a quadrature rule, as stored in a LocalBasisTable, and the
+         Jacobians J of the geometries of a batch of elements, this computes
+         the contravariant Piola transformations
+
+           s_i J phi_i(x_q) / det J
+
+         and their divergences s_i div phi_i(x_q) / det J on all elements.
+         det J is the signed determinant.  The divergence formula holds for
+         non-affine geometries as well.  The sign s_i is -1 if bit i of the
+         variant of the element is set and 1 otherwise, which are the sign
+         flips of the variants of RT02DLocalFiniteElement when the table
+         holds variant 0.
+
+         The results are stored element-major, each element in the
+         point-major layout of the table, i.e. entry (e*numPoints()+q)*size()+i
+         belongs to shape function i at quadrature point q on element e.  As
+         in PhysicalGradients, affine() takes one Jacobian per element and
+         multilinear() one per element and quadrature point.
+
+         \tparam LB Local basis that has been tabulated, with dimRange == dimDomain
+
+         \nosubgrouping
+   */
+  template<class LB>
+  class ContravariantPiola
+  {
+  public:
+    //! \brief Export type traits of the local basis
+    typedef typename LB::Traits Traits;
+
+    //! \brief The table of reference values and Jacobians
+    typedef LocalBasisTable<LB> TableType;
+
+    //! \brief Jacobian of a geometry, entry (i,j) is the derivative of x_i in direction j
+    typedef FieldMatrix<typename Traits::DomainFieldType,Traits::dimDomain,Traits::dimDomain>
+    GeometryJacobianType;
+
+    //! \brief Number of elements that share one pass over the reference values in affine()
+    enum {blockSize = 4};
+
+    dune_static_assert(int(Traits::dimRange) == int(Traits::dimDomain),
+                       "ContravariantPiola needs vector fields with dimRange == dimDomain");
+
+    /** \brief Values and divergences on elements with constant Jacobians
+
+       \param table Reference values and Jacobians
+       \param jacobians jacobians[e] is J of element e
+       \param variants variants[e] selects the signs on element e, may be empty for no sign flips
+       \param values Physical values, resized to jacobians.size()*numPoints()*size()
+       \param divergences Physical divergences, resized like values
+     */
+    static void affine (const TableType& table,
+                        const std::vector<GeometryJacobianType>& jacobians,
+                        const std::vector<unsigned int>& variants,
+                        std::vector<typename Traits::RangeType>& values,
+                        std::vector<typename Traits::RangeFieldType>& divergences)
+    {
+      assert(variants.empty() || variants.size() == jacobians.size());
+      values.resize(jacobians.size()*table.numPoints()*table.size());
+      divergences.resize(values.size());
+      if (!jacobians.empty())
+        affine(table,&jacobians[0],variants.empty() ? 0 : &variants[0],jacobians.size(),
+               &values[0],&divergences[0]);
+    }
+
+    //! \brief Values and divergences on elements with constant Jacobians into caller-provided storage for elements*numPoints()*size() entries each, variants may be 0
+    static void affine (const TableType& table,
+                        const GeometryJacobianType* jacobians,
+                        const unsigned int* variants,
+                        unsigned int elements,
+                        typename Traits::RangeType* values,
+                        typename Traits::RangeFieldType* divergences)
+    {
+      const unsigned int stride = table.numPoints()*table.size();
+
+      unsigned int e = 0;
+      for (; e+blockSize<=elements; e+=blockSize)
+        affineBlock<blockSize>(table,jacobians+e,variants ? variants+e : 0,
+                               values+e*stride,divergences+e*stride);
+      for (; e<elements; e++)
+        affineBlock<1>(table,jacobians+e,variants ? variants+e : 0,
+                       values+e*stride,divergences+e*stride);
+    }
+
+    /** \brief Values and divergences on elements with a Jacobian per quadrature point
+
+       \param table Reference values and Jacobians
+       \param jacobians jacobians[e*numPoints()+q] is J of element e at quadrature point q
+       \param variants variants[e] selects the signs on element e, may be empty for no sign flips
+       \param values Physical values, resized to jacobians.size()*size()
+       \param divergences Physical divergences, resized like values
+     */
+    static void multilinear (const TableType& table,
+                             const std::vector<GeometryJacobianType>& jacobians,
+                             const std::vector<unsigned int>& variants,
+                             std::vector<typename Traits::RangeType>& values,
+                             std::vector<typename Traits::RangeFieldType>& divergences)
+    {
+      assert(jacobians.size() % table.numPoints() == 0);
+      const unsigned int elements = jacobians.size()/table.numPoints();
+      assert(variants.empty() || variants.size() == elements);
+      values.resize(jacobians.size()*table.size());
+      divergences.resize(values.size());
+      if (!jacobians.empty())
+        multilinear(table,&jacobians[0],variants.empty() ? 0 : &variants[0],elements,
+                    &values[0],&divergences[0]);
+    }
+
+    //! \brief Values and divergences on elements with a Jacobian per quadrature point into caller-provided storage for elements*numPoints()*size() entries each, variants may be 0
+    static void multilinear (const TableType& table,
+                             const GeometryJacobianType* jacobians,
+                             const unsigned int* variants,
+                             unsigned int elements,
+                             typename Traits::RangeType* values,
+                             typename Traits::RangeFieldType* divergences)
+    {
+      typedef typename Traits::DomainFieldType DF;
+      typedef typename Traits::RangeFieldType RF;
+      const int dim = Traits::dimDomain;
+      const unsigned int n = table.size();
+      const unsigned int points = table.numPoints();
+
+      for (unsigned int e=0; e<elements; e++)
+      {
+        const unsigned int variant = variants ? variants[e] : 0;
+        const typename Traits::RangeType* ref = &table.values()[0];
+        const typename Traits::JacobianType* refJacobian = &table.jacobians()[0];
+        for (unsigned int q=0; q<points; q++, jacobians++, ref+=n, refJacobian+=n)
+        {
+          const DF inverseDeterminant = 1/jacobians->determinant();
+          DF a[dim][dim];
+          for (int w=0; w<dim; w++)
+            for (int d=0; d<dim; d++)
+              a[w][d] = (*jacobians)[w][d]*inverseDeterminant;
+
+          for (unsigned int i=0; i<n; i++, values++, divergences++)
+          {
+            const RF sign = (variant>>i & 1) ? -1 : 1;
+            for (int w=0; w<dim; w++)
+            {
+              RF sum = 0;
+              for (int d=0; d<dim; d++)
+                sum += a[w][d]*ref[i][d];
+              (*values)[w] = sign*sum;
+            }
+            *divergences = sign*inverseDeterminant*divergence(refJacobian[i]);
+          }
+        }
+      }
+    }
+
+  private:
+    //! \brief Divergence of a shape function from its Jacobian
+    static typename Traits::RangeFieldType divergence (const typename Traits::JacobianType& jacobian)
+    {
+      typename Traits::RangeFieldType sum = 0;
+      for (int d=0; d<Traits::dimDomain; d++)
+        sum += jacobian[d][d];
+      return sum;
+    }
+
+    //! \brief Apply the Jacobians of B elements during one pass over the reference values
+    template<int B>
+    static void affineBlock (const TableType& table,
+                             const GeometryJacobianType* jacobians,
+                             const unsigned int* variants,
+                             typename Traits::RangeType* values,
+                             typename Traits::RangeFieldType* divergences)
+    {
+      typedef typename Traits::DomainFieldType DF;
+      typedef typename Traits::RangeFieldType RF;
+      const int dim = Traits::dimDomain;
+      const unsigned int n = table.size();
+      const unsigned int stride = table.numPoints()*n;
+      const typename Traits::RangeType* ref = &table.values()[0];
+      const typename Traits::JacobianType* refJacobian = &table.jacobians()[0];
+
+      DF a[B][dim][dim], inverseDeterminant[B];
+      unsigned int variant[B];
+      for (int b=0; b<B; b++)
+      {
+        inverseDeterminant[b] = 1/jacobians[b].determinant();
+        for (int w=0; w<dim; w++)
+          for (int d=0; d<dim; d++)
+            a[b][w][d] = jacobians[b][w][d]*inverseDeterminant[b];
+        variant[b] = variants ? variants[b] : 0;
+      }
+
+      for (unsigned int k=0, i=0; k<stride; k++, i = (i+1 == n) ? 0 : i+1)
+      {
+        RF v[dim];
+        for (int d=0; d<dim; d++)
+          v[d] = ref[k][d];
+        const RF div = divergence(refJacobian[k]);
+
+        for (int b=0; b<B; b++)
+        {
+          const RF sign = (variant[b]>>i & 1) ? -1 : 1;
+          for (int w=0; w<dim; w++)
+          {
+            RF sum = 0;
+            for (int d=0; d<dim; d++)
+              sum += a[b][w][d]*v[d];
+            values[b*stride+k][w] = sign*sum;
+          }
+          divergences[b*stride+k] = sign*inverseDeterminant[b]*div;
+        }
+      }
+    }
+  };
+
+  /**@ingroup LocalBasisInterface
+         \brief Transforms tabulated H(curl) shape functions to many elements at once
+
+         Given the values and Jacobians of a vector-valued local basis at the
+         points of a quadrature rule, as stored in a LocalBasisTable, and the
+         inverse transposed Jacobians J^{-T} of the geometries of a batch of
+         elements, this computes the covariant Piola transformations
+
+           J^{-T} phi_i(x_q)
+
+         and their curls.  In 2d the curl is the scalar curl phi_i / det J,
+         in 3d the vector J curl phi_i / det J, both with the signed
+         determinant.  These formulas also hold for non-affine geometries,
+         e.g. general quadrilaterals, where multilinear() takes J^{-T} at
+         every quadrature point.  Tangential components of the transformed
+         functions are continuous between elements whenever those of the
+         reference functions are.
+
+         The layout of the results is that of ContravariantPiola.
+
+         \tparam LB Local basis that has been tabulated, with dimRange == dimDomain of 2 or 3
+
+         \nosubgrouping
+   */
+  template<class LB>
+  class CovariantPiola
+  {
+    typedef PiolaImp::Curl<LB::Traits::dimDomain> Curl;
+
+  public:
+    //! \brief Export type traits of the local basis
+    typedef typename LB::Traits Traits;
+
+    //! \brief The table of reference values and Jacobians
+    typedef LocalBasisTable<LB> TableType;
+
+    //! \brief Inverse transposed Jacobian of a geometry, as returned by Geometry::jacobianInverseTransposed()
+    typedef FieldMatrix<typename Traits::DomainFieldType,Traits::dimDomain,Traits::dimDomain>
+    JacobianInverseTransposedType;
+
+    //! \brief Curl of one shape function, with one component in 2d and three in 3d
+    typedef FieldVector<typename Traits::RangeFieldType,Curl::size> CurlType;
+
+    //! \brief Number of elements that share one pass over the reference values in affine()
+    enum {blockSize = 4};
+
+    dune_static_assert(int(Traits::dimRange) == int(Traits::dimDomain),
+                       "CovariantPiola needs vector fields with dimRange == dimDomain");
+
+    /** \brief Values and curls on elements with constant Jacobians
+
+       \param table Reference values and Jacobians
+       \param jit jit[e] is J^{-T} of element e
+       \param values Physical values, resized to jit.size()*numPoints()*size()
+       \param curls Physical curls, resized like values
+     */
+    static void affine (const TableType& table,
+                        const std::vector<JacobianInverseTransposedType>& jit,
+                        std::vector<typename Traits::RangeType>& values,
+                        std::vector<CurlType>& curls)
+    {
+      values.resize(jit.size()*table.numPoints()*table.size());
+      curls.resize(values.size());
+      if (!jit.empty())
+        affine(table,&jit[0],jit.size(),&values[0],&curls[0]);
+    }
+
+    //! \brief Values and curls on elements with constant Jacobians into caller-provided storage for elements*numPoints()*size() entries each
+    static void affine (const TableType& table,
+                        const JacobianInverseTransposedType* jit,
+                        unsigned int elements,
+                        typename Traits::RangeType* values,
+                        CurlType* curls)
+    {
+      const unsigned int stride = table.numPoints()*table.size();
+
+      unsigned int e = 0;
+      for (; e+blockSize<=elements; e+=blockSize)
+        affineBlock<blockSize>(table,jit+e,values+e*stride,curls+e*stride);
+      for (; e<elements; e++)
+        affineBlock<1>(table,jit+e,values+e*stride,curls+e*stride);
+    }
+
+    /** \brief Values and curls on elements with a Jacobian per quadrature point
+
+       \param table Reference values and Jacobians
+       \param jit jit[e*numPoints()+q] is J^{-T} of element e at quadrature point q
+       \param values Physical values, resized to jit.size()*size()
+       \param curls Physical curls, resized like values
+     */
+    static void multilinear (const TableType& table,
+                             const std::vector<JacobianInverseTransposedType>& jit,
+                             std::vector<typename Traits::RangeType>& values,
+                             std::vector<CurlType>& curls)
+    {
+      assert(jit.size() % table.numPoints() == 0);
+      values.resize(jit.size()*table.size());
+      curls.resize(values.size());
+      if (!jit.empty())
+        multilinear(table,&jit[0],jit.size()/table.numPoints(),&values[0],&curls[0]);
+    }
+
+    //! \brief Values and curls on elements with a Jacobian per quadrature point into caller-provided storage for elements*numPoints()*size() entries each
+    static void multilinear (const TableType& table,
+                             const JacobianInverseTransposedType* jit,
+                             unsigned int elements,
+                             typename Traits::RangeType* values,
+                             CurlType* curls)
+    {
+      typedef typename Traits::DomainFieldType DF;
+      typedef typename Traits::RangeFieldType RF;
+      const int dim = Traits::dimDomain;
+      const unsigned int n = table.size();
+      const unsigned int points = table.numPoints();
+
+      for (unsigned int e=0; e<elements; e++)
+      {
+        const typename Traits::RangeType* ref = &table.values()[0];
+        const typename Traits::JacobianType* refJacobian = &table.jacobians()[0];
+        for (unsigned int q=0; q<points; q++, jit++, ref+=n, refJacobian+=n)
+        {
+          DF a[dim][dim], k[Curl::size][Curl::size];
+          for (int w=0; w<dim; w++)
+            for (int d=0; d<dim; d++)
+              a[w][d] = (*jit)[w][d];
+          Curl::matrix(a,k);
+
+          for (unsigned int i=0; i<n; i++, values++, curls++)
+          {
+            for (int w=0; w<dim; w++)
+            {
+              RF sum = 0;
+              for (int d=0; d<dim; d++)
+                sum += a[w][d]*ref[i][d];
+              (*values)[w] = sum;
+            }
+
+            RF c[Curl::size];
+            Curl::reference(refJacobian[i],c);
+            for (int w=0; w<Curl::size; w++)
+            {
+              RF sum = 0;
+              for (int d=0; d<Curl::size; d++)
+                sum += k[w][d]*c[d];
+              (*curls)[w] = sum;
+            }
+          }
+        }
+      }
+    }
+
+  private:
+    //! \brief Apply the matrices of B elements during one pass over the reference values
+    template<int B>
+    static void affineBlock (const TableType& table,
+                             const JacobianInverseTransposedType* jit,
+                             typename Traits::RangeType* values,
+                             CurlType* curls)
+    {
+      typedef typename Traits::DomainFieldType DF;
+      typedef typename Traits::RangeFieldType RF;
+      const int dim = Traits::dimDomain;
+      const unsigned int stride = table.numPoints()*table.size();
+      const typename Traits::RangeType* ref = &table.values()[0];
+      const typename Traits::JacobianType* refJacobian = &table.jacobians()[0];
+
+      DF a[B][dim][dim], k[B][Curl::size][Curl::size];
+      for (int b=0; b<B; b++)
+      {
+        for (int w=0; w<dim; w++)
+          for (int d=0; d<dim; d++)
+            a[b][w][d] = jit[b][w][d];
+        Curl::matrix(a[b],k[b]);
+      }
+
+      for (unsigned int l=0; l<stride; l++)
+      {
+        RF v[dim], c[Curl::size];
+        for (int d=0; d<dim; d++)
+          v[d] = ref[l][d];
+        Curl::reference(refJacobian[l],c);
+
+        for (int b=0; b<B; b++)
+        {
+          for (int w=0; w<dim; w++)
+          {
+            RF sum = 0;
+            for (int d=0; d<dim; d++)
+              sum += a[b][w][d]*v[d];
+            values[b*stride+l][w] = sum;
+          }
+          for (int w=0; w<Curl::size; w++)
+          {
+            RF sum = 0;
+            for (int d=0; d<Curl::size; d++)
+              sum += k[b][w][d]*c[d];
+            curls[b*stride+l][w] = sum;
+          }
+        }
+      }
+    }
+  };
+
+}
+#endif
@@ -0,0 +1,44 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+#ifndef DUNE_LOCALFUNCTIONS_PRECOMPILED_HH
+#define DUNE_LOCALFUNCTIONS_PRECOMPILED_HH
+
+/** \file
+    \brief Support for the explicit instantiations in libdunelocalfunctions
+
+    With --enable-precompiled-localfunctions, configure defines
+    DUNE_LOCALFUNCTIONS_PRECOMPILED and libdunelocalfunctions contains
+    explicit instantiations of the local bases for D = R = double and
+    D = R = float, of orders 1 and 2 for the bases of arbitrary order, of
+    the Monom and orthonormal interpolations, and of
+    LocalFiniteElementRegistry.  The header of each element then declares
+    them with DUNE_LOCALFUNCTIONS_EXTERN_TEMPLATE.  Programs must then be
+    linked with the library.
+
+    An extern template declaration only keeps a translation unit from
+    compiling the members that are not inline.  Hence the evaluation
+    kernels of the bases (evaluateFunctionAt() etc.), the setup of the
+    interpolation projections and LocalFiniteElementRegistry::get() are
+    defined outside of their classes: programs call these, compiled with
+    LOCALFUNCTIONS_CXXFLAGS, from the library.  Everything defined in the
+    class, like the batched loops around the kernels, is still compiled
+    and inlined by each program.  So is interpolate(), which is a template
+    in the type of the interpolated function and cannot be instantiated
+    in advance.
+
+    The library is compiled without DUNE_VIRTUAL_SHAPEFUNCTIONS, and the
+    bases differ in their vtables when it is defined.  Programs that
+    define it themselves, like virtualbasisbenchmark, therefore do not
+    use the instantiations in the library but compile their own.
+
+    Explicit instantiation declarations are part of C++0x; g++ accepts them
+    in C++98 as an extension.
+ */
+
+#ifdef __GNUC__
+#define DUNE_LOCALFUNCTIONS_EXTERN_TEMPLATE __extension__ extern template
+#else
+#define DUNE_LOCALFUNCTIONS_EXTERN_TEMPLATE extern template
+#endif
+
+#endif
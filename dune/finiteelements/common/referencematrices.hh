@@ -0,0 +1,374 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+#ifndef DUNE_REFERENCEMATRICES_HH
+#define DUNE_REFERENCEMATRICES_HH
+
+#include <cassert>
+#include <cmath>
+#include <vector>
+
+#include <dune/common/exceptions.hh>
+#include <dune/common/fvector.hh>
+#include <dune/common/fmatrix.hh>
+#include <dune/common/geometrytype.hh>
+#include <dune/grid/common/quadraturerules.hh>
+
+#include "localbasis.hh"
+
+namespace Dune
+{
+
+  /**@ingroup LocalBasisInterface
+         \brief Element matrices of a local basis on the reference element
+
+         The constructor integrates, once and for all, with the shape
+         functions phi_i of the basis and their reference gradients
+         \code
+         mass(i,j)         = int phi_i . phi_j
+         stiffness(i,j,a,b) = int sum_r d_a phi_i^r d_b phi_j^r
+         convection(i,j,a)  = int sum_r phi_i^r d_a phi_j^r
+         massTensor(i,j,a,b) = int phi_i^a phi_j^b     (only if dimRange == dimDomain)
+         \endcode
+         On an affine element with inverse transposed Jacobian J^{-T} and
+         integration element mu = |det J| the element matrices are then
+         small contractions of these tensors with the geometry, e.g. the
+         stiffness matrix is mu sum_ab stiffness(i,j,a,b) G_ab with the
+         metric G = J^{-1} J^{-T}.  The assemble methods compute them with
+         dim(dim+1)/2 multiply-adds per entry for stiffness and Piola mass
+         matrices, dim for convection and one for the mass matrix.
+
+         The integrals use the quadrature rule of order 2*order().  Bases
+         that are only piecewise polynomial on a uniformly refined reference
+         element, like RefinedP1, are integrated exactly by passing the
+         number of refinements to the constructor.
+
+         Bases with variants, such as RT02D, differ between objects of the
+         same type, so the matrices belong to one basis object.  They are
+         meant to be computed once and kept next to the finite element, e.g.
+         one object per variant.
+
+         \tparam LB Local basis
+
+         \nosubgrouping
+   */
+  template<class LB>
+  class LocalReferenceMatrices
+  {
+  public:
+    //! \brief Export type traits of the local basis
+    typedef typename LB::Traits Traits;
+
+    typedef typename Traits::DomainFieldType DF;
+    typedef typename Traits::RangeFieldType RF;
+
+    enum {
+      //! \brief Dimension of the reference element
+      dim = Traits::dimDomain,
+      //! \brief Number of entries of a symmetric dim x dim matrix
+      packedSize = dim*(dim+1)/2
+    };
+
+    /** \brief Integrate on the reference element of type gt
+
+       \param lb The basis
+       \param gt Type of the reference element
+       \param refinement Number of uniform refinements of the reference
+       element on whose subelements the basis is polynomial; only
+       implemented for cubes and triangles
+     */
+    LocalReferenceMatrices (const LB& lb, const GeometryType& gt, int refinement = 0)
+      : n(lb.size()),
+        mass_(n*n,RF(0)),
+        stiffness_(n*n*dim*dim,RF(0)),
+        convection_(n*n*dim,RF(0)),
+        massTensor_(int(Traits::dimRange)==int(dim) ? n*n*dim*dim : 0,RF(0))
+    {
+      // the subelements are the images of x -> offset + scale*x
+      std::vector<FieldVector<DF,dim> > offsets(1,FieldVector<DF,dim>(DF(0)));
+      std::vector<DF> scales(1,DF(1));
+      if (refinement > 0 && gt.isSimplex() && dim > 2)
+        DUNE_THROW(NotImplemented, "refined reference elements are only implemented for cubes and triangles");
+      for (int level=0; level<refinement; level++)
+        refine(gt.isSimplex() && dim == 2, offsets, scales);
+
+      const QuadratureRule<DF,dim>& quad = QuadratureRules<DF,dim>::rule(gt,2*lb.order());
+
+      std::vector<typename Traits::RangeType> values;
+      std::vector<typename Traits::JacobianType> jacobians;
+      for (size_t s=0; s<offsets.size(); s++)
+      {
+        DF volume = 1;
+        for (int d=0; d<dim; d++)
+          volume *= std::abs(scales[s]);
+
+        for (size_t q=0; q<quad.size(); q++)
+        {
+          FieldVector<DF,dim> x = offsets[s];
+          x.axpy(scales[s],quad[q].position());
+          const DF weight = quad[q].weight()*volume;
+
+          lb.evaluateFunctionAndJacobian(x,values,jacobians);
+          accumulate(weight,values,jacobians);
+        }
+      }
+
+      pack(stiffness_,packedStiffness_);
+      pack(massTensor_,packedMassTensor_);
+    }
+
+    //! \brief Number of shape functions
+    unsigned int size () const
+    {
+      return n;
+    }
+
+    //! \brief Integral of phi_i . phi_j
+    RF mass (unsigned int i, unsigned int j) const
+    {
+      return mass_[i*n+j];
+    }
+
+    //! \brief Integral of sum_r d_a phi_i^r d_b phi_j^r
+    RF stiffness (unsigned int i, unsigned int j, int a, int b) const
+    {
+      return stiffness_[(i*n+j)*dim*dim+a*dim+b];
+    }
+
+    //! \brief Integral of sum_r phi_i^r d_a phi_j^r
+    RF convection (unsigned int i, unsigned int j, int a) const
+    {
+      return convection_[(i*n+j)*dim+a];
+    }
+
+    //! \brief Integral of phi_i^a phi_j^b, for vector-valued bases with dimRange == dimDomain
+    RF massTensor (unsigned int i, unsigned int j, int a, int b) const
+    {
+      assert(!massTensor_.empty());
+      return massTensor_[(i*n+j)*dim*dim+a*dim+b];
+    }
+
+    /** \brief Set A to the mass matrix of an affine element
+
+       \param integrationElement |det J| of the element
+       \param A Matrix with A[i][j] for i,j < size(), the entries are overwritten
+     */
+    template<class M>
+    void assembleMass (DF integrationElement, M& A) const
+    {
+      for (unsigned int i=0; i<n; i++)
+        for (unsigned int j=0; j<n; j++)
+          A[i][j] = integrationElement*mass_[i*n+j];
+    }
+
+    /** \brief Set A to the stiffness matrix int grad phi_i . grad phi_j of an affine element
+
+       \param jit Inverse transposed Jacobian J^{-T} of the element
+       \param integrationElement |det J| of the element
+       \param A Matrix with A[i][j] for i,j < size(), the entries are overwritten
+     */
+    template<int dimworld, class M>
+    void assembleStiffness (const FieldMatrix<DF,dimworld,dim>& jit,
+                            DF integrationElement, M& A) const
+    {
+      RF g[packedSize];
+      metric(jit,integrationElement,g);
+      contract(packedStiffness_,g,A);
+    }
+
+    /** \brief Set A to the convection matrix int phi_i (beta . grad phi_j) of an affine element
+
+       \param jit Inverse transposed Jacobian J^{-T} of the element
+       \param integrationElement |det J| of the element
+       \param beta Constant velocity in world coordinates
+       \param A Matrix with A[i][j] for i,j < size(), the entries are overwritten
+     */
+    template<int dimworld, class M>
+    void assembleConvection (const FieldMatrix<DF,dimworld,dim>& jit,
+                             DF integrationElement,
+                             const FieldVector<RF,dimworld>& beta,
+                             M& A) const
+    {
+      // beta . J^{-T} grad = (J^{-1} beta) . grad
+      RF b[dim];
+      for (int a=0; a<dim; a++)
+      {
+        b[a] = 0;
+        for (int w=0; w<dimworld; w++)
+          b[a] += jit[w][a]*beta[w];
+        b[a] *= integrationElement;
+      }
+
+      const RF* c = &convection_[0];
+      for (unsigned int i=0; i<n; i++)
+        for (unsigned int j=0; j<n; j++, c+=dim)
+        {
+          RF sum = 0;
+          for (int a=0; a<dim; a++)
+            sum += c[a]*b[a];
+          A[i][j] = sum;
+        }
+    }
+
+    /** \brief Set A to the mass matrix of an affine element for the covariant Piola transformation phi = J^{-T} phi^
+
+       This is the transformation of H(curl) elements like EdgeR12D, it
+       needs dimRange == dimDomain.
+
+       \param jit Inverse transposed Jacobian J^{-T} of the element
+       \param integrationElement |det J| of the element
+       \param A Matrix with A[i][j] for i,j < size(), the entries are overwritten
+     */
+    template<int dimworld, class M>
+    void assembleCovariantMass (const FieldMatrix<DF,dimworld,dim>& jit,
+                                DF integrationElement, M& A) const
+    {
+      assert(!packedMassTensor_.empty());
+      RF g[packedSize];
+      metric(jit,integrationElement,g);
+      contract(packedMassTensor_,g,A);
+    }
+
+    /** \brief Set A to the mass matrix of an affine element for the contravariant Piola transformation phi = J phi^ / det J
+
+       This is the transformation of H(div) elements like RT02D, it
+       needs dimRange == dimDomain.
+
+       \param jacobian Jacobian J of the element, with one row per world coordinate
+       \param integrationElement |det J| of the element
+       \param A Matrix with A[i][j] for i,j < size(), the entries are overwritten
+     */
+    template<int dimworld, class M>
+    void assembleContravariantMass (const FieldMatrix<DF,dimworld,dim>& jacobian,
+                                    DF integrationElement, M& A) const
+    {
+      assert(!packedMassTensor_.empty());
+      RF g[packedSize];
+      metric(jacobian,1/integrationElement,g);
+      contract(packedMassTensor_,g,A);
+    }
+
+  private:
+    //! \brief Add the contributions of one quadrature point
+    void accumulate (DF weight,
+                     const std::vector<typename Traits::RangeType>& values,
+                     const std::vector<typename Traits::JacobianType>& jacobians)
+    {
+      for (unsigned int i=0; i<n; i++)
+        for (unsigned int j=0; j<n; j++)
+        {
+          const unsigned int ij = i*n+j;
+          for (int r=0; r<Traits::dimRange; r++)
+          {
+            mass_[ij] += weight*values[i][r]*values[j][r];
+            for (int a=0; a<dim; a++)
+            {
+              convection_[ij*dim+a] += weight*values[i][r]*jacobians[j][r][a];
+              for (int b=0; b<dim; b++)
+                stiffness_[(ij*dim+a)*dim+b] += weight*jacobians[i][r][a]*jacobians[j][r][b];
+            }
+          }
+          if (!massTensor_.empty())
+            for (int a=0; a<dim; a++)
+              for (int b=0; b<dim; b++)
+                massTensor_[(ij*dim+a)*dim+b] += weight*values[i][a]*values[j][b];
+        }
+    }
+
+    //! \brief Fold a tensor T_ij,ab into its contraction with symmetric matrices, stored for a <= b
+    void pack (const std::vector<RF>& full, std::vector<RF>& packed) const
+    {
+      if (full.empty())
+        return;
+      packed.resize(n*n*packedSize);
+      for (unsigned int ij=0; ij<n*n; ij++)
+      {
+        int s = 0;
+        for (int a=0; a<dim; a++)
+          for (int b=a; b<dim; b++, s++)
+            packed[ij*packedSize+s] = (a == b)
+                                      ? full[(ij*dim+a)*dim+a]
+                                      : full[(ij*dim+a)*dim+b] + full[(ij*dim+b)*dim+a];
+      }
+    }
+
+    //! \brief The entries a <= b of factor * B^T B
+    template<int dimworld>
+    static void metric (const FieldMatrix<DF,dimworld,dim>& B, DF factor, RF* g)
+    {
+      int s = 0;
+      for (int a=0; a<dim; a++)
+        for (int b=a; b<dim; b++, s++)
+        {
+          g[s] = 0;
+          for (int w=0; w<dimworld; w++)
+            g[s] += B[w][a]*B[w][b];
+          g[s] *= factor;
+        }
+    }
+
+    //! \brief A_ij = sum_s packed_ij,s g_s
+    template<class M>
+    void contract (const std::vector<RF>& packed, const RF* g, M& A) const
+    {
+      const RF* p = &packed[0];
+      for (unsigned int i=0; i<n; i++)
+        for (unsigned int j=0; j<n; j++, p+=packedSize)
+        {
+          RF sum = 0;
+          for (int s=0; s<packedSize; s++)
+            sum += p[s]*g[s];
+          A[i][j] = sum;
+        }
+    }
+
+    /** \brief Replace every subelement by the subelements of its uniform refinement
+
+       Cubes are split into 2^dim cubes.  Triangles are split into three
+       corner triangles and the middle one, which is the reflection of the
+       element at its center (negative scale), as in RefinedP1.
+     */
+    static void refine (bool triangle,
+                        std::vector<FieldVector<DF,dim> >& offsets,
+                        std::vector<DF>& scales)
+    {
+      std::vector<FieldVector<DF,dim> > newOffsets;
+      std::vector<DF> newScales;
+      for (size_t s=0; s<offsets.size(); s++)
+      {
+        const DF h = scales[s]/2;
+        for (int c=0; c<(1<<dim); c++)
+        {
+          FieldVector<DF,dim> corner(DF(0));
+          for (int d=0; d<dim; d++)
+            corner[d] = (c>>d) & 1;
+
+          FieldVector<DF,dim> offset = offsets[s];
+          offset.axpy(h,corner);
+          if (triangle && c == 3)
+          {
+            // the middle triangle, mapped with corner (1,1) and reflected
+            newOffsets.push_back(offset);
+            newScales.push_back(-h);
+          }
+          else
+          {
+            newOffsets.push_back(offset);
+            newScales.push_back(h);
+          }
+        }
+      }
+      offsets.swap(newOffsets);
+      scales.swap(newScales);
+    }
+
+    unsigned int n;
+    std::vector<RF> mass_;
+    std::vector<RF> stiffness_;
+    std::vector<RF> convection_;
+    std::vector<RF> massTensor_;
+    std::vector<RF> packedStiffness_;
+    std::vector<RF> packedMassTensor_;
+  };
+
+}
+#endif
@@ -0,0 +1,213 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+#ifndef DUNE_SHAREDLOCALFINITEELEMENT_HH
+#define DUNE_SHAREDLOCALFINITEELEMENT_HH
+
+#include <vector>
+
+#include <dune/common/fvector.hh>
+#include <dune/common/geometrytype.hh>
+
+#include "cachemutex.hh"
+#include "localbasis.hh"
+#include "localbasiscache.hh"
+#include "localcoefficients.hh"
+#include "localfacecache.hh"
+
+namespace Dune
+{
+
+  /**@ingroup LocalBasisInterface
+         \brief A local finite element whose type is chosen at run time
+
+         Hides the type of a local finite element behind virtual functions,
+         independently of DUNE_VIRTUAL_SHAPEFUNCTIONS.  The object combines
+         the local basis, the local keys and the interpolation, and it keeps
+         the tabulations of its basis at volume and face quadrature points.
+         Since objects of this class are meant to be shared between all
+         elements of a grid, they are immutable apart from these caches,
+         which are filled on first use under a CacheMutex, so that
+         several threads may request tables at the same time.
+
+         The class itself satisfies the requirements of LocalBasisCache on
+         a local basis, so the tables are LocalBasisTable<SharedLocalFiniteElement>.
+
+         \tparam D Type to represent the field in the domain
+         \tparam R Type to represent the field in the range
+         \tparam dim Domain dimension
+         \tparam dimR Range dimension
+
+         \nosubgrouping
+   */
+  template<class D, class R, int dim, int dimR = 1>
+  class SharedLocalFiniteElement
+  {
+  public:
+    //! \brief Types of the domain, range and Jacobians
+    typedef C1LocalBasisTraits<D,dim,Dune::FieldVector<D,dim>,R,dimR,Dune::FieldVector<R,dimR>,
+        Dune::FieldVector<Dune::FieldVector<R,dim>,dimR> > Traits;
+
+    //! \brief Tables of the basis at the points of a quadrature rule
+    typedef LocalBasisTable<SharedLocalFiniteElement> TableType;
+
+    //! \brief A function to interpolate
+    class FunctionType
+    {
+    public:
+      //! \brief Export the domain and range types, as needed by some interpolations
+      typedef typename SharedLocalFiniteElement::Traits Traits;
+
+      virtual ~FunctionType ()
+      {}
+
+      virtual void evaluate (const typename Traits::DomainType& x, typename Traits::RangeType& y) const = 0;
+    };
+
+    SharedLocalFiniteElement ()
+      : volumeCache(*this), faceCache(*this)
+    {}
+
+    virtual ~SharedLocalFiniteElement ()
+    {}
+
+    //! \brief Type of the reference element
+    virtual GeometryType type () const = 0;
+
+    //! \brief Number of shape functions
+    virtual unsigned int size () const = 0;
+
+    //! \brief Polynomial order of the shape functions
+    virtual unsigned int order () const = 0;
+
+    //! \brief Local key of shape function i
+    virtual const LocalKey& localKey (unsigned int i) const = 0;
+
+    //! \brief Evaluate all shape functions
+    virtual void evaluateFunction (const typename Traits::DomainType& in,
+                                   std::vector<typename Traits::RangeType>& out) const = 0;
+
+    //! \brief Evaluate the Jacobians of all shape functions
+    virtual void evaluateJacobian (const typename Traits::DomainType& in,
+                                   std::vector<typename Traits::JacobianType>& out) const = 0;
+
+    //! \brief Evaluate all shape functions at a list of positions, point-major
+    virtual void evaluateFunctionBatched (const std::vector<typename Traits::DomainType>& in,
+                                          std::vector<typename Traits::RangeType>& out) const = 0;
+
+    //! \brief Evaluate the Jacobians of all shape functions at a list of positions, point-major
+    virtual void evaluateJacobianBatched (const std::vector<typename Traits::DomainType>& in,
+                                          std::vector<typename Traits::JacobianType>& out) const = 0;
+
+    //! \brief Determine the coefficients interpolating f
+    virtual void interpolate (const FunctionType& f, std::vector<R>& out) const = 0;
+
+    //! \brief Values and Jacobians at the points of the quadrature rule of the given order
+    const TableType& table (int order) const
+    {
+      CacheMutex::Lock lock(mutex);
+      return volumeCache.table(type(),order);
+    }
+
+    //! \brief Values and Jacobians at the points of the face rule of the given order on face f with orientation o
+    const TableType& faceTable (int face, int orientation, int order) const
+    {
+      CacheMutex::Lock lock(mutex);
+      return faceCache.table(type(),face,orientation,order);
+    }
+
+  private:
+    // a copy would refer to the basis of the original
+    SharedLocalFiniteElement (const SharedLocalFiniteElement&);
+    SharedLocalFiniteElement& operator= (const SharedLocalFiniteElement&);
+
+    LocalBasisCache<SharedLocalFiniteElement> volumeCache;
+    LocalFaceCache<SharedLocalFiniteElement> faceCache;
+    mutable CacheMutex mutex;
+  };
+
+
+
+  /** \brief Implements SharedLocalFiniteElement by forwarding to a local finite element
+
+      \tparam FE Local finite element, which is copied into the object
+   */
+  template<class FE>
+  class SharedLocalFiniteElementImp
+    : public SharedLocalFiniteElement<typename FE::Traits::LocalBasisType::Traits::DomainFieldType,
+          typename FE::Traits::LocalBasisType::Traits::RangeFieldType,
+          FE::Traits::LocalBasisType::Traits::dimDomain,
+          FE::Traits::LocalBasisType::Traits::dimRange>
+  {
+    typedef typename FE::Traits::LocalBasisType::Traits LBTraits;
+    typedef SharedLocalFiniteElement<typename LBTraits::DomainFieldType,typename LBTraits::RangeFieldType,
+        LBTraits::dimDomain,LBTraits::dimRange> Base;
+
+  public:
+    typedef typename Base::Traits Traits;
+    typedef typename Base::FunctionType FunctionType;
+
+    explicit SharedLocalFiniteElementImp (const FE& fe_)
+      : fe(fe_)
+    {}
+
+    virtual GeometryType type () const
+    {
+      return fe.type();
+    }
+
+    virtual unsigned int size () const
+    {
+      return fe.localBasis().size();
+    }
+
+    virtual unsigned int order () const
+    {
+      return fe.localBasis().order();
+    }
+
+    virtual const LocalKey& localKey (unsigned int i) const
+    {
+      return fe.localCoefficients().localKey(i);
+    }
+
+    virtual void evaluateFunction (const typename Traits::DomainType& in,
+                                   std::vector<typename Traits::RangeType>& out) const
+    {
+      fe.localBasis().evaluateFunction(in,out);
+    }
+
+    virtual void evaluateJacobian (const typename Traits::DomainType& in,
+                                   std::vector<typename Traits::JacobianType>& out) const
+    {
+      fe.localBasis().evaluateJacobian(in,out);
+    }
+
+    virtual void evaluateFunctionBatched (const std::vector<typename Traits::DomainType>& in,
+                                          std::vector<typename Traits::RangeType>& out) const
+    {
+      fe.localBasis().evaluateFunctionBatched(in,out);
+    }
+
+    virtual void evaluateJacobianBatched (const std::vector<typename Traits::DomainType>& in,
+                                          std::vector<typename Traits::JacobianType>& out) const
+    {
+      fe.localBasis().evaluateJacobianBatched(in,out);
+    }
+
+    virtual void interpolate (const FunctionType& f, std::vector<typename Traits::RangeFieldType>& out) const
+    {
+      fe.localInterpolation().interpolate(f,out);
+    }
+
+    //! \brief The wrapped finite element
+    const FE& finiteElement () const
+    {
+      return fe;
+    }
+
+  private:
+    const FE fe;
+  };
+
+}
+#endif
@@ -0,0 +1,292 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+#ifndef DUNE_SIMD_HH
+#define DUNE_SIMD_HH
+
+/** \file
+    \brief A portable short vector type to evaluate shape functions on several elements at once
+
+    All local bases accept Simd<T,n> as domain and range field type.  Lane l
+    of every coordinate, value and derivative then belongs to the l-th of n
+    independent evaluations, e.g. on n different elements.  Each operation
+    is a loop over the lanes, which the compiler unrolls and vectorizes.
+
+    Code that is to be generic over scalar and vector fields does not branch
+    on comparisons.  It keeps their results in SimdTraits<T>::MaskType, a
+    bool for scalar types, and chooses values with cond().
+ */
+
+#include <cmath>
+#include <ostream>
+
+namespace Dune
+{
+
+  /** \brief The result of comparing two Simd vectors, one bool per lane */
+  template<int n>
+  class SimdMask
+  {
+  public:
+    enum {lanes = n};
+
+    SimdMask ()
+    {}
+
+    //! \brief Set all lanes to b
+    SimdMask (bool b)
+    {
+      for (int l=0; l<n; l++)
+        m[l] = b;
+    }
+
+    bool& operator[] (int l)
+    {
+      return m[l];
+    }
+
+    const bool& operator[] (int l) const
+    {
+      return m[l];
+    }
+
+    SimdMask operator! () const
+    {
+      SimdMask r;
+      for (int l=0; l<n; l++)
+        r.m[l] = !m[l];
+      return r;
+    }
+
+    //! \brief Lane-wise and, both sides are always evaluated
+    friend SimdMask operator&& (const SimdMask& a, const SimdMask& b)
+    {
+      SimdMask r;
+      for (int l=0; l<n; l++)
+        r.m[l] = a.m[l] && b.m[l];
+      return r;
+    }
+
+    //! \brief Lane-wise or, both sides are always evaluated
+    friend SimdMask operator|| (const SimdMask& a, const SimdMask& b)
+    {
+      SimdMask r;
+      for (int l=0; l<n; l++)
+        r.m[l] = a.m[l] || b.m[l];
+      return r;
+    }
+
+  private:
+    bool m[n];
+  };
+
+  /** \brief A vector of n values of the field type T with lane-wise arithmetic
+
+      Scalars convert implicitly to a Simd with all lanes equal, so that
+      expressions like <tt>1-x</tt> work unchanged.
+   */
+  template<class T, int n>
+  class Simd
+  {
+  public:
+    enum {lanes = n};
+
+    typedef T value_type;
+
+    Simd ()
+    {}
+
+    //! \brief Set all lanes to t
+    Simd (const T& t)
+    {
+      for (int l=0; l<n; l++)
+        v[l] = t;
+    }
+
+    T& operator[] (int l)
+    {
+      return v[l];
+    }
+
+    const T& operator[] (int l) const
+    {
+      return v[l];
+    }
+
+    Simd& operator+= (const Simd& y)
+    {
+      for (int l=0; l<n; l++)
+        v[l] += y.v[l];
+      return *this;
+    }
+
+    Simd& operator-= (const Simd& y)
+    {
+      for (int l=0; l<n; l++)
+        v[l] -= y.v[l];
+      return *this;
+    }
+
+    Simd& operator*= (const Simd& y)
+    {
+      for (int l=0; l<n; l++)
+        v[l] *= y.v[l];
+      return *this;
+    }
+
+    Simd& operator/= (const Simd& y)
+    {
+      for (int l=0; l<n; l++)
+        v[l] /= y.v[l];
+      return *this;
+    }
+
+    Simd operator+ () const
+    {
+      return *this;
+    }
+
+    Simd operator- () const
+    {
+      Simd r;
+      for (int l=0; l<n; l++)
+        r.v[l] = -v[l];
+      return r;
+    }
+
+    friend Simd operator+ (Simd a, const Simd& b)
+    {
+      return a += b;
+    }
+
+    friend Simd operator- (Simd a, const Simd& b)
+    {
+      return a -= b;
+    }
+
+    friend Simd operator* (Simd a, const Simd& b)
+    {
+      return a *= b;
+    }
+
+    friend Simd operator/ (Simd a, const Simd& b)
+    {
+      return a /= b;
+    }
+
+#define DUNE_SIMD_COMPARISON(OP)                                  \
+  friend SimdMask<n> operator OP (const Simd& a, const Simd& b)   \
+  {                                                               \
+    SimdMask<n> r;                                                \
+    for (int l=0; l<n; l++)                                       \
+      r[l] = a.v[l] OP b.v[l];                                    \
+    return r;                                                     \
+  }
+
+    DUNE_SIMD_COMPARISON(<)
+    DUNE_SIMD_COMPARISON(<=)
+    DUNE_SIMD_COMPARISON(>)
+    DUNE_SIMD_COMPARISON(>=)
+    DUNE_SIMD_COMPARISON(==)
+    DUNE_SIMD_COMPARISON(!=)
+
+#undef DUNE_SIMD_COMPARISON
+
+    //! \brief Lane-wise square root, found by argument-dependent lookup only
+    friend Simd sqrt (const Simd& x)
+    {
+      using std::sqrt;
+      Simd r;
+      for (int l=0; l<n; l++)
+        r.v[l] = sqrt(x.v[l]);
+      return r;
+    }
+
+    //! \brief Lane-wise absolute value, found by argument-dependent lookup only
+    friend Simd abs (const Simd& x)
+    {
+      using std::abs;
+      Simd r;
+      for (int l=0; l<n; l++)
+        r.v[l] = abs(x.v[l]);
+      return r;
+    }
+
+  private:
+    T v[n];
+  };
+
+  template<class T, int n>
+  std::ostream& operator<< (std::ostream& s, const Simd<T,n>& x)
+  {
+    s << "<";
+    for (int l=0; l<n; l++)
+      s << (l ? "," : "") << x[l];
+    return s << ">";
+  }
+
+  /** \brief Properties of a field type that may be a Simd vector
+
+      The primary template describes scalars: one lane and bool masks.
+   */
+  template<class T>
+  struct SimdTraits
+  {
+    //! \brief The field type of a single lane
+    typedef T ValueType;
+
+    //! \brief The result of comparing two values of type T
+    typedef bool MaskType;
+
+    //! \brief Number of lanes
+    enum {lanes = 1};
+
+    //! \brief The only lane of x
+    static ValueType lane (const T& x, int)
+    {
+      return x;
+    }
+
+    //! \brief Set the only lane of x to y
+    static void setLane (T& x, int, const ValueType& y)
+    {
+      x = y;
+    }
+  };
+
+  template<class T, int n>
+  struct SimdTraits<Simd<T,n> >
+  {
+    typedef T ValueType;
+    typedef SimdMask<n> MaskType;
+    enum {lanes = n};
+
+    static ValueType lane (const Simd<T,n>& x, int l)
+    {
+      return x[l];
+    }
+
+    static void setLane (Simd<T,n>& x, int l, const ValueType& y)
+    {
+      x[l] = y;
+    }
+  };
+
+  //! \brief Choose a if c holds and b otherwise
+  template<class T>
+  inline T cond (bool c, const T& a, const T& b)
+  {
+    return c ? a : b;
+  }
+
+  //! \brief Choose lane-wise between a and b without branching
+  template<class T, int n>
+  inline Simd<T,n> cond (const SimdMask<n>& c, const Simd<T,n>& a, const Simd<T,n>& b)
+  {
+    Simd<T,n> r;
+    for (int l=0; l<n; l++)
+      r[l] = c[l] ? a[l] : b[l];
+    return r;
+  }
+
+}
+#endif // DUNE_SIMD_HH
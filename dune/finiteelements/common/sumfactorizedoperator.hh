@@ -0,0 +1,395 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+#ifndef DUNE_SUMFACTORIZEDOPERATOR_HH
+#define DUNE_SUMFACTORIZEDOPERATOR_HH
+
+#include <cassert>
+#include <vector>
+
+#include <dune/common/fvector.hh>
+#include <dune/common/exceptions.hh>
+#include <dune/common/fmatrix.hh>
+#include <dune/common/geometrytype.hh>
+#include <dune/common/static_assert.hh>
+#include <dune/grid/common/quadraturerules.hh>
+
+#include "simd.hh"
+#include "tensorproductlayout.hh"
+
+namespace Dune
+{
+
+  /**@ingroup LocalBasisInterface
+         \brief Matrix-free application of the element mass and Laplace operators by sum factorization
+
+         For a local basis of tensor products of one-dimensional Lagrange
+         polynomials, as described by TensorProductLayout, this applies
+
+         - the mass operator y_i = sum_q c_q phi_i(x_q) sum_j phi_j(x_q) x_j
+         - the Laplace operator y_i = sum_q grad phi_i(x_q)^T G_q sum_j grad phi_j(x_q) x_j
+
+         on the tensor product of a one-dimensional Gauss rule without
+         assembling a matrix.  The values at the quadrature points are
+         computed one direction at a time from the one-dimensional basis
+         table, and the reference gradients from these values by
+         differentiation of the interpolating polynomial through the Gauss
+         points in each direction.  Testing runs the same steps transposed.
+         One application costs O(dim (k+1)^{dim+1}) operations instead of
+         the O((k+1)^{2dim}) of a product with the element matrix, which
+         pays off from moderate k on, in particular in 3D.
+
+         The geometry enters only through the factors c_q and G_q per
+         quadrature point, which massFactors() and laplaceFactors() compute
+         from the integration elements and the inverse transposed Jacobians.
+         G_q is symmetric and stored packed, entry (a,b) with a<=b at
+         position a*dim - a*(a-1)/2 + b-a.  The factors of many elements are
+         stored one after another, and so are their coefficients, such that
+         a whole batch of elements is applied with one call.
+
+         An object holds scratch space for the intermediate tensors; it must
+         not be used by several threads at once.
+
+         \tparam LB Local basis for which TensorProductLayout is specialized
+         \tparam dimworld Dimension of the world, the number of rows of J^{-T}
+
+         \nosubgrouping
+   */
+  template<class LB, int dimworld = LB::Traits::dimDomain>
+  class SumFactorizedOperator
+  {
+    typedef TensorProductLayout<LB> Layout;
+
+    typedef typename LB::Traits::DomainFieldType DF;
+    typedef typename LB::Traits::RangeFieldType RF;
+
+    // the one-dimensional tables are set up with scalars, also if DF and RF are Simd vectors
+    typedef typename SimdTraits<DF>::ValueType DV;
+    typedef typename SimdTraits<RF>::ValueType RV;
+
+  public:
+    //! \brief Export type traits of the local basis
+    typedef typename LB::Traits Traits;
+
+    //! \brief Inverse transposed Jacobian of a geometry, as returned by Geometry::jacobianInverseTransposed()
+    typedef FieldMatrix<DF,dimworld,Traits::dimDomain> JacobianInverseTransposedType;
+
+    enum {
+      //! \brief Dimension of the reference element
+      dim = Layout::dim,
+      //! \brief Number of entries of the packed symmetric factor G_q
+      packedSize = dim*(dim+1)/2
+    };
+
+    /** \brief Set up the one-dimensional tables
+
+       \param order Order of the one-dimensional Gauss rule, 2k if negative,
+                    which integrates the mass matrix of an affine element exactly
+     */
+    explicit SumFactorizedOperator (int order = -1)
+    {
+      dune_static_assert((int)Layout::dim == (int)Traits::dimDomain, "TensorProductLayout does not match the local basis");
+
+      const int k = Layout::k;
+      const QuadratureRule<DV,1>& rule =
+        QuadratureRules<DV,1>::rule(GeometryType(GeometryType::cube,1), order < 0 ? 2*k : order);
+
+      n1_ = k+1;
+      q1_ = rule.size();
+      if (q1_ < n1_)
+        DUNE_THROW(NotImplemented, "SumFactorizedOperator needs at least k+1 quadrature points per direction");
+
+      std::vector<DV> nodes(n1_);
+      for (unsigned int a=0; a<n1_; a++)
+        nodes[a] = DV(a)/k;
+      points1d_.resize(q1_);
+      weights1d_.resize(q1_);
+      for (unsigned int q=0; q<q1_; q++)
+      {
+        points1d_[q] = rule[q].position()[0];
+        weights1d_[q] = rule[q].weight();
+      }
+
+      // the shape functions at the Gauss points, and the derivatives of the
+      // Lagrange polynomials through the Gauss points at the Gauss points
+      values_.resize(q1_*n1_);
+      valuesT_.resize(n1_*q1_);
+      derivatives_.resize(q1_*q1_);
+      derivativesT_.resize(q1_*q1_);
+      for (unsigned int q=0; q<q1_; q++)
+      {
+        RV derivative;
+        for (unsigned int a=0; a<n1_; a++)
+          lagrange(nodes,a,points1d_[q],values_[q*n1_+a],derivative);
+        for (unsigned int p=0; p<q1_; p++)
+        {
+          RV value;
+          lagrange(points1d_,p,points1d_[q],value,derivatives_[q*q1_+p]);
+        }
+      }
+      for (unsigned int q=0; q<q1_; q++)
+      {
+        for (unsigned int a=0; a<n1_; a++)
+          valuesT_[a*q1_+q] = values_[q*n1_+a];
+        for (unsigned int p=0; p<q1_; p++)
+          derivativesT_[p*q1_+q] = derivatives_[q*q1_+p];
+      }
+
+      size_ = numPoints_ = 1;
+      for (int d=0; d<dim; d++)
+      {
+        size_ *= n1_;
+        numPoints_ *= q1_;
+      }
+      for (int i=0; i<2; i++)
+        work_[i].resize(numPoints_);
+      for (int d=0; d<dim; d++)
+        gradient_[d].resize(numPoints_);
+    }
+
+    //! \brief Number of shape functions
+    unsigned int size () const
+    {
+      return size_;
+    }
+
+    //! \brief Number of quadrature points of the tensor product rule
+    unsigned int numPoints () const
+    {
+      return numPoints_;
+    }
+
+    //! \brief Position of quadrature point q, the points are numbered with the first coordinate running fastest
+    typename Traits::DomainType position (unsigned int q) const
+    {
+      typename Traits::DomainType x;
+      for (int d=0; d<dim; d++, q/=q1_)
+        x[d] = points1d_[q%q1_];
+      return x;
+    }
+
+    //! \brief Weight of quadrature point q
+    DV weight (unsigned int q) const
+    {
+      DV w = 1;
+      for (int d=0; d<dim; d++, q/=q1_)
+        w *= weights1d_[q%q1_];
+      return w;
+    }
+
+    //! \brief Factors c_q of the mass operator, integrationElement[q] is |det J| at position(q)
+    void massFactors (const DF* integrationElement, RF* c) const
+    {
+      for (unsigned int q=0; q<numPoints_; q++)
+        c[q] = weight(q)*integrationElement[q];
+    }
+
+    /** \brief Packed factors G_q of the Laplace operator
+
+       \param jit jit[q] is J^{-T} at position(q)
+       \param integrationElement integrationElement[q] is |det J| at position(q)
+       \param g Storage for numPoints()*packedSize factors
+     */
+    void laplaceFactors (const JacobianInverseTransposedType* jit, const DF* integrationElement, RF* g) const
+    {
+      for (unsigned int q=0; q<numPoints_; q++)
+      {
+        const RF w = weight(q)*integrationElement[q];
+        for (int a=0; a<dim; a++)
+          for (int b=a; b<dim; b++, g++)
+          {
+            RF sum = 0;
+            for (int r=0; r<dimworld; r++)
+              sum += jit[q][r][a]*jit[q][r][b];
+            *g = w*sum;
+          }
+      }
+    }
+
+    /** \brief Apply the mass operator on a batch of elements
+
+       \param x Coefficients, size() per element
+       \param c Factors from massFactors(), numPoints() per element
+       \param y Result, resized to x.size()
+     */
+    void applyMass (const std::vector<RF>& x, const std::vector<RF>& c, std::vector<RF>& y) const
+    {
+      assert(x.size() % size_ == 0 && c.size()*size_ == x.size()*numPoints_);
+      y.resize(x.size());
+      if (!x.empty())
+        applyMass(&x[0],&c[0],x.size()/size_,&y[0]);
+    }
+
+    //! \brief Apply the mass operator on one element into caller-provided storage for size() values
+    void applyMass (const RF* x, const RF* c, RF* y) const
+    {
+      RF* u = interpolate(x);
+      for (unsigned int q=0; q<numPoints_; q++)
+        u[q] *= c[q];
+      integrate(dim%2,y);
+    }
+
+    //! \brief Apply the mass operator on a batch of elements into caller-provided storage for elements*size() values
+    void applyMass (const RF* x, const RF* c, unsigned int elements, RF* y) const
+    {
+      for (unsigned int e=0; e<elements; e++, x+=size_, c+=numPoints_, y+=size_)
+        applyMass(x,c,y);
+    }
+
+    /** \brief Apply the Laplace operator on a batch of elements
+
+       \param x Coefficients, size() per element
+       \param g Packed factors from laplaceFactors(), numPoints()*packedSize per element
+       \param y Result, resized to x.size()
+     */
+    void applyLaplace (const std::vector<RF>& x, const std::vector<RF>& g, std::vector<RF>& y) const
+    {
+      assert(x.size() % size_ == 0 && g.size()*size_ == x.size()*numPoints_*packedSize);
+      y.resize(x.size());
+      if (!x.empty())
+        applyLaplace(&x[0],&g[0],x.size()/size_,&y[0]);
+    }
+
+    //! \brief Apply the Laplace operator on one element into caller-provided storage for size() values
+    void applyLaplace (const RF* x, const RF* g, RF* y) const
+    {
+      // reference gradients at the quadrature points
+      const RF* u = interpolate(x);
+      unsigned int inner = 1;
+      for (int d=0; d<dim; d++, inner*=q1_)
+        contract(&derivatives_[0],q1_,q1_,inner,numPoints_/(inner*q1_),u,&gradient_[d][0],false);
+
+      // fluxes G_q grad u, overwriting the gradients
+      for (unsigned int q=0; q<numPoints_; q++, g+=packedSize)
+      {
+        RF grad[dim];
+        for (int a=0; a<dim; a++)
+          grad[a] = gradient_[a][q];
+        for (int a=0; a<dim; a++)
+        {
+          RF sum = 0;
+          for (int b=0; b<dim; b++)
+            sum += g[(a<=b) ? a*dim-a*(a-1)/2+b-a : b*dim-b*(b-1)/2+a-b]*grad[b];
+          gradient_[a][q] = sum;
+        }
+      }
+
+      // sum of the derivatives of the fluxes, tested with the shape functions
+      inner = 1;
+      for (int d=0; d<dim; d++, inner*=q1_)
+        contract(&derivativesT_[0],q1_,q1_,inner,numPoints_/(inner*q1_),&gradient_[d][0],&work_[0][0],d>0);
+      integrate(0,y);
+    }
+
+    //! \brief Apply the Laplace operator on a batch of elements into caller-provided storage for elements*size() values
+    void applyLaplace (const RF* x, const RF* g, unsigned int elements, RF* y) const
+    {
+      for (unsigned int e=0; e<elements; e++, x+=size_, g+=numPoints_*packedSize, y+=size_)
+        applyLaplace(x,g,y);
+    }
+
+  private:
+    //! \brief Value and derivative at x of the a-th Lagrange polynomial with the given nodes
+    static void lagrange (const std::vector<DV>& nodes, unsigned int a, DV x, RV& value, RV& derivative)
+    {
+      value = 1;
+      derivative = 0;
+      for (unsigned int b=0; b<nodes.size(); b++)
+      {
+        if (b == a)
+          continue;
+        const RV factor = (x - nodes[b])/(nodes[a] - nodes[b]);
+        derivative = derivative*factor + value/(nodes[a] - nodes[b]);
+        value *= factor;
+      }
+    }
+
+    //! \brief Values of sum_j x_j phi_j at all quadrature points, computed in the scratch space work_[dim%2]
+    RF* interpolate (const RF* x) const
+    {
+      RF* u = &work_[0][0];
+      for (unsigned int l=0; l<size_; l++)
+        u[l] = x[Layout::index(l)];
+
+      // the first d directions have been contracted
+      unsigned int inner = 1;
+      unsigned int outer = size_/n1_;
+      for (int d=0; d<dim; d++, inner*=q1_, outer/=n1_)
+        contract(&values_[0],q1_,n1_,inner,outer,&work_[d%2][0],&work_[(d+1)%2][0],false);
+      return &work_[dim%2][0];
+    }
+
+    //! \brief Store the values at the quadrature points in work_[start], tested with all shape functions, into y
+    void integrate (int start, RF* y) const
+    {
+      unsigned int inner = 1;
+      unsigned int outer = numPoints_/q1_;
+      for (int d=0; d<dim; d++, inner*=n1_, outer/=q1_)
+        contract(&valuesT_[0],n1_,q1_,inner,outer,&work_[(start+d)%2][0],&work_[(start+d+1)%2][0],false);
+
+      const RF* v = &work_[(start+dim)%2][0];
+      for (unsigned int l=0; l<size_; l++)
+        y[Layout::index(l)] = v[l];
+    }
+
+    /** \brief Apply the rows x cols matrix a in one direction of the tensor in
+
+       in has the size inner*cols*outer, the contracted direction in the middle.
+       The result, of size inner*rows*outer, is stored into or added to out.
+     */
+    static void contract (const RV* a, unsigned int rows, unsigned int cols,
+                          unsigned int inner, unsigned int outer,
+                          const RF* in, RF* out, bool add)
+    {
+      // the contracted direction is the fastest one: small matrix-vector products
+      if (inner == 1)
+      {
+        for (unsigned int o=0; o<outer; o++, in+=cols, out+=rows)
+          for (unsigned int r=0; r<rows; r++)
+          {
+            RF sum = add ? out[r] : RF(0);
+            const RV* row = a+r*cols;
+            for (unsigned int c=0; c<cols; c++)
+              sum += row[c]*in[c];
+            out[r] = sum;
+          }
+        return;
+      }
+
+      for (unsigned int o=0; o<outer; o++, in+=inner*cols, out+=inner*rows)
+        for (unsigned int r=0; r<rows; r++)
+        {
+          RF* target = out+r*inner;
+          if (!add)
+            for (unsigned int i=0; i<inner; i++)
+              target[i] = 0;
+          for (unsigned int c=0; c<cols; c++)
+          {
+            const RV f = a[r*cols+c];
+            const RF* source = in+c*inner;
+            for (unsigned int i=0; i<inner; i++)
+              target[i] += f*source[i];
+          }
+        }
+    }
+
+    unsigned int n1_;
+    unsigned int q1_;
+    unsigned int size_;
+    unsigned int numPoints_;
+
+    std::vector<DV> points1d_;
+    std::vector<DV> weights1d_;
+
+    // one-dimensional tables, q1_ x n1_ and q1_ x q1_, and their transposes
+    std::vector<RV> values_;
+    std::vector<RV> valuesT_;
+    std::vector<RV> derivatives_;
+    std::vector<RV> derivativesT_;
+
+    // scratch space
+    mutable std::vector<RF> work_[2];
+    mutable std::vector<RF> gradient_[dim];
+  };
+
+}
+#endif
@@ -0,0 +1,31 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+#ifndef DUNE_TENSORPRODUCTLAYOUT_HH
+#define DUNE_TENSORPRODUCTLAYOUT_HH
+
+namespace Dune
+{
+
+  /**@ingroup LocalBasisInterface
+         \brief Describes a local basis of tensor products of one-dimensional Lagrange polynomials
+
+         Only bases whose shape functions are products of the Lagrange
+         polynomials of order k with the equidistant nodes 0, 1/k, ..., 1 in
+         every direction specialize this class.  A specialization provides
+
+         \code
+         enum {dim = ..., k = ...};
+         // number of the shape function with the multi-index (a_0,...,a_{dim-1}),
+         // given as l = a_0 + a_1 (k+1) + ... + a_{dim-1} (k+1)^{dim-1}
+         static unsigned int index (unsigned int l);
+         \endcode
+
+         It is used by SumFactorizedOperator.
+
+         \tparam LB Local basis
+   */
+  template<class LB>
+  struct TensorProductLayout;
+
+}
+#endif
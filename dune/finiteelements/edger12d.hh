@@ -6,6 +6,7 @@
 #include <dune/common/geometrytype.hh>
 
 #include "common/localfiniteelement.hh"
+#include "common/precompiled.hh"
 #include "edger12d/edger12dlocalbasis.hh"
 #include "edger12d/edger12dlocalcoefficients.hh"
 #include "edger12d/edger12dlocalinterpolation.hh"
@@ -20,8 +21,10 @@ namespace Dune
               EdgeR12DLocalBasis<D,R>,
               EdgeR12DLocalCoefficients,
               EdgeR12DLocalInterpolation<EdgeR12DLocalBasis<D,R> >
-              >,
-          EdgeR12DLocalFiniteElement<D,R>
+              >
+#ifndef DUNE_VIRTUAL_SHAPEFUNCTIONS
+          ,EdgeR12DLocalFiniteElement<D,R>
+#endif
           >
   {
   public:
@@ -63,6 +66,12 @@ namespace Dune
     GeometryType gt;
   };
 
+#if DUNE_LOCALFUNCTIONS_PRECOMPILED && !defined(DUNE_VIRTUAL_SHAPEFUNCTIONS)
+  // instantiated in libdunelocalfunctions, see common/precompiled.hh
+  DUNE_LOCALFUNCTIONS_EXTERN_TEMPLATE class EdgeR12DLocalBasis<double,double>;
+  DUNE_LOCALFUNCTIONS_EXTERN_TEMPLATE class EdgeR12DLocalBasis<float,float>;
+#endif
+
 }
 
 #endif //DUNE_EDGER12DLOCALFINITEELEMENT_HH
@@ -13,9 +13,13 @@ namespace Dune
      These are from Jianming Jin: "The Finite Element Method in
      Electromagnetics" 2nd edition, section 8.1.1 "Rectangular Elements".
 
-     Note that it is not yet checked whether these basis functions work on
-     general quadrilaterals as well as rectangles.  The transformation might
-     destroy some properties of the basis.
+     The values are those on the reference element.  On other elements,
+     including general quadrilaterals, the shape functions are mapped by
+     the covariant Piola transformation J^{-T} phi, which keeps their
+     tangential components continuous across edges; CovariantPiola applies
+     it, together with the curls, to many elements at once.  Note that on
+     non-parallelograms the transformed curls lose approximation order
+     (Arnold, Boffi and Falk, SIAM J. Numer. Anal. 42, 2005).
 
      - <tt>D</tt>: Type to represent the field in the domain.
      - <tt>R</tt>: Type to represent the field in the range.
@@ -24,24 +28,26 @@ namespace Dune
    */
   template<class D, class R>
   class EdgeR12DLocalBasis
-    : public C1LocalBasisInterface<
+    : public C1LocalBasisForwarder<
           C1LocalBasisTraits<
               D, 2,
               Dune::FieldVector<D,2>,
               R, 2,
-              Dune::FieldVector<R,3>,
-              Dune::FieldVector<Dune::FieldVector<R,2>, 1>
+              Dune::FieldVector<R,2>,
+              Dune::FieldVector<Dune::FieldVector<R,2>, 2>
               >,
-          EdgeR12DLocalBasis<D,R>
-          >
+          EdgeR12DLocalBasis<D,R>, 4>
   {
   public:
+    //! \brief Number of shape functions as a compile-time constant
+    enum {N = 4};
+
     typedef C1LocalBasisTraits<
         D, 2,
         Dune::FieldVector<D,2>,
         R, 2,
-        Dune::FieldVector<R,3>,
-        Dune::FieldVector<Dune::FieldVector<R,2>, 1>
+        Dune::FieldVector<R,2>,
+        Dune::FieldVector<Dune::FieldVector<R,2>, 2>
         > Traits;
 
     //! \brief number of shape functions
@@ -50,34 +56,41 @@ namespace Dune
       return 4;
     }
 
-    //! \brief Evaluate all shape functions
-    inline void evaluateFunction (const typename Traits::DomainType& in,
-                                  std::vector<typename Traits::RangeType>& out) const
-    {
-      out.resize(4);
-      out[0] = 0; out[0][0] = 1-in[1];
-      out[1] = 0; out[1][0] =   in[1];
-      out[2] = 0; out[2][1] = 1-in[0];
-      out[3] = 0; out[3][1] =   in[0];
-    }
-
-    //! \brief Evaluate Jacobian of all shape functions
-    inline void
-    evaluateJacobian (const typename Traits::DomainType& in,         // position
-                      std::vector<typename Traits::JacobianType>& out) const      // return value
-    {
-      out.resize(4);
-      out[0] = 0; out[0][0][1] = -1;
-      out[1] = 0; out[1][0][1] = +1;
-      out[2] = 0; out[2][1][0] = -1;
-      out[3] = 0; out[3][1][0] = +1;
-    }
-
     //! \brief Polynomial order of the shape functions
     unsigned int order () const
     {
       return 1;
     }
+
+  private:
+    friend class C1LocalBasisForwarder<Traits,EdgeR12DLocalBasis,N>;
+
+    void evaluateFunctionAt (const typename Traits::DomainType& in,
+                             typename Traits::RangeType* out) const;
+
+    void evaluateJacobianAt (const typename Traits::DomainType&,
+                             typename Traits::JacobianType* out) const;
   };
+
+  // not inline, such that the instantiations in libdunelocalfunctions are used
+  template<class D, class R>
+  void EdgeR12DLocalBasis<D,R>::evaluateFunctionAt (const typename Traits::DomainType& in,
+                                                    typename Traits::RangeType* out) const
+  {
+    out[0] = R(0); out[0][0] = 1-in[1];
+    out[1] = R(0); out[1][0] =   in[1];
+    out[2] = R(0); out[2][1] = 1-in[0];
+    out[3] = R(0); out[3][1] =   in[0];
+  }
+
+  template<class D, class R>
+  void EdgeR12DLocalBasis<D,R>::evaluateJacobianAt (const typename Traits::DomainType&,
+                                                    typename Traits::JacobianType* out) const
+  {
+    out[0] = R(0); out[0][0][1] = -1;
+    out[1] = R(0); out[1][0][1] = +1;
+    out[2] = R(0); out[2][1][0] = -1;
+    out[3] = R(0); out[3][1][0] = +1;
+  }
 }
 #endif // DUNE_EDGER12DLOCALBASIS_HH
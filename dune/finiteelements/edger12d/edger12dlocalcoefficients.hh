@@ -17,17 +17,19 @@ namespace Dune
      \nosubgrouping
    */
   class EdgeR12DLocalCoefficients
+#if DUNE_VIRTUAL_SHAPEFUNCTIONS
+    : public LocalCoefficientsInterface
+#else
     : public LocalCoefficientsInterface<EdgeR12DLocalCoefficients>
+#endif
   {
+    typedef LocalKeyTable<EdgeR12DLocalCoefficients,4> Table;
+    friend class LocalKeyTable<EdgeR12DLocalCoefficients,4>;
+
   public:
     //! \brief Standard constructor
-    EdgeR12DLocalCoefficients () : li(4)
-    {
-      li[0] = LocalKey(2,1,0);
-      li[1] = LocalKey(3,1,0);
-      li[2] = LocalKey(0,1,0);
-      li[3] = LocalKey(1,1,0);
-    }
+    EdgeR12DLocalCoefficients () : li(Table::keys()), packed(Table::packedKeys())
+    {}
 
     //! number of coefficients
     int size () const
@@ -41,8 +43,23 @@ namespace Dune
       return li[i];
     }
 
+    //! get i'th index, packed into 32 bits
+    const PackedLocalKey& packedLocalKey (int i) const
+    {
+      return packed[i];
+    }
+
   private:
-    std::vector<LocalKey> li;
+    const LocalKey* li;
+    const PackedLocalKey* packed;
+
+    static void fill (int, LocalKey* keys)
+    {
+      keys[0] = LocalKey(2,1,0);
+      keys[1] = LocalKey(3,1,0);
+      keys[2] = LocalKey(0,1,0);
+      keys[3] = LocalKey(1,1,0);
+    }
   };
 
 }
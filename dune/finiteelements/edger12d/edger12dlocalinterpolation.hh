@@ -18,12 +18,18 @@ namespace Dune
     //! \brief Local interpolation of a function
     template<typename F, typename C>
     void interpolate (const F& f, std::vector<C>& out) const
+    {
+      out.resize(4);
+      interpolate(f,&out[0]);
+    }
+
+    //! \brief Local interpolation into caller-provided storage with room for all coefficients
+    template<typename F, typename C>
+    void interpolate (const F& f, C* out) const
     {
       typename LB::Traits::DomainType x;
       typename LB::Traits::RangeType y;
 
-      out.resize(4);
-
       // Evaluate f at the center of the edge corresponding to the given
       // coefficient.  This is the Gauß quadrature rule:
       //
@@ -0,0 +1,397 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+#ifndef DUNE_LOCALFINITEELEMENTREGISTRY_HH
+#define DUNE_LOCALFINITEELEMENTREGISTRY_HH
+
+#include <map>
+#include <memory>
+#include <utility>
+
+#include <dune/common/exceptions.hh>
+#include <dune/common/fixedarray.hh>
+#include <dune/common/geometrytype.hh>
+
+#include "common/cachemutex.hh"
+#include "common/precompiled.hh"
+#include "common/sharedlocalfiniteelement.hh"
+#include "edger12d.hh"
+#include "monom.hh"
+#include "orthonormal.hh"
+#include "pk2d.hh"
+#include "pk3d.hh"
+#include "qk.hh"
+#include "refinedp1.hh"
+#include "rt02d.hh"
+
+namespace Dune
+{
+
+  //! \brief The families of local finite elements known to LocalFiniteElementRegistry
+  struct LocalFiniteElementFamily
+  {
+    enum Type {
+      //! \brief Lagrange elements: Pk2D and Pk3D on simplices, Qk on cubes and lines
+      lagrange,
+      //! \brief Discontinuous elements with monomial shape functions, Monom
+      monomial,
+      //! \brief Discontinuous elements with L2-orthonormal shape functions, Orthonormal
+      orthonormal,
+      //! \brief P1 elements on the uniformly refined triangle, RefinedP1
+      refinedLagrange,
+      //! \brief Lowest order Raviart-Thomas elements on triangles, RT02D
+      raviartThomas,
+      //! \brief Lowest order edge elements on quadrilaterals, EdgeR12D
+      nedelec
+    };
+  };
+
+  namespace RegistryImp
+  {
+
+    /** \brief Tries the orders k, k-1, ..., 0 of a family
+
+        Family::create<k>() constructs the element of order k.
+     */
+    template<class Family, int k>
+    struct OrderSwitch
+    {
+      static typename Family::ElementType* create (int order, const GeometryType& gt, unsigned int variant)
+      {
+        if (order == k)
+          return Family::template create<k>(gt,variant);
+        return OrderSwitch<Family,k-1>::create(order,gt,variant);
+      }
+    };
+
+    template<class Family>
+    struct OrderSwitch<Family,-1>
+    {
+      static typename Family::ElementType* create (int order, const GeometryType& gt, unsigned int)
+      {
+        DUNE_THROW(NotImplemented, "order " << order << " is not available for " << gt);
+      }
+    };
+
+    //! \brief Wraps a local finite element into a new shared one
+    template<class FE>
+    SharedLocalFiniteElementImp<FE>* share (const FE& fe)
+    {
+      return new SharedLocalFiniteElementImp<FE>(fe);
+    }
+
+    //! \brief Only variant 0 exists
+    inline void noVariants (const GeometryType& gt, unsigned int variant)
+    {
+      if (variant != 0)
+        DUNE_THROW(NotImplemented, "elements on " << gt << " have no variant " << variant);
+    }
+
+    //! \brief Lagrange elements on simplices, the variant selects the orientations of the subentities
+    template<class D, class R, int dim>
+    struct LagrangeSimplex;
+
+    template<class D, class R>
+    struct LagrangeSimplex<D,R,1>
+    {
+      typedef SharedLocalFiniteElement<D,R,1> ElementType;
+
+      template<int k>
+      static ElementType* create (const GeometryType& gt, unsigned int variant)
+      {
+        noVariants(gt,variant);
+        return share(QkLocalFiniteElement<D,R,1,k>());
+      }
+    };
+
+    template<class D, class R>
+    struct LagrangeSimplex<D,R,2>
+    {
+      typedef SharedLocalFiniteElement<D,R,2> ElementType;
+
+      template<int k>
+      static ElementType* create (const GeometryType&, unsigned int variant)
+      {
+        if (variant >= 8)
+          DUNE_THROW(NotImplemented, "Pk2D has no variant " << variant);
+        return share(Pk2DLocalFiniteElement<D,R,k>(variant));
+      }
+    };
+
+    template<class D, class R>
+    struct LagrangeSimplex<D,R,3>
+    {
+      typedef SharedLocalFiniteElement<D,R,3> ElementType;
+
+      template<int k>
+      static ElementType* create (const GeometryType&, unsigned int variant)
+      {
+        Dune::array<int,4> faceVariant;
+        for (int f=0; f<4; f++)
+        {
+          faceVariant[f] = (variant >> (6+3*f)) & 7;
+          if (faceVariant[f] >= 6)
+            DUNE_THROW(NotImplemented, "Pk3D has no variant " << variant);
+        }
+        if (variant >= (1u<<18))
+          DUNE_THROW(NotImplemented, "Pk3D has no variant " << variant);
+        return share(Pk3DLocalFiniteElement<D,R,k>(variant & 63, faceVariant));
+      }
+    };
+
+    //! \brief Lagrange elements on cubes
+    template<class D, class R, int dim>
+    struct LagrangeCube
+    {
+      typedef SharedLocalFiniteElement<D,R,dim> ElementType;
+
+      template<int k>
+      static ElementType* create (const GeometryType& gt, unsigned int variant)
+      {
+        noVariants(gt,variant);
+        return share(QkLocalFiniteElement<D,R,dim,k>());
+      }
+    };
+
+    template<class D, class R, int dim>
+    struct Monomial
+    {
+      typedef SharedLocalFiniteElement<D,R,dim> ElementType;
+
+      template<int k>
+      static ElementType* create (const GeometryType& gt, unsigned int variant)
+      {
+        noVariants(gt,variant);
+        return share(MonomLocalFiniteElement<D,R,dim,k>(gt.basicType()));
+      }
+    };
+
+    template<class D, class R, int dim>
+    struct Orthonormal
+    {
+      typedef SharedLocalFiniteElement<D,R,dim> ElementType;
+
+      template<int k>
+      static ElementType* create (const GeometryType& gt, unsigned int variant)
+      {
+        noVariants(gt,variant);
+        if (gt.isCube())
+          return share(OrthonormalLocalFiniteElement<D,R,dim,k,GeometryType::cube>());
+        return share(OrthonormalLocalFiniteElement<D,R,dim,k,GeometryType::simplex>());
+      }
+    };
+
+    //! \brief P1 elements on the refined reference element, which only exist for triangles
+    template<class D, class R, int dim>
+    struct RefinedLagrange
+    {
+      static SharedLocalFiniteElement<D,R,dim>* create (const GeometryType& gt)
+      {
+        DUNE_THROW(NotImplemented, "no refined Lagrange elements on " << gt);
+      }
+    };
+
+    template<class D, class R>
+    struct RefinedLagrange<D,R,2>
+    {
+      static SharedLocalFiniteElement<D,R,2>* create (const GeometryType&)
+      {
+        return share(RefinedP1LocalFiniteElement<D,R>());
+      }
+    };
+
+    /** \brief Creates the elements of one range dimension
+
+        The primary template has no elements.  The specializations create
+        the scalar elements and the vector-valued ones in 2D.
+     */
+    template<class D, class R, int dim, int dimR, int maxOrder>
+    struct Factory
+    {
+      typedef SharedLocalFiniteElement<D,R,dim,dimR> ElementType;
+
+      static ElementType* create (LocalFiniteElementFamily::Type family, const GeometryType& gt,
+                                  int order, unsigned int variant)
+      {
+        DUNE_THROW(NotImplemented, "no " << dimR << "-valued elements on " << gt);
+      }
+    };
+
+    template<class D, class R, int maxOrder>
+    struct Factory<D,R,2,2,maxOrder>
+    {
+      typedef SharedLocalFiniteElement<D,R,2,2> ElementType;
+
+      static ElementType* create (LocalFiniteElementFamily::Type family, const GeometryType& gt,
+                                  int order, unsigned int variant)
+      {
+        if (family == LocalFiniteElementFamily::raviartThomas && gt.isTriangle() && order == 1)
+        {
+          if (variant >= 8)
+            DUNE_THROW(NotImplemented, "RT02D has no variant " << variant);
+          return share(RT02DLocalFiniteElement<D,R>(variant));
+        }
+        if (family == LocalFiniteElementFamily::nedelec && gt.isQuadrilateral() && order == 1)
+        {
+          noVariants(gt,variant);
+          return share(EdgeR12DLocalFiniteElement<D,R>());
+        }
+        DUNE_THROW(NotImplemented, "family " << family << " of order " << order
+                                             << " is not available for " << gt);
+      }
+    };
+
+    template<class D, class R, int dim, int maxOrder>
+    struct Factory<D,R,dim,1,maxOrder>
+    {
+      typedef SharedLocalFiniteElement<D,R,dim> ElementType;
+
+      static ElementType* create (LocalFiniteElementFamily::Type family, const GeometryType& gt,
+                                  int order, unsigned int variant)
+      {
+        if (!gt.isSimplex() && !gt.isCube())
+          DUNE_THROW(NotImplemented, "no elements on " << gt);
+
+        switch (family)
+        {
+        case LocalFiniteElementFamily::lagrange :
+          if (gt.isCube())
+            return OrderSwitch<LagrangeCube<D,R,dim>,maxOrder>::create(order,gt,variant);
+          return OrderSwitch<LagrangeSimplex<D,R,dim>,maxOrder>::create(order,gt,variant);
+        case LocalFiniteElementFamily::monomial :
+          return OrderSwitch<Monomial<D,R,dim>,maxOrder>::create(order,gt,variant);
+        case LocalFiniteElementFamily::orthonormal :
+          return OrderSwitch<Orthonormal<D,R,dim>,maxOrder>::create(order,gt,variant);
+        case LocalFiniteElementFamily::refinedLagrange :
+          if (gt.isSimplex() && order == 1)
+          {
+            noVariants(gt,variant);
+            return RefinedLagrange<D,R,dim>::create(gt);
+          }
+          break;
+        default :
+          break;
+        }
+        DUNE_THROW(NotImplemented, "family " << family << " of order " << order
+                                             << " is not available for " << gt);
+      }
+    };
+
+  }
+
+
+
+  /**@ingroup LocalBasisInterface
+         \brief Hands out shared local finite elements chosen at run time
+
+         For grids with several element types, get() returns the local finite
+         element of a family on a reference element of given order and
+         variant as a SharedLocalFiniteElement.  Each combination is created
+         once, on its first request, and then shared by all callers, together
+         with its tabulations.  Grid code keeps a pointer per element, or
+         one per element type, instead of a finite element object per
+         element.
+
+         The order is the polynomial order, as returned by order().  Lagrange,
+         monomial and orthonormal elements exist up to maxOrder, the other
+         families in their only order 1.  The variant selects orientations:
+         - Pk2D: bit i flips the order on edge i, Pk2DLocalFiniteElement::variant()
+           computes it from the global vertex ids
+         - Pk3D: bits 0 to 5 flip the order on the edges, bits 6+3f to 8+3f
+           hold the permutation 0 to 5 of face f, see Pk3DLocalCoefficients
+         - RT02D: the variant of RT02DLocalFiniteElement, see
+           RT02DLocalFiniteElement::variant()
+         All other elements only have variant 0.  Unknown combinations throw
+         NotImplemented.
+
+         The elements stay alive until the end of the program.  get() and
+         the caches of the elements are locked with a CacheMutex, so
+         several threads may request elements and tables at the same time.
+
+         \tparam D Type to represent the field in the domain
+         \tparam R Type to represent the field in the range
+         \tparam dim Domain dimension
+         \tparam dimR Range dimension, dim for the vector-valued families
+
+         \nosubgrouping
+   */
+  template<class D, class R, int dim, int dimR = 1>
+  class LocalFiniteElementRegistry
+  {
+  public:
+    //! \brief The type of the shared elements
+    typedef SharedLocalFiniteElement<D,R,dim,dimR> ElementType;
+
+    //! \brief Highest order of the Lagrange, monomial and orthonormal families
+    enum {maxOrder = 6};
+
+    //! \brief The shared element of the given family, reference element, order and variant
+    static const ElementType& get (LocalFiniteElementFamily::Type family, const GeometryType& gt,
+                                   int order, unsigned int variant = 0);
+
+  private:
+    typedef std::pair<std::pair<int,int>,std::pair<int,unsigned int> > Key;
+    typedef std::map<Key,ElementType*> Map;
+
+    //! \brief Owns the shared elements
+    struct Instances
+    {
+      ~Instances ()
+      {
+        for (typename Map::iterator it = map.begin(); it != map.end(); ++it)
+          delete it->second;
+      }
+
+      Map map;
+      CacheMutex mutex;
+    };
+
+    static Instances& instances ();
+  };
+
+  // not inline, such that the instantiations in libdunelocalfunctions are used
+  template<class D, class R, int dim, int dimR>
+  const typename LocalFiniteElementRegistry<D,R,dim,dimR>::ElementType&
+  LocalFiniteElementRegistry<D,R,dim,dimR>::get (LocalFiniteElementFamily::Type family, const GeometryType& gt,
+                                                 int order, unsigned int variant)
+  {
+    if (gt.dim() != dim)
+      DUNE_THROW(NotImplemented, "the registry for dimension " << dim << " has no elements on " << gt);
+
+    Instances& shared = instances();
+    CacheMutex::Lock lock(shared.mutex);
+    Map& map = shared.map;
+    const Key key(std::make_pair(int(family),int(gt.basicType())),std::make_pair(order,variant));
+    typename Map::iterator it = map.find(key);
+    if (it == map.end())
+    {
+      // owned here until the map owns it
+      std::auto_ptr<ElementType> element(
+        RegistryImp::Factory<D,R,dim,dimR,maxOrder>::create(family,gt,order,variant));
+      it = map.insert(std::make_pair(key,element.get())).first;
+      element.release();
+    }
+    return *it->second;
+  }
+
+  template<class D, class R, int dim, int dimR>
+  typename LocalFiniteElementRegistry<D,R,dim,dimR>::Instances&
+  LocalFiniteElementRegistry<D,R,dim,dimR>::instances ()
+  {
+    static Instances instances;
+    return instances;
+  }
+
+#if DUNE_LOCALFUNCTIONS_PRECOMPILED && !defined(DUNE_VIRTUAL_SHAPEFUNCTIONS)
+  // instantiated in libdunelocalfunctions, see common/precompiled.hh
+  DUNE_LOCALFUNCTIONS_EXTERN_TEMPLATE class LocalFiniteElementRegistry<double,double,1>;
+  DUNE_LOCALFUNCTIONS_EXTERN_TEMPLATE class LocalFiniteElementRegistry<double,double,2>;
+  DUNE_LOCALFUNCTIONS_EXTERN_TEMPLATE class LocalFiniteElementRegistry<double,double,3>;
+  DUNE_LOCALFUNCTIONS_EXTERN_TEMPLATE class LocalFiniteElementRegistry<double,double,2,2>;
+  DUNE_LOCALFUNCTIONS_EXTERN_TEMPLATE class LocalFiniteElementRegistry<float,float,1>;
+  DUNE_LOCALFUNCTIONS_EXTERN_TEMPLATE class LocalFiniteElementRegistry<float,float,2>;
+  DUNE_LOCALFUNCTIONS_EXTERN_TEMPLATE class LocalFiniteElementRegistry<float,float,3>;
+  DUNE_LOCALFUNCTIONS_EXTERN_TEMPLATE class LocalFiniteElementRegistry<float,float,2,2>;
+#endif
+
+}
+#endif
@@ -6,6 +6,7 @@
 #include <dune/common/geometrytype.hh>
 
 #include "common/localfiniteelement.hh"
+#include "common/precompiled.hh"
 #include "monom/monomlocalbasis.hh"
 #include "monom/monomlocalcoefficients.hh"
 #include "monom/monomlocalinterpolation.hh"
@@ -20,8 +21,11 @@ namespace Dune
                                       LocalFiniteElementTraits<
                                           MonomLocalBasis<D,R,d,p>,
                                           MonomLocalCoefficients<MonomImp::Size<d,p>::val>,
-                                          MonomLocalInterpolation<MonomLocalBasis<D,R,d,p>,MonomImp::Size<d,p>::val> >,
-                                      MonomLocalFiniteElement<D,R,d,p> >
+                                          MonomLocalInterpolation<MonomLocalBasis<D,R,d,p>,MonomImp::Size<d,p>::val> >
+#ifndef DUNE_VIRTUAL_SHAPEFUNCTIONS
+                                      ,MonomLocalFiniteElement<D,R,d,p>
+#endif
+                                      >
   {
     enum { static_size = MonomImp::Size<d,p>::val };
 
@@ -75,6 +79,34 @@ namespace Dune
     GeometryType gt;
   };
 
+#if DUNE_LOCALFUNCTIONS_PRECOMPILED && !defined(DUNE_VIRTUAL_SHAPEFUNCTIONS)
+  // instantiated in libdunelocalfunctions, see common/precompiled.hh
+  DUNE_LOCALFUNCTIONS_EXTERN_TEMPLATE class MonomLocalBasis<double,double,1,1>;
+  DUNE_LOCALFUNCTIONS_EXTERN_TEMPLATE class MonomLocalInterpolation<MonomLocalBasis<double,double,1,1>,MonomImp::Size<1,1>::val>;
+  DUNE_LOCALFUNCTIONS_EXTERN_TEMPLATE class MonomLocalBasis<double,double,1,2>;
+  DUNE_LOCALFUNCTIONS_EXTERN_TEMPLATE class MonomLocalInterpolation<MonomLocalBasis<double,double,1,2>,MonomImp::Size<1,2>::val>;
+  DUNE_LOCALFUNCTIONS_EXTERN_TEMPLATE class MonomLocalBasis<double,double,2,1>;
+  DUNE_LOCALFUNCTIONS_EXTERN_TEMPLATE class MonomLocalInterpolation<MonomLocalBasis<double,double,2,1>,MonomImp::Size<2,1>::val>;
+  DUNE_LOCALFUNCTIONS_EXTERN_TEMPLATE class MonomLocalBasis<double,double,2,2>;
+  DUNE_LOCALFUNCTIONS_EXTERN_TEMPLATE class MonomLocalInterpolation<MonomLocalBasis<double,double,2,2>,MonomImp::Size<2,2>::val>;
+  DUNE_LOCALFUNCTIONS_EXTERN_TEMPLATE class MonomLocalBasis<double,double,3,1>;
+  DUNE_LOCALFUNCTIONS_EXTERN_TEMPLATE class MonomLocalInterpolation<MonomLocalBasis<double,double,3,1>,MonomImp::Size<3,1>::val>;
+  DUNE_LOCALFUNCTIONS_EXTERN_TEMPLATE class MonomLocalBasis<double,double,3,2>;
+  DUNE_LOCALFUNCTIONS_EXTERN_TEMPLATE class MonomLocalInterpolation<MonomLocalBasis<double,double,3,2>,MonomImp::Size<3,2>::val>;
+  DUNE_LOCALFUNCTIONS_EXTERN_TEMPLATE class MonomLocalBasis<float,float,1,1>;
+  DUNE_LOCALFUNCTIONS_EXTERN_TEMPLATE class MonomLocalInterpolation<MonomLocalBasis<float,float,1,1>,MonomImp::Size<1,1>::val>;
+  DUNE_LOCALFUNCTIONS_EXTERN_TEMPLATE class MonomLocalBasis<float,float,1,2>;
+  DUNE_LOCALFUNCTIONS_EXTERN_TEMPLATE class MonomLocalInterpolation<MonomLocalBasis<float,float,1,2>,MonomImp::Size<1,2>::val>;
+  DUNE_LOCALFUNCTIONS_EXTERN_TEMPLATE class MonomLocalBasis<float,float,2,1>;
+  DUNE_LOCALFUNCTIONS_EXTERN_TEMPLATE class MonomLocalInterpolation<MonomLocalBasis<float,float,2,1>,MonomImp::Size<2,1>::val>;
+  DUNE_LOCALFUNCTIONS_EXTERN_TEMPLATE class MonomLocalBasis<float,float,2,2>;
+  DUNE_LOCALFUNCTIONS_EXTERN_TEMPLATE class MonomLocalInterpolation<MonomLocalBasis<float,float,2,2>,MonomImp::Size<2,2>::val>;
+  DUNE_LOCALFUNCTIONS_EXTERN_TEMPLATE class MonomLocalBasis<float,float,3,1>;
+  DUNE_LOCALFUNCTIONS_EXTERN_TEMPLATE class MonomLocalInterpolation<MonomLocalBasis<float,float,3,1>,MonomImp::Size<3,1>::val>;
+  DUNE_LOCALFUNCTIONS_EXTERN_TEMPLATE class MonomLocalBasis<float,float,3,2>;
+  DUNE_LOCALFUNCTIONS_EXTERN_TEMPLATE class MonomLocalInterpolation<MonomLocalBasis<float,float,3,2>,MonomImp::Size<3,2>::val>;
+#endif
+
 }
 
 #endif // DUNE_MONOMLOCALFINITEELEMENT_HH
@@ -3,6 +3,8 @@
 #ifndef DUNE_MONOMLOCALBASIS_HH
 #define DUNE_MONOMLOCALBASIS_HH
 
+#include <cassert>
+
 #include <dune/grid/common/referenceelements.hh>
 
 #include "../common/localbasis.hh"
@@ -26,65 +28,86 @@ namespace Dune
       enum { val = 1 };
     };
 
-    //! Access output vector of evaluateFunction() and evaluate()
-    template <typename Traits>
-    class EvalAccess {
-      std::vector<typename Traits::RangeType> &out;
+    /** \brief Table of the powers of the coordinates of a point, differentiated
+     *
+     *  Entry (j,e) holds the derivatives[j]-th derivative of x_j^e, that is
+     *  e(e-1)...(e-derivatives[j]+1) x_j^(e-derivatives[j]), or zero if e is
+     *  smaller than the order of the derivative.  The powers are built by
+     *  repeated multiplication, so no call of std::pow is needed.
+     *  \internal
+     */
+    template <typename Traits, int p>
+    class Powers
+    {
+      typedef typename Traits::RangeFieldType R;
+
     public:
-      EvalAccess(std::vector<typename Traits::RangeType> &out_)
-        : out(out_)
-      { }
-      typename Traits::RangeFieldType &operator[](unsigned int index)
+      Powers (const typename Traits::DomainType &in,
+              const array<int, Traits::dimDomain> &derivatives)
       {
-        return out[index][0];
+        for (int j=0; j<Traits::dimDomain; j++)
+        {
+          const int m = derivatives[j];
+          R power = 1;
+          for (int e=0; e<=p; e++)
+          {
+            if (e < m)
+              table[j][e] = 0;
+            else
+            {
+              R factor = 1;
+              for (int i=e-m+1; i<=e; i++)
+                factor *= i;
+              table[j][e] = factor*power;
+              power *= in[j];
+            }
+          }
+        }
       }
+
+      //! the derivative of x_j^e
+      R operator() (int j, int e) const
+      {
+        return table[j][e];
+      }
+
+    private:
+      R table[Traits::dimDomain][p+1];
     };
 
-    //! Access output vector of evaluateJacobian()
+    //! Access output vector of evaluateFunction() and evaluate()
     template <typename Traits>
-    class JacobianAccess {
-      std::vector<typename Traits::JacobianType> &out;
-      unsigned int row;
+    class EvalAccess {
+      typename Traits::RangeType *out;
     public:
-      JacobianAccess(std::vector<typename Traits::JacobianType> &out_,
-                     unsigned int row_)
-        : out(out_), row(row_)
+      EvalAccess(typename Traits::RangeType *out_)
+        : out(out_)
       { }
       typename Traits::RangeFieldType &operator[](unsigned int index)
       {
-        return out[index][row][0];
+        return out[index][0];
       }
     };
 
     /** Template Metaprogramm for evaluating monomial shapefunctions
+     *
+     *  Runs through all monomials of total degree bound in the
+     *  coordinates d,...,dimDomain-1, x_d having the highest exponent
+     *  first, and multiplies prod by the tabulated powers.
      *  \internal
      */
     template <typename Traits, int c>
     struct Evaluate
     {
       enum { d = Traits::dimDomain - c };
-      template <typename Access>
-      static void eval (const typename Traits::DomainType &in,
-                        const array<int, Traits::dimDomain> &derivatives,
+      template <typename Table, typename Access>
+      static void eval (const Table &powers,
                         typename Traits::RangeFieldType prod,
                         int bound, int& index, Access &access)
       {
         for (int newbound=0; newbound<=bound; newbound++)
-        {
-          int e = bound-newbound;
-          /*if(e < derivatives[d])
-             Evaluate<Traits,c-1>::
-              eval(in, derivatives, 0, newbound, index, access);
-             else*/{
-            /*int divisor = 1;
-               for(int i = e - derivatives[d] + 1; i <= e; ++i)
-               divisor *= i;*/
-            Evaluate<Traits,c-1>::
-            eval(in, derivatives,
-                 prod*std::pow(in[d], typename Traits::DomainFieldType(e /*-derivatives[d]*/)) /*/ divisor* /,
-                 newbound, index, access);
-          }
-        }
+          Evaluate<Traits,c-1>::
+          eval(powers, prod*powers(d,bound-newbound), newbound, index, access);
       }
     };
 
@@ -96,21 +119,105 @@ namespace Dune
     struct Evaluate<Traits, 1>
     {
       enum { d = Traits::dimDomain-1 };
-      template <typename Access>
-      static void eval (const typename Traits::DomainType &in,
-                        const array<int, Traits::dimDomain> &derivatives,
+      template <typename Table, typename Access>
+      static void eval (const Table &powers,
                         typename Traits::RangeFieldType prod,
                         int bound, int& index, Access &access)
       {
-        /*if(bound < derivatives[d])
-           prod = 0;
-           else*/{
-          /*int divisor = 1;
-             for(int i = bound - derivatives[d] + 1; i <= bound; ++i)
-             divisor *= i;*/
-          prod *= std::pow(in[d], typename Traits::DomainFieldType(bound /*-derivatives[d]*/)) /*/ divisor* /;
+        access[index] = prod*powers(d,bound);
+        ++index;
+      }
+    };
+
+    /** Template Metaprogramm for evaluating monomial shapefunctions and their gradients
+     *
+     *  Same traversal as Evaluate.  grad[i] holds the product of the
+     *  factors collected so far, with the derivative taken in direction i
+     *  if that coordinate has been visited already.
+     *  \internal
+     */
+    template <typename Traits, int c>
+    struct EvaluateJacobian
+    {
+      enum { d = Traits::dimDomain - c };
+      template <typename Table>
+      static void eval (const Table &powers, const Table &derivatives,
+                        typename Traits::RangeFieldType prod,
+                        const FieldVector<typename Traits::RangeFieldType, Traits::dimDomain> &grad,
+                        int bound, int& index,
+                        typename Traits::RangeType *values,
+                        typename Traits::JacobianType *jacobians)
+      {
+        FieldVector<typename Traits::RangeFieldType, Traits::dimDomain> newgrad;
+        for (int newbound=0; newbound<=bound; newbound++)
+        {
+          const int e = bound-newbound;
+          for (int i=0; i<Traits::dimDomain; i++)
+            newgrad[i] = grad[i]*powers(d,e);
+          newgrad[d] = grad[d]*derivatives(d,e);
+          EvaluateJacobian<Traits,c-1>::
+          eval(powers, derivatives, prod*powers(d,e), newgrad, newbound, index, values, jacobians);
         }
-        access[index] = prod;
+      }
+    };
+
+    /** \copydoc EvaluateJacobian
+     *  \brief Specializes the end of the recursion
+     *  \internal
+     */
+    template <typename Traits>
+    struct EvaluateJacobian<Traits, 1>
+    {
+      enum { d = Traits::dimDomain-1 };
+      template <typename Table>
+      static void eval (const Table &powers, const Table &derivatives,
+                        typename Traits::RangeFieldType prod,
+                        const FieldVector<typename Traits::RangeFieldType, Traits::dimDomain> &grad,
+                        int bound, int& index,
+                        typename Traits::RangeType *values,
+                        typename Traits::JacobianType *jacobians)
+      {
+        values[index] = prod*powers(d,bound);
+        for (int i=0; i<Traits::dimDomain; i++)
+          jacobians[index][0][i] = grad[i]*powers(d,bound);
+        jacobians[index][0][d] = grad[d]*derivatives(d,bound);
+        ++index;
+      }
+    };
+
+    /** Template Metaprogramm for the exponents of the monomials
+     *
+     *  Same traversal as Evaluate, stores the exponents of each monomial.
+     *  \internal
+     */
+    template <int dim, int c>
+    struct Exponents
+    {
+      enum { d = dim - c };
+      static void eval (array<int, dim> &exponents, int bound, int& index,
+                        array<int, dim> *out)
+      {
+        for (int newbound=0; newbound<=bound; newbound++)
+        {
+          exponents[d] = bound-newbound;
+          Exponents<dim,c-1>::eval(exponents, newbound, index, out);
+        }
+      }
+    };
+
+    /** \copydoc Exponents
+     *  \brief Specializes the end of the recursion
+     *  \internal
+     */
+    template <int dim>
+    struct Exponents<dim, 1>
+    {
+      enum { d = dim-1 };
+      static void eval (array<int, dim> &exponents, int bound, int& index,
+                        array<int, dim> *out)
+      {
+        exponents[d] = bound;
+        out[index] = exponents;
         ++index;
       }
     };
@@ -118,10 +225,11 @@ namespace Dune
   } //namespace MonomImp
 
   /**@ingroup LocalBasisImplementation
-         \brief Constant shape function
+         \brief Monomial shape functions
 
-         Defines the constant scalar shape function in d dimensions. Is
-         valid on any type of reference element.
+         Defines all scalar monomials of total degree at most p in d
+         dimensions, ordered by degree.  Is valid on any type of reference
+         element.
 
          - <tt>D</tt>: Type to represent the field in the domain.
          - <tt>R</tt>: Type to represent the field in the range.
@@ -132,15 +240,23 @@ namespace Dune
    */
   template<class D, class R, unsigned int d, unsigned int p>
   class MonomLocalBasis :
-    public CkLocalBasisInterface<
+    public C1LocalBasisForwarder<
         CkLocalBasisTraits<D,d,Dune::FieldVector<D,d>,
             R,1,Dune::FieldVector<R,1>,
             Dune::FieldVector<Dune::FieldVector<R,d>,1>, p>,
-        MonomLocalBasis<D,R,d,p> >
+        MonomLocalBasis<D,R,d,p>, MonomImp::Size<d,p>::val,
+        CkLocalBasisInterface<
+            CkLocalBasisTraits<D,d,Dune::FieldVector<D,d>,
+                R,1,Dune::FieldVector<R,1>,
+                Dune::FieldVector<Dune::FieldVector<R,d>,1>, p>,
+            MonomLocalBasis<D,R,d,p> > >
   {
     enum { static_size = MonomImp::Size<d,p>::val };
 
   public:
+    //! \brief Number of shape functions as a compile-time constant
+    enum { N = static_size };
+
     //! \brief export type traits for function signature
     typedef CkLocalBasisTraits<D,d,Dune::FieldVector<D,d>,R,1,Dune::FieldVector<R,1>,
         Dune::FieldVector<Dune::FieldVector<R,d>,1>,p> Traits;
@@ -151,13 +267,6 @@ namespace Dune
       return static_size;
     }
 
-    //! \brief Evaluate all shape functions
-    inline void evaluateFunction (const typename Traits::DomainType& in,
-                                  std::vector<typename Traits::RangeType>& out) const
-    {
-      evaluate<0>(array<int, 0>(), in, out);
-    }
-
     //! return given derivative of all components
     template<int k>
     inline void evaluate (const array<int,k>& directions,
@@ -165,39 +274,147 @@ namespace Dune
                           std::vector<typename Traits::RangeType>& out) const
     {
       out.resize(size());
+      evaluateAt<k>(directions,in,&out[0]);
+    }
+
+    //! \brief Evaluate all shape functions and their partial derivatives up to order r
+    template<int r>
+    inline void evaluateJet (const typename Traits::DomainType& in,
+                             std::vector<LocalBasisJet<Traits,r> >& out) const
+    {
+      out.resize(N);
+      evaluateJetAt<r>(in,&out[0]);
+    }
+
+    //! \brief Evaluate the jets of all shape functions into caller-provided storage with room for \a capacity >= N values
+    template<int r>
+    inline void evaluateJet (const typename Traits::DomainType& in,
+                             LocalBasisJet<Traits,r>* out,
+                             unsigned int capacity) const
+    {
+      assert(capacity >= N);
+      evaluateJetAt<r>(in,out);
+    }
+
+    //! \brief Polynomial order of the shape functions
+    unsigned int order () const
+    {
+      return p;
+    }
+
+  private:
+    friend class C1LocalBasisForwarder<Traits,MonomLocalBasis,N,CkLocalBasisInterface<Traits,MonomLocalBasis> >;
+
+    void evaluateFunctionAt (const typename Traits::DomainType& in,
+                             typename Traits::RangeType* out) const;
+
+    template<int k>
+    inline void evaluateAt (const array<int,k>& directions,
+                            const typename Traits::DomainType& in,
+                            typename Traits::RangeType* out) const
+    {
       int index = 0;
       array<int, d> derivatives;
       for(unsigned int i = 0; i < d; ++i) derivatives[i] = 0;
       for(int i = 0; i < k; ++i) ++derivatives[directions[i]];
+      const MonomImp::Powers<Traits, p> powers(in, derivatives);
       MonomImp::EvalAccess<Traits> access(out);
       for(unsigned int lp = 0; lp <= p; ++lp)
-        MonomImp::Evaluate<Traits, d>::eval(in, derivatives, 1, lp, index,
-                                            access);
+        MonomImp::Evaluate<Traits, d>::eval(powers, 1, lp, index, access);
     }
 
-    //! \brief Evaluate Jacobian of all shape functions
-    inline void
-    evaluateJacobian (const typename Traits::DomainType& in,         // position
-                      std::vector<typename Traits::JacobianType>& out) const      // return value
+    void evaluateJacobianAt (const typename Traits::DomainType& in,
+                             typename Traits::JacobianType* out) const;
+
+    void evaluateFunctionAndJacobianAt (const typename Traits::DomainType& in,
+                                        typename Traits::RangeType* values,
+                                        typename Traits::JacobianType* jacobians) const;
+
+    template<int r>
+    inline void evaluateJetAt (const typename Traits::DomainType& in,
+                               LocalBasisJet<Traits,r>* out) const
     {
-      out.resize(size());
-      for(int i = 0; i < d; ++i)
+      // power[j][e][s] is the s-th derivative of x_j^e
+      R power[d][p+1][r+1];
+      array<int, d> derivatives;
+      for(int s = 0; s <= r; ++s)
       {
-        array<int, 1> directions;
-        directions[0] = i;
-        int index = 0;
-        MonomImp::Evaluate<Traits, d>::eval(in, out, directions, 1, p, index,
-                                            MonomImp::JacobianAccess<Traits>(out, i));
+        for(unsigned int i = 0; i < d; ++i) derivatives[i] = s;
+        const MonomImp::Powers<Traits, p> powers(in, derivatives);
+        for(unsigned int j = 0; j < d; ++j)
+          for(unsigned int e = 0; e <= p; ++e)
+            power[j][e][s] = powers(j,e);
+      }
+
+      // each monomial is the product of its powers
+      const array<int, d>* exponents = monomialExponents();
+      LocalBasisJetImp::TensorProductPartial<R, d> partial;
+      for(int i = 0; i < N; ++i)
+      {
+        for(unsigned int j = 0; j < d; ++j)
+          partial.factor[j] = power[j][exponents[i][j]];
+        LocalBasisJetImp::fill(partial, out[i]);
       }
     }
 
-    //! \brief Polynomial order of the shape functions
-    unsigned int order () const
+    //! \brief The exponents of the monomials, shared by all objects
+    static const array<int, d>* monomialExponents ()
     {
-      return p;
+      static const ExponentTable table;
+      return table.exponents;
     }
+
+    /* The exponents are computed in the constructor of a function-local
+       static object, whose initialization g++ guards against concurrent
+       first use. */
+    struct ExponentTable
+    {
+      ExponentTable ()
+      {
+        array<int, d> current;
+        int index = 0;
+        for(unsigned int lp = 0; lp <= p; ++lp)
+          MonomImp::Exponents<d, d>::eval(current, lp, index, exponents);
+      }
+
+      array<int, d> exponents[N];
+    };
   };
 
+  // not inline, such that the instantiations in libdunelocalfunctions are used
+  template<class D, class R, unsigned int d, unsigned int p>
+  void MonomLocalBasis<D,R,d,p>::evaluateFunctionAt (const typename Traits::DomainType& in,
+                                                     typename Traits::RangeType* out) const
+  {
+    evaluateAt<0>(array<int, 0>(), in, out);
+  }
+
+  template<class D, class R, unsigned int d, unsigned int p>
+  void MonomLocalBasis<D,R,d,p>::evaluateJacobianAt (const typename Traits::DomainType& in,
+                                                     typename Traits::JacobianType* out) const
+  {
+    typename Traits::RangeType values[N];
+    evaluateFunctionAndJacobianAt(in,values,out);
+  }
+
+  template<class D, class R, unsigned int d, unsigned int p>
+  void MonomLocalBasis<D,R,d,p>::evaluateFunctionAndJacobianAt (const typename Traits::DomainType& in,
+                                                                typename Traits::RangeType* values,
+                                                                typename Traits::JacobianType* jacobians) const
+  {
+    array<int, d> derivatives;
+    for(unsigned int i = 0; i < d; ++i) derivatives[i] = 0;
+    const MonomImp::Powers<Traits, p> powers(in, derivatives);
+    for(unsigned int i = 0; i < d; ++i) derivatives[i] = 1;
+    const MonomImp::Powers<Traits, p> firstDerivatives(in, derivatives);
+
+    const FieldVector<typename Traits::RangeFieldType, d> one(1);
+    int index = 0;
+    for(unsigned int lp = 0; lp <= p; ++lp)
+      MonomImp::EvaluateJacobian<Traits, d>::eval(powers, firstDerivatives, 1, one, lp, index,
+                                                  values, jacobians);
+  }
+
 }
 
 #endif // DUNE_MONOMLOCALBASIS_HH
@@ -17,16 +17,21 @@ namespace Dune
          \nosubgrouping
    */
   template<int static_size>
-  class MonomLocalCoefficients : public LocalCoefficientsInterface<MonomLocalCoefficients<static_size> >
+  class MonomLocalCoefficients
+#if DUNE_VIRTUAL_SHAPEFUNCTIONS
+    : public LocalCoefficientsInterface
+#else
+    : public LocalCoefficientsInterface<MonomLocalCoefficients<static_size> >
+#endif
   {
+    typedef LocalKeyTable<MonomLocalCoefficients,static_size> Table;
+    friend class LocalKeyTable<MonomLocalCoefficients,static_size>;
+
   public:
     //! \brief Standard constructor
     MonomLocalCoefficients ()
-      : index(static_size, LocalKey(0,0,0))
-    {
-      for(int i = 0; i < static_size; ++i)
-        index[i].index(i);
-    }
+      : index(Table::keys()), packed(Table::packedKeys())
+    {}
 
     //! number of coefficients
     int size () const
@@ -40,8 +45,21 @@ namespace Dune
       return index[i];
     }
 
+    //! get i'th index, packed into 32 bits
+    const PackedLocalKey& packedLocalKey (int i) const
+    {
+      return packed[i];
+    }
+
   private:
-    std::vector<LocalKey> index;
+    const LocalKey* index;
+    const PackedLocalKey* packed;
+
+    static void fill (int, LocalKey* keys)
+    {
+      for(int i = 0; i < static_size; ++i)
+        keys[i] = LocalKey(0,0,i);
+    }
   };
 
 }
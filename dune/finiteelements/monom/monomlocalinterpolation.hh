@@ -5,16 +5,30 @@
 
 #include <vector>
 
+#include <dune/common/exceptions.hh>
 #include <dune/common/geometrytype.hh>
 #include <dune/common/fvector.hh>
 #include <dune/common/fmatrix.hh>
 #include <dune/grid/common/quadraturerules.hh>
 
 #include "../common/localinterpolation.hh"
+#include "../common/simd.hh"
 
 namespace Dune
 {
 
+  /** \brief L2 projection onto the monomials
+
+      The coefficients are c_i = sum_q P_qi f(x_q) with
+      P_qi = w_q sum_j (M^-1)_ij phi_j(x_q), where M is the mass matrix and
+      x_q, w_q are the points and weights of the quadrature rule of order 2p.
+      P only depends on the basis type and the reference element, so it is
+      computed once per GeometryType and shared by all objects.  Each P is a
+      function-local static, built completely by its constructor, so that
+      the compiler guards its initialization against concurrent first use
+      (g++ does unless -fno-threadsafe-statics is given), and an exception
+      leaves nothing behind.
+   */
   template<class LB, unsigned int size>
   class MonomLocalInterpolation
     : public LocalInterpolationInterface<MonomLocalInterpolation<LB, size> >
@@ -25,59 +39,132 @@ namespace Dune
     typedef typename LB::Traits::RangeType R;
     typedef typename LB::Traits::RangeFieldType RF;
 
-    typedef QuadratureRule<DF,dimD> QR;
+    // the projection is set up with scalars, also if DF and RF are Simd vectors
+    typedef typename SimdTraits<DF>::ValueType DV;
+    typedef typename SimdTraits<RF>::ValueType RV;
+
+    typedef QuadratureRule<DV,dimD> QR;
     typedef typename QR::iterator QRiterator;
 
-  public:
-    MonomLocalInterpolation (const GeometryType::BasicType &bt_,
-                             const LB &lb_)
-      : bt(bt_), lb(lb_), Minv(0)
-        , qr(QuadratureRules<DF,dimD>::rule(bt, 2*lb.order()))
+    //! quadrature points and projection matrix, stored point-major
+    struct Projection
     {
-      if(size != lb.size())
-        DUNE_THROW(Exception, "size template parameter does not match size of local basis");
+      //! set up the projection onto the monomials lb on the reference element of type bt
+      Projection (GeometryType::BasicType bt, const LB &lb)
+      {
+        const QR &qr = QuadratureRules<DV,dimD>::rule(bt, 2*lb.order());
+
+        FieldMatrix<RV, size, size> Minv(0);
+        RV base[size];
+        const QRiterator qrend = qr.end();
+        for(QRiterator qrit = qr.begin(); qrit != qrend; ++qrit) {
+          evaluateScalar(lb,qrit->position(),base);
+
+          for(unsigned int i = 0; i < size; ++i)
+            for(unsigned int j = 0; j < size; ++j)
+              Minv[i][j] += qrit->weight() * base[i] * base[j];
+        }
+        Minv.invert();
+
+        positions.resize(qr.size());
+        matrix.resize(qr.size()*size);
+        RV* row = &matrix[0];
+        D* position = &positions[0];
+        for(QRiterator qrit = qr.begin(); qrit != qrend; ++qrit, row += size, ++position) {
+          *position = evaluateScalar(lb,qrit->position(),base);
+
+          for(unsigned int i = 0; i < size; ++i) {
+            row[i] = 0;
+            for(unsigned int j = 0; j < size; ++j)
+              row[i] += Minv[i][j] * base[j];
+            row[i] *= qrit->weight();
+          }
+        }
+      }
 
-      const QRiterator qrend = qr.end();
-      for(QRiterator qrit = qr.begin(); qrit != qrend; ++qrit) {
-        std::vector<R> base;
-        lb.evaluateFunction(qrit->position(),base);
+      //! values of all shape functions at the scalar position x, returns x as a DomainType
+      static D evaluateScalar (const LB &lb, const FieldVector<DV,dimD>& x, RV* base)
+      {
+        D position;
+        for(int d = 0; d < dimD; ++d)
+          position[d] = x[d];
 
+        FieldVector<R, size> values;
+        lb.evaluateFunction(position,values);
         for(unsigned int i = 0; i < size; ++i)
-          for(unsigned int j = 0; j < size; ++j)
-            Minv[i][j] += qrit->weight() * base[i] * base[j];
+          base[i] = SimdTraits<RF>::lane(values[i][0],0);
+
+        return position;
       }
-      Minv.invert();
+
+      std::vector<D> positions;
+      std::vector<RV> matrix;
+    };
+
+  public:
+    MonomLocalInterpolation (const GeometryType::BasicType &bt_,
+                             const LB &lb_)
+      : projection(&getProjection(bt_, lb_))
+    {
+      if(size != lb_.size())
+        DUNE_THROW(Exception, "size template parameter does not match size of local basis");
     }
 
     //! determine coefficients interpolating a given function
     template<typename F, typename C>
     void interpolate (const F& f, std::vector<C>& out) const
     {
-      out.clear();
-      out.resize(size, 0);
+      out.resize(size);
+      interpolate(f,&out[0]);
+    }
 
-      const QRiterator qrend = qr.end();
-      for(QRiterator qrit = qr.begin(); qrit != qrend; ++qrit) {
-        //TODO: mass matrix
-        R y;
-        f.evaluate(qrit->position(),y);
+    //! determine coefficients into caller-provided storage for size coefficients
+    template<typename F, typename C>
+    void interpolate (const F& f, C* out) const
+    {
+      for(unsigned int i = 0; i < size; ++i)
+        out[i] = 0;
 
-        std::vector<R> base;
-        lb.evaluateFunction(qrit->position(),base);
+      const RV* row = &projection->matrix[0];
+      for(size_t q = 0; q < projection->positions.size(); ++q, row += size) {
+        R y;
+        f.evaluate(projection->positions[q],y);
 
         for(unsigned int i = 0; i < size; ++i)
-          for(unsigned int j = 0; j < size; ++j)
-            out[i] += Minv[i][j] * qrit->weight() * y * base[j];
+          out[i] += row[i] * y[0];
       }
     }
 
   private:
-    GeometryType::BasicType bt;
-    const LB &lb;
-    FieldMatrix<RF, size, size> Minv;
-    const QR &qr;
+    //! the projection for the given reference element, set up on first use
+    static const Projection& getProjection (GeometryType::BasicType bt, const LB &lb);
+
+    //! the projection for reference elements of type bt
+    template<GeometryType::BasicType bt>
+    static const Projection& staticProjection (const LB &lb)
+    {
+      static const Projection projection(bt, lb);
+      return projection;
+    }
+
+    const Projection* projection;
   };
 
+  // not inline, such that the instantiations in libdunelocalfunctions are used
+  template<class LB, unsigned int size>
+  const typename MonomLocalInterpolation<LB,size>::Projection&
+  MonomLocalInterpolation<LB,size>::getProjection (GeometryType::BasicType bt, const LB &lb)
+  {
+    switch (bt) {
+    case GeometryType::simplex : return staticProjection<GeometryType::simplex>(lb);
+    case GeometryType::cube :    return staticProjection<GeometryType::cube>(lb);
+    case GeometryType::pyramid : return staticProjection<GeometryType::pyramid>(lb);
+    case GeometryType::prism :   return staticProjection<GeometryType::prism>(lb);
+    default :
+      DUNE_THROW(NotImplemented, "MonomLocalInterpolation for this GeometryType");
+    }
+  }
+
 }
 
 #endif //DUNE_MONOMLOCALINTERPOLATION_HH
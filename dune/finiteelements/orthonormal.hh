@@ -0,0 +1,126 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+#ifndef DUNE_ORTHONORMALLOCALFINITEELEMENT_HH
+#define DUNE_ORTHONORMALLOCALFINITEELEMENT_HH
+
+#include <dune/common/geometrytype.hh>
+
+#include "common/localfiniteelement.hh"
+#include "common/precompiled.hh"
+#include "orthonormal/orthonormallocalbasis.hh"
+#include "orthonormal/orthonormallocalcoefficients.hh"
+#include "orthonormal/orthonormallocalinterpolation.hh"
+
+namespace Dune
+{
+
+  /** \brief Discontinuous element with an orthonormal basis of the polynomials of total degree at most p
+
+      Spans the same space as MonomLocalFiniteElement, but the mass matrix
+      is the identity.  The reference element is given by the template
+      parameter bt, which is GeometryType::cube or GeometryType::simplex.
+   */
+  template<class D, class R, int d, unsigned int p, GeometryType::BasicType bt>
+  class OrthonormalLocalFiniteElement
+    :
+#if DUNE_VIRTUAL_SHAPEFUNCTIONS
+      public
+#endif
+      LocalFiniteElementInterface<
+          LocalFiniteElementTraits<OrthonormalLocalBasis<D,R,d,p,bt>,
+              OrthonormalLocalCoefficients<OrthonormalLocalBasis<D,R,d,p,bt>::N>,
+              OrthonormalLocalInterpolation<OrthonormalLocalBasis<D,R,d,p,bt>,bt> >
+#ifndef DUNE_VIRTUAL_SHAPEFUNCTIONS
+          ,OrthonormalLocalFiniteElement<D,R,d,p,bt>
+#endif
+          >
+  {
+    enum { static_size = OrthonormalLocalBasis<D,R,d,p,bt>::N };
+
+  public:
+    /** \todo Please doc me !
+     */
+    typedef LocalFiniteElementTraits<OrthonormalLocalBasis<D,R,d,p,bt>,
+        OrthonormalLocalCoefficients<static_size>,
+        OrthonormalLocalInterpolation<OrthonormalLocalBasis<D,R,d,p,bt>,bt> > Traits;
+
+    /** \todo Please doc me !
+     */
+    OrthonormalLocalFiniteElement ()
+      : gt(bt,d)
+    {}
+
+    /** \todo Please doc me !
+     */
+    const typename Traits::LocalBasisType& localBasis () const
+    {
+      return basis;
+    }
+
+    /** \todo Please doc me !
+     */
+    const typename Traits::LocalCoefficientsType& localCoefficients () const
+    {
+      return coefficients;
+    }
+
+    /** \todo Please doc me !
+     */
+    const typename Traits::LocalInterpolationType& localInterpolation () const
+    {
+      return interpolation;
+    }
+
+    /** \todo Please doc me !
+     */
+    GeometryType type () const
+    {
+      return gt;
+    }
+
+  private:
+    OrthonormalLocalBasis<D,R,d,p,bt> basis;
+    OrthonormalLocalCoefficients<static_size> coefficients;
+    OrthonormalLocalInterpolation<OrthonormalLocalBasis<D,R,d,p,bt>,bt> interpolation;
+    GeometryType gt;
+  };
+
+#if DUNE_LOCALFUNCTIONS_PRECOMPILED && !defined(DUNE_VIRTUAL_SHAPEFUNCTIONS)
+  // instantiated in libdunelocalfunctions, see common/precompiled.hh
+  DUNE_LOCALFUNCTIONS_EXTERN_TEMPLATE class OrthonormalLocalBasis<double,double,2,1,GeometryType::simplex>;
+  DUNE_LOCALFUNCTIONS_EXTERN_TEMPLATE class OrthonormalLocalInterpolation<OrthonormalLocalBasis<double,double,2,1,GeometryType::simplex>,GeometryType::simplex>;
+  DUNE_LOCALFUNCTIONS_EXTERN_TEMPLATE class OrthonormalLocalBasis<double,double,2,2,GeometryType::simplex>;
+  DUNE_LOCALFUNCTIONS_EXTERN_TEMPLATE class OrthonormalLocalInterpolation<OrthonormalLocalBasis<double,double,2,2,GeometryType::simplex>,GeometryType::simplex>;
+  DUNE_LOCALFUNCTIONS_EXTERN_TEMPLATE class OrthonormalLocalBasis<double,double,3,1,GeometryType::simplex>;
+  DUNE_LOCALFUNCTIONS_EXTERN_TEMPLATE class OrthonormalLocalInterpolation<OrthonormalLocalBasis<double,double,3,1,GeometryType::simplex>,GeometryType::simplex>;
+  DUNE_LOCALFUNCTIONS_EXTERN_TEMPLATE class OrthonormalLocalBasis<double,double,3,2,GeometryType::simplex>;
+  DUNE_LOCALFUNCTIONS_EXTERN_TEMPLATE class OrthonormalLocalInterpolation<OrthonormalLocalBasis<double,double,3,2,GeometryType::simplex>,GeometryType::simplex>;
+  DUNE_LOCALFUNCTIONS_EXTERN_TEMPLATE class OrthonormalLocalBasis<double,double,2,1,GeometryType::cube>;
+  DUNE_LOCALFUNCTIONS_EXTERN_TEMPLATE class OrthonormalLocalInterpolation<OrthonormalLocalBasis<double,double,2,1,GeometryType::cube>,GeometryType::cube>;
+  DUNE_LOCALFUNCTIONS_EXTERN_TEMPLATE class OrthonormalLocalBasis<double,double,2,2,GeometryType::cube>;
+  DUNE_LOCALFUNCTIONS_EXTERN_TEMPLATE class OrthonormalLocalInterpolation<OrthonormalLocalBasis<double,double,2,2,GeometryType::cube>,GeometryType::cube>;
+  DUNE_LOCALFUNCTIONS_EXTERN_TEMPLATE class OrthonormalLocalBasis<double,double,3,1,GeometryType::cube>;
+  DUNE_LOCALFUNCTIONS_EXTERN_TEMPLATE class OrthonormalLocalInterpolation<OrthonormalLocalBasis<double,double,3,1,GeometryType::cube>,GeometryType::cube>;
+  DUNE_LOCALFUNCTIONS_EXTERN_TEMPLATE class OrthonormalLocalBasis<double,double,3,2,GeometryType::cube>;
+  DUNE_LOCALFUNCTIONS_EXTERN_TEMPLATE class OrthonormalLocalInterpolation<OrthonormalLocalBasis<double,double,3,2,GeometryType::cube>,GeometryType::cube>;
+  DUNE_LOCALFUNCTIONS_EXTERN_TEMPLATE class OrthonormalLocalBasis<float,float,2,1,GeometryType::simplex>;
+  DUNE_LOCALFUNCTIONS_EXTERN_TEMPLATE class OrthonormalLocalInterpolation<OrthonormalLocalBasis<float,float,2,1,GeometryType::simplex>,GeometryType::simplex>;
+  DUNE_LOCALFUNCTIONS_EXTERN_TEMPLATE class OrthonormalLocalBasis<float,float,2,2,GeometryType::simplex>;
+  DUNE_LOCALFUNCTIONS_EXTERN_TEMPLATE class OrthonormalLocalInterpolation<OrthonormalLocalBasis<float,float,2,2,GeometryType::simplex>,GeometryType::simplex>;
+  DUNE_LOCALFUNCTIONS_EXTERN_TEMPLATE class OrthonormalLocalBasis<float,float,3,1,GeometryType::simplex>;
+  DUNE_LOCALFUNCTIONS_EXTERN_TEMPLATE class OrthonormalLocalInterpolation<OrthonormalLocalBasis<float,float,3,1,GeometryType::simplex>,GeometryType::simplex>;
+  DUNE_LOCALFUNCTIONS_EXTERN_TEMPLATE class OrthonormalLocalBasis<float,float,3,2,GeometryType::simplex>;
+  DUNE_LOCALFUNCTIONS_EXTERN_TEMPLATE class OrthonormalLocalInterpolation<OrthonormalLocalBasis<float,float,3,2,GeometryType::simplex>,GeometryType::simplex>;
+  DUNE_LOCALFUNCTIONS_EXTERN_TEMPLATE class OrthonormalLocalBasis<float,float,2,1,GeometryType::cube>;
+  DUNE_LOCALFUNCTIONS_EXTERN_TEMPLATE class OrthonormalLocalInterpolation<OrthonormalLocalBasis<float,float,2,1,GeometryType::cube>,GeometryType::cube>;
+  DUNE_LOCALFUNCTIONS_EXTERN_TEMPLATE class OrthonormalLocalBasis<float,float,2,2,GeometryType::cube>;
+  DUNE_LOCALFUNCTIONS_EXTERN_TEMPLATE class OrthonormalLocalInterpolation<OrthonormalLocalBasis<float,float,2,2,GeometryType::cube>,GeometryType::cube>;
+  DUNE_LOCALFUNCTIONS_EXTERN_TEMPLATE class OrthonormalLocalBasis<float,float,3,1,GeometryType::cube>;
+  DUNE_LOCALFUNCTIONS_EXTERN_TEMPLATE class OrthonormalLocalInterpolation<OrthonormalLocalBasis<float,float,3,1,GeometryType::cube>,GeometryType::cube>;
+  DUNE_LOCALFUNCTIONS_EXTERN_TEMPLATE class OrthonormalLocalBasis<float,float,3,2,GeometryType::cube>;
+  DUNE_LOCALFUNCTIONS_EXTERN_TEMPLATE class OrthonormalLocalInterpolation<OrthonormalLocalBasis<float,float,3,2,GeometryType::cube>,GeometryType::cube>;
+#endif
+
+}
+
+#endif
@@ -0,0 +1,364 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+#ifndef DUNE_ORTHONORMALLOCALBASIS_HH
+#define DUNE_ORTHONORMALLOCALBASIS_HH
+
+#include <cmath>
+
+#include <dune/common/geometrytype.hh>
+#include <dune/common/static_assert.hh>
+
+#include "../common/localbasis.hh"
+#include "../common/localfunction.hh"
+
+namespace Dune
+{
+  namespace OrthonormalImp {
+
+    /** \brief Scaled Jacobi polynomials J_n(u,v) = v^n P_n^(alpha,0)(u/v), n=0,...,m
+     *
+     *  Uses the three-term recurrence of the Jacobi polynomials, multiplied
+     *  by v^(n+1), so J_n is a polynomial in u and v that can be evaluated
+     *  for v=0 as well.  alpha=0 gives the Legendre polynomials.
+     *  \internal
+     */
+    template<class R>
+    inline void jacobi (int m, int alpha, R u, R v, R* J)
+    {
+      J[0] = 1;
+      if (m == 0)
+        return;
+      J[1] = 0.5*((alpha+2)*u + alpha*v);
+      for (int n=1; n<m; n++)
+      {
+        const int a = 2*n+alpha;
+        const R w = R((a+2)*a)*u + R(alpha*alpha)*v;
+        J[n+1] = ((a+1)*w*J[n] - R(2*n*(n+alpha)*(a+2))*v*v*J[n-1])
+                 / R(2*(n+1)*(n+alpha+1)*a);
+      }
+    }
+
+    /** \brief Scaled Jacobi polynomials and their partial derivatives in u and v
+     *
+     *  The derivatives follow from differentiating the recurrence.
+     *  \internal
+     */
+    template<class R>
+    inline void jacobi (int m, int alpha, R u, R v, R* J, R* Ju, R* Jv)
+    {
+      J[0] = 1; Ju[0] = 0; Jv[0] = 0;
+      if (m == 0)
+        return;
+      J[1] = 0.5*((alpha+2)*u + alpha*v);
+      Ju[1] = 0.5*(alpha+2);
+      Jv[1] = 0.5*alpha;
+      for (int n=1; n<m; n++)
+      {
+        const int a = 2*n+alpha;
+        const R c1 = (a+2)*a;
+        const R c2 = alpha*alpha;
+        const R w = c1*u + c2*v;
+        const R c = 2*n*(n+alpha)*(a+2);
+        const R inv = 1.0/(2*(n+1)*(n+alpha+1)*a);
+        J[n+1] = ((a+1)*w*J[n] - c*v*v*J[n-1])*inv;
+        Ju[n+1] = ((a+1)*(c1*J[n] + w*Ju[n]) - c*v*v*Ju[n-1])*inv;
+        Jv[n+1] = ((a+1)*(c2*J[n] + w*Jv[n]) - c*(2*v*J[n-1] + v*v*Jv[n-1]))*inv;
+      }
+    }
+
+    /** \brief Evaluates the orthonormal polynomials on a given reference element
+     *
+     *  The primary template handles the cube, where the basis consists of
+     *  the products of the Legendre polynomials sqrt(2n+1) P_n(2x_i-1) of
+     *  total degree at most p.  Shape function s has the degree a[s][i] in
+     *  direction i.
+     *  \internal
+     */
+    template<class D, class R, int dim, int p, GeometryType::BasicType bt>
+    struct Evaluate
+    {
+      //! \brief Normalization factor of the polynomial with degrees a
+      static R norm (const int* a)
+      {
+        int c = 1;
+        for (int i=0; i<dim; i++)
+          c *= 2*a[i]+1;
+        return R(std::sqrt(double(c)));
+      }
+
+      //! \brief Values and, if jacobians is not null, Jacobians of all shape functions
+      template<class RangeType, class JacobianType>
+      static void apply (const FieldVector<D,dim>& x, int n, const int (*a)[dim], const R* norm,
+                         RangeType* values, JacobianType* jacobians)
+      {
+        R L[dim][p+1], dL[dim][p+1], unused[p+1];
+        for (int i=0; i<dim; i++)
+          if (jacobians)
+            jacobi<R>(p,0,2*x[i]-1,1,L[i],dL[i],unused);
+          else
+            jacobi<R>(p,0,2*x[i]-1,1,L[i]);
+
+        for (int s=0; s<n; s++)
+        {
+          R value = norm[s];
+          for (int i=0; i<dim; i++)
+            value *= L[i][a[s][i]];
+          values[s] = value;
+
+          if (jacobians)
+            for (int j=0; j<dim; j++)
+            {
+              R d = 2*norm[s]*dL[j][a[s][j]];
+              for (int i=0; i<dim; i++)
+                if (i != j)
+                  d *= L[i][a[s][i]];
+              jacobians[s][0][j] = d;
+            }
+        }
+      }
+    };
+
+    //! \brief The line is a cube
+    template<class D, class R, int p>
+    struct Evaluate<D,R,1,p,GeometryType::simplex>
+      : public Evaluate<D,R,1,p,GeometryType::cube>
+    {};
+
+    /** \brief Dubiner basis on the reference triangle
+     *
+     *  Shape function (i,j) is
+     *    c_ij S_i(2x+y-1,1-y) J^(2i+1)_j(2y-1,1),  c_ij = sqrt((2i+1)(2i+2j+2)),
+     *  with the scaled Jacobi polynomials S=J^(0) and J^(2i+1) of jacobi().
+     *  \internal
+     */
+    template<class D, class R, int p>
+    struct Evaluate<D,R,2,p,GeometryType::simplex>
+    {
+      static R norm (const int* a)
+      {
+        return R(std::sqrt(double((2*a[0]+1)*(2*a[0]+2*a[1]+2))));
+      }
+
+      template<class RangeType, class JacobianType>
+      static void apply (const FieldVector<D,2>& x, int n, const int (*a)[2], const R* norm,
+                         RangeType* values, JacobianType* jacobians)
+      {
+        R S[p+1], Su[p+1], Sv[p+1];
+        R T[p+1][p+1], Tu[p+1][p+1], unused[p+1];
+        if (jacobians)
+        {
+          jacobi<R>(p,0,2*x[0]+x[1]-1,1-x[1],S,Su,Sv);
+          for (int i=0; i<=p; i++)
+            jacobi<R>(p-i,2*i+1,2*x[1]-1,1,T[i],Tu[i],unused);
+        }
+        else
+        {
+          jacobi<R>(p,0,2*x[0]+x[1]-1,1-x[1],S);
+          for (int i=0; i<=p; i++)
+            jacobi<R>(p-i,2*i+1,2*x[1]-1,1,T[i]);
+        }
+
+        for (int s=0; s<n; s++)
+        {
+          const int i = a[s][0], j = a[s][1];
+          values[s] = norm[s]*S[i]*T[i][j];
+
+          if (jacobians)
+          {
+            jacobians[s][0][0] = norm[s]*2*Su[i]*T[i][j];
+            jacobians[s][0][1] = norm[s]*((Su[i]-Sv[i])*T[i][j] + 2*S[i]*Tu[i][j]);
+          }
+        }
+      }
+    };
+
+    /** \brief Dubiner basis on the reference tetrahedron
+     *
+     *  Shape function (i,j,k) is
+     *    c_ijk S_i(2x+y+z-1,1-y-z) J^(2i+1)_j(2y+z-1,1-z) J^(2i+2j+2)_k(2z-1,1)
+     *  with c_ijk = sqrt(2(2i+1)(i+j+1)(2i+2j+2k+3)).
+     *  \internal
+     */
+    template<class D, class R, int p>
+    struct Evaluate<D,R,3,p,GeometryType::simplex>
+    {
+      static R norm (const int* a)
+      {
+        return R(std::sqrt(double(2*(2*a[0]+1)*(a[0]+a[1]+1)*(2*a[0]+2*a[1]+2*a[2]+3))));
+      }
+
+      template<class RangeType, class JacobianType>
+      static void apply (const FieldVector<D,3>& x, int n, const int (*a)[3], const R* norm,
+                         RangeType* values, JacobianType* jacobians)
+      {
+        R S[p+1], Su[p+1], Sv[p+1];
+        R T[p+1][p+1], Tu[p+1][p+1], Tv[p+1][p+1];
+        R W[p+1][p+1], Wu[p+1][p+1], unused[p+1];
+        const R u1 = 2*x[0]+x[1]+x[2]-1, v1 = 1-x[1]-x[2];
+        const R u2 = 2*x[1]+x[2]-1, v2 = 1-x[2];
+        const R u3 = 2*x[2]-1;
+        if (jacobians)
+        {
+          jacobi<R>(p,0,u1,v1,S,Su,Sv);
+          for (int i=0; i<=p; i++)
+          {
+            jacobi<R>(p-i,2*i+1,u2,v2,T[i],Tu[i],Tv[i]);
+            // the third factor only depends on i+j
+            jacobi<R>(p-i,2*i+2,u3,1,W[i],Wu[i],unused);
+          }
+        }
+        else
+        {
+          jacobi<R>(p,0,u1,v1,S);
+          for (int i=0; i<=p; i++)
+          {
+            jacobi<R>(p-i,2*i+1,u2,v2,T[i]);
+            jacobi<R>(p-i,2*i+2,u3,1,W[i]);
+          }
+        }
+
+        for (int s=0; s<n; s++)
+        {
+          const int i = a[s][0], j = a[s][1], k = a[s][2];
+          const R st = S[i]*T[i][j];
+          values[s] = norm[s]*st*W[i+j][k];
+
+          if (jacobians)
+          {
+            const R dS = (Su[i]-Sv[i])*T[i][j]*W[i+j][k];
+            jacobians[s][0][0] = norm[s]*2*Su[i]*T[i][j]*W[i+j][k];
+            jacobians[s][0][1] = norm[s]*(dS + 2*S[i]*Tu[i][j]*W[i+j][k]);
+            jacobians[s][0][2] = norm[s]*(dS + S[i]*(Tu[i][j]-Tv[i][j])*W[i+j][k]
+                                          + 2*st*Wu[i+j][k]);
+          }
+        }
+      }
+    };
+
+  } // namespace OrthonormalImp
+
+  /**@ingroup LocalBasisImplementation
+         \brief Orthonormal polynomials of total degree at most p
+
+         The shape functions are orthonormal in L2 of the reference element,
+         so the mass matrix is the identity.  They span the polynomials of
+         total degree at most p on every reference element, also on the
+         cube, where this is P_p and not the tensor-product space Q_p.  On
+         the cube they are the products of Legendre polynomials whose
+         degrees sum to at most p, on the triangle and the tetrahedron the
+         Dubiner polynomials.  Values and derivatives are computed
+         with the three-term recurrence of the Jacobi polynomials.  The
+         shape functions are ordered by degree, and within one degree as
+         MonomLocalBasis orders the monomials.
+
+         \tparam D  Type to represent the field in the domain.
+         \tparam R  Type to represent the field in the range.
+         \tparam dim Dimension of the reference element, 1, 2 or 3.
+         \tparam p  Polynomial order.
+         \tparam bt Reference element, GeometryType::cube or GeometryType::simplex.
+
+         \nosubgrouping
+   */
+  template<class D, class R, int dim, unsigned int p, GeometryType::BasicType bt>
+  class OrthonormalLocalBasis :
+    public C1LocalBasisForwarder<
+        C1LocalBasisTraits<D,dim,Dune::FieldVector<D,dim>,R,1,Dune::FieldVector<R,1>,
+            Dune::FieldVector<Dune::FieldVector<R,dim>,1> >,
+        OrthonormalLocalBasis<D,R,dim,p,bt>, (dim == 1) ? p+1 : (dim == 2) ? (p+1)*(p+2)/2 : (p+1)*(p+2)*(p+3)/6>
+  {
+    dune_static_assert(dim >= 1 && dim <= 3, "OrthonormalLocalBasis is only implemented for dimensions 1 to 3");
+    dune_static_assert(bt == GeometryType::cube || bt == GeometryType::simplex,
+                       "OrthonormalLocalBasis is only implemented for cubes and simplices");
+
+    typedef OrthonormalImp::Evaluate<D,R,dim,p,bt> Evaluate;
+
+  public:
+    enum {N = (dim == 1) ? p+1 : (dim == 2) ? (p+1)*(p+2)/2 : (p+1)*(p+2)*(p+3)/6};
+    enum {O = p};
+
+    typedef C1LocalBasisTraits<D,dim,Dune::FieldVector<D,dim>,R,1,Dune::FieldVector<R,1>,
+        Dune::FieldVector<Dune::FieldVector<R,dim>,1> > Traits;
+
+    //! \brief Standard constructor
+    OrthonormalLocalBasis ()
+    {
+      int s = 0;
+      int a[dim];
+      for (unsigned int n=0; n<=p; n++)
+        fill(n,0,a,s);
+    }
+
+    //! \brief number of shape functions
+    unsigned int size () const
+    {
+      return N;
+    }
+
+    //! \brief Polynomial order of the shape functions
+    unsigned int order () const
+    {
+      return p;
+    }
+
+  private:
+    friend class C1LocalBasisForwarder<Traits,OrthonormalLocalBasis,N>;
+
+    //! \brief Degrees of the shape functions of total degree bound in the directions c,...,dim-1
+    void fill (int bound, int c, int* a, int& s)
+    {
+      if (c == dim-1)
+      {
+        a[c] = bound;
+        for (int i=0; i<dim; i++)
+          degree[s][i] = a[i];
+        norm[s] = Evaluate::norm(a);
+        s++;
+        return;
+      }
+      for (int newbound=0; newbound<=bound; newbound++)
+      {
+        a[c] = bound-newbound;
+        fill(newbound,c+1,a,s);
+      }
+    }
+
+    void evaluateFunctionAt (const typename Traits::DomainType& x,
+                             typename Traits::RangeType* out) const;
+
+    void evaluateJacobianAt (const typename Traits::DomainType& x,
+                             typename Traits::JacobianType* out) const;
+
+    void evaluateFunctionAndJacobianAt (const typename Traits::DomainType& x,
+                                        typename Traits::RangeType* values,
+                                        typename Traits::JacobianType* jacobians) const;
+
+    int degree[N][dim];
+    R norm[N];
+  };
+
+  // not inline, such that the instantiations in libdunelocalfunctions are used
+  template<class D, class R, int dim, unsigned int p, GeometryType::BasicType bt>
+  void OrthonormalLocalBasis<D,R,dim,p,bt>::evaluateFunctionAt (const typename Traits::DomainType& x,
+                                                                typename Traits::RangeType* out) const
+  {
+    Evaluate::apply(x,N,degree,norm,out,static_cast<typename Traits::JacobianType*>(0));
+  }
+
+  template<class D, class R, int dim, unsigned int p, GeometryType::BasicType bt>
+  void OrthonormalLocalBasis<D,R,dim,p,bt>::evaluateJacobianAt (const typename Traits::DomainType& x,
+                                                                typename Traits::JacobianType* out) const
+  {
+    typename Traits::RangeType values[N];
+    Evaluate::apply(x,N,degree,norm,values,out);
+  }
+
+  template<class D, class R, int dim, unsigned int p, GeometryType::BasicType bt>
+  void OrthonormalLocalBasis<D,R,dim,p,bt>::evaluateFunctionAndJacobianAt (const typename Traits::DomainType& x,
+                                                                           typename Traits::RangeType* values,
+                                                                           typename Traits::JacobianType* jacobians) const
+  {
+    Evaluate::apply(x,N,degree,norm,values,jacobians);
+  }
+
+}
+#endif
@@ -0,0 +1,68 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+#ifndef DUNE_ORTHONORMALLOCALCOEFFICIENTS_HH
+#define DUNE_ORTHONORMALLOCALCOEFFICIENTS_HH
+
+#include <iostream>
+#include <vector>
+
+#include "../common/localcoefficients.hh"
+
+namespace Dune
+{
+
+  /**@ingroup LocalLayoutImplementation
+         \brief Layout map for discontinuous elements with orthonormal shape functions
+
+         All degrees of freedom belong to the element itself.
+
+         \nosubgrouping
+   */
+  template<int static_size>
+  class OrthonormalLocalCoefficients
+#if DUNE_VIRTUAL_SHAPEFUNCTIONS
+    : public LocalCoefficientsInterface
+#else
+    : public LocalCoefficientsInterface<OrthonormalLocalCoefficients<static_size> >
+#endif
+  {
+    typedef LocalKeyTable<OrthonormalLocalCoefficients,static_size> Table;
+    friend class LocalKeyTable<OrthonormalLocalCoefficients,static_size>;
+
+  public:
+    //! \brief Standard constructor
+    OrthonormalLocalCoefficients ()
+      : index(Table::keys()), packed(Table::packedKeys())
+    {}
+
+    //! number of coefficients
+    int size () const
+    {
+      return static_size;
+    }
+
+    //! get i'th index
+    const LocalKey& localKey (int i) const
+    {
+      return index[i];
+    }
+
+    //! get i'th index, packed into 32 bits
+    const PackedLocalKey& packedLocalKey (int i) const
+    {
+      return packed[i];
+    }
+
+  private:
+    const LocalKey* index;
+    const PackedLocalKey* packed;
+
+    static void fill (int, LocalKey* keys)
+    {
+      for(int i = 0; i < static_size; ++i)
+        keys[i] = LocalKey(0,0,i);
+    }
+  };
+
+}
+#endif
@@ -0,0 +1,123 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+#ifndef DUNE_ORTHONORMALLOCALINTERPOLATION_HH
+#define DUNE_ORTHONORMALLOCALINTERPOLATION_HH
+
+#include <vector>
+
+#include <dune/common/geometrytype.hh>
+#include <dune/grid/common/quadraturerules.hh>
+
+#include "../common/localinterpolation.hh"
+#include "../common/simd.hh"
+
+namespace Dune
+{
+
+  /** \brief L2 projection onto an orthonormal basis
+
+      Since the mass matrix is the identity, the coefficients are the
+      weighted sums c_i = sum_q w_q phi_i(x_q) f(x_q) over the quadrature
+      rule of order 2p.  The weighted values of the shape functions at the
+      quadrature points only depend on the basis type, so they are
+      computed once and shared by all objects.  Like in
+      MonomLocalInterpolation, they are a function-local static built
+      completely by its constructor, whose initialization the compiler
+      guards against concurrent first use.
+   */
+  template<class LB, GeometryType::BasicType bt>
+  class OrthonormalLocalInterpolation
+    : public LocalInterpolationInterface<OrthonormalLocalInterpolation<LB,bt> >
+  {
+    typedef typename LB::Traits::DomainType D;
+    typedef typename LB::Traits::DomainFieldType DF;
+    static const int dimD=LB::Traits::dimDomain;
+    typedef typename LB::Traits::RangeType R;
+    typedef typename LB::Traits::RangeFieldType RF;
+
+    // the projection is set up with scalars, also if DF and RF are Simd vectors
+    typedef typename SimdTraits<DF>::ValueType DV;
+    typedef typename SimdTraits<RF>::ValueType RV;
+
+    typedef QuadratureRule<DV,dimD> QR;
+    typedef typename QR::iterator QRiterator;
+
+    //! quadrature points and weighted shape functions, stored point-major
+    struct Projection
+    {
+      //! set up the weighted shape functions
+      Projection ()
+      {
+        const LB lb;
+        const QR &qr = QuadratureRules<DV,dimD>::rule(GeometryType(bt,dimD), 2*lb.order());
+
+        positions.resize(qr.size());
+        matrix.resize(qr.size()*LB::N);
+        RV* row = &matrix[0];
+        D* position = &positions[0];
+        Dune::array<R,LB::N> base;
+        const QRiterator qrend = qr.end();
+        for(QRiterator qrit = qr.begin(); qrit != qrend; ++qrit, row += LB::N, ++position) {
+          for(int d = 0; d < dimD; ++d)
+            (*position)[d] = qrit->position()[d];
+          lb.evaluateFunction(*position,base);
+
+          for(unsigned int i = 0; i < LB::N; ++i)
+            row[i] = qrit->weight() * SimdTraits<RF>::lane(base[i][0],0);
+        }
+      }
+
+      std::vector<D> positions;
+      std::vector<RV> matrix;
+    };
+
+  public:
+    //! \brief Standard constructor
+    OrthonormalLocalInterpolation ()
+      : projection(&getProjection())
+    {}
+
+    //! determine coefficients interpolating a given function
+    template<typename F, typename C>
+    void interpolate (const F& f, std::vector<C>& out) const
+    {
+      out.resize(LB::N);
+      interpolate(f,&out[0]);
+    }
+
+    //! determine coefficients into caller-provided storage for LB::N coefficients
+    template<typename F, typename C>
+    void interpolate (const F& f, C* out) const
+    {
+      for(unsigned int i = 0; i < LB::N; ++i)
+        out[i] = 0;
+
+      const RV* row = &projection->matrix[0];
+      for(size_t q = 0; q < projection->positions.size(); ++q, row += LB::N) {
+        R y;
+        f.evaluate(projection->positions[q],y);
+
+        for(unsigned int i = 0; i < LB::N; ++i)
+          out[i] += row[i] * y[0];
+      }
+    }
+
+  private:
+    //! the weighted shape functions, set up on first use
+    static const Projection& getProjection ();
+
+    const Projection* projection;
+  };
+
+  // not inline, such that the instantiations in libdunelocalfunctions are used
+  template<class LB, GeometryType::BasicType bt>
+  const typename OrthonormalLocalInterpolation<LB,bt>::Projection&
+  OrthonormalLocalInterpolation<LB,bt>::getProjection ()
+  {
+    static const Projection projection;
+    return projection;
+  }
+
+}
+
+#endif
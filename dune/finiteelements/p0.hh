@@ -6,6 +6,7 @@
 #include <dune/common/geometrytype.hh>
 
 #include "common/localfiniteelement.hh"
+#include "common/precompiled.hh"
 #include "p0/p0localbasis.hh"
 #include "p0/p0localcoefficients.hh"
 #include "p0/p0localinterpolation.hh"
@@ -18,8 +19,11 @@ namespace Dune
   template<class D, class R, int d>
   class P0LocalFiniteElement : LocalFiniteElementInterface<
                                    LocalFiniteElementTraits<P0LocalBasis<D,R,d>,P0LocalCoefficients,
-                                       P0LocalInterpolation<P0LocalBasis<D,R,d> > >,
-                                   P0LocalFiniteElement<D,R,d> >
+                                       P0LocalInterpolation<P0LocalBasis<D,R,d> > >
+#ifndef DUNE_VIRTUAL_SHAPEFUNCTIONS
+                                   ,P0LocalFiniteElement<D,R,d>
+#endif
+                                   >
   {
   public:
     /** \todo Please doc me !
@@ -69,6 +73,16 @@ namespace Dune
     GeometryType gt;
   };
 
+#if DUNE_LOCALFUNCTIONS_PRECOMPILED && !defined(DUNE_VIRTUAL_SHAPEFUNCTIONS)
+  // instantiated in libdunelocalfunctions, see common/precompiled.hh
+  DUNE_LOCALFUNCTIONS_EXTERN_TEMPLATE class P0LocalBasis<double,double,1>;
+  DUNE_LOCALFUNCTIONS_EXTERN_TEMPLATE class P0LocalBasis<double,double,2>;
+  DUNE_LOCALFUNCTIONS_EXTERN_TEMPLATE class P0LocalBasis<double,double,3>;
+  DUNE_LOCALFUNCTIONS_EXTERN_TEMPLATE class P0LocalBasis<float,float,1>;
+  DUNE_LOCALFUNCTIONS_EXTERN_TEMPLATE class P0LocalBasis<float,float,2>;
+  DUNE_LOCALFUNCTIONS_EXTERN_TEMPLATE class P0LocalBasis<float,float,3>;
+#endif
+
 }
 
 #endif
@@ -23,12 +23,15 @@ namespace Dune
    */
   template<class D, class R, int d>
   class P0LocalBasis :
-    public C1LocalBasisInterface<
+    public C1LocalBasisForwarder<
         C1LocalBasisTraits<D,d,Dune::FieldVector<D,d>,R,1,Dune::FieldVector<R,1>,
             Dune::FieldVector<Dune::FieldVector<R,d>,1> >,
-        P0LocalBasis<D,R,d> >
+        P0LocalBasis<D,R,d>, 1>
   {
   public:
+    //! \brief Number of shape functions as a compile-time constant
+    enum {N = 1};
+
     //! \brief export type traits for function signature
     typedef C1LocalBasisTraits<D,d,Dune::FieldVector<D,d>,R,1,Dune::FieldVector<R,1>,
         Dune::FieldVector<Dune::FieldVector<R,d>,1> > Traits;
@@ -39,31 +42,38 @@ namespace Dune
       return 1;
     }
 
-    //! \brief Evaluate all shape functions
-    inline void evaluateFunction (const typename Traits::DomainType& in,
-                                  std::vector<typename Traits::RangeType>& out) const
-    {
-      out.resize(1);
-      out[0] = 1;
-    }
-
-    //! \brief Evaluate Jacobian of all shape functions
-    inline void
-    evaluateJacobian (const typename Traits::DomainType& in,         // position
-                      std::vector<typename Traits::JacobianType>& out) const      // return value
-    {
-      out.resize(1);
-      for (int i=0; i<d; i++)
-        out[0][0][i] = 0;
-    }
-
     //! \brief Polynomial order of the shape functions
     unsigned int order () const
     {
       return 0;
     }
+
+  private:
+    friend class C1LocalBasisForwarder<Traits,P0LocalBasis,N>;
+
+    void evaluateFunctionAt (const typename Traits::DomainType&,
+                             typename Traits::RangeType* out) const;
+
+    void evaluateJacobianAt (const typename Traits::DomainType&,
+                             typename Traits::JacobianType* out) const;
   };
 
+  // not inline, such that the instantiations in libdunelocalfunctions are used
+  template<class D, class R, int d>
+  void P0LocalBasis<D,R,d>::evaluateFunctionAt (const typename Traits::DomainType&,
+                                                typename Traits::RangeType* out) const
+  {
+    out[0] = 1;
+  }
+
+  template<class D, class R, int d>
+  void P0LocalBasis<D,R,d>::evaluateJacobianAt (const typename Traits::DomainType&,
+                                                typename Traits::JacobianType* out) const
+  {
+    for (int i=0; i<d; i++)
+      out[0][0][i] = 0;
+  }
+
 }
 
 #endif
@@ -16,11 +16,16 @@ namespace Dune
 
          \nosubgrouping
    */
-  class P0LocalCoefficients : public LocalCoefficientsInterface<P0LocalCoefficients>
+  class P0LocalCoefficients
+#if DUNE_VIRTUAL_SHAPEFUNCTIONS
+    : public LocalCoefficientsInterface
+#else
+    : public LocalCoefficientsInterface<P0LocalCoefficients>
+#endif
   {
   public:
     //! \brief Standard constructor
-    P0LocalCoefficients () : index(0,0,0)
+    P0LocalCoefficients () : index(0,0,0), packed(index)
     {}
 
     //! number of coefficients
@@ -35,8 +40,15 @@ namespace Dune
       return index;
     }
 
+    //! get i'th index, packed into 32 bits
+    const PackedLocalKey& packedLocalKey (int) const
+    {
+      return packed;
+    }
+
   private:
     LocalKey index;
+    PackedLocalKey packed;
   };
 
 }
@@ -21,6 +21,14 @@ namespace Dune
     //! determine coefficients interpolating a given function
     template<typename F, typename C>
     void interpolate (const F& f, std::vector<C>& out) const
+    {
+      out.resize(1);
+      interpolate(f,&out[0]);
+    }
+
+    //! \brief Local interpolation into caller-provided storage with room for all coefficients
+    template<typename F, typename C>
+    void interpolate (const F& f, C* out) const
     {
       typedef typename LB::Traits::DomainType DomainType;
       typedef typename LB::Traits::RangeType RangeType;
@@ -30,7 +38,6 @@ namespace Dune
       DomainType x = Dune::ReferenceElements<DF,dim>::general(gt).position(0,0);
       RangeType y;
 
-      out.resize(1);
       f.evaluate(x,y); out[0] = y;
     }
   private:
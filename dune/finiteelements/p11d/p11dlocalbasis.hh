@@ -19,15 +19,15 @@ namespace Dune
    */
   template<class D, class R>
   class P11DLocalBasis :
-    public C1LocalBasisInterface<
+    public C1LocalBasisForwarder<
         C1LocalBasisTraits<D,1,Dune::FieldVector<D,1>,R,1,Dune::FieldVector<R,1>,
-            Dune::FieldVector<Dune::FieldVector<R,1>,1> >
-#ifndef DUNE_VIRTUAL_SHAPEFUNCTIONS
-        , P11DLocalBasis<D,R>
-#endif
-        >
+            Dune::FieldVector<Dune::FieldVector<R,1>,1> >,
+        P11DLocalBasis<D,R>, 2>
   {
   public:
+    //! \brief Number of shape functions as a compile-time constant
+    enum {N = 2};
+
     //! \brief export type traits for function signature
     typedef C1LocalBasisTraits<D,1,Dune::FieldVector<D,1>,R,1,Dune::FieldVector<R,1>,
         Dune::FieldVector<Dune::FieldVector<R,1>,1> > Traits;
@@ -38,30 +38,37 @@ namespace Dune
       return 2;
     }
 
-    //! \brief Evaluate all shape functions
-    inline void evaluateFunction (const typename Traits::DomainType& in,
-                                  std::vector<typename Traits::RangeType>& out) const
-    {
-      out.resize(2);
-      out[0] = 1.0-in[0];
-      out[1] = in[0];
-    }
-
-    //! \brief Evaluate Jacobian of all shape functions
-    inline void
-    evaluateJacobian (const typename Traits::DomainType& in,         // position
-                      std::vector<typename Traits::JacobianType>& out) const      // return value
-    {
-      out.resize(2);
-      out[0][0][0] = -1; // basis function 0
-      out[1][0][0] =  1; // basis function 1
-    }
-
     //! \brief Polynomial order of the shape functions
     unsigned int order () const
     {
       return 1;
     }
+
+  private:
+    friend class C1LocalBasisForwarder<Traits,P11DLocalBasis,N>;
+
+    void evaluateFunctionAt (const typename Traits::DomainType& in,
+                             typename Traits::RangeType* out) const;
+
+    void evaluateJacobianAt (const typename Traits::DomainType&,
+                             typename Traits::JacobianType* out) const;
   };
+
+  // not inline, such that the instantiations in libdunelocalfunctions are used
+  template<class D, class R>
+  void P11DLocalBasis<D,R>::evaluateFunctionAt (const typename Traits::DomainType& in,
+                                                typename Traits::RangeType* out) const
+  {
+    out[0] = 1.0-in[0];
+    out[1] = in[0];
+  }
+
+  template<class D, class R>
+  void P11DLocalBasis<D,R>::evaluateJacobianAt (const typename Traits::DomainType&,
+                                                typename Traits::JacobianType* out) const
+  {
+    out[0][0][0] = -1; // basis function 0
+    out[1][0][0] =  1; // basis function 1
+  }
 }
 #endif
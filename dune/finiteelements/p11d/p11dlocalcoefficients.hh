@@ -21,13 +21,13 @@ namespace Dune
                                 <P11DLocalCoefficients>
 #endif
   {
+    typedef LocalKeyTable<P11DLocalCoefficients,2> Table;
+    friend class LocalKeyTable<P11DLocalCoefficients,2>;
+
   public:
     //! \brief Standard constructor
-    P11DLocalCoefficients () : li(2)
-    {
-      for (int i=0; i<2; i++)
-        li[i] = LocalKey(i,1,0);
-    }
+    P11DLocalCoefficients () : li(Table::keys()), packed(Table::packedKeys())
+    {}
 
     //! number of coefficients
     int size () const
@@ -41,8 +41,21 @@ namespace Dune
       return li[i];
     }
 
+    //! get i'th index, packed into 32 bits
+    const PackedLocalKey& packedLocalKey (int i) const
+    {
+      return packed[i];
+    }
+
   private:
-    std::vector<LocalKey> li;
+    const LocalKey* li;
+    const PackedLocalKey* packed;
+
+    static void fill (int, LocalKey* keys)
+    {
+      for (int i=0; i<2; i++)
+        keys[i] = LocalKey(i,1,0);
+    }
   };
 
 }
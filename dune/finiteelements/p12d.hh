@@ -6,6 +6,7 @@
 #include <dune/common/geometrytype.hh>
 
 #include "common/localfiniteelement.hh"
+#include "common/precompiled.hh"
 #include "p12d/p12dlocalbasis.hh"
 #include "p12d/p12dlocalcoefficients.hh"
 #include "p12d/p12dlocalinterpolation.hh"
@@ -72,6 +73,12 @@ namespace Dune
     GeometryType gt;
   };
 
+#if DUNE_LOCALFUNCTIONS_PRECOMPILED && !defined(DUNE_VIRTUAL_SHAPEFUNCTIONS)
+  // instantiated in libdunelocalfunctions, see common/precompiled.hh
+  DUNE_LOCALFUNCTIONS_EXTERN_TEMPLATE class P12DLocalBasis<double,double>;
+  DUNE_LOCALFUNCTIONS_EXTERN_TEMPLATE class P12DLocalBasis<float,float>;
+#endif
+
 }
 
 #endif
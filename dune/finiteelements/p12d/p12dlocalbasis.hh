@@ -19,15 +19,15 @@ namespace Dune
    */
   template<class D, class R>
   class P12DLocalBasis :
-    public C1LocalBasisInterface<
+    public C1LocalBasisForwarder<
         C1LocalBasisTraits<D,2,Dune::FieldVector<D,2>,R,1,Dune::FieldVector<R,1>,
-            Dune::FieldVector<Dune::FieldVector<R,2>,1> >
-#ifndef DUNE_VIRTUAL_SHAPEFUNCTIONS
-        , P12DLocalBasis<D,R>
-#endif
-        >
+            Dune::FieldVector<Dune::FieldVector<R,2>,1> >,
+        P12DLocalBasis<D,R>, 3>
   {
   public:
+    //! \brief Number of shape functions as a compile-time constant
+    enum {N = 3};
+
     //! \brief export type traits for function signature
     typedef C1LocalBasisTraits<D,2,Dune::FieldVector<D,2>,R,1,Dune::FieldVector<R,1>,
         Dune::FieldVector<Dune::FieldVector<R,2>,1> > Traits;
@@ -38,32 +38,39 @@ namespace Dune
       return 3;
     }
 
-    //! \brief Evaluate all shape functions
-    inline void evaluateFunction (const typename Traits::DomainType& in,
-                                  std::vector<typename Traits::RangeType>& out) const
-    {
-      out.resize(3);
-      out[0] = 1.0-in[0]-in[1];
-      out[1] = in[0];
-      out[2] = in[1];
-    }
-
-    //! \brief Evaluate Jacobian of all shape functions
-    inline void
-    evaluateJacobian (const typename Traits::DomainType& in,         // position
-                      std::vector<typename Traits::JacobianType>& out) const      // return value
-    {
-      out.resize(3);
-      out[0][0][0] = -1; out[0][0][1] = -1; // basis function 0
-      out[1][0][0] =  1; out[1][0][1] =  0; // basis function 1
-      out[2][0][0] =  0; out[2][0][1] =  1; // basis function 2
-    }
-
     //! \brief Polynomial order of the shape functions
     unsigned int order () const
     {
       return 1;
     }
+
+  private:
+    friend class C1LocalBasisForwarder<Traits,P12DLocalBasis,N>;
+
+    void evaluateFunctionAt (const typename Traits::DomainType& in,
+                             typename Traits::RangeType* out) const;
+
+    void evaluateJacobianAt (const typename Traits::DomainType&,
+                             typename Traits::JacobianType* out) const;
   };
+
+  // not inline, such that the instantiations in libdunelocalfunctions are used
+  template<class D, class R>
+  void P12DLocalBasis<D,R>::evaluateFunctionAt (const typename Traits::DomainType& in,
+                                                typename Traits::RangeType* out) const
+  {
+    out[0] = 1.0-in[0]-in[1];
+    out[1] = in[0];
+    out[2] = in[1];
+  }
+
+  template<class D, class R>
+  void P12DLocalBasis<D,R>::evaluateJacobianAt (const typename Traits::DomainType&,
+                                                typename Traits::JacobianType* out) const
+  {
+    out[0][0][0] = -1; out[0][0][1] = -1; // basis function 0
+    out[1][0][0] =  1; out[1][0][1] =  0; // basis function 1
+    out[2][0][0] =  0; out[2][0][1] =  1; // basis function 2
+  }
 }
 #endif
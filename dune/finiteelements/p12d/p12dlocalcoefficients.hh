@@ -21,13 +21,13 @@ namespace Dune
                                 <P12DLocalCoefficients>
 #endif
   {
+    typedef LocalKeyTable<P12DLocalCoefficients,3> Table;
+    friend class LocalKeyTable<P12DLocalCoefficients,3>;
+
   public:
     //! \brief Standard constructor
-    P12DLocalCoefficients () : li(3)
-    {
-      for (int i=0; i<3; i++)
-        li[i] = LocalKey(i,2,0);
-    }
+    P12DLocalCoefficients () : li(Table::keys()), packed(Table::packedKeys())
+    {}
 
     //! number of coefficients
     int size () const
@@ -41,8 +41,21 @@ namespace Dune
       return li[i];
     }
 
+    //! get i'th index, packed into 32 bits
+    const PackedLocalKey& packedLocalKey (int i) const
+    {
+      return packed[i];
+    }
+
   private:
-    std::vector<LocalKey> li;
+    const LocalKey* li;
+    const PackedLocalKey* packed;
+
+    static void fill (int, LocalKey* keys)
+    {
+      for (int i=0; i<3; i++)
+        keys[i] = LocalKey(i,2,0);
+    }
   };
 
 }
@@ -22,10 +22,17 @@ namespace Dune
     //! \brief Local interpolation of a function
     template<typename F, typename C>
     void interpolate (const F& f, std::vector<C>& out) const
+    {
+      out.resize(3);
+      interpolate(f,&out[0]);
+    }
+
+    //! \brief Local interpolation into caller-provided storage with room for all coefficients
+    template<typename F, typename C>
+    void interpolate (const F& f, C* out) const
     {
       typename LB::Traits::RangeType y;
 
-      out.resize(3);
       f.evaluate(x[0],y); out[0] = y;
       f.evaluate(x[1],y); out[1] = y;
       f.evaluate(x[2],y); out[2] = y;
@@ -6,6 +6,7 @@
 #include <dune/common/geometrytype.hh>
 
 #include "common/localfiniteelement.hh"
+#include "common/precompiled.hh"
 #include "p13d/p13dlocalbasis.hh"
 #include "p13d/p13dlocalcoefficients.hh"
 #include "p13d/p13dlocalinterpolation.hh"
@@ -72,6 +73,12 @@ namespace Dune
     GeometryType gt;
   };
 
+#if DUNE_LOCALFUNCTIONS_PRECOMPILED && !defined(DUNE_VIRTUAL_SHAPEFUNCTIONS)
+  // instantiated in libdunelocalfunctions, see common/precompiled.hh
+  DUNE_LOCALFUNCTIONS_EXTERN_TEMPLATE class P13DLocalBasis<double,double>;
+  DUNE_LOCALFUNCTIONS_EXTERN_TEMPLATE class P13DLocalBasis<float,float>;
+#endif
+
 }
 
 #endif
@@ -19,15 +19,15 @@ namespace Dune
    */
   template<class D, class R>
   class P13DLocalBasis :
-    public C1LocalBasisInterface<
+    public C1LocalBasisForwarder<
         C1LocalBasisTraits<D,3,Dune::FieldVector<D,3>,R,1,Dune::FieldVector<R,1>,
-            Dune::FieldVector<Dune::FieldVector<R,3>,1> >
-#ifndef DUNE_VIRTUAL_SHAPEFUNCTIONS
-        , P13DLocalBasis<D,R>
-#endif
-        >
+            Dune::FieldVector<Dune::FieldVector<R,3>,1> >,
+        P13DLocalBasis<D,R>, 4>
   {
   public:
+    //! \brief Number of shape functions as a compile-time constant
+    enum {N = 4};
+
     //! \brief export type traits for function signature
     typedef C1LocalBasisTraits<D,3,Dune::FieldVector<D,3>,R,1,Dune::FieldVector<R,1>,
         Dune::FieldVector<Dune::FieldVector<R,3>,1> > Traits;
@@ -38,34 +38,41 @@ namespace Dune
       return 4;
     }
 
-    //! \brief Evaluate all shape functions
-    inline void evaluateFunction (const typename Traits::DomainType& in,
-                                  std::vector<typename Traits::RangeType>& out) const
-    {
-      out.resize(4);
-      out[0] = 1.0-in[0]-in[1]-in[2];
-      out[1] = in[0];
-      out[2] = in[1];
-      out[3] = in[2];
-    }
-
-    //! \brief Evaluate Jacobian of all shape functions
-    inline void
-    evaluateJacobian (const typename Traits::DomainType& in,         // position
-                      std::vector<typename Traits::JacobianType>& out) const      // return value
-    {
-      out.resize(4);
-      out[0][0][0] = -1; out[0][0][1] = -1; out[0][0][2] = -1; // basis function 0
-      out[1][0][0] =  1; out[1][0][1] =  0; out[1][0][2] =  0; // basis function 1
-      out[2][0][0] =  0; out[2][0][1] =  1; out[2][0][2] =  0; // basis function 2
-      out[3][0][0] =  0; out[3][0][1] =  0; out[3][0][2] =  1; // basis function 3
-    }
-
     //! \brief Polynomial order of the shape functions
     unsigned int order () const
     {
       return 1;
     }
+
+  private:
+    friend class C1LocalBasisForwarder<Traits,P13DLocalBasis,N>;
+
+    void evaluateFunctionAt (const typename Traits::DomainType& in,
+                             typename Traits::RangeType* out) const;
+
+    void evaluateJacobianAt (const typename Traits::DomainType&,
+                             typename Traits::JacobianType* out) const;
   };
+
+  // not inline, such that the instantiations in libdunelocalfunctions are used
+  template<class D, class R>
+  void P13DLocalBasis<D,R>::evaluateFunctionAt (const typename Traits::DomainType& in,
+                                                typename Traits::RangeType* out) const
+  {
+    out[0] = 1.0-in[0]-in[1]-in[2];
+    out[1] = in[0];
+    out[2] = in[1];
+    out[3] = in[2];
+  }
+
+  template<class D, class R>
+  void P13DLocalBasis<D,R>::evaluateJacobianAt (const typename Traits::DomainType&,
+                                                typename Traits::JacobianType* out) const
+  {
+    out[0][0][0] = -1; out[0][0][1] = -1; out[0][0][2] = -1; // basis function 0
+    out[1][0][0] =  1; out[1][0][1] =  0; out[1][0][2] =  0; // basis function 1
+    out[2][0][0] =  0; out[2][0][1] =  1; out[2][0][2] =  0; // basis function 2
+    out[3][0][0] =  0; out[3][0][1] =  0; out[3][0][2] =  1; // basis function 3
+  }
 }
 #endif
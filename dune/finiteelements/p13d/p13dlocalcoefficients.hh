@@ -21,13 +21,13 @@ namespace Dune
                                 <P13DLocalCoefficients>
 #endif
   {
+    typedef LocalKeyTable<P13DLocalCoefficients,4> Table;
+    friend class LocalKeyTable<P13DLocalCoefficients,4>;
+
   public:
     //! \brief Standard constructor
-    P13DLocalCoefficients () : li(4)
-    {
-      for (int i=0; i<4; i++)
-        li[i] = LocalKey(i,3,0);
-    }
+    P13DLocalCoefficients () : li(Table::keys()), packed(Table::packedKeys())
+    {}
 
     //! number of coefficients
     int size () const
@@ -41,8 +41,21 @@ namespace Dune
       return li[i];
     }
 
+    //! get i'th index, packed into 32 bits
+    const PackedLocalKey& packedLocalKey (int i) const
+    {
+      return packed[i];
+    }
+
   private:
-    std::vector<LocalKey> li;
+    const LocalKey* li;
+    const PackedLocalKey* packed;
+
+    static void fill (int, LocalKey* keys)
+    {
+      for (int i=0; i<4; i++)
+        keys[i] = LocalKey(i,3,0);
+    }
   };
 
 }
@@ -6,6 +6,7 @@
 #include <dune/common/geometrytype.hh>
 
 #include "common/localfiniteelement.hh"
+#include "common/precompiled.hh"
 #include "p23d/p23dlocalbasis.hh"
 #include "p23d/p23dlocalcoefficients.hh"
 #include "p23d/p23dlocalinterpolation.hh"
@@ -73,6 +74,12 @@ namespace Dune
     GeometryType gt;
   };
 
+#if DUNE_LOCALFUNCTIONS_PRECOMPILED && !defined(DUNE_VIRTUAL_SHAPEFUNCTIONS)
+  // instantiated in libdunelocalfunctions, see common/precompiled.hh
+  DUNE_LOCALFUNCTIONS_EXTERN_TEMPLATE class P23DLocalBasis<double,double>;
+  DUNE_LOCALFUNCTIONS_EXTERN_TEMPLATE class P23DLocalBasis<float,float>;
+#endif
+
 }
 
 #endif
@@ -3,6 +3,8 @@
 #ifndef DUNE_P2_3DLOCALBASIS_HH
 #define DUNE_P2_3DLOCALBASIS_HH
 
+#include <cassert>
+
 #include "../common/localbasis.hh"
 
 namespace Dune
@@ -19,15 +21,15 @@ namespace Dune
    */
   template<class D, class R>
   class P23DLocalBasis :
-    public C1LocalBasisInterface<
+    public C1LocalBasisForwarder<
         C1LocalBasisTraits<D,3,Dune::FieldVector<D,3>,R,1,Dune::FieldVector<R,1>,
-            Dune::FieldVector<Dune::FieldVector<R,3>,1> >
-#ifndef DUNE_VIRTUAL_SHAPEFUNCTIONS
-        , P23DLocalBasis<D,R>
-#endif
-        >
+            Dune::FieldVector<Dune::FieldVector<R,3>,1> >,
+        P23DLocalBasis<D,R>, 10>
   {
   public:
+    //! \brief Number of shape functions as a compile-time constant
+    enum {N = 10};
+
     //! \brief export type traits for function signature
     typedef C1LocalBasisTraits<D,3,Dune::FieldVector<D,3>,R,1,Dune::FieldVector<R,1>,
         Dune::FieldVector<Dune::FieldVector<R,3>,1> > Traits;
@@ -38,365 +40,36 @@ namespace Dune
       return 10;
     }
 
-    //! \brief Evaluate all shape functions
-    inline void evaluateFunction (const typename Traits::DomainType& in,
-                                  std::vector<typename Traits::RangeType>& out) const
+    //! \brief Evaluate all shape functions and their partial derivatives up to order r
+    template<int r>
+    inline void evaluateJet (const typename Traits::DomainType& in,
+                             std::vector<LocalBasisJet<Traits,r> >& out) const
     {
-      out.resize(10);
-
-      int coeff;
-      R a[2], b[3], c[3];
-
-      // case 0:
-      coeff=2;
-      a[0]=1.0;
-      a[1]=0.5;
-      b[0]=-1.0;
-      b[1]=-1.0;
-      b[2]=-1.0;
-      c[0]=-1.0;
-      c[1]=-1.0;
-      c[2]=-1.0;
-
-      out[0] = coeff * (a[0] + b[0]*in[0] + b[1]*in[1] + b[2]*in[2]) * (a[1] + c[0]*in[0] + c[1]*in[1] + c[2]*in[2]);
-
-      // case 1:
-      coeff=2;
-      a[0]=0.0;
-      a[1]=-0.5;
-      b[0]=1.0;
-      b[1]=0.0;
-      b[2]=0.0;
-      c[0]=1.0;
-      c[1]=0.0;
-      c[2]=0.0;
-
-      out[1] = coeff * (a[0] + b[0]*in[0] + b[1]*in[1] + b[2]*in[2]) * (a[1] + c[0]*in[0] + c[1]*in[1] + c[2]*in[2]);
-
-      // case 2:
-      coeff=2;
-      a[0]=0.0;
-      a[1]=-0.5;
-      b[0]=0.0;
-      b[1]=1.0;
-      b[2]=0.0;
-      c[0]=0.0;
-      c[1]=1.0;
-      c[2]=0.0;
-
-      out[2] = coeff * (a[0] + b[0]*in[0] + b[1]*in[1] + b[2]*in[2]) * (a[1] + c[0]*in[0] + c[1]*in[1] + c[2]*in[2]);
-
-      // case 3:
-      coeff=2;
-      a[0]=0.0;
-      a[1]=-0.5;
-      b[0]=0.0;
-      b[1]=0.0;
-      b[2]=1.0;
-      c[0]=0.0;
-      c[1]=0.0;
-      c[2]=1.0;
-
-      out[3] = coeff * (a[0] + b[0]*in[0] + b[1]*in[1] + b[2]*in[2]) * (a[1] + c[0]*in[0] + c[1]*in[1] + c[2]*in[2]);
-
-      // case 4:
-      coeff=4;
-      a[0]=0.0;
-      a[1]=1.0;
-      b[0]=1.0;
-      b[1]=0.0;
-      b[2]=0.0;
-      c[0]=-1.0;
-      c[1]=-1.0;
-      c[2]=-1.0;
-
-      out[4] = coeff * (a[0] + b[0]*in[0] + b[1]*in[1] + b[2]*in[2]) * (a[1] + c[0]*in[0] + c[1]*in[1] + c[2]*in[2]);
-
-      // case 5:
-      coeff=4;
-      a[0]=0.0;
-      a[1]=0.0;
-      b[0]=1.0;
-      b[1]=0.0;
-      b[2]=0.0;
-      c[0]=0.0;
-      c[1]=1.0;
-      c[2]=0.0;
-
-      out[5] = coeff * (a[0] + b[0]*in[0] + b[1]*in[1] + b[2]*in[2]) * (a[1] + c[0]*in[0] + c[1]*in[1] + c[2]*in[2]);
-
-      // case 6:
-      coeff=4;
-      a[0]=0.0;
-      a[1]=1.0;
-      b[0]=0.0;
-      b[1]=1.0;
-      b[2]=0.0;
-      c[0]=-1.0;
-      c[1]=-1.0;
-      c[2]=-1.0;
-
-      out[6] = coeff * (a[0] + b[0]*in[0] + b[1]*in[1] + b[2]*in[2]) * (a[1] + c[0]*in[0] + c[1]*in[1] + c[2]*in[2]);
-
-      // case 7:
-      coeff=4;
-      a[0]=0.0;
-      a[1]=1.0;
-      b[0]=0.0;
-      b[1]=0.0;
-      b[2]=1.0;
-      c[0]=-1.0;
-      c[1]=-1.0;
-      c[2]=-1.0;
-
-      out[7] = coeff * (a[0] + b[0]*in[0] + b[1]*in[1] + b[2]*in[2]) * (a[1] + c[0]*in[0] + c[1]*in[1] + c[2]*in[2]);
-
-      // case 8:
-      coeff=4;
-      a[0]=0.0;
-      a[1]=0.0;
-      b[0]=1.0;
-      b[1]=0.0;
-      b[2]=0.0;
-      c[0]=0.0;
-      c[1]=0.0;
-      c[2]=1.0;
-
-      out[8] = coeff * (a[0] + b[0]*in[0] + b[1]*in[1] + b[2]*in[2]) * (a[1] + c[0]*in[0] + c[1]*in[1] + c[2]*in[2]);
-
-      // case 9:
-      coeff=4;
-      a[0]=0.0;
-      a[1]=0.0;
-      b[0]=0.0;
-      b[1]=1.0;
-      b[2]=0.0;
-      c[0]=0.0;
-      c[1]=0.0;
-      c[2]=1.0;
-
-      out[9] = coeff * (a[0] + b[0]*in[0] + b[1]*in[1] + b[2]*in[2]) * (a[1] + c[0]*in[0] + c[1]*in[1] + c[2]*in[2]);
-
+      out.resize(N);
+      evaluateJetAt<r>(in,&out[0]);
     }
 
-    //! \brief Evaluate Jacobian of all shape functions
-    inline void
-    evaluateJacobian (const typename Traits::DomainType& in,         // position
-                      std::vector<typename Traits::JacobianType>& out) const      // return value
+    //! \brief Evaluate the jets of all shape functions into caller-provided storage with room for \a capacity >= N values
+    template<int r>
+    inline void evaluateJet (const typename Traits::DomainType& in,
+                             LocalBasisJet<Traits,r>* out,
+                             unsigned int capacity) const
     {
-      out.resize(10);
-
-      R aa[3][3], bb[3][3];
-      // case 0:
-      //x derivative
-      aa[0][0]=-3.0;
-      bb[0][0]=4.0;
-      bb[1][0]=4.0;
-      bb[2][0]=4.0;
-      //y derivative
-      aa[0][1]=-3.0;
-      bb[0][1]=4.0;
-      bb[1][1]=4.0;
-      bb[2][1]=4.0;
-      // z derivative
-      aa[0][2]=-3.0;
-      bb[0][2]=4.0;
-      bb[1][2]=4.0;
-      bb[2][2]=4.0;
-
-      out[0][0][0] = aa[0][0] + bb[0][0]*in[0] + bb[1][0]*in[1] + bb[2][0]*in[2];
-      out[0][0][1] = aa[0][1] + bb[0][1]*in[0] + bb[1][1]*in[1] + bb[2][1]*in[2];
-      out[0][0][2] = aa[0][2] + bb[0][2]*in[0] + bb[1][2]*in[1] + bb[2][2]*in[2];
-
-      //case 1:
-      //x derivative
-      aa[0][0]=-1.0;
-      bb[0][0]=4.0;
-      bb[1][0]=0.0;
-      bb[2][0]=0.0;
-      //y derivative
-      aa[0][1]=0.0;
-      bb[0][1]=0.0;
-      bb[1][1]=0.0;
-      bb[2][1]=0.0;
-      // z derivative
-      aa[0][2]=0.0;
-      bb[0][2]=0.0;
-      bb[1][2]=0.0;
-      bb[2][2]=0.0;
-
-      out[1][0][0] = aa[0][0] + bb[0][0]*in[0] + bb[1][0]*in[1] + bb[2][0]*in[2];
-      out[1][0][1] = aa[0][1] + bb[0][1]*in[0] + bb[1][1]*in[1] + bb[2][1]*in[2];
-      out[1][0][2] = aa[0][2] + bb[0][2]*in[0] + bb[1][2]*in[1] + bb[2][2]*in[2];
-
-      // case 2:
-      //x derivative
-      aa[0][0]=0.0;
-      bb[0][0]=0.0;
-      bb[1][0]=0.0;
-      bb[2][0]=0.0;
-      //y derivative
-      aa[0][1]=-1.0;
-      bb[0][1]=0.0;
-      bb[1][1]=4.0;
-      bb[2][1]=0.0;
-      // z derivative
-      aa[0][2]=0.0;
-      bb[0][2]=0.0;
-      bb[1][2]=0.0;
-      bb[2][2]=0.0;
-
-      out[2][0][0] = aa[0][0] + bb[0][0]*in[0] + bb[1][0]*in[1] + bb[2][0]*in[2];
-      out[2][0][1] = aa[0][1] + bb[0][1]*in[0] + bb[1][1]*in[1] + bb[2][1]*in[2];
-      out[2][0][2] = aa[0][2] + bb[0][2]*in[0] + bb[1][2]*in[1] + bb[2][2]*in[2];
-
-      // case 3:
-      //x derivative
-      aa[0][0]=0.0;
-      bb[0][0]=0.0;
-      bb[1][0]=0.0;
-      bb[2][0]=0.0;
-      //y derivative
-      aa[0][1]=0.0;
-      bb[0][1]=0.0;
-      bb[1][1]=0.0;
-      bb[2][1]=0.0;
-      // z derivative
-      aa[0][2]=-1.0;
-      bb[0][2]=0.0;
-      bb[1][2]=0.0;
-      bb[2][2]=4.0;
-
-      out[3][0][0] = aa[0][0] + bb[0][0]*in[0] + bb[1][0]*in[1] + bb[2][0]*in[2];
-      out[3][0][1] = aa[0][1] + bb[0][1]*in[0] + bb[1][1]*in[1] + bb[2][1]*in[2];
-      out[3][0][2] = aa[0][2] + bb[0][2]*in[0] + bb[1][2]*in[1] + bb[2][2]*in[2];
-
-      // case 4:
-      //x derivative
-      aa[0][0]=4.0;
-      bb[0][0]=-8.0;
-      bb[1][0]=-4.0;
-      bb[2][0]=-4.0;
-      //y derivative
-      aa[0][1]=0.0;
-      bb[0][1]=-4.0;
-      bb[1][1]=0.0;
-      bb[2][1]=0.0;
-      // z derivative
-      aa[0][2]=0.0;
-      bb[0][2]=-4.0;
-      bb[1][2]=0.0;
-      bb[2][2]=0.0;
-
-      out[4][0][0] = aa[0][0] + bb[0][0]*in[0] + bb[1][0]*in[1] + bb[2][0]*in[2];
-      out[4][0][1] = aa[0][1] + bb[0][1]*in[0] + bb[1][1]*in[1] + bb[2][1]*in[2];
-      out[4][0][2] = aa[0][2] + bb[0][2]*in[0] + bb[1][2]*in[1] + bb[2][2]*in[2];
-
-      // case 5:
-      //x derivative
-      aa[0][0]=0.0;
-      bb[0][0]=0.0;
-      bb[1][0]=4.0;
-      bb[2][0]=0.0;
-      //y derivative
-      aa[0][1]=0.0;
-      bb[0][1]=4.0;
-      bb[1][1]=0.0;
-      bb[2][1]=0.0;
-      // z derivative
-      aa[0][2]=0.0;
-      bb[0][2]=0.0;
-      bb[1][2]=0.0;
-      bb[2][2]=0.0;
-
-      out[5][0][0] = aa[0][0] + bb[0][0]*in[0] + bb[1][0]*in[1] + bb[2][0]*in[2];
-      out[5][0][1] = aa[0][1] + bb[0][1]*in[0] + bb[1][1]*in[1] + bb[2][1]*in[2];
-      out[5][0][2] = aa[0][2] + bb[0][2]*in[0] + bb[1][2]*in[1] + bb[2][2]*in[2];
-
-      // case 6:
-      //x derivative
-      aa[0][0]=0.0;
-      bb[0][0]=0.0;
-      bb[1][0]=-4.0;
-      bb[2][0]=0.0;
-      //y derivative
-      aa[0][1]=4.0;
-      bb[0][1]=-4.0;
-      bb[1][1]=-8.0;
-      bb[2][1]=-4.0;
-      // z derivative
-      aa[0][2]=0.0;
-      bb[0][2]=0.0;
-      bb[1][2]=-4.0;
-      bb[2][2]=0.0;
-
-      out[6][0][0] = aa[0][0] + bb[0][0]*in[0] + bb[1][0]*in[1] + bb[2][0]*in[2];
-      out[6][0][1] = aa[0][1] + bb[0][1]*in[0] + bb[1][1]*in[1] + bb[2][1]*in[2];
-      out[6][0][2] = aa[0][2] + bb[0][2]*in[0] + bb[1][2]*in[1] + bb[2][2]*in[2];
-
-      // case 7:
-      //x derivative
-      aa[0][0]=0.0;
-      bb[0][0]=0.0;
-      bb[1][0]=0.0;
-      bb[2][0]=-4.0;
-      //y derivative
-      aa[0][1]=0.0;
-      bb[0][1]=0.0;
-      bb[1][1]=0.0;
-      bb[2][1]=-4.0;
-      // z derivative
-      aa[0][2]=4.0;
-      bb[0][2]=-4.0;
-      bb[1][2]=-4.0;
-      bb[2][2]=-8.0;
-
-      out[7][0][0] = aa[0][0] + bb[0][0]*in[0] + bb[1][0]*in[1] + bb[2][0]*in[2];
-      out[7][0][1] = aa[0][1] + bb[0][1]*in[0] + bb[1][1]*in[1] + bb[2][1]*in[2];
-      out[7][0][2] = aa[0][2] + bb[0][2]*in[0] + bb[1][2]*in[1] + bb[2][2]*in[2];
-
-      //case 8:
-      //x derivative
-      aa[0][0]=0.0;
-      bb[0][0]=0.0;
-      bb[1][0]=0.0;
-      bb[2][0]=4.0;
-      //y derivative
-      aa[0][1]=0.0;
-      bb[0][1]=0.0;
-      bb[1][1]=0.0;
-      bb[2][1]=0.0;
-      // z derivative
-      aa[0][2]=0.0;
-      bb[0][2]=4.0;
-      bb[1][2]=0.0;
-      bb[2][2]=0.0;
-
-      out[8][0][0] = aa[0][0] + bb[0][0]*in[0] + bb[1][0]*in[1] + bb[2][0]*in[2];
-      out[8][0][1] = aa[0][1] + bb[0][1]*in[0] + bb[1][1]*in[1] + bb[2][1]*in[2];
-      out[8][0][2] = aa[0][2] + bb[0][2]*in[0] + bb[1][2]*in[1] + bb[2][2]*in[2];
-
-      // case 9:
-      //x derivative
-      aa[0][0]=0.0;
-      bb[0][0]=0.0;
-      bb[1][0]=0.0;
-      bb[2][0]=0.0;
-      //y derivative
-      aa[0][1]=0.0;
-      bb[0][1]=0.0;
-      bb[1][1]=0.0;
-      bb[2][1]=4.0;
-      // z derivative
-      aa[0][2]=0.0;
-      bb[0][2]=0.0;
-      bb[1][2]=4.0;
-      bb[2][2]=0.0;
-
-      out[9][0][0] = aa[0][0] + bb[0][0]*in[0] + bb[1][0]*in[1] + bb[2][0]*in[2];
-      out[9][0][1] = aa[0][1] + bb[0][1]*in[0] + bb[1][1]*in[1] + bb[2][1]*in[2];
-      out[9][0][2] = aa[0][2] + bb[0][2]*in[0] + bb[1][2]*in[1] + bb[2][2]*in[2];
+      assert(capacity >= N);
+      evaluateJetAt<r>(in,out);
+    }
 
+    //! \brief Evaluate the derivative of all shape functions in the given directions, of order r <= 3
+    template<int r>
+    inline void evaluate (const Dune::array<int,r>& directions,
+                          const typename Traits::DomainType& in,
+                          std::vector<typename Traits::RangeType>& out) const
+    {
+      LocalBasisJet<Traits,r> jets[N];
+      evaluateJetAt<r>(in,jets);
+      out.resize(N);
+      for (int i=0; i<N; i++)
+        out[i] = LocalBasisJetImp::derivative(jets[i],directions);
     }
 
     //! \brief Polynomial order of the shape functions
@@ -404,6 +77,448 @@ namespace Dune
     {
       return 2;
     }
+
+  private:
+    friend class C1LocalBasisForwarder<Traits,P23DLocalBasis,N>;
+
+    void evaluateFunctionAt (const typename Traits::DomainType& in,
+                             typename Traits::RangeType* out) const;
+
+    void evaluateJacobianAt (const typename Traits::DomainType& in,
+                             typename Traits::JacobianType* out) const;
+
+    void evaluateFunctionAndJacobianAt (const typename Traits::DomainType& in,
+                                        typename Traits::RangeType* values,
+                                        typename Traits::JacobianType* jacobians) const;
+
+    /* Partial derivatives of l_a (2 l_a - 1) if a == b, and of 4 l_a l_b
+       otherwise, with the barycentric coordinates l and their gradients grad */
+    struct Partial
+    {
+      R operator() (int r, const int* directions) const
+      {
+        switch (r)
+        {
+        case 0 :
+          return (a == b) ? l[a]*(2*l[a]-1) : 4*l[a]*l[b];
+        case 1 :
+          if (a == b)
+            return (4*l[a]-1)*grad[a][directions[0]];
+          return 4*(l[b]*grad[a][directions[0]] + l[a]*grad[b][directions[0]]);
+        case 2 :
+          return 4*(grad[a][directions[0]]*grad[b][directions[1]]
+                    + (a == b ? 0 : grad[b][directions[0]]*grad[a][directions[1]]));
+        default :
+          return 0;
+        }
+      }
+
+      const R* l;
+      const R (*grad)[3];
+      int a, b;
+    };
+
+    template<int r>
+    inline void evaluateJetAt (const typename Traits::DomainType& in,
+                               LocalBasisJet<Traits,r>* out) const
+    {
+      const R l[4] = { 1-in[0]-in[1]-in[2], in[0], in[1], in[2] };
+      static const R grad[4][3] = { {-1,-1,-1}, {1,0,0}, {0,1,0}, {0,0,1} };
+      static const int edge[6][2] = { {0,1}, {1,2}, {0,2}, {0,3}, {1,3}, {2,3} };
+
+      Partial partial;
+      partial.l = l;
+      partial.grad = grad;
+      for (int i=0; i<10; i++)
+      {
+        partial.a = (i < 4) ? i : edge[i-4][0];
+        partial.b = (i < 4) ? i : edge[i-4][1];
+        LocalBasisJetImp::fill(partial,out[i]);
+      }
+    }
   };
+
+  // not inline, such that the instantiations in libdunelocalfunctions are used
+  template<class D, class R>
+  void P23DLocalBasis<D,R>::evaluateFunctionAt (const typename Traits::DomainType& in,
+                                                typename Traits::RangeType* out) const
+  {
+    int coeff;
+    R a[2], b[3], c[3];
+
+    // case 0:
+    coeff=2;
+    a[0]=1.0;
+    a[1]=0.5;
+    b[0]=-1.0;
+    b[1]=-1.0;
+    b[2]=-1.0;
+    c[0]=-1.0;
+    c[1]=-1.0;
+    c[2]=-1.0;
+
+    out[0] = coeff * (a[0] + b[0]*in[0] + b[1]*in[1] + b[2]*in[2]) * (a[1] + c[0]*in[0] + c[1]*in[1] + c[2]*in[2]);
+
+    // case 1:
+    coeff=2;
+    a[0]=0.0;
+    a[1]=-0.5;
+    b[0]=1.0;
+    b[1]=0.0;
+    b[2]=0.0;
+    c[0]=1.0;
+    c[1]=0.0;
+    c[2]=0.0;
+
+    out[1] = coeff * (a[0] + b[0]*in[0] + b[1]*in[1] + b[2]*in[2]) * (a[1] + c[0]*in[0] + c[1]*in[1] + c[2]*in[2]);
+
+    // case 2:
+    coeff=2;
+    a[0]=0.0;
+    a[1]=-0.5;
+    b[0]=0.0;
+    b[1]=1.0;
+    b[2]=0.0;
+    c[0]=0.0;
+    c[1]=1.0;
+    c[2]=0.0;
+
+    out[2] = coeff * (a[0] + b[0]*in[0] + b[1]*in[1] + b[2]*in[2]) * (a[1] + c[0]*in[0] + c[1]*in[1] + c[2]*in[2]);
+
+    // case 3:
+    coeff=2;
+    a[0]=0.0;
+    a[1]=-0.5;
+    b[0]=0.0;
+    b[1]=0.0;
+    b[2]=1.0;
+    c[0]=0.0;
+    c[1]=0.0;
+    c[2]=1.0;
+
+    out[3] = coeff * (a[0] + b[0]*in[0] + b[1]*in[1] + b[2]*in[2]) * (a[1] + c[0]*in[0] + c[1]*in[1] + c[2]*in[2]);
+
+    // case 4:
+    coeff=4;
+    a[0]=0.0;
+    a[1]=1.0;
+    b[0]=1.0;
+    b[1]=0.0;
+    b[2]=0.0;
+    c[0]=-1.0;
+    c[1]=-1.0;
+    c[2]=-1.0;
+
+    out[4] = coeff * (a[0] + b[0]*in[0] + b[1]*in[1] + b[2]*in[2]) * (a[1] + c[0]*in[0] + c[1]*in[1] + c[2]*in[2]);
+
+    // case 5:
+    coeff=4;
+    a[0]=0.0;
+    a[1]=0.0;
+    b[0]=1.0;
+    b[1]=0.0;
+    b[2]=0.0;
+    c[0]=0.0;
+    c[1]=1.0;
+    c[2]=0.0;
+
+    out[5] = coeff * (a[0] + b[0]*in[0] + b[1]*in[1] + b[2]*in[2]) * (a[1] + c[0]*in[0] + c[1]*in[1] + c[2]*in[2]);
+
+    // case 6:
+    coeff=4;
+    a[0]=0.0;
+    a[1]=1.0;
+    b[0]=0.0;
+    b[1]=1.0;
+    b[2]=0.0;
+    c[0]=-1.0;
+    c[1]=-1.0;
+    c[2]=-1.0;
+
+    out[6] = coeff * (a[0] + b[0]*in[0] + b[1]*in[1] + b[2]*in[2]) * (a[1] + c[0]*in[0] + c[1]*in[1] + c[2]*in[2]);
+
+    // case 7:
+    coeff=4;
+    a[0]=0.0;
+    a[1]=1.0;
+    b[0]=0.0;
+    b[1]=0.0;
+    b[2]=1.0;
+    c[0]=-1.0;
+    c[1]=-1.0;
+    c[2]=-1.0;
+
+    out[7] = coeff * (a[0] + b[0]*in[0] + b[1]*in[1] + b[2]*in[2]) * (a[1] + c[0]*in[0] + c[1]*in[1] + c[2]*in[2]);
+
+    // case 8:
+    coeff=4;
+    a[0]=0.0;
+    a[1]=0.0;
+    b[0]=1.0;
+    b[1]=0.0;
+    b[2]=0.0;
+    c[0]=0.0;
+    c[1]=0.0;
+    c[2]=1.0;
+
+    out[8] = coeff * (a[0] + b[0]*in[0] + b[1]*in[1] + b[2]*in[2]) * (a[1] + c[0]*in[0] + c[1]*in[1] + c[2]*in[2]);
+
+    // case 9:
+    coeff=4;
+    a[0]=0.0;
+    a[1]=0.0;
+    b[0]=0.0;
+    b[1]=1.0;
+    b[2]=0.0;
+    c[0]=0.0;
+    c[1]=0.0;
+    c[2]=1.0;
+
+    out[9] = coeff * (a[0] + b[0]*in[0] + b[1]*in[1] + b[2]*in[2]) * (a[1] + c[0]*in[0] + c[1]*in[1] + c[2]*in[2]);
+  }
+
+  template<class D, class R>
+  void P23DLocalBasis<D,R>::evaluateJacobianAt (const typename Traits::DomainType& in,
+                                                typename Traits::JacobianType* out) const
+  {
+    R aa[3][3], bb[3][3];
+    // case 0:
+    //x derivative
+    aa[0][0]=-3.0;
+    bb[0][0]=4.0;
+    bb[1][0]=4.0;
+    bb[2][0]=4.0;
+    //y derivative
+    aa[0][1]=-3.0;
+    bb[0][1]=4.0;
+    bb[1][1]=4.0;
+    bb[2][1]=4.0;
+    // z derivative
+    aa[0][2]=-3.0;
+    bb[0][2]=4.0;
+    bb[1][2]=4.0;
+    bb[2][2]=4.0;
+
+    out[0][0][0] = aa[0][0] + bb[0][0]*in[0] + bb[1][0]*in[1] + bb[2][0]*in[2];
+    out[0][0][1] = aa[0][1] + bb[0][1]*in[0] + bb[1][1]*in[1] + bb[2][1]*in[2];
+    out[0][0][2] = aa[0][2] + bb[0][2]*in[0] + bb[1][2]*in[1] + bb[2][2]*in[2];
+
+    //case 1:
+    //x derivative
+    aa[0][0]=-1.0;
+    bb[0][0]=4.0;
+    bb[1][0]=0.0;
+    bb[2][0]=0.0;
+    //y derivative
+    aa[0][1]=0.0;
+    bb[0][1]=0.0;
+    bb[1][1]=0.0;
+    bb[2][1]=0.0;
+    // z derivative
+    aa[0][2]=0.0;
+    bb[0][2]=0.0;
+    bb[1][2]=0.0;
+    bb[2][2]=0.0;
+
+    out[1][0][0] = aa[0][0] + bb[0][0]*in[0] + bb[1][0]*in[1] + bb[2][0]*in[2];
+    out[1][0][1] = aa[0][1] + bb[0][1]*in[0] + bb[1][1]*in[1] + bb[2][1]*in[2];
+    out[1][0][2] = aa[0][2] + bb[0][2]*in[0] + bb[1][2]*in[1] + bb[2][2]*in[2];
+
+    // case 2:
+    //x derivative
+    aa[0][0]=0.0;
+    bb[0][0]=0.0;
+    bb[1][0]=0.0;
+    bb[2][0]=0.0;
+    //y derivative
+    aa[0][1]=-1.0;
+    bb[0][1]=0.0;
+    bb[1][1]=4.0;
+    bb[2][1]=0.0;
+    // z derivative
+    aa[0][2]=0.0;
+    bb[0][2]=0.0;
+    bb[1][2]=0.0;
+    bb[2][2]=0.0;
+
+    out[2][0][0] = aa[0][0] + bb[0][0]*in[0] + bb[1][0]*in[1] + bb[2][0]*in[2];
+    out[2][0][1] = aa[0][1] + bb[0][1]*in[0] + bb[1][1]*in[1] + bb[2][1]*in[2];
+    out[2][0][2] = aa[0][2] + bb[0][2]*in[0] + bb[1][2]*in[1] + bb[2][2]*in[2];
+
+    // case 3:
+    //x derivative
+    aa[0][0]=0.0;
+    bb[0][0]=0.0;
+    bb[1][0]=0.0;
+    bb[2][0]=0.0;
+    //y derivative
+    aa[0][1]=0.0;
+    bb[0][1]=0.0;
+    bb[1][1]=0.0;
+    bb[2][1]=0.0;
+    // z derivative
+    aa[0][2]=-1.0;
+    bb[0][2]=0.0;
+    bb[1][2]=0.0;
+    bb[2][2]=4.0;
+
+    out[3][0][0] = aa[0][0] + bb[0][0]*in[0] + bb[1][0]*in[1] + bb[2][0]*in[2];
+    out[3][0][1] = aa[0][1] + bb[0][1]*in[0] + bb[1][1]*in[1] + bb[2][1]*in[2];
+    out[3][0][2] = aa[0][2] + bb[0][2]*in[0] + bb[1][2]*in[1] + bb[2][2]*in[2];
+
+    // case 4:
+    //x derivative
+    aa[0][0]=4.0;
+    bb[0][0]=-8.0;
+    bb[1][0]=-4.0;
+    bb[2][0]=-4.0;
+    //y derivative
+    aa[0][1]=0.0;
+    bb[0][1]=-4.0;
+    bb[1][1]=0.0;
+    bb[2][1]=0.0;
+    // z derivative
+    aa[0][2]=0.0;
+    bb[0][2]=-4.0;
+    bb[1][2]=0.0;
+    bb[2][2]=0.0;
+
+    out[4][0][0] = aa[0][0] + bb[0][0]*in[0] + bb[1][0]*in[1] + bb[2][0]*in[2];
+    out[4][0][1] = aa[0][1] + bb[0][1]*in[0] + bb[1][1]*in[1] + bb[2][1]*in[2];
+    out[4][0][2] = aa[0][2] + bb[0][2]*in[0] + bb[1][2]*in[1] + bb[2][2]*in[2];
+
+    // case 5:
+    //x derivative
+    aa[0][0]=0.0;
+    bb[0][0]=0.0;
+    bb[1][0]=4.0;
+    bb[2][0]=0.0;
+    //y derivative
+    aa[0][1]=0.0;
+    bb[0][1]=4.0;
+    bb[1][1]=0.0;
+    bb[2][1]=0.0;
+    // z derivative
+    aa[0][2]=0.0;
+    bb[0][2]=0.0;
+    bb[1][2]=0.0;
+    bb[2][2]=0.0;
+
+    out[5][0][0] = aa[0][0] + bb[0][0]*in[0] + bb[1][0]*in[1] + bb[2][0]*in[2];
+    out[5][0][1] = aa[0][1] + bb[0][1]*in[0] + bb[1][1]*in[1] + bb[2][1]*in[2];
+    out[5][0][2] = aa[0][2] + bb[0][2]*in[0] + bb[1][2]*in[1] + bb[2][2]*in[2];
+
+    // case 6:
+    //x derivative
+    aa[0][0]=0.0;
+    bb[0][0]=0.0;
+    bb[1][0]=-4.0;
+    bb[2][0]=0.0;
+    //y derivative
+    aa[0][1]=4.0;
+    bb[0][1]=-4.0;
+    bb[1][1]=-8.0;
+    bb[2][1]=-4.0;
+    // z derivative
+    aa[0][2]=0.0;
+    bb[0][2]=0.0;
+    bb[1][2]=-4.0;
+    bb[2][2]=0.0;
+
+    out[6][0][0] = aa[0][0] + bb[0][0]*in[0] + bb[1][0]*in[1] + bb[2][0]*in[2];
+    out[6][0][1] = aa[0][1] + bb[0][1]*in[0] + bb[1][1]*in[1] + bb[2][1]*in[2];
+    out[6][0][2] = aa[0][2] + bb[0][2]*in[0] + bb[1][2]*in[1] + bb[2][2]*in[2];
+
+    // case 7:
+    //x derivative
+    aa[0][0]=0.0;
+    bb[0][0]=0.0;
+    bb[1][0]=0.0;
+    bb[2][0]=-4.0;
+    //y derivative
+    aa[0][1]=0.0;
+    bb[0][1]=0.0;
+    bb[1][1]=0.0;
+    bb[2][1]=-4.0;
+    // z derivative
+    aa[0][2]=4.0;
+    bb[0][2]=-4.0;
+    bb[1][2]=-4.0;
+    bb[2][2]=-8.0;
+
+    out[7][0][0] = aa[0][0] + bb[0][0]*in[0] + bb[1][0]*in[1] + bb[2][0]*in[2];
+    out[7][0][1] = aa[0][1] + bb[0][1]*in[0] + bb[1][1]*in[1] + bb[2][1]*in[2];
+    out[7][0][2] = aa[0][2] + bb[0][2]*in[0] + bb[1][2]*in[1] + bb[2][2]*in[2];
+
+    //case 8:
+    //x derivative
+    aa[0][0]=0.0;
+    bb[0][0]=0.0;
+    bb[1][0]=0.0;
+    bb[2][0]=4.0;
+    //y derivative
+    aa[0][1]=0.0;
+    bb[0][1]=0.0;
+    bb[1][1]=0.0;
+    bb[2][1]=0.0;
+    // z derivative
+    aa[0][2]=0.0;
+    bb[0][2]=4.0;
+    bb[1][2]=0.0;
+    bb[2][2]=0.0;
+
+    out[8][0][0] = aa[0][0] + bb[0][0]*in[0] + bb[1][0]*in[1] + bb[2][0]*in[2];
+    out[8][0][1] = aa[0][1] + bb[0][1]*in[0] + bb[1][1]*in[1] + bb[2][1]*in[2];
+    out[8][0][2] = aa[0][2] + bb[0][2]*in[0] + bb[1][2]*in[1] + bb[2][2]*in[2];
+
+    // case 9:
+    //x derivative
+    aa[0][0]=0.0;
+    bb[0][0]=0.0;
+    bb[1][0]=0.0;
+    bb[2][0]=0.0;
+    //y derivative
+    aa[0][1]=0.0;
+    bb[0][1]=0.0;
+    bb[1][1]=0.0;
+    bb[2][1]=4.0;
+    // z derivative
+    aa[0][2]=0.0;
+    bb[0][2]=0.0;
+    bb[1][2]=4.0;
+    bb[2][2]=0.0;
+
+    out[9][0][0] = aa[0][0] + bb[0][0]*in[0] + bb[1][0]*in[1] + bb[2][0]*in[2];
+    out[9][0][1] = aa[0][1] + bb[0][1]*in[0] + bb[1][1]*in[1] + bb[2][1]*in[2];
+    out[9][0][2] = aa[0][2] + bb[0][2]*in[0] + bb[1][2]*in[1] + bb[2][2]*in[2];
+  }
+
+  template<class D, class R>
+  void P23DLocalBasis<D,R>::evaluateFunctionAndJacobianAt (const typename Traits::DomainType& in,
+                                                           typename Traits::RangeType* values,
+                                                           typename Traits::JacobianType* jacobians) const
+  {
+    // barycentric coordinates and their gradients
+    R l[4] = { 1-in[0]-in[1]-in[2], in[0], in[1], in[2] };
+    R grad[4][3] = { {-1,-1,-1}, {1,0,0}, {0,1,0}, {0,0,1} };
+
+    // vertex functions l_i (2 l_i - 1)
+    for (int i=0; i<4; i++)
+    {
+      values[i] = l[i]*(2*l[i]-1);
+      for (int c=0; c<3; c++)
+        jacobians[i][0][c] = (4*l[i]-1)*grad[i][c];
+    }
+
+    // edge functions 4 l_a l_b, the edges are numbered as in P23DLocalCoefficients
+    static const int edge[6][2] = { {0,1}, {1,2}, {0,2}, {0,3}, {1,3}, {2,3} };
+    for (int e=0; e<6; e++)
+    {
+      const int a = edge[e][0], b = edge[e][1];
+      values[4+e] = 4*l[a]*l[b];
+      for (int c=0; c<3; c++)
+        jacobians[4+e][0][c] = 4*(l[b]*grad[a][c] + l[a]*grad[b][c]);
+    }
+  }
 }
 #endif
@@ -20,24 +20,13 @@ namespace Dune
                                 <P23DLocalCoefficients>
 #endif
   {
+    typedef LocalKeyTable<P23DLocalCoefficients,10> Table;
+    friend class LocalKeyTable<P23DLocalCoefficients,10>;
+
   public:
     //! \brief Standard constructor
-    P23DLocalCoefficients () : li(10)
-    {
-      // Vertex shape functions
-      li[0] = LocalKey(0,3,0);
-      li[1] = LocalKey(1,3,0);
-      li[2] = LocalKey(2,3,0);
-      li[3] = LocalKey(3,3,0);
-
-      // Edge bubbles
-      li[4] = LocalKey(0,2,0);
-      li[5] = LocalKey(1,2,0);
-      li[6] = LocalKey(2,2,0);
-      li[7] = LocalKey(3,2,0);
-      li[8] = LocalKey(4,2,0);
-      li[9] = LocalKey(5,2,0);
-    }
+    P23DLocalCoefficients () : li(Table::keys()), packed(Table::packedKeys())
+    {}
 
     //! number of coefficients
     int size () const
@@ -51,8 +40,32 @@ namespace Dune
       return li[i];
     }
 
+    //! get i'th index, packed into 32 bits
+    const PackedLocalKey& packedLocalKey (int i) const
+    {
+      return packed[i];
+    }
+
   private:
-    std::vector<LocalKey> li;
+    const LocalKey* li;
+    const PackedLocalKey* packed;
+
+    static void fill (int, LocalKey* keys)
+    {
+      // Vertex shape functions
+      keys[0] = LocalKey(0,3,0);
+      keys[1] = LocalKey(1,3,0);
+      keys[2] = LocalKey(2,3,0);
+      keys[3] = LocalKey(3,3,0);
+
+      // Edge bubbles
+      keys[4] = LocalKey(0,2,0);
+      keys[5] = LocalKey(1,2,0);
+      keys[6] = LocalKey(2,2,0);
+      keys[7] = LocalKey(3,2,0);
+      keys[8] = LocalKey(4,2,0);
+      keys[9] = LocalKey(5,2,0);
+    }
   };
 
 }
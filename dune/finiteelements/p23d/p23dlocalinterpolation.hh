@@ -16,10 +16,17 @@ namespace Dune
     //! \brief Local interpolation of a function
     template<typename F, typename C>
     void interpolate (const F& f, std::vector<C>& out) const
+    {
+      out.resize(10);
+      interpolate(f,&out[0]);
+    }
+
+    //! \brief Local interpolation into caller-provided storage with room for all coefficients
+    template<typename F, typename C>
+    void interpolate (const F& f, C* out) const
     {
       typename LB::Traits::RangeType y;
 
-      out.resize(10);
       typename LB::Traits::DomainType x;
 
       x[0] = 0.0;   x[1] = 0.0;   x[2] = 0.0;
@@ -6,6 +6,8 @@
 #include <dune/common/geometrytype.hh>
 
 #include "common/localfiniteelement.hh"
+#include "common/localfiniteelementvariants.hh"
+#include "common/precompiled.hh"
 #include "pk2d/pk2dlocalbasis.hh"
 #include "pk2d/pk2dlocalcoefficients.hh"
 #include "pk2d/pk2dlocalinterpolation.hh"
@@ -37,6 +39,9 @@ namespace Dune
         Pk2DLocalCoefficients<k>,
         Pk2DLocalInterpolation<Pk2DLocalBasis<D,R,k> > > Traits;
 
+    //! \brief Number of variants, bit i of the variant flips the order on edge i
+    enum {variants = 8};
+
     /** \todo Please doc me !
      */
     Pk2DLocalFiniteElement ()
@@ -79,6 +84,18 @@ namespace Dune
       return gt;
     }
 
+    /** \brief The variant for a triangle with the given global vertex ids
+
+        Neighbouring triangles with these variants number the degrees of
+        freedom on their common edge in the same direction, see
+        triangleEdgeFlips().
+     */
+    template<class IdVector>
+    static unsigned int variant (const IdVector& globalVertexIds)
+    {
+      return triangleEdgeFlips(globalVertexIds);
+    }
+
   private:
     Pk2DLocalBasis<D,R,k> basis;
     Pk2DLocalCoefficients<k> coefficients;
@@ -86,6 +103,14 @@ namespace Dune
     GeometryType gt;
   };
 
+#if DUNE_LOCALFUNCTIONS_PRECOMPILED && !defined(DUNE_VIRTUAL_SHAPEFUNCTIONS)
+  // instantiated in libdunelocalfunctions, see common/precompiled.hh
+  DUNE_LOCALFUNCTIONS_EXTERN_TEMPLATE class Pk2DLocalBasis<double,double,1>;
+  DUNE_LOCALFUNCTIONS_EXTERN_TEMPLATE class Pk2DLocalBasis<double,double,2>;
+  DUNE_LOCALFUNCTIONS_EXTERN_TEMPLATE class Pk2DLocalBasis<float,float,1>;
+  DUNE_LOCALFUNCTIONS_EXTERN_TEMPLATE class Pk2DLocalBasis<float,float,2>;
+#endif
+
 }
 
 #endif
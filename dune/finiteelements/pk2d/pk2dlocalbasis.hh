@@ -3,7 +3,10 @@
 #ifndef DUNE_PK2DLOCALBASIS_HH
 #define DUNE_PK2DLOCALBASIS_HH
 
+#include <cassert>
+
 #include "../common/localbasis.hh"
+#include "../common/localfunction.hh"
 
 namespace Dune
 {
@@ -21,13 +24,10 @@ namespace Dune
    */
   template<class D, class R, unsigned int k>
   class Pk2DLocalBasis :
-    public C1LocalBasisInterface<
+    public C1LocalBasisForwarder<
         C1LocalBasisTraits<D,2,Dune::FieldVector<D,2>,R,1,Dune::FieldVector<R,1>,
-            Dune::FieldVector<Dune::FieldVector<R,2>,1> >
-#ifndef DUNE_VIRTUAL_SHAPEFUNCTIONS
-        ,Pk2DLocalBasis<D,R,k>
-#endif
-        >
+            Dune::FieldVector<Dune::FieldVector<R,2>,1> >,
+        Pk2DLocalBasis<D,R,k>, (k+1)*(k+2)/2>
   {
   public:
     enum {N = (k+1)*(k+2)/2};
@@ -39,8 +39,9 @@ namespace Dune
     //! \brief Standard constructor
     Pk2DLocalBasis ()
     {
-      for (unsigned int i=0; i<=k; i++)
-        pos[i] = (1.0*i)/k;
+      inverse[0] = 0.0;
+      for (unsigned int m=1; m<=k; m++)
+        inverse[m] = 1.0/m;
     }
 
     //! \brief number of shape functions
@@ -50,101 +51,36 @@ namespace Dune
       return N;
     }
 
-    //! \brief Evaluate all shape functions
-    inline void evaluateFunction (const typename Traits::DomainType& x,
-                                  std::vector<typename Traits::RangeType>& out) const
+    //! \brief Evaluate all shape functions and their partial derivatives up to order r
+    template<int r>
+    inline void evaluateJet (const typename Traits::DomainType& x,
+                             std::vector<LocalBasisJet<Traits,r> >& out) const
     {
       out.resize(N);
-      int n=0;
-      for (unsigned int j=0; j<=k; j++)
-        for (unsigned int i=0; i<=k-j; i++)
-        {
-          out[n] = 1.0;
-          for (unsigned int alpha=0; alpha<i; alpha++)
-            out[n] *= (x[0]-pos[alpha])/(pos[i]-pos[alpha]);
-          for (unsigned int beta=0; beta<j; beta++)
-            out[n] *= (x[1]-pos[beta])/(pos[j]-pos[beta]);
-          for (unsigned int gamma=i+j+1; gamma<=k; gamma++)
-            out[n] *= (pos[gamma]-x[0]-x[1])/(pos[gamma]-pos[i]-pos[j]);
-          n++;
-        }
+      evaluateJetAt<r>(x,&out[0]);
     }
 
-    //! \brief Evaluate Jacobian of all shape functions
-    inline void
-    evaluateJacobian (const typename Traits::DomainType& x,       // position
-                      std::vector<typename Traits::JacobianType>& out) const                        // return value
+    //! \brief Evaluate the jets of all shape functions into caller-provided storage with room for \a capacity >= N values
+    template<int r>
+    inline void evaluateJet (const typename Traits::DomainType& x,
+                             LocalBasisJet<Traits,r>* out,
+                             unsigned int capacity) const
     {
-      out.resize(N);
-      int n=0;
-      for (int j=0; j<=k; j++)
-        for (int i=0; i<=k-j; i++)
-        {
-          // x_0 derivative
-          out[n][0][0] = 0.0;
-          R factor=1.0;
-          for (int beta=0; beta<j; beta++)
-            factor *= (x[1]-pos[beta])/(pos[j]-pos[beta]);
-          for (int a=0; a<i; a++)
-          {
-            R product=factor;
-            for (int alpha=0; alpha<i; alpha++)
-              if (alpha==a)
-                product *= 1.0/(pos[i]-pos[alpha]);
-              else
-                product *= (x[0]-pos[alpha])/(pos[i]-pos[alpha]);
-            for (int gamma=i+j+1; gamma<=k; gamma++)
-              product *= (pos[gamma]-x[0]-x[1])/(pos[gamma]-pos[i]-pos[j]);
-            out[n][0][0] += product;
-          }
-          for (int c=i+j+1; c<=k; c++)
-          {
-            R product=factor;
-            for (int alpha=0; alpha<i; alpha++)
-              product *= (x[0]-pos[alpha])/(pos[i]-pos[alpha]);
-            for (int gamma=i+j+1; gamma<=k; gamma++)
-              if (gamma==c)
-                product *= -1.0/(pos[gamma]-pos[i]-pos[j]);
-              else
-                product *= (pos[gamma]-x[0]-x[1])/(pos[gamma]-pos[i]-pos[j]);
-            out[n][0][0] += product;
-          }
-
-          // x_1 derivative
-          out[n][0][1] = 0.0;
-          factor = 1.0;
-          for (int alpha=0; alpha<i; alpha++)
-            factor *= (x[0]-pos[alpha])/(pos[i]-pos[alpha]);
-          for (int b=0; b<j; b++)
-          {
-            R product=factor;
-            for (int beta=0; beta<j; beta++)
-              if (beta==b)
-                product *= 1.0/(pos[j]-pos[beta]);
-              else
-                product *= (x[1]-pos[beta])/(pos[j]-pos[beta]);
-            for (int gamma=i+j+1; gamma<=k; gamma++)
-              product *= (pos[gamma]-x[0]-x[1])/(pos[gamma]-pos[i]-pos[j]);
-            out[n][0][1] += product;
-          }
-          for (int c=i+j+1; c<=k; c++)
-          {
-            R product=factor;
-            for (int beta=0; beta<j; beta++)
-              product *= (x[1]-pos[beta])/(pos[j]-pos[beta]);
-            for (int gamma=i+j+1; gamma<=k; gamma++)
-              if (gamma==c)
-                product *= -1.0/(pos[gamma]-pos[i]-pos[j]);
-              else
-                product *= (pos[gamma]-x[0]-x[1])/(pos[gamma]-pos[i]-pos[j]);
-            out[n][0][1] += product;
-          }
-
-          n++;
-        }
+      assert(capacity >= N);
+      evaluateJetAt<r>(x,out);
+    }
 
-      //        for (int i=0; i<N; i++)
-      //          std::cout << i << " " << out[i][0][0] << " " << out[i][0][1] << std::endl;
+    //! \brief Evaluate the derivative of all shape functions in the given directions, of order r <= 3
+    template<int r>
+    inline void evaluate (const Dune::array<int,r>& directions,
+                          const typename Traits::DomainType& x,
+                          std::vector<typename Traits::RangeType>& out) const
+    {
+      LocalBasisJet<Traits,r> jets[N];
+      evaluateJetAt<r>(x,jets);
+      out.resize(N);
+      for (unsigned int i=0; i<N; i++)
+        out[i] = LocalBasisJetImp::derivative(jets[i],directions);
     }
 
     //! \brief Polynomial order of the shape functions
@@ -154,22 +90,199 @@ namespace Dune
     }
 
   private:
-    R pos[k+1]; // positions on the interval
+    friend class C1LocalBasisForwarder<Traits,Pk2DLocalBasis,N>;
+
+    /* The Lagrange nodes are (i/k,j/k), and the shape function belonging
+       to node (i,j) factors into
+         phi_ij(x) = A_i(x[0]) A_j(x[1]) A_{k-i-j}(1-x[0]-x[1])
+       with the one-dimensional polynomials
+         A_m(t) = prod_{b<m} (kt-b) / m!,
+       which all share the recurrence A_m = A_{m-1} (kt-m+1)/m.  Tabulating
+       A_0,...,A_k for the three barycentric coordinates costs O(k) per
+       point, after which every shape function and its gradient is a
+       product of three tabulated factors. */
+
+    //! \brief A_0(t),...,A_k(t)
+    void evaluateFactors (R t, R* a) const;
+
+    //! \brief A_0(t),...,A_k(t) and their derivatives
+    void evaluateFactors (R t, R* a, R* da) const;
+
+    //! \brief A_0(t),...,A_k(t) and their derivatives up to order r, a[m][s] is the s-th derivative of A_m
+    template<int r>
+    inline void evaluateFactors (R t, R a[k+1][r+1]) const
+    {
+      const R kt = k*t;
+      a[0][0] = 1.0;
+      for (int s=1; s<=r; s++)
+        a[0][s] = 0.0;
+      for (unsigned int m=1; m<=k; m++)
+      {
+        // Leibniz rule for A_m = A_{m-1} (kt-m+1)/m
+        a[m][0] = a[m-1][0]*(kt-(m-1))*inverse[m];
+        for (int s=1; s<=r; s++)
+          a[m][s] = (a[m-1][s]*(kt-(m-1)) + s*k*a[m-1][s-1])*inverse[m];
+      }
+    }
+
+    /* Partial derivatives of A_i(x[0]) A_j(x[1]) A_l(1-x[0]-x[1]) by the
+       Leibniz rule, a, b and c point to the derivatives of the three factors */
+    struct Partial
+    {
+      R operator() (int r, const int* directions) const
+      {
+        static const int binomial[4][4] = {{1,0,0,0},{1,1,0,0},{1,2,1,0},{1,3,3,1}};
+
+        int alpha = 0;
+        for (int s=0; s<r; s++)
+          if (directions[s] == 0)
+            alpha++;
+        const int beta = r-alpha;
+
+        R sum = 0;
+        for (int s=0; s<=alpha; s++)
+          for (int t=0; t<=beta; t++)
+          {
+            const R term = binomial[alpha][s]*binomial[beta][t]*a[alpha-s]*b[beta-t]*c[s+t];
+            sum += ((s+t)%2) ? -term : term;
+          }
+        return sum;
+      }
+
+      const R* a;
+      const R* b;
+      const R* c;
+    };
+
+    template<int r>
+    inline void evaluateJetAt (const typename Traits::DomainType& x,
+                               LocalBasisJet<Traits,r>* out) const
+    {
+      R a[k+1][r+1], b[k+1][r+1], c[k+1][r+1];
+      evaluateFactors<r>(x[0],a);
+      evaluateFactors<r>(x[1],b);
+      evaluateFactors<r>(1.0-x[0]-x[1],c);
+
+      Partial partial;
+      int n=0;
+      for (unsigned int j=0; j<=k; j++)
+        for (unsigned int i=0; i<=k-j; i++)
+        {
+          partial.a = a[i];
+          partial.b = b[j];
+          partial.c = c[k-i-j];
+          LocalBasisJetImp::fill(partial,out[n++]);
+        }
+    }
+
+    void evaluateFunctionAt (const typename Traits::DomainType& x,
+                             typename Traits::RangeType* out) const;
+
+    void evaluateJacobianAt (const typename Traits::DomainType& x,
+                             typename Traits::JacobianType* out) const;
+
+    void evaluateFunctionAndJacobianAt (const typename Traits::DomainType& x,
+                                        typename Traits::RangeType* values,
+                                        typename Traits::JacobianType* jacobians) const;
+
+    R inverse[k+1]; // inverse[m] = 1/m, inverse[0] is unused
+
+    friend class LocalFunctionEvaluator<Pk2DLocalBasis>;
   };
 
+  // not inline, such that the instantiations in libdunelocalfunctions are used
+  template<class D, class R, unsigned int k>
+  void Pk2DLocalBasis<D,R,k>::evaluateFactors (R t, R* a) const
+  {
+    const R kt = k*t;
+    a[0] = 1.0;
+    for (unsigned int m=1; m<=k; m++)
+      a[m] = a[m-1]*(kt-(m-1))*inverse[m];
+  }
+
+  template<class D, class R, unsigned int k>
+  void Pk2DLocalBasis<D,R,k>::evaluateFactors (R t, R* a, R* da) const
+  {
+    const R kt = k*t;
+    a[0] = 1.0;
+    da[0] = 0.0;
+    for (unsigned int m=1; m<=k; m++)
+    {
+      da[m] = (da[m-1]*(kt-(m-1)) + a[m-1]*k)*inverse[m];
+      a[m] = a[m-1]*(kt-(m-1))*inverse[m];
+    }
+  }
+
+  template<class D, class R, unsigned int k>
+  void Pk2DLocalBasis<D,R,k>::evaluateFunctionAt (const typename Traits::DomainType& x,
+                                                  typename Traits::RangeType* out) const
+  {
+    R a[k+1], b[k+1], c[k+1];
+    evaluateFactors(x[0],a);
+    evaluateFactors(x[1],b);
+    evaluateFactors(1.0-x[0]-x[1],c);
+
+    int n=0;
+    for (unsigned int j=0; j<=k; j++)
+      for (unsigned int i=0; i<=k-j; i++)
+        out[n++] = a[i]*b[j]*c[k-i-j];
+  }
+
+  template<class D, class R, unsigned int k>
+  void Pk2DLocalBasis<D,R,k>::evaluateJacobianAt (const typename Traits::DomainType& x,
+                                                  typename Traits::JacobianType* out) const
+  {
+    R a[k+1], b[k+1], c[k+1], da[k+1], db[k+1], dc[k+1];
+    evaluateFactors(x[0],a,da);
+    evaluateFactors(x[1],b,db);
+    evaluateFactors(1.0-x[0]-x[1],c,dc);
+
+    int n=0;
+    for (unsigned int j=0; j<=k; j++)
+      for (unsigned int i=0; i<=k-j; i++)
+      {
+        const unsigned int l = k-i-j;
+        out[n][0][0] = (da[i]*c[l] - a[i]*dc[l])*b[j];
+        out[n][0][1] = (db[j]*c[l] - b[j]*dc[l])*a[i];
+        n++;
+      }
+  }
+
+  template<class D, class R, unsigned int k>
+  void Pk2DLocalBasis<D,R,k>::evaluateFunctionAndJacobianAt (const typename Traits::DomainType& x,
+                                                             typename Traits::RangeType* values,
+                                                             typename Traits::JacobianType* jacobians) const
+  {
+    R a[k+1], b[k+1], c[k+1], da[k+1], db[k+1], dc[k+1];
+    evaluateFactors(x[0],a,da);
+    evaluateFactors(x[1],b,db);
+    evaluateFactors(1.0-x[0]-x[1],c,dc);
+
+    int n=0;
+    for (unsigned int j=0; j<=k; j++)
+      for (unsigned int i=0; i<=k-j; i++)
+      {
+        const unsigned int l = k-i-j;
+        values[n] = a[i]*b[j]*c[l];
+        jacobians[n][0][0] = (da[i]*c[l] - a[i]*dc[l])*b[j];
+        jacobians[n][0][1] = (db[j]*c[l] - b[j]*dc[l])*a[i];
+        n++;
+      }
+  }
+
 
   //Specialization for k=0
   template<class D, class R>
   class Pk2DLocalBasis<D,R,0> :
-    public C1LocalBasisInterface<
+    public C1LocalBasisForwarder<
         C1LocalBasisTraits<D,2,Dune::FieldVector<D,2>,R,1,Dune::FieldVector<R,1>,
-            Dune::FieldVector<Dune::FieldVector<R,2>,1> >
-#ifndef DUNE_VIRTUAL_SHAPEFUNCTIONS
-        ,Pk2DLocalBasis<D,R,0>
-#endif
-        >
+            Dune::FieldVector<Dune::FieldVector<R,2>,1> >,
+        Pk2DLocalBasis<D,R,0>, 1>
   {
   public:
+    enum {N = 1};
+    enum {O = 0};
+
     typedef C1LocalBasisTraits<D,2,Dune::FieldVector<D,2>,R,1,Dune::FieldVector<R,1>,
         Dune::FieldVector<Dune::FieldVector<R,2>,1> > Traits;
 
@@ -178,22 +291,6 @@ namespace Dune
       return 1;
     }
 
-    inline void evaluateFunction (const typename Traits::DomainType& in,
-                                  std::vector<typename Traits::RangeType>& out) const
-    {
-      out.resize(1);
-      out[0] = 1;
-    }
-
-    // evaluate derivative of a single component
-    inline void
-    evaluateJacobian (const typename Traits::DomainType& in,     // position
-                      std::vector<typename Traits::JacobianType>& out) const                  // return value
-    {
-      out.resize(1);
-      out[0][0][0] = 0; out[0][0][1] = 0;
-    }
-
     // local interpolation of a function
     template<typename E, typename F, typename C>
     void interpolate (const E& e, const F& f, std::vector<C>& out) const
@@ -203,10 +300,184 @@ namespace Dune
       x[0] = 1.0/3.0; x[1] = 1.0/3.0; f.eval_local(e,x,y); out[0] = y;
     }
 
+    //! \brief Evaluate all shape functions and their partial derivatives up to order r
+    template<int r>
+    inline void evaluateJet (const typename Traits::DomainType& x,
+                             std::vector<LocalBasisJet<Traits,r> >& out) const
+    {
+      out.resize(N);
+      evaluateJetAt<r>(x,&out[0]);
+    }
+
+    //! \brief Evaluate the jets of all shape functions into caller-provided storage with room for \a capacity >= N values
+    template<int r>
+    inline void evaluateJet (const typename Traits::DomainType& x,
+                             LocalBasisJet<Traits,r>* out,
+                             unsigned int capacity) const
+    {
+      assert(capacity >= N);
+      evaluateJetAt<r>(x,out);
+    }
+
+    //! \brief Evaluate the derivative of all shape functions in the given directions, of order r <= 3
+    template<int r>
+    inline void evaluate (const Dune::array<int,r>& directions,
+                          const typename Traits::DomainType& x,
+                          std::vector<typename Traits::RangeType>& out) const
+    {
+      LocalBasisJet<Traits,r> jets[N];
+      evaluateJetAt<r>(x,jets);
+      out.resize(N);
+      for (unsigned int i=0; i<N; i++)
+        out[i] = LocalBasisJetImp::derivative(jets[i],directions);
+    }
+
     unsigned int order () const
     {
       return 0;
     }
+
+  private:
+    friend class C1LocalBasisForwarder<Traits,Pk2DLocalBasis,N>;
+
+    inline void evaluateFunctionAt (const typename Traits::DomainType&,
+                                    typename Traits::RangeType* out) const
+    {
+      out[0] = 1;
+    }
+
+    inline void evaluateJacobianAt (const typename Traits::DomainType&,
+                                    typename Traits::JacobianType* out) const
+    {
+      out[0][0][0] = 0; out[0][0][1] = 0;
+    }
+
+    template<int r>
+    inline void evaluateJetAt (const typename Traits::DomainType&,
+                               LocalBasisJet<Traits,r>* out) const
+    {
+      // the constant one, all derivatives vanish
+      R one[r+1];
+      one[0] = 1;
+      for (int s=1; s<=r; s++)
+        one[s] = 0;
+      LocalBasisJetImp::TensorProductPartial<R,2> partial;
+      partial.factor[0] = partial.factor[1] = one;
+      LocalBasisJetImp::fill(partial,out[0]);
+    }
   };
+
+
+  /** \brief LocalFunctionEvaluator for Pk2DLocalBasis
+
+      Sums the coefficients against the factorised shape functions row by
+      row, without forming the values of the single shape functions.
+   */
+  template<class D, class R, unsigned int k>
+  class LocalFunctionEvaluator<Pk2DLocalBasis<D,R,k> >
+  {
+    typedef Pk2DLocalBasis<D,R,k> LB;
+
+  public:
+    //! \brief Export type traits of the local basis
+    typedef typename LB::Traits Traits;
+
+    //! \brief Value of the function with coefficients coeff[0],...,coeff[N-1] at position x
+    template<class C>
+    static void evaluateFunction (const LB& lb,
+                                  const typename Traits::DomainType& x,
+                                  const C* coeff,
+                                  typename Traits::RangeType& value)
+    {
+      R a[k+1], b[k+1], c[k+1];
+      lb.evaluateFactors(x[0],a);
+      lb.evaluateFactors(x[1],b);
+      lb.evaluateFactors(1.0-x[0]-x[1],c);
+
+      R u = 0.0;
+      int n=0;
+      for (unsigned int j=0; j<=k; j++)
+      {
+        R v = 0.0;
+        for (unsigned int i=0; i<=k-j; i++)
+          v += coeff[n++]*a[i]*c[k-i-j];
+        u += b[j]*v;
+      }
+      value = u;
+    }
+
+    //! \brief Value and Jacobian of the function with coefficients coeff[0],...,coeff[N-1] at position x
+    template<class C>
+    static void evaluateFunctionAndJacobian (const LB& lb,
+                                             const typename Traits::DomainType& x,
+                                             const C* coeff,
+                                             typename Traits::RangeType& value,
+                                             typename Traits::JacobianType& jacobian)
+    {
+      R a[k+1], b[k+1], c[k+1], da[k+1], db[k+1], dc[k+1];
+      lb.evaluateFactors(x[0],a,da);
+      lb.evaluateFactors(x[1],b,db);
+      lb.evaluateFactors(1.0-x[0]-x[1],c,dc);
+
+      // u, and its derivatives in direction 0 and 1
+      R u = 0.0, u0 = 0.0, u1 = 0.0;
+      int n=0;
+      for (unsigned int j=0; j<=k; j++)
+      {
+        // sum over the row without the factor b[j], and its derivatives
+        // in direction 0 and through the third barycentric coordinate
+        R v = 0.0, v0 = 0.0, vc = 0.0;
+        for (unsigned int i=0; i<=k-j; i++)
+        {
+          const unsigned int l = k-i-j;
+          v += coeff[n]*a[i]*c[l];
+          v0 += coeff[n]*(da[i]*c[l] - a[i]*dc[l]);
+          vc -= coeff[n]*a[i]*dc[l];
+          n++;
+        }
+        u += b[j]*v;
+        u0 += b[j]*v0;
+        u1 += db[j]*v + b[j]*vc;
+      }
+      value = u;
+      jacobian[0][0] = u0;
+      jacobian[0][1] = u1;
+    }
+  };
+
+  /** \brief LocalFunctionEvaluator for the constant Pk2DLocalBasis
+   */
+  template<class D, class R>
+  class LocalFunctionEvaluator<Pk2DLocalBasis<D,R,0> >
+  {
+    typedef Pk2DLocalBasis<D,R,0> LB;
+
+  public:
+    //! \brief Export type traits of the local basis
+    typedef typename LB::Traits Traits;
+
+    //! \brief Value of the function with coefficient coeff[0]
+    template<class C>
+    static void evaluateFunction (const LB&,
+                                  const typename Traits::DomainType&,
+                                  const C* coeff,
+                                  typename Traits::RangeType& value)
+    {
+      value = coeff[0];
+    }
+
+    //! \brief Value and Jacobian of the function with coefficient coeff[0]
+    template<class C>
+    static void evaluateFunctionAndJacobian (const LB&,
+                                             const typename Traits::DomainType&,
+                                             const C* coeff,
+                                             typename Traits::RangeType& value,
+                                             typename Traits::JacobianType& jacobian)
+    {
+      value = coeff[0];
+      jacobian[0] = 0;
+    }
+  };
+
 }
 #endif
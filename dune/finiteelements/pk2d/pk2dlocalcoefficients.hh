@@ -26,25 +26,17 @@ namespace Dune
   {
     enum {N = (k+1)*(k+2)/2};
 
+    typedef LocalKeyTable<Pk2DLocalCoefficients,N,8> Table;
+    friend class LocalKeyTable<Pk2DLocalCoefficients,N,8>;
+
   public:
     //! \brief Standard constructor
-    Pk2DLocalCoefficients () : li(N)
-    {
-      fill_default();
-    }
+    Pk2DLocalCoefficients () : li(Table::keys(0)), packed(Table::packedKeys(0))
+    {}
 
     //! constructor for eight variants with order on edges flipped
-    Pk2DLocalCoefficients (int variant) : li(N)
-    {
-      fill_default();
-      bool flip[3];
-      if (variant & 1) flip[0]=true;else flip[0]=false;
-      if (variant & 2) flip[1]=true;else flip[1]=false;
-      if (variant & 4) flip[2]=true;else flip[2]=false;
-      for (int i=0; i<N; i++)
-        if (li[i].codim()==1 && flip[li[i].subentity()])
-          li[i].index(k-2-li[i].index());
-    }
+    Pk2DLocalCoefficients (int variant) : li(Table::keys(variant)), packed(Table::packedKeys(variant))
+    {}
 
     //! number of coefficients
     int size () const
@@ -58,14 +50,33 @@ namespace Dune
       return li[i];
     }
 
+    //! get i'th index, packed into 32 bits
+    const PackedLocalKey& packedLocalKey (int i) const
+    {
+      return packed[i];
+    }
+
   private:
-    std::vector<LocalKey> li;
+    const LocalKey* li;
+    const PackedLocalKey* packed;
+
+    static void fill (int variant, LocalKey* keys)
+    {
+      fill_default(keys);
+      bool flip[3];
+      if (variant & 1) flip[0]=true;else flip[0]=false;
+      if (variant & 2) flip[1]=true;else flip[1]=false;
+      if (variant & 4) flip[2]=true;else flip[2]=false;
+      for (int i=0; i<N; i++)
+        if (keys[i].codim()==1 && flip[keys[i].subentity()])
+          keys[i].index(k-2-keys[i].index());
+    }
 
-    void fill_default ()
+    static void fill_default (LocalKey* keys)
     {
       if (k==0)
       {
-        li[0] = LocalKey(0,0,0);
+        keys[0] = LocalKey(0,0,0);
         return;
       }
       int n=0;
@@ -75,35 +86,35 @@ namespace Dune
         {
           if (i==0 && j==0)
           {
-            li[n++] = LocalKey(0,2,0);
+            keys[n++] = LocalKey(0,2,0);
             continue;
           }
           if (i==k && j==0)
           {
-            li[n++] = LocalKey(1,2,0);
+            keys[n++] = LocalKey(1,2,0);
             continue;
           }
           if (i==0 && j==k)
           {
-            li[n++] = LocalKey(2,2,0);
+            keys[n++] = LocalKey(2,2,0);
             continue;
           }
           if (j==0)
           {
-            li[n++] = LocalKey(2,1,i-1);
+            keys[n++] = LocalKey(2,1,i-1);
             continue;
           }
           if (i==0)
           {
-            li[n++] = LocalKey(1,1,j-1);
+            keys[n++] = LocalKey(1,1,j-1);
             continue;
           }
           if (i+j==k)
           {
-            li[n++] = LocalKey(0,1,j-1);
+            keys[n++] = LocalKey(0,1,j-1);
             continue;
           }
-          li[n++] = LocalKey(0,0,c++);
+          keys[n++] = LocalKey(0,0,c++);
         }
     }
   };
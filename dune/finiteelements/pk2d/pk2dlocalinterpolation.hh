@@ -17,11 +17,18 @@ namespace Dune
 
     template<typename F, typename C>
     void interpolate (const F& f, std::vector<C>& out) const
+    {
+      out.resize(N);
+      interpolate(f,&out[0]);
+    }
+
+    //! \brief Local interpolation into caller-provided storage with room for all coefficients
+    template<typename F, typename C>
+    void interpolate (const F& f, C* out) const
     {
       typename LB::Traits::DomainType x;
       typename LB::Traits::RangeType y;
       typedef typename LB::Traits::DomainFieldType D;
-      out.resize(N);
       int n=0;
       for (int j=0; j<=k; j++)
         for (int i=0; i<=k-j; i++)
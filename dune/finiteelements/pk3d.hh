@@ -0,0 +1,112 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+#ifndef DUNE_PK3DLOCALFINITEELEMENT_HH
+#define DUNE_PK3DLOCALFINITEELEMENT_HH
+
+#include <dune/common/fixedarray.hh>
+#include <dune/common/geometrytype.hh>
+
+#include "common/localfiniteelement.hh"
+#include "common/precompiled.hh"
+#include "pk3d/pk3dlocalbasis.hh"
+#include "pk3d/pk3dlocalcoefficients.hh"
+#include "pk3d/pk3dlocalinterpolation.hh"
+
+namespace Dune
+{
+
+  /** \brief Lagrange finite element of arbitrary order on the tetrahedron
+
+      The variants of Pk3DLocalCoefficients are available through the
+      constructors.
+   */
+  template<class D, class R, unsigned int k>
+  class Pk3DLocalFiniteElement
+    :
+#if DUNE_VIRTUAL_SHAPEFUNCTIONS
+      public
+#endif
+      LocalFiniteElementInterface<
+          LocalFiniteElementTraits<Pk3DLocalBasis<D,R,k>,
+              Pk3DLocalCoefficients<k>,
+              Pk3DLocalInterpolation<Pk3DLocalBasis<D,R,k> > >
+#ifndef DUNE_VIRTUAL_SHAPEFUNCTIONS
+          ,Pk3DLocalFiniteElement<D,R,k>
+#endif
+          >
+  {
+  public:
+    /** \todo Please doc me !
+     */
+    typedef LocalFiniteElementTraits<Pk3DLocalBasis<D,R,k>,
+        Pk3DLocalCoefficients<k>,
+        Pk3DLocalInterpolation<Pk3DLocalBasis<D,R,k> > > Traits;
+
+    /** \todo Please doc me !
+     */
+    Pk3DLocalFiniteElement ()
+    {
+      gt.makeTetrahedron();
+    }
+
+    /** \todo Please doc me !
+     */
+    Pk3DLocalFiniteElement (int variant) : coefficients(variant)
+    {
+      gt.makeTetrahedron();
+    }
+
+    /** \brief Element with the given orientation of the edges and faces, see Pk3DLocalCoefficients
+     */
+    Pk3DLocalFiniteElement (int edgeVariant, const Dune::array<int,4>& faceVariant)
+      : coefficients(edgeVariant,faceVariant)
+    {
+      gt.makeTetrahedron();
+    }
+
+    /** \todo Please doc me !
+     */
+    const typename Traits::LocalBasisType& localBasis () const
+    {
+      return basis;
+    }
+
+    /** \todo Please doc me !
+     */
+    const typename Traits::LocalCoefficientsType& localCoefficients () const
+    {
+      return coefficients;
+    }
+
+    /** \todo Please doc me !
+     */
+    const typename Traits::LocalInterpolationType& localInterpolation () const
+    {
+      return interpolation;
+    }
+
+    /** \todo Please doc me !
+     */
+    GeometryType type () const
+    {
+      return gt;
+    }
+
+  private:
+    Pk3DLocalBasis<D,R,k> basis;
+    Pk3DLocalCoefficients<k> coefficients;
+    Pk3DLocalInterpolation<Pk3DLocalBasis<D,R,k> > interpolation;
+    GeometryType gt;
+  };
+
+#if DUNE_LOCALFUNCTIONS_PRECOMPILED && !defined(DUNE_VIRTUAL_SHAPEFUNCTIONS)
+  // instantiated in libdunelocalfunctions, see common/precompiled.hh
+  DUNE_LOCALFUNCTIONS_EXTERN_TEMPLATE class Pk3DLocalBasis<double,double,1>;
+  DUNE_LOCALFUNCTIONS_EXTERN_TEMPLATE class Pk3DLocalBasis<double,double,2>;
+  DUNE_LOCALFUNCTIONS_EXTERN_TEMPLATE class Pk3DLocalBasis<float,float,1>;
+  DUNE_LOCALFUNCTIONS_EXTERN_TEMPLATE class Pk3DLocalBasis<float,float,2>;
+#endif
+
+}
+
+#endif
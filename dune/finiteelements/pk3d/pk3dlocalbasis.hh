@@ -0,0 +1,265 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+#ifndef DUNE_PK3DLOCALBASIS_HH
+#define DUNE_PK3DLOCALBASIS_HH
+
+#include "../common/localbasis.hh"
+#include "../common/localfunction.hh"
+
+namespace Dune
+{
+  /**@ingroup LocalBasisImplementation
+         \brief Lagrange shape functions of arbitrary order on the reference tetrahedron.
+
+         Lagrange shape functions of arbitrary order have the property that
+         \f$\hat\phi^i(x_j) = \delta_{i,j}\f$ for certain points \f$x_j\f$.
+
+         \tparam D Type to represent the field in the domain.
+         \tparam R Type to represent the field in the range.
+         \tparam k Polynomial order.
+
+         \nosubgrouping
+   */
+  template<class D, class R, unsigned int k>
+  class Pk3DLocalBasis :
+    public C1LocalBasisForwarder<
+        C1LocalBasisTraits<D,3,Dune::FieldVector<D,3>,R,1,Dune::FieldVector<R,1>,
+            Dune::FieldVector<Dune::FieldVector<R,3>,1> >,
+        Pk3DLocalBasis<D,R,k>, (k+1)*(k+2)*(k+3)/6>
+  {
+  public:
+    enum {N = (k+1)*(k+2)*(k+3)/6};
+    enum {O = k};
+
+    typedef C1LocalBasisTraits<D,3,Dune::FieldVector<D,3>,R,1,Dune::FieldVector<R,1>,
+        Dune::FieldVector<Dune::FieldVector<R,3>,1> > Traits;
+
+    //! \brief Standard constructor
+    Pk3DLocalBasis ()
+    {
+      inverse[0] = 0.0;
+      for (unsigned int m=1; m<=k; m++)
+        inverse[m] = 1.0/m;
+    }
+
+    //! \brief number of shape functions
+    unsigned int size () const
+    {
+      return N;
+    }
+
+    //! \brief Polynomial order of the shape functions
+    unsigned int order () const
+    {
+      return k;
+    }
+
+  private:
+    friend class C1LocalBasisForwarder<Traits,Pk3DLocalBasis,N>;
+
+    /* The Lagrange nodes are (i/k,j/k,l/k), and the shape function
+       belonging to node (i,j,l) factors into
+         phi_ijl(x) = A_i(x[0]) A_j(x[1]) A_l(x[2]) A_{k-i-j-l}(1-x[0]-x[1]-x[2])
+       with the one-dimensional polynomials
+         A_m(t) = prod_{b<m} (kt-b) / m!,
+       exactly as for Pk2DLocalBasis.  Tabulating A_0,...,A_k for the four
+       barycentric coordinates costs O(k) per point, after which every
+       shape function and its gradient is a product of four tabulated
+       factors. */
+
+    //! \brief A_0(t),...,A_k(t)
+    void evaluateFactors (R t, R* a) const;
+
+    //! \brief A_0(t),...,A_k(t) and their derivatives
+    void evaluateFactors (R t, R* a, R* da) const;
+
+    void evaluateFunctionAt (const typename Traits::DomainType& x,
+                             typename Traits::RangeType* out) const;
+
+    void evaluateJacobianAt (const typename Traits::DomainType& x,
+                             typename Traits::JacobianType* out) const;
+
+    void evaluateFunctionAndJacobianAt (const typename Traits::DomainType& x,
+                                        typename Traits::RangeType* values,
+                                        typename Traits::JacobianType* jacobians) const;
+
+    R inverse[k+1]; // inverse[m] = 1/m, inverse[0] is unused
+
+    friend class LocalFunctionEvaluator<Pk3DLocalBasis>;
+  };
+
+  // not inline, such that the instantiations in libdunelocalfunctions are used
+  template<class D, class R, unsigned int k>
+  void Pk3DLocalBasis<D,R,k>::evaluateFactors (R t, R* a) const
+  {
+    const R kt = k*t;
+    a[0] = 1.0;
+    for (unsigned int m=1; m<=k; m++)
+      a[m] = a[m-1]*(kt-(m-1))*inverse[m];
+  }
+
+  template<class D, class R, unsigned int k>
+  void Pk3DLocalBasis<D,R,k>::evaluateFactors (R t, R* a, R* da) const
+  {
+    const R kt = k*t;
+    a[0] = 1.0;
+    da[0] = 0.0;
+    for (unsigned int m=1; m<=k; m++)
+    {
+      da[m] = (da[m-1]*(kt-(m-1)) + a[m-1]*k)*inverse[m];
+      a[m] = a[m-1]*(kt-(m-1))*inverse[m];
+    }
+  }
+
+  template<class D, class R, unsigned int k>
+  void Pk3DLocalBasis<D,R,k>::evaluateFunctionAt (const typename Traits::DomainType& x,
+                                                  typename Traits::RangeType* out) const
+  {
+    R a[k+1], b[k+1], c[k+1], d[k+1];
+    evaluateFactors(x[0],a);
+    evaluateFactors(x[1],b);
+    evaluateFactors(x[2],c);
+    evaluateFactors(1.0-x[0]-x[1]-x[2],d);
+
+    int n=0;
+    for (unsigned int l=0; l<=k; l++)
+      for (unsigned int j=0; j<=k-l; j++)
+      {
+        const R bc = b[j]*c[l];
+        for (unsigned int i=0; i<=k-j-l; i++)
+          out[n++] = a[i]*bc*d[k-i-j-l];
+      }
+  }
+
+  template<class D, class R, unsigned int k>
+  void Pk3DLocalBasis<D,R,k>::evaluateJacobianAt (const typename Traits::DomainType& x,
+                                                  typename Traits::JacobianType* out) const
+  {
+    typename Traits::RangeType values[N];
+    evaluateFunctionAndJacobianAt(x,values,out);
+  }
+
+  template<class D, class R, unsigned int k>
+  void Pk3DLocalBasis<D,R,k>::evaluateFunctionAndJacobianAt (const typename Traits::DomainType& x,
+                                                             typename Traits::RangeType* values,
+                                                             typename Traits::JacobianType* jacobians) const
+  {
+    R a[k+1], b[k+1], c[k+1], d[k+1], da[k+1], db[k+1], dc[k+1], dd[k+1];
+    evaluateFactors(x[0],a,da);
+    evaluateFactors(x[1],b,db);
+    evaluateFactors(x[2],c,dc);
+    evaluateFactors(1.0-x[0]-x[1]-x[2],d,dd);
+
+    int n=0;
+    for (unsigned int l=0; l<=k; l++)
+      for (unsigned int j=0; j<=k-l; j++)
+        for (unsigned int i=0; i<=k-j-l; i++)
+        {
+          const unsigned int m = k-i-j-l;
+          const R ad = a[i]*d[m];
+          const R bc = b[j]*c[l];
+          values[n] = ad*bc;
+          jacobians[n][0][0] = (da[i]*d[m] - a[i]*dd[m])*bc;
+          jacobians[n][0][1] = (db[j]*d[m] - b[j]*dd[m])*a[i]*c[l];
+          jacobians[n][0][2] = (dc[l]*d[m] - c[l]*dd[m])*a[i]*b[j];
+          n++;
+        }
+  }
+
+
+  /** \brief LocalFunctionEvaluator for Pk3DLocalBasis
+
+      Sums the coefficients against the factorised shape functions line by
+      line and layer by layer, without forming the values of the single
+      shape functions.
+   */
+  template<class D, class R, unsigned int k>
+  class LocalFunctionEvaluator<Pk3DLocalBasis<D,R,k> >
+  {
+    typedef Pk3DLocalBasis<D,R,k> LB;
+
+  public:
+    //! \brief Export type traits of the local basis
+    typedef typename LB::Traits Traits;
+
+    //! \brief Value of the function with coefficients coeff[0],...,coeff[N-1] at position x
+    template<class C>
+    static void evaluateFunction (const LB& lb,
+                                  const typename Traits::DomainType& x,
+                                  const C* coeff,
+                                  typename Traits::RangeType& value)
+    {
+      R a[k+1], b[k+1], c[k+1], d[k+1];
+      lb.evaluateFactors(x[0],a);
+      lb.evaluateFactors(x[1],b);
+      lb.evaluateFactors(x[2],c);
+      lb.evaluateFactors(1.0-x[0]-x[1]-x[2],d);
+
+      R u = 0.0;
+      int n=0;
+      for (unsigned int l=0; l<=k; l++)
+      {
+        R v = 0.0;
+        for (unsigned int j=0; j<=k-l; j++)
+        {
+          R w = 0.0;
+          for (unsigned int i=0; i<=k-j-l; i++)
+            w += coeff[n++]*a[i]*d[k-i-j-l];
+          v += b[j]*w;
+        }
+        u += c[l]*v;
+      }
+      value = u;
+    }
+
+    //! \brief Value and Jacobian of the function with coefficients coeff[0],...,coeff[N-1] at position x
+    template<class C>
+    static void evaluateFunctionAndJacobian (const LB& lb,
+                                             const typename Traits::DomainType& x,
+                                             const C* coeff,
+                                             typename Traits::RangeType& value,
+                                             typename Traits::JacobianType& jacobian)
+    {
+      R a[k+1], b[k+1], c[k+1], d[k+1], da[k+1], db[k+1], dc[k+1], dd[k+1];
+      lb.evaluateFactors(x[0],a,da);
+      lb.evaluateFactors(x[1],b,db);
+      lb.evaluateFactors(x[2],c,dc);
+      lb.evaluateFactors(1.0-x[0]-x[1]-x[2],d,dd);
+
+      // partial sums and their derivatives; the suffix d denotes the
+      // derivative through the fourth barycentric coordinate only
+      R u = 0.0, u0 = 0.0, u1 = 0.0, u2 = 0.0;
+      int n=0;
+      for (unsigned int l=0; l<=k; l++)
+      {
+        R v = 0.0, v0 = 0.0, v1 = 0.0, vd = 0.0;
+        for (unsigned int j=0; j<=k-l; j++)
+        {
+          R w = 0.0, w0 = 0.0, wd = 0.0;
+          for (unsigned int i=0; i<=k-j-l; i++)
+          {
+            const unsigned int m = k-i-j-l;
+            w += coeff[n]*a[i]*d[m];
+            w0 += coeff[n]*(da[i]*d[m] - a[i]*dd[m]);
+            wd -= coeff[n]*a[i]*dd[m];
+            n++;
+          }
+          v += b[j]*w;
+          v0 += b[j]*w0;
+          v1 += db[j]*w + b[j]*wd;
+          vd += b[j]*wd;
+        }
+        u += c[l]*v;
+        u0 += c[l]*v0;
+        u1 += c[l]*v1;
+        u2 += dc[l]*v + c[l]*vd;
+      }
+      value = u;
+      jacobian[0][0] = u0;
+      jacobian[0][1] = u1;
+      jacobian[0][2] = u2;
+    }
+  };
+
+}
+#endif
@@ -0,0 +1,159 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+#ifndef DUNE_PK3DLOCALCOEFFICIENTS_HH
+#define DUNE_PK3DLOCALCOEFFICIENTS_HH
+
+#include <iostream>
+#include <vector>
+
+#include <dune/common/fixedarray.hh>
+
+#include "../common/localcoefficients.hh"
+
+namespace Dune
+{
+
+  /**@ingroup LocalLayoutImplementation
+         \brief Layout map for Pk3D elements
+
+         The Lagrange nodes (i/k,j/k,l/k) are numbered with i running
+         fastest, as in Pk2DLocalCoefficients.  Vertices, edges and faces
+         follow the numbering of the reference tetrahedron: edge 0 connects
+         vertices 0 and 1, then (1,2), (0,2), (0,3), (1,3), (2,3), and face i
+         lies opposite vertex i.
+
+         The degrees of freedom on an edge from vertex a to vertex b, a<b,
+         are numbered starting at a.  The ones on a face with vertices
+         f0<f1<f2 are numbered like the interior nodes of a Pk2D element with
+         f0, f1, f2 as its vertices 0, 1, 2.  Neighbouring elements can
+         agree on this numbering by choosing one of the variants, which flip
+         the order on single edges and permute the vertices of single faces.
+
+         \nosubgrouping
+   */
+  template<unsigned int k>
+  class Pk3DLocalCoefficients
+#if DUNE_VIRTUAL_SHAPEFUNCTIONS
+    : public LocalCoefficientsInterface
+#else
+    : public LocalCoefficientsInterface<Pk3DLocalCoefficients<k> >
+#endif
+  {
+    enum {N = (k+1)*(k+2)*(k+3)/6};
+
+  public:
+    //! \brief Standard constructor
+    Pk3DLocalCoefficients ()
+    {
+      Dune::array<int,4> faceVariant;
+      for (int f=0; f<4; f++)
+        faceVariant[f] = 0;
+      fill(0,faceVariant);
+    }
+
+    //! constructor for the 64 variants with order on edges flipped
+    Pk3DLocalCoefficients (int edgeVariant)
+    {
+      Dune::array<int,4> faceVariant;
+      for (int f=0; f<4; f++)
+        faceVariant[f] = 0;
+      fill(edgeVariant,faceVariant);
+    }
+
+    /** \brief constructor for all edge and face variants
+
+        \param edgeVariant  Bit i set means that the order on edge i is flipped
+        \param faceVariant  Entry i, 0<=faceVariant[i]<6, selects the
+                            permutation of the vertices of face i, see
+                            facePermutation()
+     */
+    Pk3DLocalCoefficients (int edgeVariant, const Dune::array<int,4>& faceVariant)
+    {
+      fill(edgeVariant,faceVariant);
+    }
+
+    //! number of coefficients
+    int size () const
+    {
+      return N;
+    }
+
+    //! get i'th index
+    const LocalKey& localKey (int i) const
+    {
+      return li[i];
+    }
+
+    //! get i'th index, packed into 32 bits
+    const PackedLocalKey& packedLocalKey (int i) const
+    {
+      return packed[i];
+    }
+
+    //! \brief Local vertex of face variant v that takes the role of local vertex r, 0<=r<3
+    static int facePermutation (int v, int r)
+    {
+      static const int permutation[6][3] = {{0,1,2},{0,2,1},{1,0,2},{1,2,0},{2,0,1},{2,1,0}};
+      return permutation[v][r];
+    }
+
+  private:
+    // the keys depend on too many variants to share them in a LocalKeyTable
+    LocalKey li[N];
+    PackedLocalKey packed[N];
+
+    void fill (int edgeVariant, const Dune::array<int,4>& faceVariant)
+    {
+      static const int edge[4][4] = {{-1,0,2,3},{0,-1,1,4},{2,1,-1,5},{3,4,5,-1}};
+
+      int n=0;
+      int c=0;
+      for (unsigned int l=0; l<=k; l++)
+        for (unsigned int j=0; j<=k-l; j++)
+          for (unsigned int i=0; i<=k-j-l; i++)
+          {
+            // barycentric weights of the node, times k
+            const int w[4] = {int(k-i-j-l), int(i), int(j), int(l)};
+
+            // vertices of the subentity that contains the node
+            int v[4];
+            int count=0;
+            for (int r=0; r<4; r++)
+              if (w[r]>0)
+                v[count++] = r;
+
+            switch (count)
+            {
+            case 1 :
+              li[n++] = LocalKey(v[0],3,0);
+              break;
+            case 2 :
+            {
+              const int e = edge[v[0]][v[1]];
+              const int index = w[v[1]]-1;
+              li[n++] = LocalKey(e,2,(edgeVariant & (1<<e)) ? k-2-index : index);
+              break;
+            }
+            case 3 :
+            {
+              // the face lies opposite the vertex with zero weight
+              const int f = 6-v[0]-v[1]-v[2];
+              const int a = w[v[facePermutation(faceVariant[f],1)]]-1;
+              const int b = w[v[facePermutation(faceVariant[f],2)]]-1;
+              // interior nodes of the face form a triangle of order k-3
+              li[n++] = LocalKey(f,1,b*(k-2) - b*(b-1)/2 + a);
+              break;
+            }
+            default :
+              li[n++] = LocalKey(0,0,c++);
+            }
+          }
+
+      for (int i=0; i<N; i++)
+        packed[i] = PackedLocalKey(li[i]);
+    }
+  };
+
+}
+
+#endif
@@ -0,0 +1,58 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+#ifndef DUNE_PK3DLOCALINTERPOLATION_HH
+#define DUNE_PK3DLOCALINTERPOLATION_HH
+
+#include "../common/localinterpolation.hh"
+
+namespace Dune
+{
+  template<class LB>
+  class Pk3DLocalInterpolation
+    : public LocalInterpolationInterface<Pk3DLocalInterpolation<LB> >
+  {
+    enum {N = LB::N};
+    enum {k = LB::O};
+  public:
+
+    //! \brief Local interpolation of a function
+    template<typename F, typename C>
+    void interpolate (const F& f, std::vector<C>& out) const
+    {
+      out.resize(N);
+      interpolate(f,&out[0]);
+    }
+
+    //! \brief Local interpolation into caller-provided storage with room for all coefficients
+    template<typename F, typename C>
+    void interpolate (const F& f, C* out) const
+    {
+      typename LB::Traits::DomainType x;
+      typename LB::Traits::RangeType y;
+      typedef typename LB::Traits::DomainFieldType D;
+
+      if (k==0)
+      {
+        // the single node is the center of the tetrahedron
+        x = 0.25;
+        f.evaluate(x,y);
+        out[0] = y;
+        return;
+      }
+
+      int n=0;
+      for (int l=0; l<=k; l++)
+        for (int j=0; j<=k-l; j++)
+          for (int i=0; i<=k-j-l; i++)
+          {
+            x[0] = ((D)i)/((D)k); x[1] = ((D)j)/((D)k); x[2] = ((D)l)/((D)k);
+            f.evaluate(x,y);
+            out[n] = y;
+            n++;
+          }
+    }
+
+  };
+}
+
+#endif
@@ -3,7 +3,10 @@
 #ifndef DUNE_Q12DLOCALBASIS_HH
 #define DUNE_Q12DLOCALBASIS_HH
 
+#include <cassert>
+
 #include "../common/localbasis.hh"
+#include "../common/tensorproductlayout.hh"
 
 namespace Dune
 {
@@ -19,15 +22,15 @@ namespace Dune
    */
   template<class D, class R>
   class Q12DLocalBasis :
-    public C1LocalBasisInterface<
+    public C1LocalBasisForwarder<
         C1LocalBasisTraits<D,2,Dune::FieldVector<D,2>,R,1,Dune::FieldVector<R,1>,
-            Dune::FieldVector<Dune::FieldVector<R,2>,1> >
-#ifndef DUNE_VIRTUAL_SHAPEFUNCTIONS
-        ,Q12DLocalBasis<D,R>
-#endif
-        >
+            Dune::FieldVector<Dune::FieldVector<R,2>,1> >,
+        Q12DLocalBasis<D,R>, 4>
   {
   public:
+    //! \brief Number of shape functions as a compile-time constant
+    enum {N = 4};
+
     typedef C1LocalBasisTraits<D,2,Dune::FieldVector<D,2>,R,1,Dune::FieldVector<R,1>,
         Dune::FieldVector<Dune::FieldVector<R,2>,1> > Traits;
 
@@ -37,27 +40,36 @@ namespace Dune
       return 4;
     }
 
-    //! \brief Evaluate all shape functions
-    inline void evaluateFunction (const typename Traits::DomainType& in,
-                                  std::vector<typename Traits::RangeType>& out) const
+    //! \brief Evaluate all shape functions and their partial derivatives up to order r
+    template<int r>
+    inline void evaluateJet (const typename Traits::DomainType& in,
+                             std::vector<LocalBasisJet<Traits,r> >& out) const
+    {
+      out.resize(N);
+      evaluateJetAt<r>(in,&out[0]);
+    }
+
+    //! \brief Evaluate the jets of all shape functions into caller-provided storage with room for \a capacity >= N values
+    template<int r>
+    inline void evaluateJet (const typename Traits::DomainType& in,
+                             LocalBasisJet<Traits,r>* out,
+                             unsigned int capacity) const
     {
-      out.resize(4);
-      out[0] = (1-in[0])*(1-in[1]);
-      out[1] = (  in[0])*(1-in[1]);
-      out[2] = (1-in[0])*(  in[1]);
-      out[3] = (  in[0])*(  in[1]);
+      assert(capacity >= N);
+      evaluateJetAt<r>(in,out);
     }
 
-    //! \brief Evaluate Jacobian of all shape functions
-    inline void
-    evaluateJacobian (const typename Traits::DomainType& in,         // position
-                      std::vector<typename Traits::JacobianType>& out) const      // return value
+    //! \brief Evaluate the derivative of all shape functions in the given directions, of order r <= 3
+    template<int r>
+    inline void evaluate (const Dune::array<int,r>& directions,
+                          const typename Traits::DomainType& in,
+                          std::vector<typename Traits::RangeType>& out) const
     {
-      out.resize(4);
-      out[0][0][0] = in[1]-1; out[0][0][1] = in[0]-1;
-      out[1][0][0] = 1-in[1]; out[1][0][1] = -in[0];
-      out[2][0][0] =  -in[1]; out[2][0][1] = 1-in[0];
-      out[3][0][0] =   in[1]; out[3][0][1] = in[0];
+      LocalBasisJet<Traits,r> jets[N];
+      evaluateJetAt<r>(in,jets);
+      out.resize(N);
+      for (int i=0; i<N; i++)
+        out[i] = LocalBasisJetImp::derivative(jets[i],directions);
     }
 
     //! \brief Polynomial order of the shape functions
@@ -65,6 +77,79 @@ namespace Dune
     {
       return 1;
     }
+
+  private:
+    friend class C1LocalBasisForwarder<Traits,Q12DLocalBasis,N>;
+
+    void evaluateFunctionAt (const typename Traits::DomainType& in,
+                             typename Traits::RangeType* out) const;
+
+    void evaluateJacobianAt (const typename Traits::DomainType& in,
+                             typename Traits::JacobianType* out) const;
+
+    void evaluateFunctionAndJacobianAt (const typename Traits::DomainType& in,
+                                        typename Traits::RangeType* values,
+                                        typename Traits::JacobianType* jacobians) const;
+
+    template<int r>
+    inline void evaluateJetAt (const typename Traits::DomainType& in,
+                               LocalBasisJet<Traits,r>* out) const
+    {
+      LocalBasisJetImp::tensorProductJet<Q12DLocalBasis,r>(in,out);
+    }
+  };
+
+  // not inline, such that the instantiations in libdunelocalfunctions are used
+  template<class D, class R>
+  void Q12DLocalBasis<D,R>::evaluateFunctionAt (const typename Traits::DomainType& in,
+                                                typename Traits::RangeType* out) const
+  {
+    out[0] = (1-in[0])*(1-in[1]);
+    out[1] = (  in[0])*(1-in[1]);
+    out[2] = (1-in[0])*(  in[1]);
+    out[3] = (  in[0])*(  in[1]);
+  }
+
+  template<class D, class R>
+  void Q12DLocalBasis<D,R>::evaluateJacobianAt (const typename Traits::DomainType& in,
+                                                typename Traits::JacobianType* out) const
+  {
+    out[0][0][0] = in[1]-1; out[0][0][1] = in[0]-1;
+    out[1][0][0] = 1-in[1]; out[1][0][1] = -in[0];
+    out[2][0][0] =  -in[1]; out[2][0][1] = 1-in[0];
+    out[3][0][0] =   in[1]; out[3][0][1] = in[0];
+  }
+
+  template<class D, class R>
+  void Q12DLocalBasis<D,R>::evaluateFunctionAndJacobianAt (const typename Traits::DomainType& in,
+                                                           typename Traits::RangeType* values,
+                                                           typename Traits::JacobianType* jacobians) const
+  {
+    R x=in[0], y=in[1];
+    R X0=1-x, Y0=1-y;
+
+    values[0] = X0*Y0;
+    values[1] =  x*Y0;
+    values[2] = X0*y;
+    values[3] =  x*y;
+
+    jacobians[0][0][0] = -Y0; jacobians[0][0][1] = -X0;
+    jacobians[1][0][0] =  Y0; jacobians[1][0][1] =  -x;
+    jacobians[2][0][0] =  -y; jacobians[2][0][1] =  X0;
+    jacobians[3][0][0] =   y; jacobians[3][0][1] =   x;
+  }
+
+
+  //! \brief The shape functions of Q12DLocalBasis are numbered lexicographically
+  template<class D, class R>
+  struct TensorProductLayout<Q12DLocalBasis<D,R> >
+  {
+    enum {dim = 2, k = 1};
+
+    static unsigned int index (unsigned int l)
+    {
+      return l;
+    }
   };
 }
 #endif
@@ -23,13 +23,13 @@ namespace Dune
     : public LocalCoefficientsInterface<Q12DLocalCoefficients>
 #endif
   {
+    typedef LocalKeyTable<Q12DLocalCoefficients,4> Table;
+    friend class LocalKeyTable<Q12DLocalCoefficients,4>;
+
   public:
     //! \brief Standard constructor
-    Q12DLocalCoefficients () : li(4)
-    {
-      for (int i=0; i<4; i++)
-        li[i] = LocalKey(i,2,0);
-    }
+    Q12DLocalCoefficients () : li(Table::keys()), packed(Table::packedKeys())
+    {}
 
     //! number of coefficients
     int size () const
@@ -43,8 +43,21 @@ namespace Dune
       return li[i];
     }
 
+    //! get i'th index, packed into 32 bits
+    const PackedLocalKey& packedLocalKey (int i) const
+    {
+      return packed[i];
+    }
+
   private:
-    std::vector<LocalKey> li;
+    const LocalKey* li;
+    const PackedLocalKey* packed;
+
+    static void fill (int, LocalKey* keys)
+    {
+      for (int i=0; i<4; i++)
+        keys[i] = LocalKey(i,2,0);
+    }
   };
 
 }
@@ -18,11 +18,18 @@ namespace Dune
     //! \brief Local interpolation of a function
     template<typename F, typename C>
     void interpolate (const F& f, std::vector<C>& out) const
+    {
+      out.resize(4);
+      interpolate(f,&out[0]);
+    }
+
+    //! \brief Local interpolation into caller-provided storage with room for all coefficients
+    template<typename F, typename C>
+    void interpolate (const F& f, C* out) const
     {
       typename LB::Traits::DomainType x;
       typename LB::Traits::RangeType y;
 
-      out.resize(4);
       x[0] = 0.0; x[1] = 0.0; f.evaluate(x,y); out[0] = y;
       x[0] = 1.0; x[1] = 0.0; f.evaluate(x,y); out[1] = y;
       x[0] = 0.0; x[1] = 1.0; f.evaluate(x,y); out[2] = y;
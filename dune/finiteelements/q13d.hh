@@ -6,6 +6,7 @@
 #include <dune/common/geometrytype.hh>
 
 #include "common/localfiniteelement.hh"
+#include "common/precompiled.hh"
 #include "q13d/q13dlocalbasis.hh"
 #include "q13d/q13dlocalcoefficients.hh"
 #include "q13d/q13dlocalinterpolation.hh"
@@ -18,8 +19,11 @@ namespace Dune
   template<class D, class R>
   class Q13DLocalFiniteElement : LocalFiniteElementInterface<
                                      LocalFiniteElementTraits<Q13DLocalBasis<D,R>,Q13DLocalCoefficients,
-                                         Q13DLocalInterpolation<Q13DLocalBasis<D,R> > >,
-                                     Q13DLocalFiniteElement<D,R> >
+                                         Q13DLocalInterpolation<Q13DLocalBasis<D,R> > >
+#ifndef DUNE_VIRTUAL_SHAPEFUNCTIONS
+                                     ,Q13DLocalFiniteElement<D,R>
+#endif
+                                     >
   {
   public:
     /** \todo Please doc me !
@@ -69,6 +73,12 @@ namespace Dune
     GeometryType gt;
   };
 
+#if DUNE_LOCALFUNCTIONS_PRECOMPILED && !defined(DUNE_VIRTUAL_SHAPEFUNCTIONS)
+  // instantiated in libdunelocalfunctions, see common/precompiled.hh
+  DUNE_LOCALFUNCTIONS_EXTERN_TEMPLATE class Q13DLocalBasis<double,double>;
+  DUNE_LOCALFUNCTIONS_EXTERN_TEMPLATE class Q13DLocalBasis<float,float>;
+#endif
+
 }
 
 #endif
@@ -3,7 +3,10 @@
 #ifndef DUNE_Q13DLOCALBASIS_HH
 #define DUNE_Q13DLOCALBASIS_HH
 
+#include <cassert>
+
 #include "../common/localbasis.hh"
+#include "../common/tensorproductlayout.hh"
 
 namespace Dune
 {
@@ -19,12 +22,15 @@ namespace Dune
    */
   template<class D, class R>
   class Q13DLocalBasis :
-    public C1LocalBasisInterface<
+    public C1LocalBasisForwarder<
         C1LocalBasisTraits<D,3,Dune::FieldVector<D,3>,R,1,Dune::FieldVector<R,1>,
             Dune::FieldVector<Dune::FieldVector<R,3>,1> >,
-        Q13DLocalBasis<D,R> >
+        Q13DLocalBasis<D,R>, 8>
   {
   public:
+    //! \brief Number of shape functions as a compile-time constant
+    enum {N = 8};
+
     typedef C1LocalBasisTraits<D,3,Dune::FieldVector<D,3>,R,1,Dune::FieldVector<R,1>,
         Dune::FieldVector<Dune::FieldVector<R,3>,1> > Traits;
 
@@ -34,44 +40,36 @@ namespace Dune
       return 8;
     }
 
-    //! \brief Evaluate all shape functions
-    inline void evaluateFunction (const typename Traits::DomainType& in,
-                                  std::vector<typename Traits::RangeType>& out) const
+    //! \brief Evaluate all shape functions and their partial derivatives up to order r
+    template<int r>
+    inline void evaluateJet (const typename Traits::DomainType& in,
+                             std::vector<LocalBasisJet<Traits,r> >& out) const
+    {
+      out.resize(N);
+      evaluateJetAt<r>(in,&out[0]);
+    }
+
+    //! \brief Evaluate the jets of all shape functions into caller-provided storage with room for \a capacity >= N values
+    template<int r>
+    inline void evaluateJet (const typename Traits::DomainType& in,
+                             LocalBasisJet<Traits,r>* out,
+                             unsigned int capacity) const
     {
-      out.resize(8);
-      out[0] = (1-in[0])*(1-in[1])*(1-in[2]);
-      out[1] = (  in[0])*(1-in[1])*(1-in[2]);
-      out[2] = (1-in[0])*(  in[1])*(1-in[2]);
-      out[3] = (  in[0])*(  in[1])*(1-in[2]);
-      out[4] = (1-in[0])*(1-in[1])*(  in[2]);
-      out[5] = (  in[0])*(1-in[1])*(  in[2]);
-      out[6] = (1-in[0])*(  in[1])*(  in[2]);
-      out[7] = (  in[0])*(  in[1])*(  in[2]);
+      assert(capacity >= N);
+      evaluateJetAt<r>(in,out);
     }
 
-    //! \brief Evaluate Jacobian of all shape functions
-    inline void
-    evaluateJacobian (const typename Traits::DomainType& in,       // position
-                      std::vector<typename Traits::JacobianType>& out) const                        // return value
+    //! \brief Evaluate the derivative of all shape functions in the given directions, of order r <= 3
+    template<int r>
+    inline void evaluate (const Dune::array<int,r>& directions,
+                          const typename Traits::DomainType& in,
+                          std::vector<typename Traits::RangeType>& out) const
     {
-      out.resize(8);
-      out[0][0][0] = -(1-in[1])*(1-in[2]); out[0][0][1] = -(1-in[0])*(1-in[2]); out[0][0][2] = -(1-in[0])*(1-in[1]);
-      out[1][0][0] = +(1-in[1])*(1-in[2]); out[1][0][1] = -(  in[0])*(1-in[2]); out[1][0][2] = -(  in[0])*(1-in[1]);
-      out[2][0][0] = -(  in[1])*(1-in[2]); out[2][0][1] = +(1-in[0])*(1-in[2]); out[2][0][2] = -(1-in[0])*(  in[1]);
-      out[3][0][0] = +(  in[1])*(1-in[2]); out[3][0][1] = +(  in[0])*(1-in[2]); out[3][0][2] = -(  in[0])*(  in[1]);
-      out[4][0][0] = -(1-in[1])*(  in[2]); out[4][0][1] = -(1-in[0])*(  in[2]); out[4][0][2] = +(1-in[0])*(1-in[1]);
-      out[5][0][0] = +(1-in[1])*(  in[2]); out[5][0][1] = -(  in[0])*(  in[2]); out[5][0][2] = +(  in[0])*(1-in[1]);
-      out[6][0][0] = -(  in[1])*(  in[2]); out[6][0][1] = +(1-in[0])*(  in[2]); out[6][0][2] = +(1-in[0])*(  in[1]);
-      out[7][0][0] = +(  in[1])*(  in[2]); out[7][0][1] = +(  in[0])*(  in[2]); out[7][0][2] = +(  in[0])*(  in[1]);
-
-      //        out[0][0][0] = -(1-in[1])*(1-in[2]); out[0][0][1] = -(1-in[0])*(1-in[2]); out[0][0][2] = -(1-in[1])*(1-in[2]);
-      //        out[1][0][0] = +(1-in[1])*(1-in[2]); out[1][0][1] = -(1-in[0])*(1-in[2]); out[1][0][2] = -(1-in[1])*(1-in[2]);
-      //        out[2][0][0] = -(1-in[1])*(1-in[2]); out[2][0][1] = +(1-in[0])*(1-in[2]); out[2][0][2] = -(1-in[1])*(1-in[2]);
-      //        out[3][0][0] = +(1-in[1])*(1-in[2]); out[3][0][1] = +(1-in[0])*(1-in[2]); out[3][0][2] = -(1-in[1])*(1-in[2]);
-      //        out[4][0][0] = -(1-in[1])*(1-in[2]); out[4][0][1] = -(1-in[0])*(1-in[2]); out[4][0][2] = +(1-in[1])*(1-in[2]);
-      //        out[5][0][0] = +(1-in[1])*(1-in[2]); out[5][0][1] = -(1-in[0])*(1-in[2]); out[5][0][2] = +(1-in[1])*(1-in[2]);
-      //        out[6][0][0] = -(1-in[1])*(1-in[2]); out[6][0][1] = +(1-in[0])*(1-in[2]); out[6][0][2] = +(1-in[1])*(1-in[2]);
-      //        out[7][0][0] = +(1-in[1])*(1-in[2]); out[7][0][1] = +(1-in[0])*(1-in[2]); out[7][0][2] = +(1-in[1])*(1-in[2]);
+      LocalBasisJet<Traits,r> jets[N];
+      evaluateJetAt<r>(in,jets);
+      out.resize(N);
+      for (int i=0; i<N; i++)
+        out[i] = LocalBasisJetImp::derivative(jets[i],directions);
     }
 
     //! \brief Polynomial order of the shape functions
@@ -79,6 +77,108 @@ namespace Dune
     {
       return 1;
     }
+
+  private:
+    friend class C1LocalBasisForwarder<Traits,Q13DLocalBasis,N>;
+
+    void evaluateFunctionAt (const typename Traits::DomainType& in,
+                             typename Traits::RangeType* out) const;
+
+    void evaluateJacobianAt (const typename Traits::DomainType& in,
+                             typename Traits::JacobianType* out) const;
+
+    void evaluateFunctionAndJacobianAt (const typename Traits::DomainType& in,
+                                        typename Traits::RangeType* values,
+                                        typename Traits::JacobianType* jacobians) const;
+
+    template<int r>
+    inline void evaluateJetAt (const typename Traits::DomainType& in,
+                               LocalBasisJet<Traits,r>* out) const
+    {
+      LocalBasisJetImp::tensorProductJet<Q13DLocalBasis,r>(in,out);
+    }
+  };
+
+  // not inline, such that the instantiations in libdunelocalfunctions are used
+  template<class D, class R>
+  void Q13DLocalBasis<D,R>::evaluateFunctionAt (const typename Traits::DomainType& in,
+                                                typename Traits::RangeType* out) const
+  {
+    out[0] = (1-in[0])*(1-in[1])*(1-in[2]);
+    out[1] = (  in[0])*(1-in[1])*(1-in[2]);
+    out[2] = (1-in[0])*(  in[1])*(1-in[2]);
+    out[3] = (  in[0])*(  in[1])*(1-in[2]);
+    out[4] = (1-in[0])*(1-in[1])*(  in[2]);
+    out[5] = (  in[0])*(1-in[1])*(  in[2]);
+    out[6] = (1-in[0])*(  in[1])*(  in[2]);
+    out[7] = (  in[0])*(  in[1])*(  in[2]);
+  }
+
+  template<class D, class R>
+  void Q13DLocalBasis<D,R>::evaluateJacobianAt (const typename Traits::DomainType& in,
+                                                typename Traits::JacobianType* out) const
+  {
+    out[0][0][0] = -(1-in[1])*(1-in[2]); out[0][0][1] = -(1-in[0])*(1-in[2]); out[0][0][2] = -(1-in[0])*(1-in[1]);
+    out[1][0][0] = +(1-in[1])*(1-in[2]); out[1][0][1] = -(  in[0])*(1-in[2]); out[1][0][2] = -(  in[0])*(1-in[1]);
+    out[2][0][0] = -(  in[1])*(1-in[2]); out[2][0][1] = +(1-in[0])*(1-in[2]); out[2][0][2] = -(1-in[0])*(  in[1]);
+    out[3][0][0] = +(  in[1])*(1-in[2]); out[3][0][1] = +(  in[0])*(1-in[2]); out[3][0][2] = -(  in[0])*(  in[1]);
+    out[4][0][0] = -(1-in[1])*(  in[2]); out[4][0][1] = -(1-in[0])*(  in[2]); out[4][0][2] = +(1-in[0])*(1-in[1]);
+    out[5][0][0] = +(1-in[1])*(  in[2]); out[5][0][1] = -(  in[0])*(  in[2]); out[5][0][2] = +(  in[0])*(1-in[1]);
+    out[6][0][0] = -(  in[1])*(  in[2]); out[6][0][1] = +(1-in[0])*(  in[2]); out[6][0][2] = +(1-in[0])*(  in[1]);
+    out[7][0][0] = +(  in[1])*(  in[2]); out[7][0][1] = +(  in[0])*(  in[2]); out[7][0][2] = +(  in[0])*(  in[1]);
+
+    //        out[0][0][0] = -(1-in[1])*(1-in[2]); out[0][0][1] = -(1-in[0])*(1-in[2]); out[0][0][2] = -(1-in[1])*(1-in[2]);
+    //        out[1][0][0] = +(1-in[1])*(1-in[2]); out[1][0][1] = -(1-in[0])*(1-in[2]); out[1][0][2] = -(1-in[1])*(1-in[2]);
+    //        out[2][0][0] = -(1-in[1])*(1-in[2]); out[2][0][1] = +(1-in[0])*(1-in[2]); out[2][0][2] = -(1-in[1])*(1-in[2]);
+    //        out[3][0][0] = +(1-in[1])*(1-in[2]); out[3][0][1] = +(1-in[0])*(1-in[2]); out[3][0][2] = -(1-in[1])*(1-in[2]);
+    //        out[4][0][0] = -(1-in[1])*(1-in[2]); out[4][0][1] = -(1-in[0])*(1-in[2]); out[4][0][2] = +(1-in[1])*(1-in[2]);
+    //        out[5][0][0] = +(1-in[1])*(1-in[2]); out[5][0][1] = -(1-in[0])*(1-in[2]); out[5][0][2] = +(1-in[1])*(1-in[2]);
+    //        out[6][0][0] = -(1-in[1])*(1-in[2]); out[6][0][1] = +(1-in[0])*(1-in[2]); out[6][0][2] = +(1-in[1])*(1-in[2]);
+    //        out[7][0][0] = +(1-in[1])*(1-in[2]); out[7][0][1] = +(1-in[0])*(1-in[2]); out[7][0][2] = +(1-in[1])*(1-in[2]);
+  }
+
+  template<class D, class R>
+  void Q13DLocalBasis<D,R>::evaluateFunctionAndJacobianAt (const typename Traits::DomainType& in,
+                                                           typename Traits::RangeType* values,
+                                                           typename Traits::JacobianType* jacobians) const
+  {
+    // the linear factors in each direction and the products of pairs of them
+    R x0=in[0], x1=in[1], x2=in[2];
+    R y0=1-x0, y1=1-x1, y2=1-x2;
+    R y1y2=y1*y2, x1y2=x1*y2, y1x2=y1*x2, x1x2=x1*x2;
+    R y0y2=y0*y2, x0y2=x0*y2, y0x2=y0*x2, x0x2=x0*x2;
+    R y0y1=y0*y1, x0y1=x0*y1, y0x1=y0*x1, x0x1=x0*x1;
+
+    values[0] = y0*y1y2;
+    values[1] = x0*y1y2;
+    values[2] = y0*x1y2;
+    values[3] = x0*x1y2;
+    values[4] = y0*y1x2;
+    values[5] = x0*y1x2;
+    values[6] = y0*x1x2;
+    values[7] = x0*x1x2;
+
+    jacobians[0][0][0] = -y1y2; jacobians[0][0][1] = -y0y2; jacobians[0][0][2] = -y0y1;
+    jacobians[1][0][0] = +y1y2; jacobians[1][0][1] = -x0y2; jacobians[1][0][2] = -x0y1;
+    jacobians[2][0][0] = -x1y2; jacobians[2][0][1] = +y0y2; jacobians[2][0][2] = -y0x1;
+    jacobians[3][0][0] = +x1y2; jacobians[3][0][1] = +x0y2; jacobians[3][0][2] = -x0x1;
+    jacobians[4][0][0] = -y1x2; jacobians[4][0][1] = -y0x2; jacobians[4][0][2] = +y0y1;
+    jacobians[5][0][0] = +y1x2; jacobians[5][0][1] = -x0x2; jacobians[5][0][2] = +x0y1;
+    jacobians[6][0][0] = -x1x2; jacobians[6][0][1] = +y0x2; jacobians[6][0][2] = +y0x1;
+    jacobians[7][0][0] = +x1x2; jacobians[7][0][1] = +x0x2; jacobians[7][0][2] = +x0x1;
+  }
+
+
+  //! \brief The shape functions of Q13DLocalBasis are numbered lexicographically
+  template<class D, class R>
+  struct TensorProductLayout<Q13DLocalBasis<D,R> >
+  {
+    enum {dim = 3, k = 1};
+
+    static unsigned int index (unsigned int l)
+    {
+      return l;
+    }
   };
 }
 #endif
@@ -16,15 +16,20 @@ namespace Dune
 
          \nosubgrouping
    */
-  class Q13DLocalCoefficients : public LocalCoefficientsInterface<Q13DLocalCoefficients>
+  class Q13DLocalCoefficients
+#if DUNE_VIRTUAL_SHAPEFUNCTIONS
+    : public LocalCoefficientsInterface
+#else
+    : public LocalCoefficientsInterface<Q13DLocalCoefficients>
+#endif
   {
+    typedef LocalKeyTable<Q13DLocalCoefficients,8> Table;
+    friend class LocalKeyTable<Q13DLocalCoefficients,8>;
+
   public:
     //! \brief Standard constructor
-    Q13DLocalCoefficients () : li(8)
-    {
-      for (int i=0; i<8; i++)
-        li[i] = LocalKey(i,3,0);
-    }
+    Q13DLocalCoefficients () : li(Table::keys()), packed(Table::packedKeys())
+    {}
 
     //! number of coefficients
     int size () const
@@ -38,8 +43,21 @@ namespace Dune
       return li[i];
     }
 
+    //! get i'th index, packed into 32 bits
+    const PackedLocalKey& packedLocalKey (int i) const
+    {
+      return packed[i];
+    }
+
   private:
-    std::vector<LocalKey> li;
+    const LocalKey* li;
+    const PackedLocalKey* packed;
+
+    static void fill (int, LocalKey* keys)
+    {
+      for (int i=0; i<8; i++)
+        keys[i] = LocalKey(i,3,0);
+    }
   };
 
 }
@@ -6,6 +6,7 @@
 #include <dune/common/geometrytype.hh>
 
 #include "common/localfiniteelement.hh"
+#include "common/precompiled.hh"
 #include "q22d/q22dlocalbasis.hh"
 #include "q22d/q22dlocalcoefficients.hh"
 #include "q22d/q22dlocalinterpolation.hh"
@@ -18,8 +19,11 @@ namespace Dune
   template<class D, class R>
   class Q22DLocalFiniteElement : LocalFiniteElementInterface<
                                      LocalFiniteElementTraits<Q22DLocalBasis<D,R>,Q22DLocalCoefficients,
-                                         Q22DLocalInterpolation<Q22DLocalBasis<D,R> > >,
-                                     Q22DLocalFiniteElement<D,R> >
+                                         Q22DLocalInterpolation<Q22DLocalBasis<D,R> > >
+#ifndef DUNE_VIRTUAL_SHAPEFUNCTIONS
+                                     ,Q22DLocalFiniteElement<D,R>
+#endif
+                                     >
   {
   public:
     /** \todo Please doc me !
@@ -69,6 +73,12 @@ namespace Dune
     GeometryType gt;
   };
 
+#if DUNE_LOCALFUNCTIONS_PRECOMPILED && !defined(DUNE_VIRTUAL_SHAPEFUNCTIONS)
+  // instantiated in libdunelocalfunctions, see common/precompiled.hh
+  DUNE_LOCALFUNCTIONS_EXTERN_TEMPLATE class Q22DLocalBasis<double,double>;
+  DUNE_LOCALFUNCTIONS_EXTERN_TEMPLATE class Q22DLocalBasis<float,float>;
+#endif
+
 }
 
 #endif
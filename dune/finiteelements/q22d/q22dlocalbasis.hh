@@ -3,7 +3,10 @@
 #ifndef DUNE_Q22DLOCALBASIS_HH
 #define DUNE_Q22DLOCALBASIS_HH
 
+#include <cassert>
+
 #include "../common/localbasis.hh"
+#include "../common/tensorproductlayout.hh"
 
 namespace Dune
 {
@@ -19,12 +22,15 @@ namespace Dune
    */
   template<class D, class R>
   class Q22DLocalBasis :
-    public C1LocalBasisInterface<
+    public C1LocalBasisForwarder<
         C1LocalBasisTraits<D,2,Dune::FieldVector<D,2>,R,1,Dune::FieldVector<R,1>,
             Dune::FieldVector<Dune::FieldVector<R,2>,1> >,
-        Q22DLocalBasis<D,R> >
+        Q22DLocalBasis<D,R>, 9>
   {
   public:
+    //! \brief Number of shape functions as a compile-time constant
+    enum {N = 9};
+
     typedef C1LocalBasisTraits<D,2,Dune::FieldVector<D,2>,R,1,Dune::FieldVector<R,1>,
         Dune::FieldVector<Dune::FieldVector<R,2>,1> > Traits;
 
@@ -34,56 +40,143 @@ namespace Dune
       return 9;
     }
 
-    //! \brief Evaluate all shape functions
-    inline void evaluateFunction (const typename Traits::DomainType& in,
-                                  std::vector<typename Traits::RangeType>& out) const
+    //! \brief Evaluate all shape functions and their partial derivatives up to order r
+    template<int r>
+    inline void evaluateJet (const typename Traits::DomainType& in,
+                             std::vector<LocalBasisJet<Traits,r> >& out) const
     {
-      out.resize(9);
-
-      R x=in[0], y=in[1];
-      R X0=2*x*x-3*x+1, X1=-4*x*x+4*x, X2=2*x*x-x;
-      R Y0=2*y*y-3*y+1, Y1=-4*y*y+4*y, Y2=2*y*y-y;
-
-      out[2] = X0*Y2;
-      out[7] = X1*Y2;
-      out[3] = X2*Y2;
+      out.resize(N);
+      evaluateJetAt<r>(in,&out[0]);
+    }
 
-      out[4] = X0*Y1;
-      out[8] = X1*Y1;
-      out[5] = X2*Y1;
+    //! \brief Evaluate the jets of all shape functions into caller-provided storage with room for \a capacity >= N values
+    template<int r>
+    inline void evaluateJet (const typename Traits::DomainType& in,
+                             LocalBasisJet<Traits,r>* out,
+                             unsigned int capacity) const
+    {
+      assert(capacity >= N);
+      evaluateJetAt<r>(in,out);
+    }
 
-      out[0] = X0*Y0;
-      out[6] = X1*Y0;
-      out[1] = X2*Y0;
+    //! \brief Evaluate the derivative of all shape functions in the given directions, of order r <= 3
+    template<int r>
+    inline void evaluate (const Dune::array<int,r>& directions,
+                          const typename Traits::DomainType& in,
+                          std::vector<typename Traits::RangeType>& out) const
+    {
+      LocalBasisJet<Traits,r> jets[N];
+      evaluateJetAt<r>(in,jets);
+      out.resize(N);
+      for (int i=0; i<N; i++)
+        out[i] = LocalBasisJetImp::derivative(jets[i],directions);
     }
 
-    //! \brief Evaluate Jacobian of all shape functions
-    inline void
-    evaluateJacobian (const typename Traits::DomainType& in,       // position
-                      std::vector<typename Traits::JacobianType>& out) const        // return value
+    //! \brief Polynomial order of the shape functions
+    unsigned int order () const
     {
-      out.resize(9);
+      return 2;
+    }
+
+  private:
+    friend class C1LocalBasisForwarder<Traits,Q22DLocalBasis,N>;
 
-      R x=in[0], y=in[1];
-      R X0=2*x*x-3*x+1, X1=4*x*x-4*x, X2=2*x*x-x;
-      R Y0=2*y*y-3*y+1, Y1=4*y*y-4*y, Y2=2*y*y-y;
-      R DX0=4*x-3, DX1=-8*x+4, DX2=4*x-1;
-      R DY0=4*y-3, DY1=-8*y+4, DY2=4*y-1;
+    void evaluateFunctionAt (const typename Traits::DomainType& in,
+                             typename Traits::RangeType* out) const;
 
-      out[2][0][0] = DX0*Y2; out[7][0][0] = DX1*Y2; out[3][0][0] = DX2*Y2;
-      out[2][0][1] = X0*DY2; out[7][0][1] = X1*DY2; out[3][0][1] = X2*DY2;
+    void evaluateJacobianAt (const typename Traits::DomainType& in,
+                             typename Traits::JacobianType* out) const;
 
-      out[4][0][0] = DX0*Y1; out[8][0][0] = DX1*Y1; out[5][0][0] = DX2*Y1;
-      out[4][0][1] = X0*DY1; out[8][0][1] = X1*DY1; out[5][0][1] = X2*DY1;
+    void evaluateFunctionAndJacobianAt (const typename Traits::DomainType& in,
+                                        typename Traits::RangeType* values,
+                                        typename Traits::JacobianType* jacobians) const;
 
-      out[0][0][0] = DX0*Y0; out[6][0][0] = DX1*Y0; out[1][0][0] = DX2*Y0;
-      out[0][0][1] = X0*DY0; out[6][0][1] = X1*DY0; out[1][0][1] = X2*DY0;
+    template<int r>
+    inline void evaluateJetAt (const typename Traits::DomainType& in,
+                               LocalBasisJet<Traits,r>* out) const
+    {
+      LocalBasisJetImp::tensorProductJet<Q22DLocalBasis,r>(in,out);
     }
+  };
 
-    //! \brief Polynomial order of the shape functions
-    unsigned int order () const
+  // not inline, such that the instantiations in libdunelocalfunctions are used
+  template<class D, class R>
+  void Q22DLocalBasis<D,R>::evaluateFunctionAt (const typename Traits::DomainType& in,
+                                                typename Traits::RangeType* out) const
+  {
+    R x=in[0], y=in[1];
+    R X0=2*x*x-3*x+1, X1=-4*x*x+4*x, X2=2*x*x-x;
+    R Y0=2*y*y-3*y+1, Y1=-4*y*y+4*y, Y2=2*y*y-y;
+
+    out[2] = X0*Y2;
+    out[7] = X1*Y2;
+    out[3] = X2*Y2;
+
+    out[4] = X0*Y1;
+    out[8] = X1*Y1;
+    out[5] = X2*Y1;
+
+    out[0] = X0*Y0;
+    out[6] = X1*Y0;
+    out[1] = X2*Y0;
+  }
+
+  template<class D, class R>
+  void Q22DLocalBasis<D,R>::evaluateJacobianAt (const typename Traits::DomainType& in,
+                                                typename Traits::JacobianType* out) const
+  {
+    R x=in[0], y=in[1];
+    R X0=2*x*x-3*x+1, X1=-4*x*x+4*x, X2=2*x*x-x;
+    R Y0=2*y*y-3*y+1, Y1=-4*y*y+4*y, Y2=2*y*y-y;
+    R DX0=4*x-3, DX1=-8*x+4, DX2=4*x-1;
+    R DY0=4*y-3, DY1=-8*y+4, DY2=4*y-1;
+
+    out[2][0][0] = DX0*Y2; out[7][0][0] = DX1*Y2; out[3][0][0] = DX2*Y2;
+    out[2][0][1] = X0*DY2; out[7][0][1] = X1*DY2; out[3][0][1] = X2*DY2;
+
+    out[4][0][0] = DX0*Y1; out[8][0][0] = DX1*Y1; out[5][0][0] = DX2*Y1;
+    out[4][0][1] = X0*DY1; out[8][0][1] = X1*DY1; out[5][0][1] = X2*DY1;
+
+    out[0][0][0] = DX0*Y0; out[6][0][0] = DX1*Y0; out[1][0][0] = DX2*Y0;
+    out[0][0][1] = X0*DY0; out[6][0][1] = X1*DY0; out[1][0][1] = X2*DY0;
+  }
+
+  template<class D, class R>
+  void Q22DLocalBasis<D,R>::evaluateFunctionAndJacobianAt (const typename Traits::DomainType& in,
+                                                           typename Traits::RangeType* values,
+                                                           typename Traits::JacobianType* jacobians) const
+  {
+    R x=in[0], y=in[1];
+    R X0=2*x*x-3*x+1, X1=-4*x*x+4*x, X2=2*x*x-x;
+    R Y0=2*y*y-3*y+1, Y1=-4*y*y+4*y, Y2=2*y*y-y;
+    R DX0=4*x-3, DX1=-8*x+4, DX2=4*x-1;
+    R DY0=4*y-3, DY1=-8*y+4, DY2=4*y-1;
+
+    values[2] = X0*Y2; values[7] = X1*Y2; values[3] = X2*Y2;
+    values[4] = X0*Y1; values[8] = X1*Y1; values[5] = X2*Y1;
+    values[0] = X0*Y0; values[6] = X1*Y0; values[1] = X2*Y0;
+
+    jacobians[2][0][0] = DX0*Y2; jacobians[7][0][0] = DX1*Y2; jacobians[3][0][0] = DX2*Y2;
+    jacobians[2][0][1] = X0*DY2; jacobians[7][0][1] = X1*DY2; jacobians[3][0][1] = X2*DY2;
+
+    jacobians[4][0][0] = DX0*Y1; jacobians[8][0][0] = DX1*Y1; jacobians[5][0][0] = DX2*Y1;
+    jacobians[4][0][1] = X0*DY1; jacobians[8][0][1] = X1*DY1; jacobians[5][0][1] = X2*DY1;
+
+    jacobians[0][0][0] = DX0*Y0; jacobians[6][0][0] = DX1*Y0; jacobians[1][0][0] = DX2*Y0;
+    jacobians[0][0][1] = X0*DY0; jacobians[6][0][1] = X1*DY0; jacobians[1][0][1] = X2*DY0;
+  }
+
+
+  //! \brief The shape functions of Q22DLocalBasis are numbered vertices first, then edges, then the center
+  template<class D, class R>
+  struct TensorProductLayout<Q22DLocalBasis<D,R> >
+  {
+    enum {dim = 2, k = 2};
+
+    static unsigned int index (unsigned int l)
     {
-      return 2;
+      static const unsigned int indices[9] = {0, 6, 1, 4, 8, 5, 2, 7, 3};
+      return indices[l];
     }
   };
 }
@@ -16,15 +16,20 @@ namespace Dune
 
          \nosubgrouping
    */
-  class Q22DLocalCoefficients : public LocalCoefficientsInterface<Q22DLocalCoefficients>
+  class Q22DLocalCoefficients
+#if DUNE_VIRTUAL_SHAPEFUNCTIONS
+    : public LocalCoefficientsInterface
+#else
+    : public LocalCoefficientsInterface<Q22DLocalCoefficients>
+#endif
   {
+    typedef LocalKeyTable<Q22DLocalCoefficients,9> Table;
+    friend class LocalKeyTable<Q22DLocalCoefficients,9>;
+
   public:
     //! \brief Standard constructor
-    Q22DLocalCoefficients () : li(9)
-    {
-      for (int i=0; i<9; i++)
-        li[i] = LocalKey(i%4,2-i/4,0);
-    }
+    Q22DLocalCoefficients () : li(Table::keys()), packed(Table::packedKeys())
+    {}
 
     //! number of coefficients
     int size () const
@@ -38,8 +43,21 @@ namespace Dune
       return li[i];
     }
 
+    //! get i'th index, packed into 32 bits
+    const PackedLocalKey& packedLocalKey (int i) const
+    {
+      return packed[i];
+    }
+
   private:
-    std::vector<LocalKey> li;
+    const LocalKey* li;
+    const PackedLocalKey* packed;
+
+    static void fill (int, LocalKey* keys)
+    {
+      for (int i=0; i<9; i++)
+        keys[i] = LocalKey(i%4,2-i/4,0);
+    }
   };
 
 }
@@ -0,0 +1,100 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+#ifndef DUNE_QKLOCALFINITEELEMENT_HH
+#define DUNE_QKLOCALFINITEELEMENT_HH
+
+#include <dune/common/geometrytype.hh>
+
+#include "common/localfiniteelement.hh"
+#include "common/precompiled.hh"
+#include "qk/qklocalbasis.hh"
+#include "qk/qklocalcoefficients.hh"
+#include "qk/qklocalinterpolation.hh"
+
+namespace Dune
+{
+
+  /** \brief Lagrange finite element of arbitrary order on the cube of dimension 1 to 4
+   */
+  template<class D, class R, int dim, unsigned int k>
+  class QkLocalFiniteElement
+    :
+#if DUNE_VIRTUAL_SHAPEFUNCTIONS
+      public
+#endif
+      LocalFiniteElementInterface<
+          LocalFiniteElementTraits<QkLocalBasis<D,R,dim,k>,
+              QkLocalCoefficients<dim,k>,
+              QkLocalInterpolation<QkLocalBasis<D,R,dim,k> > >
+#ifndef DUNE_VIRTUAL_SHAPEFUNCTIONS
+          ,QkLocalFiniteElement<D,R,dim,k>
+#endif
+          >
+  {
+  public:
+    /** \todo Please doc me !
+     */
+    typedef LocalFiniteElementTraits<QkLocalBasis<D,R,dim,k>,
+        QkLocalCoefficients<dim,k>,
+        QkLocalInterpolation<QkLocalBasis<D,R,dim,k> > > Traits;
+
+    /** \todo Please doc me !
+     */
+    QkLocalFiniteElement ()
+      : gt(GeometryType::cube,dim)
+    {}
+
+    /** \todo Please doc me !
+     */
+    const typename Traits::LocalBasisType& localBasis () const
+    {
+      return basis;
+    }
+
+    /** \todo Please doc me !
+     */
+    const typename Traits::LocalCoefficientsType& localCoefficients () const
+    {
+      return coefficients;
+    }
+
+    /** \todo Please doc me !
+     */
+    const typename Traits::LocalInterpolationType& localInterpolation () const
+    {
+      return interpolation;
+    }
+
+    /** \todo Please doc me !
+     */
+    GeometryType type () const
+    {
+      return gt;
+    }
+
+  private:
+    QkLocalBasis<D,R,dim,k> basis;
+    QkLocalCoefficients<dim,k> coefficients;
+    QkLocalInterpolation<QkLocalBasis<D,R,dim,k> > interpolation;
+    GeometryType gt;
+  };
+
+#if DUNE_LOCALFUNCTIONS_PRECOMPILED && !defined(DUNE_VIRTUAL_SHAPEFUNCTIONS)
+  // instantiated in libdunelocalfunctions, see common/precompiled.hh
+  DUNE_LOCALFUNCTIONS_EXTERN_TEMPLATE class QkLocalBasis<double,double,1,1>;
+  DUNE_LOCALFUNCTIONS_EXTERN_TEMPLATE class QkLocalBasis<double,double,1,2>;
+  DUNE_LOCALFUNCTIONS_EXTERN_TEMPLATE class QkLocalBasis<double,double,2,1>;
+  DUNE_LOCALFUNCTIONS_EXTERN_TEMPLATE class QkLocalBasis<double,double,2,2>;
+  DUNE_LOCALFUNCTIONS_EXTERN_TEMPLATE class QkLocalBasis<double,double,3,1>;
+  DUNE_LOCALFUNCTIONS_EXTERN_TEMPLATE class QkLocalBasis<double,double,3,2>;
+  DUNE_LOCALFUNCTIONS_EXTERN_TEMPLATE class QkLocalBasis<float,float,1,1>;
+  DUNE_LOCALFUNCTIONS_EXTERN_TEMPLATE class QkLocalBasis<float,float,1,2>;
+  DUNE_LOCALFUNCTIONS_EXTERN_TEMPLATE class QkLocalBasis<float,float,2,1>;
+  DUNE_LOCALFUNCTIONS_EXTERN_TEMPLATE class QkLocalBasis<float,float,2,2>;
+  DUNE_LOCALFUNCTIONS_EXTERN_TEMPLATE class QkLocalBasis<float,float,3,1>;
+  DUNE_LOCALFUNCTIONS_EXTERN_TEMPLATE class QkLocalBasis<float,float,3,2>;
+#endif
+
+}
+
+#endif
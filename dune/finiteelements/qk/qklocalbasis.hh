@@ -0,0 +1,444 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+#ifndef DUNE_QKLOCALBASIS_HH
+#define DUNE_QKLOCALBASIS_HH
+
+#include <vector>
+
+#include "../common/localbasis.hh"
+#include "../common/localfunction.hh"
+#include "../common/tensorproductlayout.hh"
+
+namespace Dune
+{
+  namespace QkImp {
+    /** template meta program to calculate b^e
+     *  \internal
+     */
+    template<int b, int e>
+    struct Power {
+      enum { val = b*Power<b,e-1>::val };
+    };
+    template<int b>
+    struct Power<b, 0> {
+      enum { val = 1 };
+    };
+  } //namespace QkImp
+
+  /**@ingroup LocalBasisImplementation
+         \brief Lagrange shape functions of arbitrary order on the reference cube of dimension 1 to 4.
+
+         The shape functions are tensor products of one-dimensional Lagrange
+         polynomials with the equidistant nodes 0, 1/k, ..., 1.  Shape
+         function i belongs to the node with multi-index (a_0,...,a_{dim-1}),
+         where i = a_0 + a_1 (k+1) + ... + a_{dim-1} (k+1)^{dim-1}, i.e.
+         the first coordinate runs fastest.
+
+         Besides the usual pointwise evaluation, a finite element function
+         given by its coefficients can be evaluated on a whole tensor-product
+         grid of points by sum factorization.  This costs O(k^{dim+1})
+         operations instead of the O(k^{2 dim}) of evaluating every shape
+         function at every point.
+
+         \tparam D Type to represent the field in the domain.
+         \tparam R Type to represent the field in the range.
+         \tparam dim Dimension of the cube.
+         \tparam k Polynomial order.
+
+         \nosubgrouping
+   */
+  template<class D, class R, int dim, unsigned int k>
+  class QkLocalBasis :
+    public C1LocalBasisForwarder<
+        C1LocalBasisTraits<D,dim,Dune::FieldVector<D,dim>,R,1,Dune::FieldVector<R,1>,
+            Dune::FieldVector<Dune::FieldVector<R,dim>,1> >,
+        QkLocalBasis<D,R,dim,k>, QkImp::Power<k+1,dim>::val>
+  {
+    dune_static_assert(dim>=1 && dim<=4, "QkLocalBasis is only implemented for dimension 1 to 4");
+
+  public:
+    enum {N = QkImp::Power<k+1,dim>::val};
+    enum {O = k};
+
+    typedef C1LocalBasisTraits<D,dim,Dune::FieldVector<D,dim>,R,1,Dune::FieldVector<R,1>,
+        Dune::FieldVector<Dune::FieldVector<R,dim>,1> > Traits;
+
+    //! \brief Standard constructor
+    QkLocalBasis ()
+    {
+      // weights[m] = 1/prod_{b!=m} (m-b), the scaling of the m-th 1d polynomial
+      for (unsigned int m=0; m<=k; m++)
+      {
+        R denominator = 1.0;
+        for (unsigned int b=0; b<=k; b++)
+          if (b!=m)
+            denominator *= R(int(m)-int(b));
+        weights[m] = 1.0/denominator;
+      }
+    }
+
+    //! \brief number of shape functions
+    unsigned int size () const
+    {
+      return N;
+    }
+
+    //! \brief Values of the k+1 one-dimensional Lagrange polynomials at t
+    void evaluateFunction1D (D t, R* out) const;
+
+    //! \brief Values and derivatives of the k+1 one-dimensional Lagrange polynomials at t
+    void evaluateFunctionAndDerivative1D (D t, R* out, R* derivative) const;
+
+    /** \brief Evaluate a finite element function on a tensor-product grid by sum factorization
+
+        The grid consists of the points (t[q_0],...,t[q_{dim-1}]) for all
+        multi-indices q, numbered like the shape functions with q_0 running
+        fastest.  Typically t are the positions of a one-dimensional
+        quadrature rule.
+
+        \param points1D      One-dimensional coordinates t
+        \param coefficients  Coefficients of the function with respect to this basis
+        \param [out] values  Values of the function at all grid points
+     */
+    template<class C>
+    void evaluateFunctionOnTensorGrid (const std::vector<D>& points1D,
+                                       const std::vector<C>& coefficients,
+                                       std::vector<typename Traits::RangeType>& values) const
+    {
+      const unsigned int nq = points1D.size();
+      std::vector<R> table(nq*(k+1));
+      for (unsigned int q=0; q<nq; q++)
+        evaluateFunction1D(points1D[q],&table[q*(k+1)]);
+
+      std::vector<R> result;
+      contract(table,table,-1,nq,coefficients,result);
+
+      values.resize(result.size());
+      for (size_t p=0; p<result.size(); p++)
+        values[p] = result[p];
+    }
+
+    /** \brief Evaluate the Jacobian of a finite element function on a tensor-product grid by sum factorization
+
+        The points are those of evaluateFunctionOnTensorGrid().
+
+        \param points1D         One-dimensional coordinates t
+        \param coefficients     Coefficients of the function with respect to this basis
+        \param [out] jacobians  Jacobians of the function at all grid points
+     */
+    template<class C>
+    void evaluateJacobianOnTensorGrid (const std::vector<D>& points1D,
+                                       const std::vector<C>& coefficients,
+                                       std::vector<typename Traits::JacobianType>& jacobians) const
+    {
+      const unsigned int nq = points1D.size();
+      std::vector<R> table(nq*(k+1)), dtable(nq*(k+1));
+      for (unsigned int q=0; q<nq; q++)
+        evaluateFunctionAndDerivative1D(points1D[q],&table[q*(k+1)],&dtable[q*(k+1)]);
+
+      std::vector<R> result;
+      for (int c=0; c<dim; c++)
+      {
+        contract(table,dtable,c,nq,coefficients,result);
+        jacobians.resize(result.size());
+        for (size_t p=0; p<result.size(); p++)
+          jacobians[p][0][c] = result[p];
+      }
+    }
+
+    //! \brief Polynomial order of the shape functions
+    unsigned int order () const
+    {
+      return k;
+    }
+
+  private:
+    friend class C1LocalBasisForwarder<Traits,QkLocalBasis,N>;
+
+    /* Apply the one-dimensional table in every direction to the coefficient
+       tensor, one direction after the other.  Direction derivativeDirection
+       uses dtable instead of table, -1 means none. */
+    template<class C>
+    void contract (const std::vector<R>& table, const std::vector<R>& dtable,
+                   int derivativeDirection, unsigned int nq,
+                   const std::vector<C>& coefficients, std::vector<R>& result) const
+    {
+      const unsigned int n = k+1;
+      std::vector<R> in(coefficients.begin(),coefficients.end());
+
+      // the tensor is stored as [outer][n][inner] with respect to direction c,
+      // and all directions before c have already been contracted
+      unsigned int inner = 1;
+      unsigned int outer = N/n;
+      for (int c=0; c<dim; c++)
+      {
+        const std::vector<R>& t = (c==derivativeDirection) ? dtable : table;
+        result.assign(outer*nq*inner,0.0);
+        for (unsigned int o=0; o<outer; o++)
+          for (unsigned int q=0; q<nq; q++)
+          {
+            R* out = &result[(o*nq+q)*inner];
+            for (unsigned int m=0; m<n; m++)
+            {
+              const R factor = t[q*n+m];
+              const R* source = &in[(o*n+m)*inner];
+              for (unsigned int i=0; i<inner; i++)
+                out[i] += factor*source[i];
+            }
+          }
+        in.swap(result);
+        inner *= nq;
+        outer /= n;
+      }
+      result.swap(in);
+    }
+
+    void evaluateFunctionAt (const typename Traits::DomainType& in,
+                             typename Traits::RangeType* out) const;
+
+    void evaluateJacobianAt (const typename Traits::DomainType& in,
+                             typename Traits::JacobianType* out) const;
+
+    void evaluateFunctionAndJacobianAt (const typename Traits::DomainType& in,
+                                        typename Traits::RangeType* values,
+                                        typename Traits::JacobianType* jacobians) const;
+
+    //! \brief Advance the multi-index a to the next shape function
+    static void increment (unsigned int* a)
+    {
+      for (int c=0; c<dim; c++)
+      {
+        if (++a[c] <= k)
+          return;
+        a[c] = 0;
+      }
+    }
+
+    R weights[k+1];
+  };
+
+  // not inline, such that the instantiations in libdunelocalfunctions are used
+  template<class D, class R, int dim, unsigned int k>
+  void QkLocalBasis<D,R,dim,k>::evaluateFunction1D (D t, R* out) const
+  {
+    R prefix[k+1], suffix[k+1];
+    const R kt = k*t;
+    prefix[0] = 1.0;
+    for (unsigned int m=1; m<=k; m++)
+      prefix[m] = prefix[m-1]*(kt-(m-1));
+    suffix[k] = 1.0;
+    for (unsigned int m=k; m>0; m--)
+      suffix[m-1] = suffix[m]*(kt-m);
+    for (unsigned int m=0; m<=k; m++)
+      out[m] = weights[m]*prefix[m]*suffix[m];
+  }
+
+  template<class D, class R, int dim, unsigned int k>
+  void QkLocalBasis<D,R,dim,k>::evaluateFunctionAndDerivative1D (D t, R* out, R* derivative) const
+  {
+    // prefix[m] = prod_{b<m} (kt-b), suffix[m] = prod_{b>m} (kt-b), with derivatives
+    R prefix[k+1], suffix[k+1], dprefix[k+1], dsuffix[k+1];
+    const R kt = k*t;
+    prefix[0] = 1.0;
+    dprefix[0] = 0.0;
+    for (unsigned int m=1; m<=k; m++)
+    {
+      dprefix[m] = dprefix[m-1]*(kt-(m-1)) + prefix[m-1]*k;
+      prefix[m] = prefix[m-1]*(kt-(m-1));
+    }
+    suffix[k] = 1.0;
+    dsuffix[k] = 0.0;
+    for (unsigned int m=k; m>0; m--)
+    {
+      dsuffix[m-1] = dsuffix[m]*(kt-m) + suffix[m]*k;
+      suffix[m-1] = suffix[m]*(kt-m);
+    }
+    for (unsigned int m=0; m<=k; m++)
+    {
+      out[m] = weights[m]*prefix[m]*suffix[m];
+      derivative[m] = weights[m]*(dprefix[m]*suffix[m] + prefix[m]*dsuffix[m]);
+    }
+  }
+
+  template<class D, class R, int dim, unsigned int k>
+  void QkLocalBasis<D,R,dim,k>::evaluateFunctionAt (const typename Traits::DomainType& in,
+                                                    typename Traits::RangeType* out) const
+  {
+    R table[dim][k+1];
+    for (int c=0; c<dim; c++)
+      evaluateFunction1D(in[c],table[c]);
+
+    unsigned int a[dim];
+    for (int c=0; c<dim; c++)
+      a[c] = 0;
+    for (unsigned int i=0; i<N; i++)
+    {
+      R value = table[0][a[0]];
+      for (int c=1; c<dim; c++)
+        value *= table[c][a[c]];
+      out[i] = value;
+      increment(a);
+    }
+  }
+
+  template<class D, class R, int dim, unsigned int k>
+  void QkLocalBasis<D,R,dim,k>::evaluateJacobianAt (const typename Traits::DomainType& in,
+                                                    typename Traits::JacobianType* out) const
+  {
+    typename Traits::RangeType values[N];
+    evaluateFunctionAndJacobianAt(in,values,out);
+  }
+
+  template<class D, class R, int dim, unsigned int k>
+  void QkLocalBasis<D,R,dim,k>::evaluateFunctionAndJacobianAt (const typename Traits::DomainType& in,
+                                                               typename Traits::RangeType* values,
+                                                               typename Traits::JacobianType* jacobians) const
+  {
+    R table[dim][k+1], dtable[dim][k+1];
+    for (int c=0; c<dim; c++)
+      evaluateFunctionAndDerivative1D(in[c],table[c],dtable[c]);
+
+    unsigned int a[dim];
+    for (int c=0; c<dim; c++)
+      a[c] = 0;
+    for (unsigned int i=0; i<N; i++)
+    {
+      R value = 1.0;
+      for (int c=0; c<dim; c++)
+      {
+        R derivative = dtable[c][a[c]];
+        for (int e=0; e<dim; e++)
+          if (e!=c)
+            derivative *= table[e][a[e]];
+        jacobians[i][0][c] = derivative;
+        value *= table[c][a[c]];
+      }
+      values[i] = value;
+      increment(a);
+    }
+  }
+
+
+  /** \brief LocalFunctionEvaluator for QkLocalBasis
+
+      Interpolates the coefficient tensor along one direction after the
+      other, as in sum factorization.  Only arrays with (k+1)^(dim-1)
+      entries are needed, and the values of the single shape functions are
+      never formed.
+   */
+  template<class D, class R, int dim, unsigned int k>
+  class LocalFunctionEvaluator<QkLocalBasis<D,R,dim,k> >
+  {
+    typedef QkLocalBasis<D,R,dim,k> LB;
+    enum {n = k+1};
+    enum {M = LB::N/n};
+
+  public:
+    //! \brief Export type traits of the local basis
+    typedef typename LB::Traits Traits;
+
+    //! \brief Value of the function with coefficients coeff[0],...,coeff[N-1] at position x
+    template<class C>
+    static void evaluateFunction (const LB& lb,
+                                  const typename Traits::DomainType& x,
+                                  const C* coeff,
+                                  typename Traits::RangeType& value)
+    {
+      R table[dim][k+1];
+      for (int c=0; c<dim; c++)
+        lb.evaluateFunction1D(x[c],table[c]);
+
+      // contract direction 0 directly from the coefficients
+      R v[M];
+      for (int o=0; o<M; o++)
+      {
+        R s = 0.0;
+        for (int m=0; m<n; m++)
+          s += table[0][m]*coeff[o*n+m];
+        v[o] = s;
+      }
+
+      // the remaining directions work in place
+      int size = M;
+      for (int c=1; c<dim; c++)
+      {
+        size /= n;
+        for (int o=0; o<size; o++)
+        {
+          R s = 0.0;
+          for (int m=0; m<n; m++)
+            s += table[c][m]*v[o*n+m];
+          v[o] = s;
+        }
+      }
+      value = v[0];
+    }
+
+    //! \brief Value and Jacobian of the function with coefficients coeff[0],...,coeff[N-1] at position x
+    template<class C>
+    static void evaluateFunctionAndJacobian (const LB& lb,
+                                             const typename Traits::DomainType& x,
+                                             const C* coeff,
+                                             typename Traits::RangeType& value,
+                                             typename Traits::JacobianType& jacobian)
+    {
+      R table[dim][k+1], dtable[dim][k+1];
+      for (int c=0; c<dim; c++)
+        lb.evaluateFunctionAndDerivative1D(x[c],table[c],dtable[c]);
+
+      // v[0] holds the partially contracted values, v[g+1] the partially
+      // contracted derivatives in direction g
+      R v[dim+1][M];
+      for (int o=0; o<M; o++)
+      {
+        R s = 0.0, ds = 0.0;
+        for (int m=0; m<n; m++)
+        {
+          s += table[0][m]*coeff[o*n+m];
+          ds += dtable[0][m]*coeff[o*n+m];
+        }
+        v[0][o] = s;
+        v[1][o] = ds;
+      }
+
+      int size = M;
+      for (int c=1; c<dim; c++)
+      {
+        size /= n;
+        for (int o=0; o<size; o++)
+        {
+          R s[dim+1];
+          for (int g=0; g<=c+1; g++)
+            s[g] = 0.0;
+          for (int m=0; m<n; m++)
+          {
+            for (int g=0; g<=c; g++)
+              s[g] += table[c][m]*v[g][o*n+m];
+            s[c+1] += dtable[c][m]*v[0][o*n+m];
+          }
+          for (int g=0; g<=c+1; g++)
+            v[g][o] = s[g];
+        }
+      }
+
+      value = v[0][0];
+      for (int g=0; g<dim; g++)
+        jacobian[0][g] = v[g+1][0];
+    }
+  };
+
+
+  //! \brief The shape functions of QkLocalBasis are numbered lexicographically
+  template<class D, class R, int d, unsigned int order>
+  struct TensorProductLayout<QkLocalBasis<D,R,d,order> >
+  {
+    enum {dim = d, k = order};
+
+    static unsigned int index (unsigned int l)
+    {
+      return l;
+    }
+  };
+
+}
+#endif
@@ -0,0 +1,140 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+#ifndef DUNE_QKLOCALCOEFFICIENTS_HH
+#define DUNE_QKLOCALCOEFFICIENTS_HH
+
+#include <iostream>
+#include <vector>
+
+#include "../common/localcoefficients.hh"
+#include "qklocalbasis.hh"
+
+namespace Dune
+{
+
+  /**@ingroup LocalLayoutImplementation
+         \brief Layout map for Qk elements
+
+         Subentities are numbered like those of the reference cube, which is
+         built recursively as a prism over the cube of one dimension less:
+         first come the prisms over the subentities of the base, then the
+         subentities of the bottom and finally those of the top.  In 2d this
+         gives the edges x_0=0, x_0=1, x_1=0, x_1=1, as in Q22DLocalCoefficients.
+
+         The degrees of freedom inside a subentity are numbered
+         lexicographically in the coordinates that vary on it, with the
+         lowest coordinate running fastest.
+
+         \nosubgrouping
+   */
+  template<int dim, unsigned int k>
+  class QkLocalCoefficients
+#if DUNE_VIRTUAL_SHAPEFUNCTIONS
+    : public LocalCoefficientsInterface
+#else
+    : public LocalCoefficientsInterface<QkLocalCoefficients<dim,k> >
+#endif
+  {
+    enum {N = QkImp::Power<k+1,dim>::val};
+
+    typedef LocalKeyTable<QkLocalCoefficients,N> Table;
+    friend class LocalKeyTable<QkLocalCoefficients,N>;
+
+  public:
+    //! \brief Standard constructor
+    QkLocalCoefficients () : li(Table::keys()), packed(Table::packedKeys())
+    {}
+
+    //! number of coefficients
+    int size () const
+    {
+      return N;
+    }
+
+    //! get i'th index
+    const LocalKey& localKey (int i) const
+    {
+      return li[i];
+    }
+
+    //! get i'th index, packed into 32 bits
+    const PackedLocalKey& packedLocalKey (int i) const
+    {
+      return packed[i];
+    }
+
+  private:
+    const LocalKey* li;
+    const PackedLocalKey* packed;
+
+    static void fill (int, LocalKey* keys)
+    {
+      for (int i=0; i<N; i++)
+      {
+        // multi-index of the node, and which coordinates lie on the boundary
+        // (0: lower, 1: upper, -1: in between)
+        int a[dim], side[dim];
+        int codim = 0;
+        int index = 0, stride = 1;
+        for (int c=0, j=i; c<dim; c++, j/=k+1)
+        {
+          a[c] = j%(k+1);
+          if (k==0)
+            side[c] = -1;
+          else if (a[c]==0)
+            side[c] = 0;
+          else if (a[c]==int(k))
+            side[c] = 1;
+          else
+            side[c] = -1;
+
+          if (side[c]>=0)
+            codim++;
+          else if (k>0)
+          {
+            index += (a[c]-1)*stride;
+            stride *= k-1;
+          }
+        }
+        keys[i] = LocalKey(subentity(side,dim,codim),codim,index);
+      }
+    }
+
+    static int power (int b, int e)
+    {
+      int result = 1;
+      for (int i=0; i<e; i++)
+        result *= b;
+      return result;
+    }
+
+    static int binomial (int n, int c)
+    {
+      int result = 1;
+      for (int i=0; i<c; i++)
+        result = result*(n-i)/(i+1);
+      return result;
+    }
+
+    //! \brief number of subentities of codimension c of the d-dimensional cube
+    static int count (int d, int c)
+    {
+      if (c<0 || c>d)
+        return 0;
+      return binomial(d,c)*power(2,c);
+    }
+
+    //! \brief number of the subentity of codimension c of the d-dimensional cube given by side[0..d-1]
+    static int subentity (const int* side, int d, int c)
+    {
+      if (d==0)
+        return 0;
+      if (side[d-1]<0)
+        return subentity(side,d-1,c);
+      return count(d-1,c) + side[d-1]*count(d-1,c-1) + subentity(side,d-1,c-1);
+    }
+  };
+
+}
+
+#endif
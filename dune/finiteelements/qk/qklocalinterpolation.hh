@@ -0,0 +1,48 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+#ifndef DUNE_QKLOCALINTERPOLATION_HH
+#define DUNE_QKLOCALINTERPOLATION_HH
+
+#include "../common/localinterpolation.hh"
+
+namespace Dune
+{
+  template<class LB>
+  class QkLocalInterpolation
+    : public LocalInterpolationInterface<QkLocalInterpolation<LB> >
+  {
+    enum {N = LB::N};
+    enum {k = LB::O};
+    enum {dim = LB::Traits::dimDomain};
+  public:
+
+    //! \brief Local interpolation of a function
+    template<typename F, typename C>
+    void interpolate (const F& f, std::vector<C>& out) const
+    {
+      out.resize(N);
+      interpolate(f,&out[0]);
+    }
+
+    //! \brief Local interpolation into caller-provided storage with room for all coefficients
+    template<typename F, typename C>
+    void interpolate (const F& f, C* out) const
+    {
+      typename LB::Traits::DomainType x;
+      typename LB::Traits::RangeType y;
+      typedef typename LB::Traits::DomainFieldType D;
+
+      for (int i=0; i<N; i++)
+      {
+        // the single node of Q0 is the center of the cube
+        for (int c=0, j=i; c<dim; c++, j/=k+1)
+          x[c] = (k==0) ? D(0.5) : D(j%(k+1))/D(k);
+        f.evaluate(x,y);
+        out[i] = y;
+      }
+    }
+
+  };
+}
+
+#endif
@@ -6,6 +6,7 @@
 #include <dune/common/geometrytype.hh>
 
 #include "common/localfiniteelement.hh"
+#include "common/precompiled.hh"
 #include "refinedp1/refinedp1localbasis.hh"
 #include "pk2d/pk2dlocalcoefficients.hh"
 #include "pk2d/pk2dlocalinterpolation.hh"
@@ -75,6 +76,12 @@ namespace Dune
     GeometryType gt;
   };
 
+#if DUNE_LOCALFUNCTIONS_PRECOMPILED && !defined(DUNE_VIRTUAL_SHAPEFUNCTIONS)
+  // instantiated in libdunelocalfunctions, see common/precompiled.hh
+  DUNE_LOCALFUNCTIONS_EXTERN_TEMPLATE class RefinedP1LocalBasis<double,double>;
+  DUNE_LOCALFUNCTIONS_EXTERN_TEMPLATE class RefinedP1LocalBasis<float,float>;
+#endif
+
 }
 
 #endif
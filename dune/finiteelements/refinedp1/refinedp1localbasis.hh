@@ -8,6 +8,7 @@
  */
 
 #include "../common/localbasis.hh"
+#include "../common/simd.hh"
 
 namespace Dune
 {
@@ -37,15 +38,15 @@ namespace Dune
    */
   template<class D, class R>
   class RefinedP1LocalBasis :
-    public C1LocalBasisInterface<
+    public C1LocalBasisForwarder<
         C1LocalBasisTraits<D,2,Dune::FieldVector<D,2>,R,1,Dune::FieldVector<R,1>,
-            Dune::FieldVector<Dune::FieldVector<R,2>,1> >
-#ifndef DUNE_VIRTUAL_SHAPEFUNCTIONS
-        ,RefinedP1LocalBasis<D,R>
-#endif
-        >
+            Dune::FieldVector<Dune::FieldVector<R,2>,1> >,
+        RefinedP1LocalBasis<D,R>, 6>
   {
   public:
+    //! \brief Number of shape functions as a compile-time constant
+    enum {N = 6};
+
     //! \brief export type traits for function signature
     typedef C1LocalBasisTraits<D,2,Dune::FieldVector<D,2>,R,1,Dune::FieldVector<R,1>,
         Dune::FieldVector<Dune::FieldVector<R,2>,1> > Traits;
@@ -56,111 +57,6 @@ namespace Dune
       return 6;
     }
 
-    //! \brief Evaluate all shape functions
-    inline void evaluateFunction (const typename Traits::DomainType& in,
-                                  std::vector<typename Traits::RangeType>& out) const
-    {
-      out.resize(6);
-
-      int subElement;
-      typename Traits::DomainType local;
-      getSubElement(in, subElement, local);
-
-      switch (subElement) {
-      case 0 :
-
-        out[0] = 1 - local[0] - local[1];
-        out[1] = local[0];
-        out[2] = 0;
-        out[3] = local[1];
-        out[4] = 0;
-        out[5] = 0;
-        break;
-
-      case 1 :
-
-        out[0] = 0;
-        out[1] = 1 - local[0] - local[1];
-        out[2] = local[0];
-        out[3] = 0;
-        out[4] = local[1];
-        out[5] = 0;
-        break;
-
-      case 2 :
-
-        out[0] = 0;
-        out[1] = 0;
-        out[2] = 0;
-        out[3] = 1 - local[0] - local[1];
-        out[4] = local[0];
-        out[5] = local[1];
-        break;
-      case 3 :
-
-        out[0] = 0;
-        out[1] = local[1];
-        out[2] = 0;
-        out[3] = local[0];
-        out[4] = 1 - local[0] - local[1];
-        out[5] = 0;
-      }
-
-    }
-
-    //! \brief Evaluate Jacobian of all shape functions
-    inline void
-    evaluateJacobian (const typename Traits::DomainType& in,         // position
-                      std::vector<typename Traits::JacobianType>& out) const      // return value
-    {
-      out.resize(6);
-
-      int subElement;
-      typename Traits::DomainType local;
-      getSubElement(in, subElement, local);
-
-      switch (subElement) {
-      case 0 :
-
-        out[0][0][0] = -2;    out[0][0][1] = -2;
-        out[1][0][0] =  2;    out[1][0][1] =  0;
-        out[2][0][0] =  0;    out[2][0][1] =  0;
-        out[3][0][0] =  0;    out[3][0][1] =  2;
-        out[4][0][0] =  0;    out[4][0][1] =  0;
-        out[5][0][0] =  0;    out[5][0][1] =  0;
-        break;
-
-      case 1 :
-
-        out[0][0][0] =  0;    out[0][0][1] =  0;
-        out[1][0][0] = -2;    out[1][0][1] = -2;
-        out[2][0][0] =  2;    out[2][0][1] =  0;
-        out[3][0][0] =  0;    out[3][0][1] =  0;
-        out[4][0][0] =  0;    out[4][0][1] =  2;
-        out[5][0][0] =  0;    out[5][0][1] =  0;
-        break;
-
-      case 2 :
-
-        out[0][0][0] =  0;    out[0][0][1] =  0;
-        out[1][0][0] =  0;    out[1][0][1] =  0;
-        out[2][0][0] =  0;    out[2][0][1] =  0;
-        out[3][0][0] = -2;    out[3][0][1] = -2;
-        out[4][0][0] =  2;    out[4][0][1] =  0;
-        out[5][0][0] =  0;    out[5][0][1] =  2;
-        break;
-      case 3 :
-
-        out[0][0][0] =  0;    out[0][0][1] =  0;
-        out[1][0][0] =  0;    out[1][0][1] = -2;
-        out[2][0][0] =  0;    out[2][0][1] =  0;
-        out[3][0][0] = -2;    out[3][0][1] =  0;
-        out[4][0][0] =  2;    out[4][0][1] =  2;
-        out[5][0][0] =  0;    out[5][0][1] =  0;
-      }
-
-    }
-
     /** \brief Polynomial order of the shape functions
         Doesn't really apply: these shape functions are only piecewise linear
      */
@@ -170,39 +66,113 @@ namespace Dune
     }
 
   private:
-    /** \brief Get local coordinates in the subtriangle
+    friend class C1LocalBasisForwarder<Traits,RefinedP1LocalBasis,N>;
+
+    //! \brief Result of comparing coordinates, a bool or one bool per lane of a Simd vector
+    typedef typename SimdTraits<D>::MaskType Mask;
+
+    void evaluateFunctionAt (const typename Traits::DomainType& in,
+                             typename Traits::RangeType* out) const;
+
+    void evaluateJacobianAt (const typename Traits::DomainType& in,
+                             typename Traits::JacobianType* out) const;
+
+    void evaluateFunctionAndJacobianAt (const typename Traits::DomainType& in,
+                                        typename Traits::RangeType* values,
+                                        typename Traits::JacobianType* jacobians) const;
+
+    /** \brief The values of all shape functions
+
+       The linear function of each subtriangle is selected with cond(), so
+       there is no branch and Simd lanes may lie in different subtriangles.
+     */
+    static void evaluateFunctionOnSubElement (const Mask* subElement,
+                                              const typename Traits::DomainType& global,
+                                              typename Traits::RangeType* out)
+    {
+      const R x = global[0];
+      const R y = global[1];
+      const R zero = 0;
+
+      out[0] = cond(subElement[0], 1 - 2*x - 2*y, zero);
+      out[1] = cond(subElement[0], 2*x,
+                    cond(subElement[1], 2 - 2*x - 2*y,
+                         cond(subElement[3], 1 - 2*y, zero)));
+      out[2] = cond(subElement[1], 2*x - 1, zero);
+      out[3] = cond(subElement[0], 2*y,
+                    cond(subElement[2], 2 - 2*x - 2*y,
+                         cond(subElement[3], 1 - 2*x, zero)));
+      out[4] = cond(subElement[1], 2*y,
+                    cond(subElement[2], 2*x,
+                         cond(subElement[3], 2*x + 2*y - 1, zero)));
+      out[5] = cond(subElement[2], 2*y - 1, zero);
+    }
+
+    //! \brief The Jacobians of all shape functions, which are constant on each subtriangle
+    static void evaluateJacobianOnSubElement (const Mask* subElement,
+                                              typename Traits::JacobianType* out)
+    {
+      const R zero = 0, two = 2, minusTwo = -2;
+
+      out[0][0][0] = cond(subElement[0], minusTwo, zero);
+      out[0][0][1] = cond(subElement[0], minusTwo, zero);
+      out[1][0][0] = cond(subElement[0], two, cond(subElement[1], minusTwo, zero));
+      out[1][0][1] = cond(subElement[1] || subElement[3], minusTwo, zero);
+      out[2][0][0] = cond(subElement[1], two, zero);
+      out[2][0][1] = zero;
+      out[3][0][0] = cond(subElement[2] || subElement[3], minusTwo, zero);
+      out[3][0][1] = cond(subElement[0], two, cond(subElement[2], minusTwo, zero));
+      out[4][0][0] = cond(subElement[2] || subElement[3], two, zero);
+      out[4][0][1] = cond(subElement[1] || subElement[3], two, zero);
+      out[5][0][0] = zero;
+      out[5][0][1] = cond(subElement[2], two, zero);
+    }
+
+    /** \brief Get the subtriangle that contains a point
 
        \param[in] global Coordinates in the reference triangle
-       \param[out] subElement Which of the four subtriangles is global in?
-       \param[out] local The local coordinates in the subtriangle
+       \param[out] subElement subElement[i] holds if global is in the i-th of
+       the four subtriangles, exactly one of them is set (in every lane)
      */
     static void getSubElement(const typename Traits::DomainType& global,
-                              int& subElement,
-                              typename Traits::DomainType& local)
+                              Mask* subElement)
     {
-      if (global[0] + global[1] <= 0.5) {
-        subElement = 0;
-        local[0] = 2*global[0];
-        local[1] = 2*global[1];
-        return;
-      } else if (global[0] >= 0.5) {
-        subElement = 1;
-        local[0] = 2*global[0]-1;
-        local[1] = 2*global[1];
-        return;
-      } else if (global[1] >= 0.5) {
-        subElement = 2;
-        local[0] = 2*global[0];
-        local[1] = 2*global[1]-1;
-        return;
-      }
-
-      subElement = 3;
-      local[0] = -2 * global[0] + 1;
-      local[1] = -2 * global[1] + 1;
-
+      subElement[0] = global[0] + global[1] <= 0.5;
+      subElement[1] = !subElement[0] && global[0] >= 0.5;
+      subElement[2] = !subElement[0] && !subElement[1] && global[1] >= 0.5;
+      subElement[3] = !subElement[0] && !subElement[1] && !subElement[2];
     }
 
   };
+
+  // not inline, such that the instantiations in libdunelocalfunctions are used
+  template<class D, class R>
+  void RefinedP1LocalBasis<D,R>::evaluateFunctionAt (const typename Traits::DomainType& in,
+                                                     typename Traits::RangeType* out) const
+  {
+    Mask subElement[4];
+    getSubElement(in, subElement);
+    evaluateFunctionOnSubElement(subElement, in, out);
+  }
+
+  template<class D, class R>
+  void RefinedP1LocalBasis<D,R>::evaluateJacobianAt (const typename Traits::DomainType& in,
+                                                     typename Traits::JacobianType* out) const
+  {
+    Mask subElement[4];
+    getSubElement(in, subElement);
+    evaluateJacobianOnSubElement(subElement, out);
+  }
+
+  template<class D, class R>
+  void RefinedP1LocalBasis<D,R>::evaluateFunctionAndJacobianAt (const typename Traits::DomainType& in,
+                                                                typename Traits::RangeType* values,
+                                                                typename Traits::JacobianType* jacobians) const
+  {
+    Mask subElement[4];
+    getSubElement(in, subElement);
+    evaluateFunctionOnSubElement(subElement, in, values);
+    evaluateJacobianOnSubElement(subElement, jacobians);
+  }
 }
 #endif
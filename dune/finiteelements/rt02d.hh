@@ -6,6 +6,8 @@
 #include <dune/common/geometrytype.hh>
 
 #include "common/localfiniteelement.hh"
+#include "common/localfiniteelementvariants.hh"
+#include "common/precompiled.hh"
 #include "rt02d/rt02dlocalbasis.hh"
 #include "rt02d/rt02dlocalcoefficients.hh"
 #include "rt02d/rt02dlocalinterpolation.hh"
@@ -16,13 +18,19 @@ namespace Dune
   template<class D, class R>
   class RT02DLocalFiniteElement : LocalFiniteElementInterface<
                                       LocalFiniteElementTraits<RT02DLocalBasis<D,R>,RT02DLocalCoefficients,
-                                          RT02DLocalInterpolation<RT02DLocalBasis<D,R> > >,
-                                      RT02DLocalFiniteElement<D,R> >
+                                          RT02DLocalInterpolation<RT02DLocalBasis<D,R> > >
+#ifndef DUNE_VIRTUAL_SHAPEFUNCTIONS
+                                      ,RT02DLocalFiniteElement<D,R>
+#endif
+                                      >
   {
   public:
     typedef LocalFiniteElementTraits<RT02DLocalBasis<D,R>,RT02DLocalCoefficients,
         RT02DLocalInterpolation<RT02DLocalBasis<D,R> > > Traits;
 
+    //! \brief Number of variants, bit i of the variant flips the sign of shape function i
+    enum {variants = 8};
+
     RT02DLocalFiniteElement ()
     {
       gt.makeTriangle();
@@ -53,6 +61,22 @@ namespace Dune
       return gt;
     }
 
+    /** \brief The variant for a triangle with the given global vertex ids
+
+        The shape functions of the variant have a positive flux through
+        each edge in the direction of the rotation by -90 degrees of the
+        edge running from the lower to the higher global vertex id.  With
+        the contravariant Piola transformation J phi / det J, where det J
+        may be negative, the normal components of neighbouring triangles
+        then match on their common edge.
+     */
+    template<class IdVector>
+    static unsigned int variant (const IdVector& globalVertexIds)
+    {
+      // edge 1 runs clockwise around the reference triangle, the others counterclockwise
+      return triangleEdgeFlips(globalVertexIds) ^ 2u;
+    }
+
   private:
     RT02DLocalBasis<D,R> basis;
     RT02DLocalCoefficients coefficients;
@@ -60,6 +84,12 @@ namespace Dune
     GeometryType gt;
   };
 
+#if DUNE_LOCALFUNCTIONS_PRECOMPILED && !defined(DUNE_VIRTUAL_SHAPEFUNCTIONS)
+  // instantiated in libdunelocalfunctions, see common/precompiled.hh
+  DUNE_LOCALFUNCTIONS_EXTERN_TEMPLATE class RT02DLocalBasis<double,double>;
+  DUNE_LOCALFUNCTIONS_EXTERN_TEMPLATE class RT02DLocalBasis<float,float>;
+#endif
+
 }
 
 #endif
@@ -17,12 +17,15 @@ namespace Dune
    */
   template<class D, class R>
   class RT02DLocalBasis :
-    public C1LocalBasisInterface<
+    public C1LocalBasisForwarder<
         C1LocalBasisTraits<D,2,Dune::FieldVector<D,2>,R,2,Dune::FieldVector<R,2>,
             Dune::FieldVector<Dune::FieldVector<R,2>,2> >,
-        RT02DLocalBasis<D,R> >
+        RT02DLocalBasis<D,R>, 3>
   {
   public:
+    //! \brief Number of shape functions as a compile-time constant
+    enum {N = 3};
+
     typedef C1LocalBasisTraits<D,2,Dune::FieldVector<D,2>,R,2,Dune::FieldVector<R,2>,
         Dune::FieldVector<Dune::FieldVector<R,2>,2> > Traits;
 
@@ -47,30 +50,6 @@ namespace Dune
       return 3;
     }
 
-    //! \brief Evaluate all shape functions
-    inline void evaluateFunction (const typename Traits::DomainType& in,
-                                  std::vector<typename Traits::RangeType>& out) const
-    {
-      out.resize(3);
-      out[0][0] = sign0*in[0];       out[0][1]=sign0*in[1];
-      out[1][0] = sign1*(in[0]-1.0); out[1][1]=sign1*in[1];
-      out[2][0] = sign2*in[0];       out[2][1]=sign2*(in[1]-1.0);
-    }
-
-    //! \brief Evaluate Jacobian of all shape functions
-    inline void
-    evaluateJacobian (const typename Traits::DomainType& in,             // position
-                      std::vector<typename Traits::JacobianType>& out) const                          // return value
-    {
-      out.resize(3);
-      out[0][0][0] = sign0;       out[0][0][1] = 0;
-      out[0][1][0] = 0;           out[0][1][1] = sign0;
-      out[1][0][0] = sign1;       out[1][0][1] = 0;
-      out[1][1][0] = 0;           out[1][1][1] = sign1;
-      out[2][0][0] = sign2;       out[2][0][1] = 0;
-      out[2][1][0] = 0;           out[2][1][1] = sign2;
-    }
-
     //! \brief Polynomial order of the shape functions
     unsigned int order () const
     {
@@ -78,7 +57,37 @@ namespace Dune
     }
 
   private:
+    friend class C1LocalBasisForwarder<Traits,RT02DLocalBasis,N>;
+
+    void evaluateFunctionAt (const typename Traits::DomainType& in,
+                             typename Traits::RangeType* out) const;
+
+    void evaluateJacobianAt (const typename Traits::DomainType&,
+                             typename Traits::JacobianType* out) const;
+
     R sign0, sign1, sign2;
   };
+
+  // not inline, such that the instantiations in libdunelocalfunctions are used
+  template<class D, class R>
+  void RT02DLocalBasis<D,R>::evaluateFunctionAt (const typename Traits::DomainType& in,
+                                                 typename Traits::RangeType* out) const
+  {
+    out[0][0] = sign0*in[0];       out[0][1]=sign0*in[1];
+    out[1][0] = sign1*(in[0]-1.0); out[1][1]=sign1*in[1];
+    out[2][0] = sign2*in[0];       out[2][1]=sign2*(in[1]-1.0);
+  }
+
+  template<class D, class R>
+  void RT02DLocalBasis<D,R>::evaluateJacobianAt (const typename Traits::DomainType&,
+                                                 typename Traits::JacobianType* out) const
+  {
+    out[0][0][0] = sign0;       out[0][0][1] = 0;
+    out[0][1][0] = 0;           out[0][1][1] = sign0;
+    out[1][0][0] = sign1;       out[1][0][1] = 0;
+    out[1][1][0] = 0;           out[1][1][1] = sign1;
+    out[2][0][0] = sign2;       out[2][0][1] = 0;
+    out[2][1][0] = 0;           out[2][1][1] = sign2;
+  }
 }
 #endif
@@ -16,15 +16,20 @@ namespace Dune
 
          \nosubgrouping
    */
-  class RT02DLocalCoefficients : public LocalCoefficientsInterface<RT02DLocalCoefficients>
+  class RT02DLocalCoefficients
+#if DUNE_VIRTUAL_SHAPEFUNCTIONS
+    : public LocalCoefficientsInterface
+#else
+    : public LocalCoefficientsInterface<RT02DLocalCoefficients>
+#endif
   {
+    typedef LocalKeyTable<RT02DLocalCoefficients,3> Table;
+    friend class LocalKeyTable<RT02DLocalCoefficients,3>;
+
   public:
     //! \brief Standard constructor
-    RT02DLocalCoefficients () : li(3)
-    {
-      for (int i=0; i<3; i++)
-        li[i] = LocalKey(i,1,0);
-    }
+    RT02DLocalCoefficients () : li(Table::keys()), packed(Table::packedKeys())
+    {}
 
     //! number of coefficients
     int size () const
@@ -38,8 +43,21 @@ namespace Dune
       return li[i];
     }
 
+    //! get i'th index, packed into 32 bits
+    const PackedLocalKey& packedLocalKey (int i) const
+    {
+      return packed[i];
+    }
+
   private:
-    std::vector<LocalKey> li;
+    const LocalKey* li;
+    const PackedLocalKey* packed;
+
+    static void fill (int, LocalKey* keys)
+    {
+      for (int i=0; i<3; i++)
+        keys[i] = LocalKey(i,1,0);
+    }
   };
 
 }
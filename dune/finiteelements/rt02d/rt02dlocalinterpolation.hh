@@ -3,6 +3,10 @@
 #ifndef DUNE_RT02DLOCALINTERPOLATION_HH
 #define DUNE_RT02DLOCALINTERPOLATION_HH
 
+#include <cassert>
+#include <cmath>
+#include <vector>
+
 #include <dune/common/exceptions.hh>
 
 #include "../common/localinterpolation.hh"
@@ -15,12 +19,8 @@ namespace Dune
   {
   public:
 
-    //! \brief Standard constructor
-    RT02DLocalInterpolation ()
-    {}
-
-    //! \brief Make set numer s, where 0<=s<8
-    RT02DLocalInterpolation (unsigned int s)
+    //! \brief Make set numer s, where 0<=s<8, the standard constructor makes set 0
+    RT02DLocalInterpolation (unsigned int s = 0)
     {
       sign0 = sign1 = sign2 = 1.0;
       if (s&1) sign0 *= -1.0;
@@ -29,7 +29,7 @@ namespace Dune
       m0[0] = 0.5; m0[1] = 0.5;
       m1[0] = 0.0; m1[1] = 0.5;
       m2[0] = 0.5; m2[1] = 0.0;
-      n0[0] = 1.0/sqrt(2.0); n0[1] = 1.0/sqrt(2.0);
+      n0[0] = 1.0/std::sqrt(2.0); n0[1] = 1.0/std::sqrt(2.0);
       n1[0] = -1.0;          n1[1] = 0.0;
       n2[0] = 0.0;           n2[1] = -1.0;
       c0 = (0.5*n0[0] + 0.5*n0[1]);
@@ -39,17 +39,65 @@ namespace Dune
 
     template<typename F, typename C>
     void interpolate (const F& f, std::vector<C>& out) const
+    {
+      out.resize(3);
+      interpolate(f,&out[0]);
+    }
+
+    //! \brief Local interpolation into caller-provided storage with room for all coefficients
+    template<typename F, typename C>
+    void interpolate (const F& f, C* out) const
     {
       // f gives v*outer normal at a point on the edge!
       typename F::Traits::RangeType y;
 
-      out.resize(3);
-
       f.evaluate(m0,y); out[0] = (y[0]*n0[0]+y[1]*n0[1])*sign0/c0;
       f.evaluate(m1,y); out[1] = (y[0]*n1[0]+y[1]*n1[1])*sign1/c1;
       f.evaluate(m2,y); out[2] = (y[0]*n2[0]+y[1]*n2[1])*sign2/c2;
     }
 
+    //! \brief The point at which interpolate() evaluates the function for coefficient i, the midpoint of edge i
+    const typename LB::Traits::DomainType& interpolationPoint (int i) const
+    {
+      return (i == 0) ? m0 : ((i == 1) ? m1 : m2);
+    }
+
+    //! \brief Interpolation on a batch of elements, values[3*e+i] is the function of element e at interpolationPoint(i)
+    template<typename C>
+    void interpolateBatched (const std::vector<typename LB::Traits::RangeType>& values,
+                             const std::vector<unsigned int>& variants,
+                             std::vector<C>& out) const
+    {
+      assert(values.size() == 3*variants.size());
+      out.resize(values.size());
+      if (!variants.empty())
+        interpolateBatched(&values[0],&variants[0],variants.size(),&out[0]);
+    }
+
+    /** \brief Interpolation on a batch of elements from the values of the functions at the interpolation points
+
+       values[3*e+i] is the function of element e at interpolationPoint(i), in
+       the reference coordinates that interpolate() expects, and
+       variants[e] is the variant of element e.  The signs of this object
+       are not used.  The coefficients of element e are stored at
+       out[3*e], out[3*e+1] and out[3*e+2].
+     */
+    template<typename C>
+    void interpolateBatched (const typename LB::Traits::RangeType* values,
+                             const unsigned int* variants,
+                             unsigned int elements,
+                             C* out) const
+    {
+      const typename LB::Traits::RangeFieldType d0 = 1/c0, d1 = 1/c1, d2 = 1/c2;
+      for (unsigned int e=0; e<elements; e++, values+=3, out+=3)
+      {
+        const unsigned int s = variants[e];
+        out[0] = (values[0][0]*n0[0]+values[0][1]*n0[1])*((s&1) ? -d0 : d0);
+        out[1] = (values[1][0]*n1[0]+values[1][1]*n1[1])*((s&2) ? -d1 : d1);
+        out[2] = (values[2][0]*n2[0]+values[2][1]*n2[1])*((s&4) ? -d2 : d2);
+      }
+    }
+
   private:
     typename LB::Traits::RangeFieldType sign0,sign1,sign2;
     typename LB::Traits::DomainType m0,m1,m2;
@@ -0,0 +1,312 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+#include <config.h>
+
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <dune/common/timer.hh>
+#include <dune/grid/common/quadraturerules.hh>
+
+#include <dune/finiteelements/p0.hh>
+#include <dune/finiteelements/p11d.hh>
+#include <dune/finiteelements/p12d.hh>
+#include <dune/finiteelements/p13d.hh>
+#include <dune/finiteelements/p23d.hh>
+#include <dune/finiteelements/pk2d.hh>
+#include <dune/finiteelements/pk3d.hh>
+#include <dune/finiteelements/q12d.hh>
+#include <dune/finiteelements/q13d.hh>
+#include <dune/finiteelements/q22d.hh>
+#include <dune/finiteelements/qk.hh>
+#include <dune/finiteelements/rt02d.hh>
+#include <dune/finiteelements/edger12d.hh>
+#include <dune/finiteelements/refinedp1.hh>
+#include <dune/finiteelements/monom.hh>
+#include <dune/finiteelements/orthonormal.hh>
+
+/** \file
+    \brief Measures the cost of the basic operations of all local finite elements
+
+    For every element the program prints one line per operation in CSV format
+
+    \code
+    element,operation,points,repetitions,ns
+    \endcode
+
+    where ns is the CPU time in nanoseconds per call, averaged over all
+    repetitions.  evaluateFunction and evaluateJacobian are called once per
+    point of the quadrature rule of order 4 on the reference element of the
+    element, interpolate, localKey and construction once per repetition.
+
+    Usage: localbasisbenchmark [repetitions [warmup]]
+
+    Each operation is run warmup times before the measurement starts.
+ */
+
+using namespace Dune;
+
+/** \brief Number of measured and unmeasured runs of each operation */
+struct Options
+{
+  int repetitions;
+  int warmup;
+};
+
+/** \brief The quadrature order that determines the evaluation points */
+const int quadratureOrder = 4;
+
+/** \brief Results are accumulated here, so that the compiler cannot drop the benchmarked calls */
+volatile double sink = 0;
+
+/** \brief Read in every repetition, so that the compiler cannot hoist the interpolation out of the loop */
+volatile double scale = 1;
+
+/** \brief A smooth function to interpolate, with the domain and range of a local basis */
+template <class T>
+class Func
+{
+public:
+  //! \brief Export the traits of the local basis, as needed by some interpolations
+  typedef T Traits;
+
+  Func (double a_) : a(a_)
+  {}
+
+  void evaluate (const typename Traits::DomainType& x, typename Traits::RangeType& y) const
+  {
+    y = a*std::exp(-x.two_norm2());
+  }
+
+private:
+  double a;
+};
+
+/** \brief Print one line of the results */
+void report (const std::string& name, const char* operation,
+             int points, const Options& options, double seconds)
+{
+  std::cout << name << "," << operation << "," << points << ","
+            << options.repetitions << ","
+            << 1e9*seconds/(double(options.repetitions)*points) << std::endl;
+}
+
+/** \brief Values of all shape functions at all points, one evaluateFunction call per point */
+template <class LB>
+double timeEvaluateFunction (const LB& lb,
+                             const std::vector<typename LB::Traits::DomainType>& points,
+                             int repetitions)
+{
+  std::vector<typename LB::Traits::RangeType> values;
+  double sum = 0;
+
+  Timer timer;
+  for (int r=0; r<repetitions; r++)
+    for (size_t p=0; p<points.size(); p++)
+    {
+      lb.evaluateFunction(points[p],values);
+      sum += values[0][0];
+    }
+  const double seconds = timer.elapsed();
+
+  sink = sink + sum;
+  return seconds;
+}
+
+/** \brief Jacobians of all shape functions at all points, one evaluateJacobian call per point */
+template <class LB>
+double timeEvaluateJacobian (const LB& lb,
+                             const std::vector<typename LB::Traits::DomainType>& points,
+                             int repetitions)
+{
+  std::vector<typename LB::Traits::JacobianType> jacobians;
+  double sum = 0;
+
+  Timer timer;
+  for (int r=0; r<repetitions; r++)
+    for (size_t p=0; p<points.size(); p++)
+    {
+      lb.evaluateJacobian(points[p],jacobians);
+      sum += jacobians[0][0][0];
+    }
+  const double seconds = timer.elapsed();
+
+  sink = sink + sum;
+  return seconds;
+}
+
+/** \brief Interpolation of Func */
+template <class LI, class T>
+double timeInterpolate (const LI& li, int repetitions)
+{
+  std::vector<typename T::RangeFieldType> coefficients;
+  double sum = 0;
+
+  Timer timer;
+  for (int r=0; r<repetitions; r++)
+  {
+    li.interpolate(Func<T>(scale),coefficients);
+    sum += coefficients[0];
+  }
+  const double seconds = timer.elapsed();
+
+  sink = sink + sum;
+  return seconds;
+}
+
+/** \brief Lookup of all local keys */
+template <class LC>
+double timeLocalKey (const LC& lc, int repetitions)
+{
+  double sum = 0;
+
+  Timer timer;
+  for (int r=0; r<repetitions; r++)
+    for (int i=0; i<lc.size(); i++)
+      sum += lc.localKey(i).subentity() + lc.localKey(i).codim() + lc.localKey(i).index();
+  const double seconds = timer.elapsed();
+
+  sink = sink + sum;
+  return seconds;
+}
+
+/** \brief Construction of a finite element with the default constructor */
+template <class FE>
+double timeConstruction (int repetitions)
+{
+  double sum = 0;
+
+  Timer timer;
+  for (int r=0; r<repetitions; r++)
+  {
+    FE fe;
+    sum += fe.localBasis().size();
+  }
+  const double seconds = timer.elapsed();
+
+  sink = sink + sum;
+  return seconds;
+}
+
+/** \brief Construction of a finite element from a single argument */
+template <class FE, class A>
+double timeConstruction (const A& a, int repetitions)
+{
+  double sum = 0;
+
+  Timer timer;
+  for (int r=0; r<repetitions; r++)
+  {
+    FE fe(a);
+    sum += fe.localBasis().size();
+  }
+  const double seconds = timer.elapsed();
+
+  sink = sink + sum;
+  return seconds;
+}
+
+/** \brief Measure evaluation, interpolation and local keys of a finite element */
+template <class FE>
+void benchmark (const FE& fe, const std::string& name, const Options& options)
+{
+  typedef typename FE::Traits::LocalBasisType LB;
+  typedef typename LB::Traits::DomainFieldType DF;
+  const int dim = LB::Traits::dimDomain;
+
+  const QuadratureRule<DF,dim>& quad = QuadratureRules<DF,dim>::rule(fe.type(),quadratureOrder);
+  std::vector<typename LB::Traits::DomainType> points(quad.size(),typename LB::Traits::DomainType(DF(0)));
+  for (size_t q=0; q<quad.size(); q++)
+    points[q] = quad[q].position();
+  const int n = points.size();
+
+  timeEvaluateFunction(fe.localBasis(),points,options.warmup);
+  report(name,"evaluateFunction",n,options,
+         timeEvaluateFunction(fe.localBasis(),points,options.repetitions));
+
+  timeEvaluateJacobian(fe.localBasis(),points,options.warmup);
+  report(name,"evaluateJacobian",n,options,
+         timeEvaluateJacobian(fe.localBasis(),points,options.repetitions));
+
+  typedef typename FE::Traits::LocalInterpolationType LI;
+  timeInterpolate<LI,typename LB::Traits>(fe.localInterpolation(),options.warmup);
+  report(name,"interpolate",1,options,
+         timeInterpolate<LI,typename LB::Traits>(fe.localInterpolation(),options.repetitions));
+
+  timeLocalKey(fe.localCoefficients(),options.warmup);
+  report(name,"localKey",1,options,
+         timeLocalKey(fe.localCoefficients(),options.repetitions));
+}
+
+/** \brief Benchmark a default-constructible finite element */
+template <class FE>
+void run (const std::string& name, const Options& options)
+{
+  timeConstruction<FE>(options.warmup);
+  report(name,"construction",1,options,timeConstruction<FE>(options.repetitions));
+
+  benchmark(FE(),name,options);
+}
+
+/** \brief Benchmark a finite element constructed from a single argument */
+template <class FE, class A>
+void run (const std::string& name, const A& a, const Options& options)
+{
+  timeConstruction<FE>(a,options.warmup);
+  report(name,"construction",1,options,timeConstruction<FE>(a,options.repetitions));
+
+  benchmark(FE(a),name,options);
+}
+
+int main (int argc, char** argv)
+{
+  Options options;
+  options.repetitions = (argc > 1) ? std::atoi(argv[1]) : 100000;
+  options.warmup = (argc > 2) ? std::atoi(argv[2]) : 1000;
+
+  if (options.repetitions < 1 || options.warmup < 0)
+  {
+    std::cerr << "Usage: " << argv[0] << " [repetitions [warmup]]" << std::endl;
+    return 1;
+  }
+
+  std::cout << "element,operation,points,repetitions,ns" << std::endl;
+
+  run<P0LocalFiniteElement<double,double,2> >("P0",GeometryType::simplex,options);
+  run<P11DLocalFiniteElement<double,double> >("P11D",options);
+  run<P12DLocalFiniteElement<double,double> >("P12D",options);
+  run<P13DLocalFiniteElement<double,double> >("P13D",options);
+  run<P23DLocalFiniteElement<double,double> >("P23D",options);
+  run<Pk2DLocalFiniteElement<double,double,1> >("Pk2D1",options);
+  run<Pk2DLocalFiniteElement<double,double,2> >("Pk2D2",options);
+  run<Pk2DLocalFiniteElement<double,double,3> >("Pk2D3",options);
+  run<Pk2DLocalFiniteElement<double,double,4> >("Pk2D4",options);
+  run<Pk2DLocalFiniteElement<double,double,5> >("Pk2D5",options);
+  run<Pk2DLocalFiniteElement<double,double,6> >("Pk2D6",options);
+  run<Pk2DLocalFiniteElement<double,double,7> >("Pk2D7",options);
+  run<Pk2DLocalFiniteElement<double,double,8> >("Pk2D8",options);
+  run<Pk3DLocalFiniteElement<double,double,2> >("Pk3D2",options);
+  run<Pk3DLocalFiniteElement<double,double,4> >("Pk3D4",options);
+  run<Q12DLocalFiniteElement<double,double> >("Q12D",options);
+  run<Q13DLocalFiniteElement<double,double> >("Q13D",options);
+  run<Q22DLocalFiniteElement<double,double> >("Q22D",options);
+  run<QkLocalFiniteElement<double,double,2,3> >("Qk2D3",options);
+  run<QkLocalFiniteElement<double,double,3,2> >("Qk3D2",options);
+  run<RT02DLocalFiniteElement<double,double> >("RT02D",options);
+  run<EdgeR12DLocalFiniteElement<double,double> >("EdgeR12D",options);
+  run<RefinedP1LocalFiniteElement<double,double> >("RefinedP1",options);
+  run<MonomLocalFiniteElement<double,double,2,3> >("Monom2D3",GeometryType::simplex,options);
+  run<MonomLocalFiniteElement<double,double,2,5> >("Monom2D5",GeometryType::simplex,options);
+  run<MonomLocalFiniteElement<double,double,3,4> >("Monom3D4",GeometryType::cube,options);
+  run<OrthonormalLocalFiniteElement<double,double,2,3,GeometryType::simplex> >("Orthonormal2D3Simplex",options);
+  run<OrthonormalLocalFiniteElement<double,double,2,5,GeometryType::simplex> >("Orthonormal2D5Simplex",options);
+  run<OrthonormalLocalFiniteElement<double,double,3,4,GeometryType::cube> >("Orthonormal3D4Cube",options);
+
+  // keep the accumulated results alive
+  std::cerr << "checksum " << sink << std::endl;
+
+  return 0;
+}
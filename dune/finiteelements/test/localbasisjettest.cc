@@ -0,0 +1,123 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+#include <config.h>
+
+#include <cmath>
+#include <iostream>
+#include <vector>
+
+#include <dune/finiteelements/common/localbasisjet.hh>
+#include <dune/finiteelements/monom.hh>
+#include <dune/finiteelements/p23d.hh>
+#include <dune/finiteelements/pk2d.hh>
+#include <dune/finiteelements/q1.hh>
+#include <dune/finiteelements/q22d.hh>
+
+/** \file
+    \brief Checks the jets of the local bases against the other evaluations and finite differences
+ */
+
+bool success = true;
+double epsilon = 1e-12;
+
+using namespace Dune;
+
+/** \brief The quadrature points of the given order as a list of positions */
+template <class LB>
+std::vector<typename LB::Traits::DomainType>
+testPoints (const GeometryType& type, int order)
+{
+  typedef typename LB::Traits::DomainFieldType DF;
+  const int dim = LB::Traits::dimDomain;
+  const QuadratureRule<DF,dim>& quad = QuadratureRules<DF,dim>::rule(type,order);
+
+  std::vector<typename LB::Traits::DomainType> points(quad.size(), typename LB::Traits::DomainType(DF(0)));
+  for (size_t i=0; i<quad.size(); i++)
+    points[i] = quad[i].position();
+  return points;
+}
+
+/** \brief Compare the jets of a Ck basis to the other evaluations and to finite differences */
+template <class LB>
+void testJet (const LB& lb, const GeometryType& type, const char* name)
+{
+  typedef typename LB::Traits::DomainType DomainType;
+  const int n = LB::Traits::dimDomain;
+  const double h = 1e-5;
+  const double tolerance = 1e-6;
+
+  std::vector<DomainType> points = testPoints<LB>(type, 3);
+
+  std::vector<LocalBasisJet<typename LB::Traits,3> > jets;
+  std::vector<LocalBasisJet<typename LB::Traits,2> > up, down;
+  std::vector<typename LB::Traits::RangeType> values;
+  std::vector<typename LB::Traits::JacobianType> jacobians, upJacobians, downJacobians;
+
+  for (size_t p=0; p<points.size(); p++) {
+    lb.template evaluateJet<3>(points[p], jets);
+    lb.evaluateFunction(points[p], values);
+    lb.evaluateJacobian(points[p], jacobians);
+
+    for (unsigned int i=0; i<lb.size(); i++) {
+      bool equal = std::abs(jets[i].value[0] - values[i][0]) < epsilon;
+      for (int a=0; a<n; a++)
+        equal = equal && std::abs(jets[i].jacobian[0][a] - jacobians[i][0][a]) < epsilon;
+      if (!equal) {
+        std::cerr << name << ": jet of shape function " << i << " at " << points[p]
+                  << " differs from evaluateFunction() or evaluateJacobian()" << std::endl;
+        success = false;
+      }
+    }
+
+    for (int a=0; a<n; a++) {
+      DomainType upPos = points[p], downPos = points[p];
+      upPos[a] += h;
+      downPos[a] -= h;
+      lb.evaluateJacobian(upPos, upJacobians);
+      lb.evaluateJacobian(downPos, downJacobians);
+      lb.template evaluateJet<2>(upPos, up);
+      lb.template evaluateJet<2>(downPos, down);
+
+      for (unsigned int i=0; i<lb.size(); i++)
+        for (int b=0; b<n; b++) {
+          const double fd = (upJacobians[i][0][b] - downJacobians[i][0][b])/(2*h);
+          if (std::abs(jets[i].hessian[0][a][b] - fd) > tolerance) {
+            std::cerr << name << ": second derivative of shape function " << i << " in directions "
+                      << a << "," << b << " at " << points[p] << " is " << jets[i].hessian[0][a][b]
+                      << ", but " << fd << " is expected" << std::endl;
+            success = false;
+          }
+
+          for (int c=0; c<n; c++) {
+            const double fd3 = (up[i].hessian[0][b][c] - down[i].hessian[0][b][c])/(2*h);
+            if (std::abs(jets[i].thirdDerivative[0][a][b][c] - fd3) > tolerance) {
+              std::cerr << name << ": third derivative of shape function " << i << " in directions "
+                        << a << "," << b << "," << c << " at " << points[p] << " is "
+                        << jets[i].thirdDerivative[0][a][b][c] << ", but " << fd3 << " is expected" << std::endl;
+              success = false;
+            }
+          }
+        }
+    }
+  }
+}
+
+int main (int argc, char *argv[]) try
+{
+  testJet(MonomLocalBasis<double,double,2,4>(), GeometryType(GeometryType::simplex,2), "Monom<2,4>");
+  testJet(MonomLocalBasis<double,double,3,3>(), GeometryType(GeometryType::cube,3), "Monom<3,3>");
+  testJet(Pk2DLocalBasis<double,double,0>(), GeometryType(GeometryType::simplex,2), "Pk2D<0>");
+  testJet(Pk2DLocalBasis<double,double,1>(), GeometryType(GeometryType::simplex,2), "Pk2D<1>");
+  testJet(Pk2DLocalBasis<double,double,4>(), GeometryType(GeometryType::simplex,2), "Pk2D<4>");
+  testJet(P23DLocalBasis<double,double>(), GeometryType(GeometryType::simplex,3), "P23D");
+  testJet(Q12DLocalBasis<double,double>(), GeometryType(GeometryType::cube,2), "Q12D");
+  testJet(Q13DLocalBasis<double,double>(), GeometryType(GeometryType::cube,3), "Q13D");
+  testJet(Q22DLocalBasis<double,double>(), GeometryType(GeometryType::cube,2), "Q22D");
+
+  return success ? 0 : 1;
+}
+catch (Exception e) {
+
+  std::cout << e << std::endl;
+  return 1;
+}
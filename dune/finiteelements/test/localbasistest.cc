@@ -0,0 +1,936 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+#include <config.h>
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <map>
+#include <utility>
+#include <vector>
+
+#include <dune/grid/common/quadraturerules.hh>
+
+#include <dune/finiteelements/common/localbasiscache.hh>
+#include <dune/finiteelements/common/localfunction.hh>
+#include <dune/finiteelements/monom.hh>
+#include <dune/finiteelements/orthonormal.hh>
+#include <dune/finiteelements/p0.hh>
+#include <dune/finiteelements/p1.hh>
+#include <dune/finiteelements/p23d.hh>
+#include <dune/finiteelements/pk2d.hh>
+#include <dune/finiteelements/pk3d.hh>
+#include <dune/finiteelements/q1.hh>
+#include <dune/finiteelements/qk.hh>
+#include <dune/finiteelements/q22d.hh>
+#include <dune/finiteelements/rt02d.hh>
+#include <dune/finiteelements/edger12d.hh>
+#include <dune/finiteelements/refinedp1.hh>
+
+/** \file
+    \brief Checks that the different evaluation paths of the local bases agree
+ */
+
+bool success = true;
+double epsilon = 1e-12;
+
+using namespace Dune;
+
+/** \brief The quadrature points of the given order as a list of positions */
+template <class LB>
+std::vector<typename LB::Traits::DomainType>
+testPoints (const GeometryType& type, int order)
+{
+  typedef typename LB::Traits::DomainFieldType DF;
+  const int dim = LB::Traits::dimDomain;
+  const QuadratureRule<DF,dim>& quad = QuadratureRules<DF,dim>::rule(type,order);
+
+  std::vector<typename LB::Traits::DomainType> points(quad.size(), typename LB::Traits::DomainType(DF(0)));
+  for (size_t i=0; i<quad.size(); i++)
+    points[i] = quad[i].position();
+  return points;
+}
+
+/** \brief Product of the factors (k t - b)/(b+1), b=0,...,m-1, which vanishes at t=0,1/k,...,(m-1)/k and is one at t=m/k */
+double simplexFactor (int k, int m, double t)
+{
+  double result = 1;
+  for (int b=0; b<m; b++)
+    result *= (k*t - b)/(b+1);
+  return result;
+}
+
+/** \brief The one-dimensional Lagrange polynomial of order k belonging to the node m/k */
+double lagrange1D (int k, int m, double t)
+{
+  double result = 1;
+  for (int b=0; b<=k; b++)
+    if (b != m)
+      result *= (k*t - b)/(m - b);
+  return result;
+}
+
+/** \brief Closed-form Lagrange shape functions of order k on the reference simplex
+
+    The shape function belonging to the node a/k is the product of simplexFactor()
+    over the barycentric coordinates.  The nodes are numbered with a[0] running
+    fastest.
+ */
+template <int dim, int k>
+struct SimplexLagrangeReference
+{
+  template <class X, class Y>
+  void operator() (const X& x, std::vector<Y>& out) const
+  {
+    out.clear();
+    int a[dim];
+    add(x, dim-1, k, a, out);
+  }
+
+  template <class X, class Y>
+  static void add (const X& x, int c, int remaining, int* a, std::vector<Y>& out)
+  {
+    if (c < 0) {
+      double value = 1, lambda0 = 1;
+      for (int j=0; j<dim; j++) {
+        value *= simplexFactor(k, a[j], x[j]);
+        lambda0 -= x[j];
+      }
+      out.push_back(Y(value*simplexFactor(k, remaining, lambda0)));
+      return;
+    }
+    for (a[c]=0; a[c]<=remaining; a[c]++)
+      add(x, c-1, remaining-a[c], a, out);
+  }
+};
+
+/** \brief Closed-form Lagrange shape functions of order k on the reference cube,
+    numbered with the first direction running fastest */
+template <int dim, int k>
+struct CubeLagrangeReference
+{
+  template <class X, class Y>
+  void operator() (const X& x, std::vector<Y>& out) const
+  {
+    int n = 1;
+    for (int c=0; c<dim; c++)
+      n *= k+1;
+    out.resize(n);
+    for (int i=0; i<n; i++) {
+      double value = 1;
+      for (int c=0, j=i; c<dim; c++, j/=k+1)
+        value *= lagrange1D(k, j%(k+1), x[c]);
+      out[i] = value;
+    }
+  }
+};
+
+/** \brief Closed-form quadratic Lagrange shape functions on the reference tetrahedron:
+    the vertex functions l_i(2l_i-1) followed by the edge functions 4l_il_j */
+struct P23DReference
+{
+  template <class X, class Y>
+  void operator() (const X& x, std::vector<Y>& out) const
+  {
+    const double l[4] = {1-x[0]-x[1]-x[2], x[0], x[1], x[2]};
+    static const int edges[6][2] = {{0,1},{1,2},{0,2},{0,3},{1,3},{2,3}};
+    out.resize(10);
+    for (int i=0; i<4; i++)
+      out[i] = l[i]*(2*l[i]-1);
+    for (int e=0; e<6; e++)
+      out[4+e] = 4*l[edges[e][0]]*l[edges[e][1]];
+  }
+};
+
+/** \brief Closed-form biquadratic Lagrange shape functions on the reference square,
+    numbered vertices first, then edges, then the center */
+struct Q22DReference
+{
+  template <class X, class Y>
+  void operator() (const X& x, std::vector<Y>& out) const
+  {
+    static const int nodes[9][2] = {{0,0},{2,0},{0,2},{2,2},{0,1},{2,1},{1,0},{1,2},{1,1}};
+    out.resize(9);
+    for (int i=0; i<9; i++)
+      out[i] = lagrange1D(2, nodes[i][0], x[0])*lagrange1D(2, nodes[i][1], x[1]);
+  }
+};
+
+/** \brief Closed-form hat functions of the uniformly refined reference triangle,
+    computed from the barycentric coordinates of the subtriangle containing x */
+struct RefinedP1Reference
+{
+  template <class X, class Y>
+  void operator() (const X& x, std::vector<Y>& out) const
+  {
+    static const double nodes[6][2] = {{0,0},{0.5,0},{1,0},{0,0.5},{0.5,0.5},{0,1}};
+    static const int subTriangles[4][3] = {{0,1,3},{1,2,4},{3,4,5},{4,3,1}};
+    out.assign(6, Y(0));
+    for (int t=0; t<4; t++) {
+      const double* a = nodes[subTriangles[t][0]];
+      const double* b = nodes[subTriangles[t][1]];
+      const double* c = nodes[subTriangles[t][2]];
+      const double det = (b[0]-a[0])*(c[1]-a[1]) - (c[0]-a[0])*(b[1]-a[1]);
+      const double lb = ((x[0]-a[0])*(c[1]-a[1]) - (c[0]-a[0])*(x[1]-a[1]))/det;
+      const double lc = ((b[0]-a[0])*(x[1]-a[1]) - (x[0]-a[0])*(b[1]-a[1]))/det;
+      if (lb >= 0 && lc >= 0 && lb+lc <= 1) {
+        out[subTriangles[t][0]] = 1-lb-lc;
+        out[subTriangles[t][1]] = lb;
+        out[subTriangles[t][2]] = lc;
+        return;
+      }
+    }
+  }
+};
+
+/** \brief Closed-form lowest order Raviart-Thomas shape functions of variant s */
+struct RT02DReference
+{
+  RT02DReference (int s) : s_(s)
+  {}
+
+  template <class X, class Y>
+  void operator() (const X& x, std::vector<Y>& out) const
+  {
+    out.resize(3);
+    out[0][0] = x[0];   out[0][1] = x[1];
+    out[1][0] = x[0]-1; out[1][1] = x[1];
+    out[2][0] = x[0];   out[2][1] = x[1]-1;
+    for (int i=0; i<3; i++)
+      if (s_ & (1<<i))
+        out[i] *= -1;
+  }
+
+private:
+  int s_;
+};
+
+/** \brief Closed-form lowest order edge elements on the reference square */
+struct EdgeR12DReference
+{
+  template <class X, class Y>
+  void operator() (const X& x, std::vector<Y>& out) const
+  {
+    out.assign(4, Y(0));
+    out[0][0] = 1-x[1];
+    out[1][0] = x[1];
+    out[2][1] = 1-x[0];
+    out[3][1] = x[0];
+  }
+};
+
+/** \brief The monomials of total degree up to p, ordered by total degree and then by
+    decreasing exponents of x_0, x_1, ... */
+template <int dim, int p>
+struct MonomReference
+{
+  template <class X, class Y>
+  void operator() (const X& x, std::vector<Y>& out) const
+  {
+    out.clear();
+    for (int degree=0; degree<=p; degree++)
+      add(x, 0, degree, 1.0, out);
+  }
+
+  template <class X, class Y>
+  static void add (const X& x, int c, int degree, double product, std::vector<Y>& out)
+  {
+    if (c == dim-1) {
+      out.push_back(Y(product*std::pow(double(x[c]), degree)));
+      return;
+    }
+    for (int e=degree; e>=0; e--)
+      add(x, c+1, degree-e, product*std::pow(double(x[c]), e), out);
+  }
+};
+
+/** \brief Compare the batched evaluation of the values to the closed-form reference */
+template <class LB, class Reference>
+void testBatchedFunction (const LB& lb, const GeometryType& type, const Reference& reference, const char* name)
+{
+  typedef typename LB::Traits::RangeType RangeType;
+  const int m = LB::Traits::dimRange;
+
+  std::vector<typename LB::Traits::DomainType> points = testPoints<LB>(type, 3);
+
+  std::vector<RangeType> batched, values;
+  lb.evaluateFunctionBatched(points, batched);
+
+  if (batched.size() != points.size()*lb.size()) {
+    std::cerr << name << ": evaluateFunctionBatched returns " << batched.size()
+              << " values, but " << points.size()*lb.size() << " are expected." << std::endl;
+    success = false;
+    return;
+  }
+
+  for (size_t p=0; p<points.size(); p++) {
+    reference(points[p], values);
+    for (unsigned int i=0; i<lb.size(); i++)
+      for (int r=0; r<m; r++)
+        if (std::abs(batched[p*lb.size()+i][r] - values[i][r]) > 1e-10) {
+          std::cerr << name << ": batched value of shape function " << i << " at " << points[p]
+                    << " is " << batched[p*lb.size()+i][r] << ", but " << values[i][r]
+                    << " is expected" << std::endl;
+          success = false;
+        }
+  }
+}
+
+/** \brief Compare the batched evaluation of the Jacobians to finite differences of the batched values */
+template <class LB>
+void testBatchedJacobian (const LB& lb, const GeometryType& type, const char* name)
+{
+  typedef typename LB::Traits::JacobianType JacobianType;
+  const int n = LB::Traits::dimDomain;
+  const int m = LB::Traits::dimRange;
+  const double h = 1e-6;
+
+  // move the points off the lines x=1/2 etc., where the derivatives of RefinedP1 jump
+  std::vector<typename LB::Traits::DomainType> points = testPoints<LB>(type, 3);
+  for (size_t p=0; p<points.size(); p++)
+    for (int c=0; c<n; c++)
+      points[p][c] = 0.95*points[p][c] + 0.005;
+
+  std::vector<JacobianType> batched;
+  lb.evaluateJacobianBatched(points, batched);
+
+  if (batched.size() != points.size()*lb.size()) {
+    std::cerr << name << ": evaluateJacobianBatched returns " << batched.size()
+              << " Jacobians, but " << points.size()*lb.size() << " are expected." << std::endl;
+    success = false;
+    return;
+  }
+
+  std::vector<typename LB::Traits::DomainType> upPoints, downPoints;
+  std::vector<typename LB::Traits::RangeType> up, down;
+  for (int c=0; c<n; c++) {
+    upPoints = downPoints = points;
+    for (size_t p=0; p<points.size(); p++) {
+      upPoints[p][c] += h;
+      downPoints[p][c] -= h;
+    }
+    lb.evaluateFunctionBatched(upPoints, up);
+    lb.evaluateFunctionBatched(downPoints, down);
+
+    for (size_t j=0; j<batched.size(); j++)
+      for (int r=0; r<m; r++) {
+        const double fd = (up[j][r] - down[j][r])/(2*h);
+        if (std::abs(batched[j][r][c] - fd) > 1e-6*(1+std::abs(fd))) {
+          std::cerr << name << ": batched derivative of shape function " << j%lb.size()
+                    << " in direction " << c << " at " << points[j/lb.size()] << " is "
+                    << batched[j][r][c] << ", but " << fd << " is expected" << std::endl;
+          success = false;
+        }
+      }
+  }
+}
+
+/** \brief Compare the fused evaluation of values and Jacobians to the separate ones */
+template <class LB>
+void testFunctionAndJacobian (const LB& lb, const GeometryType& type, const char* name)
+{
+  typedef typename LB::Traits::RangeType RangeType;
+  typedef typename LB::Traits::JacobianType JacobianType;
+  const int n = LB::Traits::dimDomain;
+  const int m = LB::Traits::dimRange;
+
+  std::vector<typename LB::Traits::DomainType> points = testPoints<LB>(type, 3);
+
+  std::vector<RangeType> fusedValues, values;
+  std::vector<JacobianType> fusedJacobians, jacobians;
+
+  for (size_t p=0; p<points.size(); p++) {
+    lb.evaluateFunctionAndJacobian(points[p], fusedValues, fusedJacobians);
+    lb.evaluateFunction(points[p], values);
+    lb.evaluateJacobian(points[p], jacobians);
+
+    if (fusedValues.size() != lb.size() || fusedJacobians.size() != lb.size()) {
+      std::cerr << name << ": evaluateFunctionAndJacobian returns the wrong number of entries" << std::endl;
+      success = false;
+      return;
+    }
+
+    for (unsigned int i=0; i<lb.size(); i++)
+      for (int r=0; r<m; r++) {
+        if (std::abs(fusedValues[i][r] - values[i][r]) > epsilon) {
+          std::cerr << name << ": fused value of shape function " << i
+                    << " at " << points[p] << " does not agree with evaluateFunction" << std::endl;
+          success = false;
+        }
+        for (int c=0; c<n; c++)
+          if (std::abs(fusedJacobians[i][r][c] - jacobians[i][r][c]) > epsilon) {
+            std::cerr << name << ": fused Jacobian of shape function " << i
+                      << " at " << points[p] << " does not agree with evaluateJacobian" << std::endl;
+            success = false;
+          }
+      }
+  }
+}
+
+/** \brief Compare the evaluation into fixed-size storage to the one into a std::vector */
+template <class LB>
+void testFixedSize (const LB& lb, const GeometryType& type, const char* name)
+{
+  typedef typename LB::Traits::RangeType RangeType;
+  typedef typename LB::Traits::JacobianType JacobianType;
+  const int n = LB::Traits::dimDomain;
+  const int m = LB::Traits::dimRange;
+
+  std::vector<typename LB::Traits::DomainType> points = testPoints<LB>(type, 3);
+
+  std::vector<RangeType> values;
+  std::vector<JacobianType> jacobians;
+  FieldVector<RangeType,LB::N> fixedValues;
+  array<JacobianType,LB::N> fixedJacobians;
+  RangeType rawValues[LB::N];
+  JacobianType rawJacobians[LB::N];
+
+  for (size_t p=0; p<points.size(); p++) {
+    lb.evaluateFunction(points[p], values);
+    lb.evaluateJacobian(points[p], jacobians);
+
+    lb.evaluateFunction(points[p], fixedValues);
+    lb.evaluateJacobian(points[p], fixedJacobians);
+    lb.evaluateFunctionAndJacobian(points[p], rawValues, rawJacobians, LB::N);
+
+    for (unsigned int i=0; i<lb.size(); i++)
+      for (int r=0; r<m; r++) {
+        if (std::abs(fixedValues[i][r] - values[i][r]) > epsilon
+            || std::abs(rawValues[i][r] - values[i][r]) > epsilon) {
+          std::cerr << name << ": value of shape function " << i << " at " << points[p]
+                    << " in fixed-size storage does not agree with evaluateFunction" << std::endl;
+          success = false;
+        }
+        for (int c=0; c<n; c++)
+          if (std::abs(fixedJacobians[i][r][c] - jacobians[i][r][c]) > epsilon
+              || std::abs(rawJacobians[i][r][c] - jacobians[i][r][c]) > epsilon) {
+            std::cerr << name << ": Jacobian of shape function " << i << " at " << points[p]
+                      << " in fixed-size storage does not agree with evaluateJacobian" << std::endl;
+            success = false;
+          }
+      }
+  }
+}
+
+/** \brief Compare the cached tabulation to the direct evaluation */
+template <class LB>
+void testCache (const LB& lb, const GeometryType& type, const char* name)
+{
+  const int n = LB::Traits::dimDomain;
+  const int m = LB::Traits::dimRange;
+
+  LocalBasisCache<LB> cache(lb);
+
+  for (int order=0; order<=4; order++) {
+    const typename LocalBasisCache<LB>::TableType& table = cache.table(type, order);
+
+    if (&table != &cache.table(type, order)) {
+      std::cerr << name << ": a second request for the same table tabulates again" << std::endl;
+      success = false;
+    }
+
+    std::vector<typename LB::Traits::DomainType> points = testPoints<LB>(type, order);
+    if (table.numPoints() != points.size() || table.size() != lb.size()) {
+      std::cerr << name << ": cached table for order " << order << " has the wrong size" << std::endl;
+      success = false;
+      continue;
+    }
+
+    std::vector<typename LB::Traits::RangeType> values;
+    std::vector<typename LB::Traits::JacobianType> jacobians;
+    for (unsigned int q=0; q<table.numPoints(); q++) {
+      lb.evaluateFunction(table.position(q), values);
+      lb.evaluateJacobian(table.position(q), jacobians);
+      for (unsigned int i=0; i<lb.size(); i++)
+        for (int r=0; r<m; r++) {
+          if (std::abs(table.value(q,i)[r] - values[i][r]) > epsilon) {
+            std::cerr << name << ": cached value of shape function " << i
+                      << " at " << table.position(q) << " is wrong" << std::endl;
+            success = false;
+          }
+          for (int c=0; c<n; c++)
+            if (std::abs(table.jacobian(q,i)[r][c] - jacobians[i][r][c]) > epsilon) {
+              std::cerr << name << ": cached Jacobian of shape function " << i
+                        << " at " << table.position(q) << " is wrong" << std::endl;
+              success = false;
+            }
+        }
+    }
+  }
+}
+
+/** \brief A single shape function, to be passed to the local interpolation */
+template <class LB>
+class ShapeFunction
+{
+public:
+  ShapeFunction (const LB& lb, unsigned int i) : lb_(lb), i_(i)
+  {}
+
+  void evaluate (const typename LB::Traits::DomainType& x,
+                 typename LB::Traits::RangeType& y) const
+  {
+    std::vector<typename LB::Traits::RangeType> values;
+    lb_.evaluateFunction(x, values);
+    y = values[i_];
+  }
+
+private:
+  const LB& lb_;
+  unsigned int i_;
+};
+
+/** \brief Check that a Lagrange element interpolates its own shape functions exactly
+    and that its local keys number the degrees of freedom on each subentity consecutively */
+template <class FE>
+void testLagrangeElement (const FE& fe, const char* name)
+{
+  typedef typename FE::Traits::LocalBasisType LB;
+  const LB& lb = fe.localBasis();
+
+  std::vector<double> coefficients;
+  for (unsigned int i=0; i<lb.size(); i++) {
+    fe.localInterpolation().interpolate(ShapeFunction<LB>(lb,i), coefficients);
+    for (unsigned int j=0; j<lb.size(); j++)
+      if (std::abs(coefficients[j] - (i==j)) > 1e-10) {
+        std::cerr << name << ": interpolating shape function " << i
+                  << " yields " << coefficients[j] << " as coefficient " << j << std::endl;
+        success = false;
+      }
+  }
+
+  // collect the indices on each subentity
+  const int dim = LB::Traits::dimDomain;
+  typedef std::map<std::pair<unsigned int,unsigned int>,std::vector<unsigned int> > IndexMap;
+  IndexMap indices;
+  for (int i=0; i<fe.localCoefficients().size(); i++) {
+    const LocalKey& key = fe.localCoefficients().localKey(i);
+    if (key.codim() > (unsigned int)dim) {
+      std::cerr << name << ": local key " << i << " has codimension " << key.codim() << std::endl;
+      success = false;
+    }
+    indices[std::make_pair(key.codim(),key.subentity())].push_back(key.index());
+  }
+  for (typename IndexMap::iterator it = indices.begin(); it != indices.end(); ++it) {
+    std::sort(it->second.begin(), it->second.end());
+    for (unsigned int i=0; i<it->second.size(); i++)
+      if (it->second[i] != i) {
+        std::cerr << name << ": the indices on subentity " << it->first.second
+                  << " of codimension " << it->first.first << " are not 0,...,"
+                  << it->second.size()-1 << std::endl;
+        success = false;
+        break;
+      }
+  }
+}
+
+/** \brief Compare the sum-factorized evaluation on a tensor grid to the pointwise one */
+template <class LB>
+void testTensorGrid (const LB& lb, const char* name)
+{
+  typedef typename LB::Traits::DomainType DomainType;
+  const int dim = LB::Traits::dimDomain;
+
+  std::vector<double> points1D;
+  for (int q=0; q<5; q++)
+    points1D.push_back(0.1 + 0.2*q*q/4.0);
+
+  std::vector<double> coefficients(lb.size());
+  for (unsigned int i=0; i<lb.size(); i++)
+    coefficients[i] = std::sin(1.0+i);
+
+  std::vector<typename LB::Traits::RangeType> values, shapeValues;
+  std::vector<typename LB::Traits::JacobianType> jacobians, shapeJacobians;
+  lb.evaluateFunctionOnTensorGrid(points1D, coefficients, values);
+  lb.evaluateJacobianOnTensorGrid(points1D, coefficients, jacobians);
+
+  size_t numPoints = 1;
+  for (int c=0; c<dim; c++)
+    numPoints *= points1D.size();
+  if (values.size() != numPoints || jacobians.size() != numPoints) {
+    std::cerr << name << ": evaluation on the tensor grid returns the wrong number of points" << std::endl;
+    success = false;
+    return;
+  }
+
+  for (size_t p=0; p<numPoints; p++) {
+    DomainType x;
+    for (int c=0, j=p; c<dim; c++, j/=points1D.size())
+      x[c] = points1D[j%points1D.size()];
+
+    lb.evaluateFunction(x, shapeValues);
+    lb.evaluateJacobian(x, shapeJacobians);
+    double value = 0;
+    FieldVector<double,dim> gradient(0);
+    for (unsigned int i=0; i<lb.size(); i++) {
+      value += coefficients[i]*shapeValues[i][0];
+      for (int c=0; c<dim; c++)
+        gradient[c] += coefficients[i]*shapeJacobians[i][0][c];
+    }
+
+    if (std::abs(values[p][0] - value) > 1e-10) {
+      std::cerr << name << ": sum-factorized value at " << x << " is " << values[p][0]
+                << ", but " << value << " is expected" << std::endl;
+      success = false;
+    }
+    for (int c=0; c<dim; c++)
+      if (std::abs(jacobians[p][0][c] - gradient[c]) > 1e-10) {
+        std::cerr << name << ": sum-factorized derivative in direction " << c << " at " << x
+                  << " is " << jacobians[p][0][c] << ", but " << gradient[c] << " is expected" << std::endl;
+        success = false;
+      }
+  }
+}
+
+/** \brief Compare LocalFunction to summing up the shape functions */
+template <class LB>
+void testLocalFunction (const LB& lb, const GeometryType& type, const char* name)
+{
+  const int n = LB::Traits::dimDomain;
+  const int m = LB::Traits::dimRange;
+
+  std::vector<double> coefficients(lb.size());
+  for (unsigned int i=0; i<lb.size(); i++)
+    coefficients[i] = std::sin(1.0+i);
+  LocalFunction<LB,double> f(lb, coefficients);
+
+  std::vector<typename LB::Traits::DomainType> points = testPoints<LB>(type, 3);
+
+  std::vector<typename LB::Traits::RangeType> values;
+  std::vector<typename LB::Traits::JacobianType> jacobians;
+  typename LB::Traits::RangeType value, fusedValue;
+  typename LB::Traits::JacobianType jacobian;
+
+  for (size_t p=0; p<points.size(); p++) {
+    lb.evaluateFunction(points[p], values);
+    lb.evaluateJacobian(points[p], jacobians);
+    f.evaluate(points[p], value);
+    f.evaluateFunctionAndJacobian(points[p], fusedValue, jacobian);
+
+    for (int r=0; r<m; r++) {
+      double expected = 0;
+      for (unsigned int i=0; i<lb.size(); i++)
+        expected += coefficients[i]*values[i][r];
+      if (std::abs(value[r] - expected) > 1e-10 || std::abs(fusedValue[r] - expected) > 1e-10) {
+        std::cerr << name << ": LocalFunction at " << points[p] << " is " << value[r]
+                  << ", but " << expected << " is expected" << std::endl;
+        success = false;
+      }
+
+      for (int c=0; c<n; c++) {
+        double expected = 0;
+        for (unsigned int i=0; i<lb.size(); i++)
+          expected += coefficients[i]*jacobians[i][r][c];
+        if (std::abs(jacobian[r][c] - expected) > 1e-10) {
+          std::cerr << name << ": Jacobian of LocalFunction at " << points[p] << " is " << jacobian[r][c]
+                    << ", but " << expected << " is expected" << std::endl;
+          success = false;
+        }
+      }
+    }
+  }
+}
+
+/** \brief Compare the Jacobians of a scalar basis to finite differences */
+template <class LB>
+void testJacobian (const LB& lb, const GeometryType& type, const char* name)
+{
+  typedef typename LB::Traits::DomainType DomainType;
+  const int n = LB::Traits::dimDomain;
+  const double h = 1e-6;
+
+  std::vector<DomainType> points = testPoints<LB>(type, 3);
+
+  std::vector<typename LB::Traits::JacobianType> jacobians;
+  std::vector<typename LB::Traits::RangeType> up, down;
+
+  for (size_t p=0; p<points.size(); p++) {
+    lb.evaluateJacobian(points[p], jacobians);
+
+    for (int a=0; a<n; a++) {
+      DomainType upPos = points[p], downPos = points[p];
+      upPos[a] += h;
+      downPos[a] -= h;
+      lb.evaluateFunction(upPos, up);
+      lb.evaluateFunction(downPos, down);
+      for (unsigned int i=0; i<lb.size(); i++) {
+        const double fd = (up[i][0] - down[i][0])/(2*h);
+        if (std::abs(jacobians[i][0][a] - fd) > 1e-6*(1+std::abs(fd))) {
+          std::cerr << name << ": derivative of shape function " << i << " in direction " << a
+                    << " at " << points[p] << " is " << jacobians[i][0][a]
+                    << ", but " << fd << " is expected" << std::endl;
+          success = false;
+        }
+      }
+    }
+  }
+}
+
+/** \brief Check that the mass matrix of a basis, assembled from the batched values, is the identity */
+template <class FE>
+void testOrthonormality (const FE& fe, const char* name)
+{
+  typedef typename FE::Traits::LocalBasisType LB;
+  const int dim = LB::Traits::dimDomain;
+  const unsigned int n = fe.localBasis().size();
+
+  const QuadratureRule<double,dim>& quad
+    = QuadratureRules<double,dim>::rule(fe.type(), 2*fe.localBasis().order());
+
+  std::vector<double> mass(n*n, 0.0);
+  std::vector<typename LB::Traits::RangeType> values;
+  fe.localBasis().evaluateFunctionBatched(testPoints<LB>(fe.type(), 2*fe.localBasis().order()), values);
+  for (size_t q=0; q<quad.size(); q++)
+    for (unsigned int i=0; i<n; i++)
+      for (unsigned int j=0; j<n; j++)
+        mass[i*n+j] += quad[q].weight()*values[q*n+i][0]*values[q*n+j][0];
+
+  for (unsigned int i=0; i<n; i++)
+    for (unsigned int j=0; j<n; j++)
+      if (std::abs(mass[i*n+j] - (i==j ? 1.0 : 0.0)) > 1e-10) {
+        std::cerr << name << ": entry (" << i << "," << j << ") of the mass matrix is "
+                  << mass[i*n+j] << std::endl;
+        success = false;
+      }
+}
+
+/** \brief Compare first and second derivatives of a Ck basis to finite differences */
+template <class LB>
+void testDerivatives (const LB& lb, const GeometryType& type, const char* name)
+{
+  typedef typename LB::Traits::DomainType DomainType;
+  const int n = LB::Traits::dimDomain;
+  const double h = 1e-5;
+  const double tolerance = 1e-6;
+
+  std::vector<DomainType> points = testPoints<LB>(type, 3);
+
+  std::vector<typename LB::Traits::JacobianType> jacobians;
+  std::vector<typename LB::Traits::RangeType> up, down, derivatives;
+
+  for (size_t p=0; p<points.size(); p++) {
+    lb.evaluateJacobian(points[p], jacobians);
+
+    for (int a=0; a<n; a++) {
+      DomainType upPos = points[p], downPos = points[p];
+      upPos[a] += h;
+      downPos[a] -= h;
+
+      // first derivatives
+      lb.evaluateFunction(upPos, up);
+      lb.evaluateFunction(downPos, down);
+      Dune::array<int,1> direction;
+      direction[0] = a;
+      lb.template evaluate<1>(direction, points[p], derivatives);
+      for (unsigned int i=0; i<lb.size(); i++) {
+        const double fd = (up[i][0] - down[i][0])/(2*h);
+        if (std::abs(jacobians[i][0][a] - fd) > tolerance
+            || std::abs(derivatives[i][0] - fd) > tolerance) {
+          std::cerr << name << ": derivative of shape function " << i << " in direction " << a
+                    << " at " << points[p] << " is " << jacobians[i][0][a]
+                    << ", but " << fd << " is expected" << std::endl;
+          success = false;
+        }
+      }
+
+      // second derivatives
+      for (int b=0; b<n; b++) {
+        direction[0] = b;
+        lb.template evaluate<1>(direction, upPos, up);
+        lb.template evaluate<1>(direction, downPos, down);
+        Dune::array<int,2> directions;
+        directions[0] = a;
+        directions[1] = b;
+        lb.template evaluate<2>(directions, points[p], derivatives);
+        for (unsigned int i=0; i<lb.size(); i++) {
+          const double fd = (up[i][0] - down[i][0])/(2*h);
+          if (std::abs(derivatives[i][0] - fd) > tolerance) {
+            std::cerr << name << ": second derivative of shape function " << i << " in directions "
+                      << a << "," << b << " at " << points[p] << " is " << derivatives[i][0]
+                      << ", but " << fd << " is expected" << std::endl;
+            success = false;
+          }
+        }
+      }
+    }
+  }
+}
+
+/** \brief Check that interpolating a function of the discrete space returns its coefficients */
+template <class FE>
+void testReproduction (const FE& fe, const char* name)
+{
+  typedef typename FE::Traits::LocalBasisType LB;
+
+  std::vector<double> coefficients(fe.localBasis().size());
+  for (unsigned int i=0; i<coefficients.size(); i++)
+    coefficients[i] = std::sin(1.0+i);
+  LocalFunction<LB,double> f(fe.localBasis(), coefficients);
+
+  std::vector<double> interpolated;
+  fe.localInterpolation().interpolate(f, interpolated);
+
+  // the mass matrix of the monomials is badly conditioned
+  for (unsigned int i=0; i<coefficients.size(); i++)
+    if (std::abs(interpolated[i] - coefficients[i]) > 1e-8) {
+      std::cerr << name << ": interpolation yields coefficient " << interpolated[i]
+                << " for shape function " << i << ", but " << coefficients[i] << " is expected" << std::endl;
+      success = false;
+    }
+}
+
+/** \brief Check that the packed local keys agree with the local keys */
+template <class LC>
+void testPackedLocalKeys (const LC& lc, const char* name)
+{
+  for (int i=0; i<lc.size(); i++) {
+    const LocalKey& key = lc.localKey(i);
+    const PackedLocalKey& packed = lc.packedLocalKey(i);
+    if (packed.subentity() != key.subentity() || packed.codim() != key.codim()
+        || packed.index() != key.index()) {
+      std::cerr << name << ": packed local key " << i << " differs from the local key" << std::endl;
+      success = false;
+    }
+  }
+}
+
+template <class FE>
+void testLocalBasis (const FE& fe, const char* name)
+{
+  testBatchedJacobian(fe.localBasis(), fe.type(), name);
+  testFunctionAndJacobian(fe.localBasis(), fe.type(), name);
+  testFixedSize(fe.localBasis(), fe.type(), name);
+  testCache(fe.localBasis(), fe.type(), name);
+  testLocalFunction(fe.localBasis(), fe.type(), name);
+  testPackedLocalKeys(fe.localCoefficients(), name);
+}
+
+int main (int argc, char *argv[]) try
+{
+  testLocalBasis(P0LocalFiniteElement<double,double,2>(GeometryType::simplex), "P0");
+  testLocalBasis(P1LocalFiniteElement<double,double,1>(), "P11D");
+  testLocalBasis(P1LocalFiniteElement<double,double,2>(), "P12D");
+  testLocalBasis(P1LocalFiniteElement<double,double,3>(), "P13D");
+  testLocalBasis(P23DLocalFiniteElement<double,double>(), "P23D");
+  testLocalBasis(Pk2DLocalFiniteElement<double,double,0>(), "Pk2D<0>");
+  testLocalBasis(Pk2DLocalFiniteElement<double,double,3>(), "Pk2D<3>");
+  testLocalBasis(Pk3DLocalFiniteElement<double,double,0>(), "Pk3D<0>");
+  testLocalBasis(Pk3DLocalFiniteElement<double,double,1>(), "Pk3D<1>");
+  testLocalBasis(Pk3DLocalFiniteElement<double,double,2>(), "Pk3D<2>");
+  testLocalBasis(Pk3DLocalFiniteElement<double,double,4>(), "Pk3D<4>");
+  testLocalBasis(Q1LocalFiniteElement<double,double,2>(), "Q12D");
+  testLocalBasis(Q1LocalFiniteElement<double,double,3>(), "Q13D");
+  testLocalBasis(Q22DLocalFiniteElement<double,double>(), "Q22D");
+  testLocalBasis(QkLocalFiniteElement<double,double,1,3>(), "Qk<1,3>");
+  testLocalBasis(QkLocalFiniteElement<double,double,2,0>(), "Qk<2,0>");
+  testLocalBasis(QkLocalFiniteElement<double,double,2,2>(), "Qk<2,2>");
+  testLocalBasis(QkLocalFiniteElement<double,double,3,3>(), "Qk<3,3>");
+  testLocalBasis(QkLocalFiniteElement<double,double,4,2>(), "Qk<4,2>");
+  testLocalBasis(RT02DLocalFiniteElement<double,double>(5), "RT02D");
+  testLocalBasis(EdgeR12DLocalFiniteElement<double,double>(), "EdgeR12D");
+  testLocalBasis(RefinedP1LocalFiniteElement<double,double>(), "RefinedP1");
+  testLocalBasis(MonomLocalFiniteElement<double,double,1,5>(GeometryType::cube), "Monom<1,5>");
+  testLocalBasis(MonomLocalFiniteElement<double,double,2,0>(GeometryType::simplex), "Monom<2,0>");
+  testLocalBasis(MonomLocalFiniteElement<double,double,2,3>(GeometryType::simplex), "Monom<2,3>");
+  testLocalBasis(MonomLocalFiniteElement<double,double,3,4>(GeometryType::cube), "Monom<3,4>");
+  testLocalBasis(OrthonormalLocalFiniteElement<double,double,1,4,GeometryType::cube>(), "Orthonormal<1,4,cube>");
+  testLocalBasis(OrthonormalLocalFiniteElement<double,double,2,3,GeometryType::cube>(), "Orthonormal<2,3,cube>");
+  testLocalBasis(OrthonormalLocalFiniteElement<double,double,3,2,GeometryType::cube>(), "Orthonormal<3,2,cube>");
+  testLocalBasis(OrthonormalLocalFiniteElement<double,double,2,0,GeometryType::simplex>(), "Orthonormal<2,0,simplex>");
+  testLocalBasis(OrthonormalLocalFiniteElement<double,double,2,4,GeometryType::simplex>(), "Orthonormal<2,4,simplex>");
+  testLocalBasis(OrthonormalLocalFiniteElement<double,double,3,3,GeometryType::simplex>(), "Orthonormal<3,3,simplex>");
+
+  // orientation variants
+  for (int s=0; s<8; s++) {
+    testLocalBasis(Pk2DLocalFiniteElement<double,double,3>(s), "Pk2D<3> variant");
+    testLocalBasis(RT02DLocalFiniteElement<double,double>(s), "RT02D variant");
+    testBatchedFunction(RT02DLocalBasis<double,double>(s), GeometryType(GeometryType::simplex,2), RT02DReference(s), "RT02D variant");
+  }
+
+  const GeometryType line(GeometryType::cube,1), triangle(GeometryType::simplex,2), tetrahedron(GeometryType::simplex,3);
+  const GeometryType square(GeometryType::cube,2), cube(GeometryType::cube,3), hypercube(GeometryType::cube,4);
+  testBatchedFunction(P0LocalBasis<double,double,2>(), triangle, SimplexLagrangeReference<2,0>(), "P0");
+  testBatchedFunction(P11DLocalBasis<double,double>(), line, SimplexLagrangeReference<1,1>(), "P11D");
+  testBatchedFunction(P12DLocalBasis<double,double>(), triangle, SimplexLagrangeReference<2,1>(), "P12D");
+  testBatchedFunction(P13DLocalBasis<double,double>(), tetrahedron, SimplexLagrangeReference<3,1>(), "P13D");
+  testBatchedFunction(P23DLocalBasis<double,double>(), tetrahedron, P23DReference(), "P23D");
+  testBatchedFunction(Pk2DLocalBasis<double,double,0>(), triangle, SimplexLagrangeReference<2,0>(), "Pk2D<0>");
+  testBatchedFunction(Pk2DLocalBasis<double,double,3>(), triangle, SimplexLagrangeReference<2,3>(), "Pk2D<3>");
+  testBatchedFunction(Pk3DLocalBasis<double,double,0>(), tetrahedron, SimplexLagrangeReference<3,0>(), "Pk3D<0>");
+  testBatchedFunction(Pk3DLocalBasis<double,double,2>(), tetrahedron, SimplexLagrangeReference<3,2>(), "Pk3D<2>");
+  testBatchedFunction(Pk3DLocalBasis<double,double,4>(), tetrahedron, SimplexLagrangeReference<3,4>(), "Pk3D<4>");
+  testBatchedFunction(Q12DLocalBasis<double,double>(), square, CubeLagrangeReference<2,1>(), "Q12D");
+  testBatchedFunction(Q13DLocalBasis<double,double>(), cube, CubeLagrangeReference<3,1>(), "Q13D");
+  testBatchedFunction(Q22DLocalBasis<double,double>(), square, Q22DReference(), "Q22D");
+  testBatchedFunction(QkLocalBasis<double,double,1,3>(), line, CubeLagrangeReference<1,3>(), "Qk<1,3>");
+  testBatchedFunction(QkLocalBasis<double,double,2,0>(), square, CubeLagrangeReference<2,0>(), "Qk<2,0>");
+  testBatchedFunction(QkLocalBasis<double,double,2,2>(), square, CubeLagrangeReference<2,2>(), "Qk<2,2>");
+  testBatchedFunction(QkLocalBasis<double,double,3,3>(), cube, CubeLagrangeReference<3,3>(), "Qk<3,3>");
+  testBatchedFunction(QkLocalBasis<double,double,4,2>(), hypercube, CubeLagrangeReference<4,2>(), "Qk<4,2>");
+  testBatchedFunction(EdgeR12DLocalBasis<double,double>(), square, EdgeR12DReference(), "EdgeR12D");
+  testBatchedFunction(RefinedP1LocalBasis<double,double>(), triangle, RefinedP1Reference(), "RefinedP1");
+  testBatchedFunction(MonomLocalBasis<double,double,1,5>(), line, MonomReference<1,5>(), "Monom<1,5>");
+  testBatchedFunction(MonomLocalBasis<double,double,2,0>(), triangle, MonomReference<2,0>(), "Monom<2,0>");
+  testBatchedFunction(MonomLocalBasis<double,double,2,3>(), triangle, MonomReference<2,3>(), "Monom<2,3>");
+  testBatchedFunction(MonomLocalBasis<double,double,3,4>(), cube, MonomReference<3,4>(), "Monom<3,4>");
+
+  // the local keys of all elements of one variant are shared
+  if (&Pk2DLocalCoefficients<3>(5).localKey(0) != &Pk2DLocalFiniteElement<double,double,3>(5).localCoefficients().localKey(0)
+      || &Q22DLocalCoefficients().localKey(0) != &Q22DLocalFiniteElement<double,double>().localCoefficients().localKey(0)) {
+    std::cerr << "local keys are not shared between coefficient objects" << std::endl;
+    success = false;
+  }
+
+  testLagrangeElement(Pk2DLocalFiniteElement<double,double,3>(5), "Pk2D<3> variant");
+  testLagrangeElement(QkLocalFiniteElement<double,double,1,4>(), "Qk<1,4>");
+  testLagrangeElement(QkLocalFiniteElement<double,double,2,0>(), "Qk<2,0>");
+  testLagrangeElement(QkLocalFiniteElement<double,double,2,3>(), "Qk<2,3>");
+  testLagrangeElement(QkLocalFiniteElement<double,double,3,4>(), "Qk<3,4>");
+  testLagrangeElement(QkLocalFiniteElement<double,double,4,3>(), "Qk<4,3>");
+
+  testReproduction(MonomLocalFiniteElement<double,double,1,5>(GeometryType::cube), "Monom<1,5>");
+  testReproduction(MonomLocalFiniteElement<double,double,2,3>(GeometryType::simplex), "Monom<2,3>");
+  testReproduction(MonomLocalFiniteElement<double,double,2,3>(GeometryType::cube), "Monom<2,3>");
+  testReproduction(MonomLocalFiniteElement<double,double,3,2>(GeometryType::simplex), "Monom<3,2>");
+  testReproduction(MonomLocalFiniteElement<double,double,3,2>(GeometryType::cube), "Monom<3,2>");
+
+  testOrthonormality(OrthonormalLocalFiniteElement<double,double,1,5,GeometryType::cube>(), "Orthonormal<1,5,cube>");
+  testOrthonormality(OrthonormalLocalFiniteElement<double,double,2,4,GeometryType::cube>(), "Orthonormal<2,4,cube>");
+  testOrthonormality(OrthonormalLocalFiniteElement<double,double,3,3,GeometryType::cube>(), "Orthonormal<3,3,cube>");
+  testOrthonormality(OrthonormalLocalFiniteElement<double,double,2,5,GeometryType::simplex>(), "Orthonormal<2,5,simplex>");
+  testOrthonormality(OrthonormalLocalFiniteElement<double,double,3,4,GeometryType::simplex>(), "Orthonormal<3,4,simplex>");
+  testJacobian(OrthonormalLocalBasis<double,double,2,5,GeometryType::cube>(), GeometryType(GeometryType::cube,2), "Orthonormal<2,5,cube>");
+  testJacobian(OrthonormalLocalBasis<double,double,2,5,GeometryType::simplex>(), GeometryType(GeometryType::simplex,2), "Orthonormal<2,5,simplex>");
+  testJacobian(OrthonormalLocalBasis<double,double,3,4,GeometryType::simplex>(), GeometryType(GeometryType::simplex,3), "Orthonormal<3,4,simplex>");
+  testReproduction(OrthonormalLocalFiniteElement<double,double,2,4,GeometryType::cube>(), "Orthonormal<2,4,cube>");
+  testReproduction(OrthonormalLocalFiniteElement<double,double,2,4,GeometryType::simplex>(), "Orthonormal<2,4,simplex>");
+  testReproduction(OrthonormalLocalFiniteElement<double,double,3,3,GeometryType::simplex>(), "Orthonormal<3,3,simplex>");
+
+  testDerivatives(MonomLocalBasis<double,double,1,5>(), GeometryType(GeometryType::cube,1), "Monom<1,5>");
+  testDerivatives(MonomLocalBasis<double,double,2,4>(), GeometryType(GeometryType::simplex,2), "Monom<2,4>");
+  testDerivatives(MonomLocalBasis<double,double,3,5>(), GeometryType(GeometryType::cube,3), "Monom<3,5>");
+  testDerivatives(Pk2DLocalBasis<double,double,3>(), GeometryType(GeometryType::simplex,2), "Pk2D<3>");
+  testDerivatives(P23DLocalBasis<double,double>(), GeometryType(GeometryType::simplex,3), "P23D");
+  testDerivatives(Q22DLocalBasis<double,double>(), GeometryType(GeometryType::cube,2), "Q22D");
+
+  testTensorGrid(QkLocalBasis<double,double,1,5>(), "Qk<1,5>");
+  testTensorGrid(QkLocalBasis<double,double,2,3>(), "Qk<2,3>");
+  testTensorGrid(QkLocalBasis<double,double,3,4>(), "Qk<3,4>");
+  testTensorGrid(QkLocalBasis<double,double,4,2>(), "Qk<4,2>");
+  testLagrangeElement(Pk3DLocalFiniteElement<double,double,0>(), "Pk3D<0>");
+  testLagrangeElement(Pk3DLocalFiniteElement<double,double,2>(), "Pk3D<2>");
+  testLagrangeElement(Pk3DLocalFiniteElement<double,double,5>(), "Pk3D<5>");
+  for (int s=0; s<64; s+=7) {
+    Dune::array<int,4> faceVariant;
+    for (int f=0; f<4; f++)
+      faceVariant[f] = (s+f)%6;
+    testLagrangeElement(Pk3DLocalFiniteElement<double,double,5>(s,faceVariant), "Pk3D<5> variant");
+  }
+
+  return success ? 0 : 1;
+}
+catch (Exception e) {
+
+  std::cout << e << std::endl;
+  return 1;
+}
@@ -0,0 +1,140 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+#include <config.h>
+
+#include <cmath>
+#include <iostream>
+#include <vector>
+
+#include <dune/finiteelements/common/localfacecache.hh>
+#include <dune/finiteelements/p1.hh>
+#include <dune/finiteelements/pk2d.hh>
+#include <dune/finiteelements/pk3d.hh>
+#include <dune/finiteelements/q1.hh>
+#include <dune/finiteelements/q22d.hh>
+#include <dune/finiteelements/qk.hh>
+#include <dune/finiteelements/rt02d.hh>
+
+/** \file
+    \brief Checks the tabulation of the local bases on all faces and orientations
+ */
+
+bool success = true;
+
+using namespace Dune;
+
+/** \brief Check the face tables against the face mapping and direct evaluation
+
+    The points of every face and orientation have to lie on the face, the
+    vertices of the reference face have to be mapped to the permuted face
+    vertices, and the tabulated values and Jacobians have to match
+    evaluateFunctionAndJacobian at the mapped points.
+ */
+template <class FE>
+void testFaceTables (const FE& fe, const char* name, int order)
+{
+  typedef typename FE::Traits::LocalBasisType LB;
+  typedef typename LB::Traits Traits;
+  typedef typename LocalFaceCache<LB>::MappingType Mapping;
+  typedef typename LocalFaceCache<LB>::TableType Table;
+  const int dim = Traits::dimDomain;
+  const int m = Traits::dimRange;
+  const GeometryType gt = fe.type();
+  const LB& lb = fe.localBasis();
+  const unsigned int n = lb.size();
+
+  LocalFaceCache<LB> cache(lb);
+  const std::vector<Table>& tables = cache.tables(gt, order);
+  if (tables.size() != (unsigned int)(Mapping::faces(gt)*Mapping::orientations(gt))
+      || &cache.table(gt, Mapping::faces(gt)-1, 0, order) != &tables[tables.size()-Mapping::orientations(gt)]) {
+    std::cerr << name << ": face cache does not hold one table per face and orientation" << std::endl;
+    success = false;
+    return;
+  }
+
+  double faceVolume = 1;
+  if (!gt.isCube())
+    for (int k=2; k<dim; k++)
+      faceVolume /= k;
+
+  std::vector<typename Traits::RangeType> values;
+  std::vector<typename Traits::JacobianType> jacobians;
+  for (int f=0; f<Mapping::faces(gt); f++)
+    for (int o=0; o<Mapping::orientations(gt); o++) {
+      const Table& table = cache.table(gt, f, o, order);
+
+      // the vertices of the reference face
+      for (int r=0; r<Mapping::faceVertices(gt); r++) {
+        typename Mapping::LocalType corner(0.0);
+        for (int j=0; j<dim-1; j++)
+          corner[j] = gt.isCube() ? (r>>j)&1 : (r==j+1);
+        typename Traits::DomainType x = Mapping::global(gt, f, o, corner);
+        x -= Mapping::vertex(gt, Mapping::faceVertex(gt, f, Mapping::permutation(gt, o, r)));
+        if (x.two_norm() > 1e-12) {
+          std::cerr << name << ": face " << f << " with orientation " << o
+                    << " does not map reference vertex " << r << " to the permuted face vertex" << std::endl;
+          success = false;
+        }
+      }
+
+      double volume = 0;
+      for (unsigned int q=0; q<table.numPoints(); q++) {
+        const typename Traits::DomainType& x = table.position(q);
+        volume += table.weight(q);
+
+        double distance;
+        if (gt.isCube())
+          distance = x[f/2] - f%2;
+        else if (f == 0) {
+          distance = 1;
+          for (int d=0; d<dim; d++)
+            distance -= x[d];
+        }
+        else
+          distance = x[f-1];
+        if (std::abs(distance) > 1e-12) {
+          std::cerr << name << ": point " << q << " of face " << f << " with orientation " << o
+                    << " does not lie on the face" << std::endl;
+          success = false;
+        }
+
+        lb.evaluateFunctionAndJacobian(x, values, jacobians);
+        for (unsigned int i=0; i<n; i++)
+          for (int r=0; r<m; r++) {
+            bool equal = std::abs(table.value(q,i)[r] - values[i][r]) < 1e-12;
+            for (int d=0; d<dim; d++)
+              equal = equal && std::abs(table.jacobian(q,i)[r][d] - jacobians[i][r][d]) < 1e-12;
+            if (!equal) {
+              std::cerr << name << ": face table of face " << f << " with orientation " << o
+                        << " differs from evaluation for shape function " << i << std::endl;
+              success = false;
+            }
+          }
+      }
+      if (std::abs(volume - faceVolume) > 1e-12) {
+        std::cerr << name << ": weights of face " << f << " sum up to " << volume
+                  << " instead of " << faceVolume << std::endl;
+        success = false;
+      }
+    }
+}
+
+int main (int argc, char *argv[]) try
+{
+  testFaceTables(P11DLocalFiniteElement<double,double>(), "P11D", 0);
+  testFaceTables(P12DLocalFiniteElement<double,double>(), "P12D", 2);
+  testFaceTables(Pk2DLocalFiniteElement<double,double,3>(), "Pk2D<3>", 6);
+  testFaceTables(Pk3DLocalFiniteElement<double,double,2>(), "Pk3D<2>", 4);
+  testFaceTables(Q1LocalFiniteElement<double,double,2>(), "Q12D", 2);
+  testFaceTables(Q1LocalFiniteElement<double,double,3>(), "Q13D", 2);
+  testFaceTables(Q22DLocalFiniteElement<double,double>(), "Q22D", 4);
+  testFaceTables(QkLocalFiniteElement<double,double,3,2>(), "Qk<3,2>", 4);
+  testFaceTables(RT02DLocalFiniteElement<double,double>(3), "RT02D", 2);
+
+  return success ? 0 : 1;
+}
+catch (Exception e) {
+
+  std::cout << e << std::endl;
+  return 1;
+}
@@ -0,0 +1,206 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+#include <config.h>
+
+#include <cmath>
+#include <iostream>
+#include <vector>
+
+#if HAVE_PTHREAD_H
+#include <pthread.h>
+#endif
+
+#include <dune/finiteelements/localfiniteelementregistry.hh>
+
+/** \file
+    \brief Checks that the registry hands out shared elements that behave as the elements they wrap
+ */
+
+bool success = true;
+
+using namespace Dune;
+
+/** \brief A smooth function to interpolate, usable through the type-erased interface */
+template <class E>
+class SharedFunction
+  : public E::FunctionType
+{
+public:
+  typedef typename E::Traits Traits;
+
+  void evaluate (const typename Traits::DomainType& x, typename Traits::RangeType& y) const
+  {
+    for (int r=0; r<Traits::dimRange; r++)
+      y[r] = std::exp(-x.two_norm2()) + 0.5*r*x[0];
+  }
+};
+
+/** \brief Check that the registry hands out one shared element that behaves as fe */
+template <class FE>
+void testSharedElement (const FE& fe, LocalFiniteElementFamily::Type family, unsigned int variant, const char* name)
+{
+  typedef typename FE::Traits::LocalBasisType LB;
+  typedef typename LB::Traits Traits;
+  typedef LocalFiniteElementRegistry<typename Traits::DomainFieldType,typename Traits::RangeFieldType,
+      Traits::dimDomain,Traits::dimRange> Registry;
+  typedef typename Registry::ElementType Element;
+  const int dim = Traits::dimDomain;
+  const int m = Traits::dimRange;
+  const LB& lb = fe.localBasis();
+  const unsigned int n = lb.size();
+
+  const Element& shared = Registry::get(family, fe.type(), lb.order(), variant);
+  if (&Registry::get(family, fe.type(), lb.order(), variant) != &shared) {
+    std::cerr << name << ": the registry creates a new element on every request" << std::endl;
+    success = false;
+  }
+  if (shared.size() != n || shared.order() != lb.order() || shared.type() != fe.type()) {
+    std::cerr << name << ": shared element differs in size, order or type" << std::endl;
+    success = false;
+    return;
+  }
+  for (unsigned int i=0; i<n; i++) {
+    const LocalKey& key = shared.localKey(i);
+    const LocalKey& expectedKey = fe.localCoefficients().localKey(i);
+    if (key.subentity() != expectedKey.subentity() || key.codim() != expectedKey.codim()
+        || key.index() != expectedKey.index()) {
+      std::cerr << name << ": shared element has a different local key " << i << std::endl;
+      success = false;
+    }
+  }
+
+  const SharedFunction<Element> f;
+  std::vector<typename Traits::RangeFieldType> coefficients, expectedCoefficients;
+  shared.interpolate(f, coefficients);
+  fe.localInterpolation().interpolate(f, expectedCoefficients);
+  for (unsigned int i=0; i<n; i++)
+    if (std::abs(coefficients[i] - expectedCoefficients[i]) > 1e-12) {
+      std::cerr << name << ": shared element interpolates differently in coefficient " << i << std::endl;
+      success = false;
+    }
+
+  // volume and face tables against direct evaluation
+  const typename Element::TableType& table = shared.table(2);
+  const typename Element::TableType& faceTable = shared.faceTable(LocalFaceMapping<double,dim>::faces(fe.type())-1, 0, 2);
+  if (&shared.table(2) != &table) {
+    std::cerr << name << ": shared element tabulates on every request" << std::endl;
+    success = false;
+  }
+  const typename Element::TableType* tables[2] = {&table, &faceTable};
+  std::vector<typename Traits::RangeType> values;
+  std::vector<typename Traits::JacobianType> jacobians;
+  for (int t=0; t<2; t++)
+    for (unsigned int q=0; q<tables[t]->numPoints(); q++) {
+      lb.evaluateFunction(tables[t]->position(q), values);
+      lb.evaluateJacobian(tables[t]->position(q), jacobians);
+      for (unsigned int i=0; i<n; i++)
+        for (int r=0; r<m; r++) {
+          bool equal = std::abs(tables[t]->value(q,i)[r] - values[i][r]) < 1e-12;
+          for (int d=0; d<dim; d++)
+            equal = equal && std::abs(tables[t]->jacobian(q,i)[r][d] - jacobians[i][r][d]) < 1e-12;
+          if (!equal) {
+            std::cerr << name << ": table of the shared element differs from the basis for shape function "
+                      << i << std::endl;
+            success = false;
+          }
+        }
+    }
+}
+
+/** \brief Check that the registry refuses unknown combinations */
+template <class Registry>
+void testMissingElement (LocalFiniteElementFamily::Type family, const GeometryType& gt,
+                         int order, unsigned int variant, const char* name)
+{
+  try {
+    Registry::get(family, gt, order, variant);
+    std::cerr << "registry: " << name << " should not exist" << std::endl;
+    success = false;
+  }
+  catch (NotImplemented&) {}
+}
+
+#if HAVE_PTHREAD_H
+/** \brief Request an element and two of its tables, run in several threads at once */
+void* requestShared (void* result)
+{
+  typedef LocalFiniteElementRegistry<double,double,2> Registry;
+  const Registry::ElementType& element
+    = Registry::get(LocalFiniteElementFamily::lagrange, GeometryType(GeometryType::simplex,2), 4, 3);
+  const void** pointers = static_cast<const void**>(result);
+  pointers[0] = &element;
+  pointers[1] = &element.table(5);
+  pointers[2] = &element.faceTable(2, 1, 5);
+  return 0;
+}
+
+/** \brief Check that threads requesting the same element and tables at once all get the same objects */
+void testThreads ()
+{
+  const int threads = 8;
+  pthread_t thread[threads];
+  const void* pointers[threads][3];
+  for (int t=0; t<threads; t++)
+    pthread_create(&thread[t], 0, requestShared, pointers[t]);
+  for (int t=0; t<threads; t++)
+    pthread_join(thread[t], 0);
+
+  for (int t=1; t<threads; t++)
+    for (int i=0; i<3; i++)
+      if (pointers[t][i] != pointers[0][i]) {
+        std::cerr << "registry: thread " << t << " got a different "
+                  << (i == 0 ? "element" : "table") << " than thread 0" << std::endl;
+        success = false;
+      }
+}
+#endif
+
+int main (int argc, char *argv[]) try
+{
+#if HAVE_PTHREAD_H
+  // first, while nothing is shared yet
+  testThreads();
+#endif
+
+  testSharedElement(QkLocalFiniteElement<double,double,1,3>(), LocalFiniteElementFamily::lagrange, 0, "Qk<1,3>");
+  testSharedElement(Pk2DLocalFiniteElement<double,double,0>(), LocalFiniteElementFamily::lagrange, 0, "Pk2D<0>");
+  testSharedElement(Pk2DLocalFiniteElement<double,double,3>(5), LocalFiniteElementFamily::lagrange, 5, "Pk2D<3> variant");
+  {
+    Dune::array<int,4> faceVariant;
+    faceVariant[0] = 1; faceVariant[1] = 0; faceVariant[2] = 5; faceVariant[3] = 2;
+    testSharedElement(Pk3DLocalFiniteElement<double,double,3>(3,faceVariant), LocalFiniteElementFamily::lagrange,
+                      3 | 1<<6 | 0<<9 | 5<<12 | 2<<15, "Pk3D<3> variant");
+  }
+  testSharedElement(QkLocalFiniteElement<double,double,2,2>(), LocalFiniteElementFamily::lagrange, 0, "Qk<2,2>");
+  testSharedElement(QkLocalFiniteElement<double,double,3,1>(), LocalFiniteElementFamily::lagrange, 0, "Qk<3,1>");
+  testSharedElement(MonomLocalFiniteElement<double,double,2,3>(GeometryType::simplex), LocalFiniteElementFamily::monomial, 0, "Monom<2,3>");
+  testSharedElement(MonomLocalFiniteElement<double,double,3,2>(GeometryType::cube), LocalFiniteElementFamily::monomial, 0, "Monom<3,2>");
+  testSharedElement(OrthonormalLocalFiniteElement<double,double,2,4,GeometryType::simplex>(), LocalFiniteElementFamily::orthonormal, 0, "Orthonormal<2,4,simplex>");
+  testSharedElement(OrthonormalLocalFiniteElement<double,double,3,2,GeometryType::cube>(), LocalFiniteElementFamily::orthonormal, 0, "Orthonormal<3,2,cube>");
+  testSharedElement(RefinedP1LocalFiniteElement<double,double>(), LocalFiniteElementFamily::refinedLagrange, 0, "RefinedP1");
+  testSharedElement(RT02DLocalFiniteElement<double,double>(6), LocalFiniteElementFamily::raviartThomas, 6, "RT02D");
+  testSharedElement(EdgeR12DLocalFiniteElement<double,double>(), LocalFiniteElementFamily::nedelec, 0, "EdgeR12D");
+
+  if (&LocalFiniteElementRegistry<double,double,1>::get(LocalFiniteElementFamily::lagrange, GeometryType(GeometryType::simplex,1), 2)
+      != &LocalFiniteElementRegistry<double,double,1>::get(LocalFiniteElementFamily::lagrange, GeometryType(GeometryType::cube,1), 2)) {
+    std::cerr << "registry: simplex and cube lines do not share their elements" << std::endl;
+    success = false;
+  }
+  testMissingElement<LocalFiniteElementRegistry<double,double,2> >(LocalFiniteElementFamily::lagrange, GeometryType(GeometryType::simplex,2), 7, 0, "Pk2D<7>");
+  testMissingElement<LocalFiniteElementRegistry<double,double,2> >(LocalFiniteElementFamily::lagrange, GeometryType(GeometryType::simplex,2), 1, 8, "Pk2D<1> variant 8");
+  testMissingElement<LocalFiniteElementRegistry<double,double,2> >(LocalFiniteElementFamily::lagrange, GeometryType(GeometryType::cube,2), 1, 1, "Qk<2,1> variant 1");
+  testMissingElement<LocalFiniteElementRegistry<double,double,3> >(LocalFiniteElementFamily::lagrange, GeometryType(GeometryType::simplex,3), 2, 6<<6, "Pk3D<2> face variant 6");
+  testMissingElement<LocalFiniteElementRegistry<double,double,2> >(LocalFiniteElementFamily::refinedLagrange, GeometryType(GeometryType::cube,2), 1, 0, "refined Lagrange on quadrilaterals");
+  testMissingElement<LocalFiniteElementRegistry<double,double,3> >(LocalFiniteElementFamily::refinedLagrange, GeometryType(GeometryType::simplex,3), 1, 0, "refined Lagrange in 3D");
+  testMissingElement<LocalFiniteElementRegistry<double,double,2> >(LocalFiniteElementFamily::raviartThomas, GeometryType(GeometryType::simplex,2), 1, 0, "scalar RT02D");
+  testMissingElement<LocalFiniteElementRegistry<double,double,2,2> >(LocalFiniteElementFamily::raviartThomas, GeometryType(GeometryType::cube,2), 1, 0, "RT02D on quadrilaterals");
+  testMissingElement<LocalFiniteElementRegistry<double,double,2> >(LocalFiniteElementFamily::lagrange, GeometryType(GeometryType::simplex,3), 1, 0, "Pk3D in the 2D registry");
+  testMissingElement<LocalFiniteElementRegistry<double,double,3> >(LocalFiniteElementFamily::lagrange, GeometryType(GeometryType::prism,3), 1, 0, "Lagrange on prisms");
+
+  return success ? 0 : 1;
+}
+catch (Exception e) {
+
+  std::cout << e << std::endl;
+  return 1;
+}
@@ -0,0 +1,187 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+#include <config.h>
+
+#include <cmath>
+#include <iostream>
+#include <vector>
+
+#include <dune/finiteelements/common/localfiniteelementvariants.hh>
+#include <dune/finiteelements/pk2d.hh>
+#include <dune/finiteelements/rt02d.hh>
+
+/** \file
+    \brief Checks that the variants chosen from global vertex ids are conforming
+ */
+
+bool success = true;
+
+using namespace Dune;
+
+/** \brief A triangle in the plane with global ids of its vertices */
+struct Triangle
+{
+  FieldVector<double,2> corner[3];
+  int id[3];
+
+  //! \brief Jacobian of the affine map from the reference triangle
+  FieldMatrix<double,2,2> jacobian () const
+  {
+    FieldMatrix<double,2,2> J;
+    for (int i=0; i<2; i++)
+      for (int j=0; j<2; j++)
+        J[i][j] = corner[j+1][i] - corner[0][i];
+    return J;
+  }
+
+  //! \brief Local coordinates of the point x
+  FieldVector<double,2> local (const FieldVector<double,2>& x) const
+  {
+    FieldMatrix<double,2,2> J = jacobian();
+    J.invert();
+    FieldVector<double,2> y = x, xi;
+    y -= corner[0];
+    J.mv(y,xi);
+    return xi;
+  }
+};
+
+/** \brief A coefficient for the degree of freedom of key that only depends on the global subentity */
+double globalCoefficient (const Triangle& t, const LocalKey& key)
+{
+  int a = 0, b = 0;
+  if (key.codim() == 2)
+    a = t.id[key.subentity()];
+  else if (key.codim() == 1) {
+    // edge e lies opposite vertex e
+    a = t.id[key.subentity()==0 ? 1 : 0];
+    b = t.id[key.subentity()==2 ? 1 : 2];
+    if (a > b)
+      std::swap(a,b);
+  }
+  else
+    a = 100 + t.id[0] + t.id[1] + t.id[2];
+  return std::sin(1.0 + 3*key.codim() + 7*a + 11*b + 13*key.index());
+}
+
+//! \brief Scalar functions are not transformed
+void piola (const FieldMatrix<double,2,2>&, FieldVector<double,1>&)
+{}
+
+//! \brief The contravariant Piola transformation J u / det J
+void piola (const FieldMatrix<double,2,2>& J, FieldVector<double,2>& u)
+{
+  FieldVector<double,2> v;
+  J.mv(u,v);
+  u = v;
+  u /= J.determinant();
+}
+
+//! \brief The part of u that has to be continuous across an edge with normal n
+double trace (const FieldVector<double,1>& u, const FieldVector<double,2>&)
+{
+  return u[0];
+}
+
+double trace (const FieldVector<double,2>& u, const FieldVector<double,2>& n)
+{
+  return u*n;
+}
+
+/** \brief Check that the variants chosen from the vertex ids match on the common edge of two triangles
+
+    A function with global coefficients must be continuous for Lagrange
+    elements and have a continuous normal component for Raviart-Thomas
+    elements.
+ */
+template <class FE>
+void testVariants (const Triangle& t0, const Triangle& t1, const char* name)
+{
+  typedef typename FE::Traits::LocalBasisType::Traits::RangeType RangeType;
+  const LocalFiniteElementVariants<FE> variants;
+
+  for (int v=0; v<FE::variants; v++)
+    for (int i=0; i<variants.variant(v).localCoefficients().size(); i++) {
+      const LocalKey& key = variants.variant(v).localCoefficients().localKey(i);
+      const LocalKey& expectedKey = FE(v).localCoefficients().localKey(i);
+      if (key.subentity() != expectedKey.subentity() || key.codim() != expectedKey.codim()
+          || key.index() != expectedKey.index()) {
+        std::cerr << name << ": variant " << v << " of the set has a different local key " << i << std::endl;
+        success = false;
+      }
+    }
+
+  std::vector<FieldVector<double,2> > edge;
+  for (int i=0; i<3; i++)
+    for (int j=0; j<3; j++)
+      if (t0.id[i] == t1.id[j])
+        edge.push_back(t0.corner[i]);
+  assert(edge.size() == 2);
+  FieldVector<double,2> n;
+  n[0] = edge[1][1] - edge[0][1];
+  n[1] = edge[0][0] - edge[1][0];
+
+  for (int q=0; q<5; q++) {
+    FieldVector<double,2> x = edge[0];
+    x.axpy(0.1 + 0.2*q, edge[1] - edge[0]);
+
+    double value[2];
+    for (int s=0; s<2; s++) {
+      const Triangle& t = (s==0) ? t0 : t1;
+      const FE& fe = variants.element(t.id);
+      std::vector<RangeType> phi;
+      fe.localBasis().evaluateFunction(t.local(x), phi);
+      RangeType u(0);
+      for (unsigned int i=0; i<phi.size(); i++)
+        u.axpy(globalCoefficient(t, fe.localCoefficients().localKey(i)), phi[i]);
+      piola(t.jacobian(), u);
+      value[s] = trace(u, n);
+    }
+    if (std::abs(value[0] - value[1]) > 1e-10) {
+      std::cerr << name << ": the variants of two triangles with vertex ids "
+                << t0.id[0] << " " << t0.id[1] << " " << t0.id[2] << " and "
+                << t1.id[0] << " " << t1.id[1] << " " << t1.id[2]
+                << " do not match on their common edge" << std::endl;
+      success = false;
+    }
+  }
+}
+
+/** \brief Check the variants chosen from vertex ids on a triangle and neighbours sharing different local edges */
+template <class FE>
+void testVariants (const char* name)
+{
+  // vertex positions and ids of a small mesh
+  double position[5][2] = {{0,0},{1,0},{0,1},{1,1},{-1,0.5}};
+  int id[5] = {5,2,9,7,4};
+  // triangles as vertex numbers, in orders with either sign of the Jacobian determinant
+  int triangle[6][3] = {{0,1,2},{3,2,1},{3,1,2},{2,3,1},{4,0,2},{2,0,4}};
+
+  Triangle t[6];
+  for (int e=0; e<6; e++)
+    for (int i=0; i<3; i++) {
+      t[e].corner[i][0] = position[triangle[e][i]][0];
+      t[e].corner[i][1] = position[triangle[e][i]][1];
+      t[e].id[i] = id[triangle[e][i]];
+    }
+
+  for (int e=1; e<6; e++) {
+    testVariants<FE>(t[0], t[e], name);
+    testVariants<FE>(t[e], t[0], name);
+  }
+}
+
+int main (int argc, char *argv[]) try
+{
+  testVariants<Pk2DLocalFiniteElement<double,double,1> >("Pk2D<1> variants");
+  testVariants<Pk2DLocalFiniteElement<double,double,3> >("Pk2D<3> variants");
+  testVariants<Pk2DLocalFiniteElement<double,double,4> >("Pk2D<4> variants");
+  testVariants<RT02DLocalFiniteElement<double,double> >("RT02D variants");
+
+  return success ? 0 : 1;
+}
+catch (Exception e) {
+
+  std::cout << e << std::endl;
+  return 1;
+}
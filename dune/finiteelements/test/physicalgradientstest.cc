@@ -0,0 +1,141 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+#include <config.h>
+
+#include <cmath>
+#include <iostream>
+#include <vector>
+
+#include <dune/finiteelements/common/localbasiscache.hh>
+#include <dune/finiteelements/common/physicalgradients.hh>
+#include <dune/finiteelements/edger12d.hh>
+#include <dune/finiteelements/monom.hh>
+#include <dune/finiteelements/orthonormal.hh>
+#include <dune/finiteelements/p0.hh>
+#include <dune/finiteelements/p1.hh>
+#include <dune/finiteelements/p23d.hh>
+#include <dune/finiteelements/pk2d.hh>
+#include <dune/finiteelements/pk3d.hh>
+#include <dune/finiteelements/q1.hh>
+#include <dune/finiteelements/q22d.hh>
+#include <dune/finiteelements/qk.hh>
+#include <dune/finiteelements/refinedp1.hh>
+#include <dune/finiteelements/rt02d.hh>
+
+/** \file
+    \brief Checks the batched transformation of reference gradients to physical gradients
+ */
+
+bool success = true;
+double epsilon = 1e-12;
+
+using namespace Dune;
+
+/** \brief Compare the batched physical gradients to one matrix-vector product per gradient */
+template <class LB>
+void testPhysicalGradients (const LB& lb, const GeometryType& type, const char* name)
+{
+  typedef PhysicalGradients<LB> PG;
+  const int n = LB::Traits::dimDomain;
+  const int m = LB::Traits::dimRange;
+
+  LocalBasisCache<LB> cache(lb);
+  const typename PG::TableType& table = cache.table(type, 2);
+  const unsigned int points = table.numPoints();
+
+  // more elements than fit into full blocks, and arbitrary matrices
+  const unsigned int elements = 2*PG::blockSize+1;
+  std::vector<typename PG::JacobianInverseTransposedType> jit(elements*points, typename PG::JacobianInverseTransposedType(0.0));
+  for (size_t e=0; e<jit.size(); e++)
+    for (int i=0; i<n; i++)
+      for (int j=0; j<n; j++)
+        jit[e][i][j] = (i==j) + 0.1*(e%7) - 0.05*i*j + 0.3*(i<j);
+
+  std::vector<typename PG::GradientType> affine, multilinear;
+  PG::affine(table, std::vector<typename PG::JacobianInverseTransposedType>(jit.begin(), jit.begin()+elements), affine);
+  PG::multilinear(table, jit, multilinear);
+
+  if (affine.size() != elements*points*lb.size() || multilinear.size() != affine.size()) {
+    std::cerr << name << ": physical gradients have the wrong size" << std::endl;
+    success = false;
+    return;
+  }
+
+  for (unsigned int e=0; e<elements; e++)
+    for (unsigned int q=0; q<points; q++)
+      for (unsigned int i=0; i<lb.size(); i++)
+        for (int r=0; r<m; r++) {
+          FieldVector<double,LB::Traits::dimDomain> expectedAffine, expectedMultilinear;
+          jit[e].mv(table.jacobian(q,i)[r], expectedAffine);
+          jit[e*points+q].mv(table.jacobian(q,i)[r], expectedMultilinear);
+          const size_t k = (e*points+q)*lb.size()+i;
+          for (int c=0; c<n; c++) {
+            if (std::abs(affine[k][r][c] - expectedAffine[c]) > epsilon) {
+              std::cerr << name << ": affine physical gradient of shape function " << i
+                        << " on element " << e << " is wrong" << std::endl;
+              success = false;
+            }
+            if (std::abs(multilinear[k][r][c] - expectedMultilinear[c]) > epsilon) {
+              std::cerr << name << ": multilinear physical gradient of shape function " << i
+                        << " on element " << e << " is wrong" << std::endl;
+              success = false;
+            }
+          }
+        }
+}
+
+/** \brief Check the physical gradients of the basis of fe */
+template <class FE>
+void testPhysicalGradients (const FE& fe, const char* name)
+{
+  testPhysicalGradients(fe.localBasis(), fe.type(), name);
+}
+
+int main (int argc, char *argv[]) try
+{
+  testPhysicalGradients(P0LocalFiniteElement<double,double,2>(GeometryType::simplex), "P0");
+  testPhysicalGradients(P1LocalFiniteElement<double,double,1>(), "P11D");
+  testPhysicalGradients(P1LocalFiniteElement<double,double,2>(), "P12D");
+  testPhysicalGradients(P1LocalFiniteElement<double,double,3>(), "P13D");
+  testPhysicalGradients(P23DLocalFiniteElement<double,double>(), "P23D");
+  testPhysicalGradients(Pk2DLocalFiniteElement<double,double,0>(), "Pk2D<0>");
+  testPhysicalGradients(Pk2DLocalFiniteElement<double,double,3>(), "Pk2D<3>");
+  testPhysicalGradients(Pk3DLocalFiniteElement<double,double,0>(), "Pk3D<0>");
+  testPhysicalGradients(Pk3DLocalFiniteElement<double,double,1>(), "Pk3D<1>");
+  testPhysicalGradients(Pk3DLocalFiniteElement<double,double,2>(), "Pk3D<2>");
+  testPhysicalGradients(Pk3DLocalFiniteElement<double,double,4>(), "Pk3D<4>");
+  testPhysicalGradients(Q1LocalFiniteElement<double,double,2>(), "Q12D");
+  testPhysicalGradients(Q1LocalFiniteElement<double,double,3>(), "Q13D");
+  testPhysicalGradients(Q22DLocalFiniteElement<double,double>(), "Q22D");
+  testPhysicalGradients(QkLocalFiniteElement<double,double,1,3>(), "Qk<1,3>");
+  testPhysicalGradients(QkLocalFiniteElement<double,double,2,0>(), "Qk<2,0>");
+  testPhysicalGradients(QkLocalFiniteElement<double,double,2,2>(), "Qk<2,2>");
+  testPhysicalGradients(QkLocalFiniteElement<double,double,3,3>(), "Qk<3,3>");
+  testPhysicalGradients(QkLocalFiniteElement<double,double,4,2>(), "Qk<4,2>");
+  testPhysicalGradients(RT02DLocalFiniteElement<double,double>(5), "RT02D");
+  testPhysicalGradients(EdgeR12DLocalFiniteElement<double,double>(), "EdgeR12D");
+  testPhysicalGradients(RefinedP1LocalFiniteElement<double,double>(), "RefinedP1");
+  testPhysicalGradients(MonomLocalFiniteElement<double,double,1,5>(GeometryType::cube), "Monom<1,5>");
+  testPhysicalGradients(MonomLocalFiniteElement<double,double,2,0>(GeometryType::simplex), "Monom<2,0>");
+  testPhysicalGradients(MonomLocalFiniteElement<double,double,2,3>(GeometryType::simplex), "Monom<2,3>");
+  testPhysicalGradients(MonomLocalFiniteElement<double,double,3,4>(GeometryType::cube), "Monom<3,4>");
+  testPhysicalGradients(OrthonormalLocalFiniteElement<double,double,1,4,GeometryType::cube>(), "Orthonormal<1,4,cube>");
+  testPhysicalGradients(OrthonormalLocalFiniteElement<double,double,2,3,GeometryType::cube>(), "Orthonormal<2,3,cube>");
+  testPhysicalGradients(OrthonormalLocalFiniteElement<double,double,3,2,GeometryType::cube>(), "Orthonormal<3,2,cube>");
+  testPhysicalGradients(OrthonormalLocalFiniteElement<double,double,2,0,GeometryType::simplex>(), "Orthonormal<2,0,simplex>");
+  testPhysicalGradients(OrthonormalLocalFiniteElement<double,double,2,4,GeometryType::simplex>(), "Orthonormal<2,4,simplex>");
+  testPhysicalGradients(OrthonormalLocalFiniteElement<double,double,3,3,GeometryType::simplex>(), "Orthonormal<3,3,simplex>");
+
+  // orientation variants
+  for (int s=0; s<8; s++) {
+    testPhysicalGradients(Pk2DLocalFiniteElement<double,double,3>(s), "Pk2D<3> variant");
+    testPhysicalGradients(RT02DLocalFiniteElement<double,double>(s), "RT02D variant");
+  }
+
+  return success ? 0 : 1;
+}
+catch (Exception e) {
+
+  std::cout << e << std::endl;
+  return 1;
+}
@@ -0,0 +1,276 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+#include <config.h>
+
+#include <cmath>
+#include <iostream>
+#include <vector>
+
+#include <dune/finiteelements/common/localbasiscache.hh>
+#include <dune/finiteelements/common/piolatransformation.hh>
+#include <dune/finiteelements/edger12d.hh>
+#include <dune/finiteelements/rt02d.hh>
+
+/** \file
+    \brief Checks the batched Piola transformations against pointwise evaluation
+ */
+
+bool success = true;
+double epsilon = 1e-12;
+
+using namespace Dune;
+
+/** \brief A linear vector field, to be passed to the local interpolation */
+class LinearField
+{
+public:
+  typedef RT02DLocalBasis<double,double>::Traits Traits;
+
+  void evaluate (const Traits::DomainType& x, Traits::RangeType& y) const
+  {
+    y[0] = 0.3 + 1.1*x[0] - 0.7*x[1];
+    y[1] = -0.2 + 0.4*x[0] + 0.9*x[1];
+  }
+};
+
+/** \brief Compare the batched Piola transformation and interpolation of RT02D to the variants evaluated pointwise */
+void testContravariantPiola ()
+{
+  typedef RT02DLocalBasis<double,double> LB;
+  typedef ContravariantPiola<LB> Piola;
+  const char* name = "RT02D Piola";
+
+  const LB referenceBasis;
+  LocalBasisCache<LB> cache(referenceBasis);
+  const Piola::TableType& table = cache.table(GeometryType(GeometryType::simplex,2), 2);
+  const unsigned int points = table.numPoints();
+  const unsigned int n = table.size();
+
+  // more elements than fit into full blocks, with both orientations and all variants
+  const unsigned int elements = 2*Piola::blockSize+1;
+  std::vector<Piola::GeometryJacobianType> jacobians(elements*points);
+  std::vector<unsigned int> variants(elements);
+  for (size_t e=0; e<jacobians.size(); e++)
+    for (int i=0; i<2; i++)
+      for (int j=0; j<2; j++)
+        jacobians[e][i][j] = (i==j)*((e%3==1) ? -1 : 1) + 0.1*(e%7) - 0.05*i*j + 0.3*(i<j);
+  for (unsigned int e=0; e<elements; e++)
+    variants[e] = e%8;
+
+  std::vector<LB::Traits::RangeType> affine, multilinear;
+  std::vector<double> affineDivergence, multilinearDivergence;
+  Piola::affine(table, std::vector<Piola::GeometryJacobianType>(jacobians.begin(), jacobians.begin()+elements),
+                variants, affine, affineDivergence);
+  Piola::multilinear(table, jacobians, variants, multilinear, multilinearDivergence);
+
+  if (affine.size() != elements*points*n || multilinear.size() != affine.size()
+      || affineDivergence.size() != affine.size() || multilinearDivergence.size() != affine.size()) {
+    std::cerr << name << ": transformed values have the wrong size" << std::endl;
+    success = false;
+    return;
+  }
+
+  for (unsigned int e=0; e<elements; e++) {
+    const LB lb(variants[e]);
+    for (unsigned int q=0; q<points; q++) {
+      std::vector<LB::Traits::RangeType> values;
+      std::vector<LB::Traits::JacobianType> referenceJacobians;
+      lb.evaluateFunction(table.position(q), values);
+      lb.evaluateJacobian(table.position(q), referenceJacobians);
+      for (unsigned int i=0; i<n; i++) {
+        const size_t k = (e*points+q)*n+i;
+        const double divergence = referenceJacobians[i][0][0] + referenceJacobians[i][1][1];
+        for (int t=0; t<2; t++) {
+          const Piola::GeometryJacobianType& J = (t==0) ? jacobians[e] : jacobians[e*points+q];
+          const LB::Traits::RangeType& value = (t==0) ? affine[k] : multilinear[k];
+          const double computedDivergence = (t==0) ? affineDivergence[k] : multilinearDivergence[k];
+          LB::Traits::RangeType expected;
+          J.mv(values[i], expected);
+          expected /= J.determinant();
+          for (int c=0; c<2; c++)
+            if (std::abs(value[c] - expected[c]) > epsilon) {
+              std::cerr << name << ": " << ((t==0) ? "affine" : "multilinear") << " value of shape function " << i
+                        << " on element " << e << " is wrong" << std::endl;
+              success = false;
+            }
+          if (std::abs(computedDivergence - divergence/J.determinant()) > epsilon) {
+            std::cerr << name << ": " << ((t==0) ? "affine" : "multilinear") << " divergence of shape function " << i
+                      << " on element " << e << " is wrong" << std::endl;
+            success = false;
+          }
+        }
+      }
+    }
+  }
+
+  // the batched interpolation agrees with the one of each variant
+  const LinearField f;
+  const RT02DLocalInterpolation<LB> interpolation;
+  std::vector<LB::Traits::RangeType> values(3*elements);
+  for (unsigned int e=0; e<elements; e++)
+    for (int i=0; i<3; i++)
+      f.evaluate(interpolation.interpolationPoint(i), values[3*e+i]);
+  std::vector<double> coefficients, expected;
+  interpolation.interpolateBatched(values, variants, coefficients);
+  for (unsigned int e=0; e<elements; e++) {
+    RT02DLocalInterpolation<LB>(variants[e]).interpolate(f, expected);
+    for (int i=0; i<3; i++)
+      if (std::abs(coefficients[3*e+i] - expected[i]) > epsilon) {
+        std::cerr << name << ": batched interpolation differs in coefficient " << i
+                  << " of variant " << variants[e] << std::endl;
+        success = false;
+      }
+  }
+}
+
+/** \brief Jacobian of the bilinear map of the unit square to the quadrilateral with the given corners */
+FieldMatrix<double,2,2> quadrilateralJacobian (const FieldVector<double,2>* corners, const FieldVector<double,2>& x)
+{
+  FieldMatrix<double,2,2> J;
+  for (int i=0; i<2; i++) {
+    J[i][0] = (1-x[1])*(corners[1][i]-corners[0][i]) + x[1]*(corners[3][i]-corners[2][i]);
+    J[i][1] = (1-x[0])*(corners[2][i]-corners[0][i]) + x[0]*(corners[3][i]-corners[1][i]);
+  }
+  return J;
+}
+
+/** \brief Inverse transposed Jacobian of a quadrilateral */
+FieldMatrix<double,2,2> quadrilateralJacobianInverseTransposed (const FieldVector<double,2>* corners,
+                                                                const FieldVector<double,2>& x)
+{
+  FieldMatrix<double,2,2> J = quadrilateralJacobian(corners, x), jit;
+  J.invert();
+  for (int i=0; i<2; i++)
+    for (int j=0; j<2; j++)
+      jit[i][j] = J[j][i];
+  return jit;
+}
+
+/** \brief Compare the batched covariant Piola transformation of EdgeR12D to pointwise evaluation
+
+    The curls on non-affine quadrilaterals are checked against central
+    differences of the transformed shape functions, mapped by the chain
+    rule, so that the formula curl phi / det J is tested as well.
+ */
+void testCovariantPiola ()
+{
+  typedef EdgeR12DLocalBasis<double,double> LB;
+  typedef CovariantPiola<LB> Piola;
+  const char* name = "EdgeR12D Piola";
+
+  const LB referenceBasis;
+  LocalBasisCache<LB> cache(referenceBasis);
+  const Piola::TableType& table = cache.table(GeometryType(GeometryType::cube,2), 3);
+  const unsigned int points = table.numPoints();
+  const unsigned int n = table.size();
+
+  // more elements than fit into full blocks, parallelograms, general
+  // quadrilaterals and mirrored ones with negative determinant
+  const unsigned int elements = 2*Piola::blockSize+1;
+  std::vector<FieldVector<double,2> > corners(4*elements);
+  for (unsigned int e=0; e<elements; e++) {
+    const double s = (e%3==1) ? -1 : 1;
+    const double skew = (e%2==0) ? 0 : 0.1*(e%5);
+    corners[4*e+0][0] = 0.1*e;   corners[4*e+0][1] = 0;
+    corners[4*e+1][0] = s*1.2;   corners[4*e+1][1] = 0.2;
+    corners[4*e+2][0] = 0.3;     corners[4*e+2][1] = 0.9;
+    corners[4*e+3][0] = corners[4*e+1][0] + corners[4*e+2][0] - corners[4*e+0][0] + skew;
+    corners[4*e+3][1] = corners[4*e+1][1] + corners[4*e+2][1] - corners[4*e+0][1] - 0.5*skew;
+  }
+
+  FieldVector<double,2> center(0.5);
+  std::vector<Piola::JacobianInverseTransposedType> affineJit(elements), jit(elements*points);
+  for (unsigned int e=0; e<elements; e++) {
+    affineJit[e] = quadrilateralJacobianInverseTransposed(&corners[4*e], center);
+    for (unsigned int q=0; q<points; q++)
+      jit[e*points+q] = quadrilateralJacobianInverseTransposed(&corners[4*e], table.position(q));
+  }
+
+  std::vector<LB::Traits::RangeType> affine, multilinear;
+  std::vector<Piola::CurlType> affineCurl, multilinearCurl;
+  Piola::affine(table, affineJit, affine, affineCurl);
+  Piola::multilinear(table, jit, multilinear, multilinearCurl);
+
+  if (affine.size() != elements*points*n || multilinear.size() != affine.size()
+      || affineCurl.size() != affine.size() || multilinearCurl.size() != affine.size()) {
+    std::cerr << name << ": transformed values have the wrong size" << std::endl;
+    success = false;
+    return;
+  }
+
+  const double h = 1e-5;
+  for (unsigned int e=0; e<elements; e++)
+    for (unsigned int q=0; q<points; q++) {
+      const FieldVector<double,2>& x = table.position(q);
+      std::vector<LB::Traits::RangeType> values;
+      std::vector<LB::Traits::JacobianType> referenceJacobians;
+      referenceBasis.evaluateFunction(x, values);
+      referenceBasis.evaluateJacobian(x, referenceJacobians);
+
+      // reference gradients of the transformed shape functions by central differences
+      std::vector<FieldMatrix<double,2,2> > gradients(n);
+      for (int d=0; d<2; d++) {
+        FieldVector<double,2> xp(x), xm(x);
+        xp[d] += h;
+        xm[d] -= h;
+        std::vector<LB::Traits::RangeType> vp, vm;
+        referenceBasis.evaluateFunction(xp, vp);
+        referenceBasis.evaluateFunction(xm, vm);
+        const FieldMatrix<double,2,2> jp = quadrilateralJacobianInverseTransposed(&corners[4*e], xp);
+        const FieldMatrix<double,2,2> jm = quadrilateralJacobianInverseTransposed(&corners[4*e], xm);
+        for (unsigned int i=0; i<n; i++) {
+          LB::Traits::RangeType up, um;
+          jp.mv(vp[i], up);
+          jm.mv(vm[i], um);
+          for (int c=0; c<2; c++)
+            gradients[i][c][d] = (up[c] - um[c])/(2*h);
+        }
+      }
+
+      for (unsigned int i=0; i<n; i++) {
+        const size_t k = (e*points+q)*n+i;
+        const double referenceCurl = referenceJacobians[i][1][0] - referenceJacobians[i][0][1];
+        for (int t=0; t<2; t++) {
+          const Piola::JacobianInverseTransposedType& M = (t==0) ? affineJit[e] : jit[e*points+q];
+          const LB::Traits::RangeType& value = (t==0) ? affine[k] : multilinear[k];
+          const double curl = (t==0) ? affineCurl[k][0] : multilinearCurl[k][0];
+          LB::Traits::RangeType expected;
+          M.mv(values[i], expected);
+          for (int c=0; c<2; c++)
+            if (std::abs(value[c] - expected[c]) > epsilon) {
+              std::cerr << name << ": " << ((t==0) ? "affine" : "multilinear") << " value of shape function " << i
+                        << " on element " << e << " is wrong" << std::endl;
+              success = false;
+            }
+          if (std::abs(curl - referenceCurl*M.determinant()) > epsilon) {
+            std::cerr << name << ": " << ((t==0) ? "affine" : "multilinear") << " curl of shape function " << i
+                      << " on element " << e << " is wrong" << std::endl;
+            success = false;
+          }
+        }
+
+        // physical gradients by the chain rule
+        FieldVector<double,2> g0, g1;
+        jit[e*points+q].mv(gradients[i][0], g0);
+        jit[e*points+q].mv(gradients[i][1], g1);
+        if (std::abs(multilinearCurl[k][0] - (g1[0] - g0[1])) > 1e-6) {
+          std::cerr << name << ": multilinear curl of shape function " << i
+                    << " on element " << e << " differs from the curl of the transformed function" << std::endl;
+          success = false;
+        }
+      }
+    }
+}
+
+int main (int argc, char *argv[]) try
+{
+  testContravariantPiola();
+  testCovariantPiola();
+
+  return success ? 0 : 1;
+}
+catch (Exception e) {
+
+  std::cout << e << std::endl;
+  return 1;
+}
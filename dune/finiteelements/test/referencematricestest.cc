@@ -0,0 +1,166 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+#include <config.h>
+
+#include <cmath>
+#include <iostream>
+#include <vector>
+
+#include <dune/finiteelements/common/referencematrices.hh>
+#include <dune/finiteelements/edger12d.hh>
+#include <dune/finiteelements/p0.hh>
+#include <dune/finiteelements/p1.hh>
+#include <dune/finiteelements/p23d.hh>
+#include <dune/finiteelements/pk2d.hh>
+#include <dune/finiteelements/q1.hh>
+#include <dune/finiteelements/refinedp1.hh>
+#include <dune/finiteelements/rt02d.hh>
+
+/** \file
+    \brief Checks the reference element matrices against quadrature
+ */
+
+bool success = true;
+
+using namespace Dune;
+
+/** \brief Check the reference element matrices
+
+    The tensors must not change on a finer composite quadrature, and for
+    bases that are polynomial on the whole element (refinement 0) the
+    assembled matrices of an affine element must agree with quadrature.
+ */
+template <class FE>
+void testReferenceMatrices (const FE& fe, const char* name, int refinement = 0)
+{
+  typedef typename FE::Traits::LocalBasisType LB;
+  typedef typename LB::Traits Traits;
+  const int dim = Traits::dimDomain;
+  const int m = Traits::dimRange;
+  const LB& lb = fe.localBasis();
+  const unsigned int n = lb.size();
+
+  LocalReferenceMatrices<LB> matrices(lb, fe.type(), refinement);
+  if (!fe.type().isSimplex() || dim < 3) {
+    LocalReferenceMatrices<LB> finer(lb, fe.type(), refinement+1);
+    for (unsigned int i=0; i<n; i++)
+      for (unsigned int j=0; j<n; j++) {
+        bool equal = std::abs(matrices.mass(i,j) - finer.mass(i,j)) < 1e-12;
+        for (int a=0; a<dim; a++) {
+          equal = equal && std::abs(matrices.convection(i,j,a) - finer.convection(i,j,a)) < 1e-12;
+          for (int b=0; b<dim; b++)
+            equal = equal && std::abs(matrices.stiffness(i,j,a,b) - finer.stiffness(i,j,a,b)) < 1e-12;
+        }
+        if (!equal) {
+          std::cerr << name << ": reference matrices for entry (" << i << "," << j
+                    << ") change under refinement" << std::endl;
+          success = false;
+        }
+      }
+  }
+
+  if (refinement > 0)
+    return;
+
+  // the affine map x -> B x
+  FieldMatrix<double,dim,dim> B, jit;
+  for (int a=0; a<dim; a++)
+    for (int b=0; b<dim; b++)
+      B[a][b] = (a==b ? 1.5 : 0.0) + 0.25*(a<b) - 0.2*(a>b);
+  FieldMatrix<double,dim,dim> inverse = B;
+  inverse.invert();
+  for (int a=0; a<dim; a++)
+    for (int b=0; b<dim; b++)
+      jit[a][b] = inverse[b][a];
+  const double det = B.determinant();
+  FieldVector<double,dim> beta;
+  for (int a=0; a<dim; a++)
+    beta[a] = 1 - 0.5*a;
+
+  std::vector<std::vector<double> > mass(n, std::vector<double>(n)), stiffness = mass, convection = mass,
+  covariant = mass, contravariant = mass;
+  matrices.assembleMass(std::abs(det), mass);
+  matrices.assembleStiffness(jit, std::abs(det), stiffness);
+  matrices.assembleConvection(jit, std::abs(det), beta, convection);
+
+  std::vector<std::vector<double> > expectedMass(n, std::vector<double>(n, 0.0)), expectedStiffness = expectedMass,
+  expectedConvection = expectedMass, expectedCovariant = expectedMass, expectedContravariant = expectedMass;
+  const QuadratureRule<double,dim>& quad = QuadratureRules<double,dim>::rule(fe.type(), 2*lb.order());
+  std::vector<typename Traits::RangeType> values;
+  std::vector<typename Traits::JacobianType> jacobians;
+  for (size_t q=0; q<quad.size(); q++) {
+    lb.evaluateFunctionAndJacobian(quad[q].position(), values, jacobians);
+    const double weight = quad[q].weight()*std::abs(det);
+    for (unsigned int i=0; i<n; i++)
+      for (unsigned int j=0; j<n; j++)
+        for (int r=0; r<m; r++) {
+          FieldVector<double,dim> gi, gj;
+          jit.mv(jacobians[i][r], gi);
+          jit.mv(jacobians[j][r], gj);
+          expectedMass[i][j] += weight*values[i][r]*values[j][r];
+          expectedStiffness[i][j] += weight*(gi*gj);
+          expectedConvection[i][j] += weight*values[i][r]*(beta*gj);
+        }
+  }
+
+  // vector-valued bases are also tested with their Piola transformations
+  if (m == dim) {
+    matrices.assembleCovariantMass(jit, std::abs(det), covariant);
+    matrices.assembleContravariantMass(B, std::abs(det), contravariant);
+    for (size_t q=0; q<quad.size(); q++) {
+      lb.evaluateFunction(quad[q].position(), values);
+      const double weight = quad[q].weight()*std::abs(det);
+      for (unsigned int i=0; i<n; i++)
+        for (unsigned int j=0; j<n; j++) {
+          FieldVector<double,dim> vi, vj, wi, wj;
+          for (int a=0; a<dim; a++) {
+            vi[a] = values[i][a];
+            vj[a] = values[j][a];
+          }
+          jit.mv(vi, wi);
+          jit.mv(vj, wj);
+          expectedCovariant[i][j] += weight*(wi*wj);
+          B.mv(vi, wi);
+          B.mv(vj, wj);
+          expectedContravariant[i][j] += weight*(wi*wj)/(det*det);
+        }
+    }
+  }
+
+  for (unsigned int i=0; i<n; i++)
+    for (unsigned int j=0; j<n; j++) {
+      bool equal = std::abs(mass[i][j] - expectedMass[i][j]) < 1e-12
+                   && std::abs(stiffness[i][j] - expectedStiffness[i][j]) < 1e-12
+                   && std::abs(convection[i][j] - expectedConvection[i][j]) < 1e-12;
+      if (m == dim)
+        equal = equal && std::abs(covariant[i][j] - expectedCovariant[i][j]) < 1e-12
+                && std::abs(contravariant[i][j] - expectedContravariant[i][j]) < 1e-12;
+      if (!equal) {
+        std::cerr << name << ": assembled element matrices differ from quadrature in entry ("
+                  << i << "," << j << ")" << std::endl;
+        success = false;
+      }
+    }
+}
+
+int main (int argc, char *argv[]) try
+{
+  testReferenceMatrices(P0LocalFiniteElement<double,double,2>(GeometryType::simplex), "P0");
+  testReferenceMatrices(P1LocalFiniteElement<double,double,1>(), "P11D");
+  testReferenceMatrices(P1LocalFiniteElement<double,double,2>(), "P12D");
+  testReferenceMatrices(P1LocalFiniteElement<double,double,3>(), "P13D");
+  testReferenceMatrices(Pk2DLocalFiniteElement<double,double,2>(), "Pk2D<2>");
+  testReferenceMatrices(Pk2DLocalFiniteElement<double,double,3>(), "Pk2D<3>");
+  testReferenceMatrices(P23DLocalFiniteElement<double,double>(), "P23D");
+  testReferenceMatrices(Q1LocalFiniteElement<double,double,2>(), "Q12D");
+  testReferenceMatrices(RT02DLocalFiniteElement<double,double>(3), "RT02D");
+  testReferenceMatrices(EdgeR12DLocalFiniteElement<double,double>(), "EdgeR12D");
+  testReferenceMatrices(RefinedP1LocalFiniteElement<double,double>(), "RefinedP1", 1);
+
+  return success ? 0 : 1;
+}
+catch (Exception e) {
+
+  std::cout << e << std::endl;
+  return 1;
+}
@@ -0,0 +1,161 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+#include <config.h>
+
+#include <cmath>
+#include <iostream>
+#include <vector>
+
+#include <dune/grid/common/quadraturerules.hh>
+
+#include <dune/finiteelements/common/simd.hh>
+
+#include <dune/finiteelements/p0.hh>
+#include <dune/finiteelements/p1.hh>
+#include <dune/finiteelements/p23d.hh>
+#include <dune/finiteelements/pk2d.hh>
+#include <dune/finiteelements/pk3d.hh>
+#include <dune/finiteelements/q1.hh>
+#include <dune/finiteelements/q22d.hh>
+#include <dune/finiteelements/qk.hh>
+#include <dune/finiteelements/rt02d.hh>
+#include <dune/finiteelements/edger12d.hh>
+#include <dune/finiteelements/refinedp1.hh>
+#include <dune/finiteelements/monom.hh>
+#include <dune/finiteelements/orthonormal.hh>
+
+/** \file
+    \brief Checks that all local finite elements work with Simd as field type
+
+    Every lane of a vectorized evaluation, Jacobian and interpolation has to
+    agree with the corresponding scalar computation.
+ */
+
+using namespace Dune;
+
+typedef Simd<double,4> V;
+
+bool success = true;
+
+/** \brief A polynomial to interpolate, scaled by a factor that may differ between the lanes */
+template <class T>
+class Func
+{
+public:
+  typedef T Traits;
+
+  Func (const typename Traits::RangeFieldType& a_) : a(a_)
+  {}
+
+  void evaluate (const typename Traits::DomainType& x, typename Traits::RangeType& y) const
+  {
+    for (int c=0; c<Traits::dimRange; c++)
+      y[c] = a*((c+1) + x[0]*x[Traits::dimDomain-1] - 0.5*x[Traits::dimDomain-1]);
+  }
+
+private:
+  typename Traits::RangeFieldType a;
+};
+
+/** \brief Compare lane l of a vectorized result to the scalar result */
+void compare (double vectorized, double scalar, const char* name, const char* what, int l)
+{
+  if (std::abs(vectorized - scalar) > 1e-12*(1+std::abs(scalar))) {
+    std::cerr << name << ": " << what << " in lane " << l << " is " << vectorized
+              << ", but the scalar computation gives " << scalar << std::endl;
+    success = false;
+  }
+}
+
+/** \brief Compare the vectorized finite element fes to its scalar counterpart fe */
+template <class FES, class FE>
+void testSimd (const FES& fes, const FE& fe, const char* name)
+{
+  typedef typename FES::Traits::LocalBasisType::Traits VT;
+  typedef typename FE::Traits::LocalBasisType::Traits ST;
+  typedef SimdTraits<typename VT::RangeFieldType> Lanes;
+  const int dim = ST::dimDomain;
+  const int lanes = Lanes::lanes;
+
+  const QuadratureRule<double,dim>& quad = QuadratureRules<double,dim>::rule(fe.type(),4);
+
+  // lane l evaluates at quadrature point q+l
+  for (size_t q=0; q<quad.size(); q++) {
+    typename VT::DomainType x;
+    for (int l=0; l<lanes; l++)
+      for (int i=0; i<dim; i++)
+        SimdTraits<typename VT::DomainFieldType>::setLane(x[i],l,quad[(q+l)%quad.size()].position()[i]);
+
+    std::vector<typename VT::RangeType> values, values2;
+    std::vector<typename VT::JacobianType> jacobians, jacobians2;
+    fes.localBasis().evaluateFunction(x,values);
+    fes.localBasis().evaluateJacobian(x,jacobians);
+    fes.localBasis().evaluateFunctionAndJacobian(x,values2,jacobians2);
+
+    for (int l=0; l<lanes; l++) {
+      std::vector<typename ST::RangeType> scalarValues;
+      std::vector<typename ST::JacobianType> scalarJacobians;
+      fe.localBasis().evaluateFunction(quad[(q+l)%quad.size()].position(),scalarValues);
+      fe.localBasis().evaluateJacobian(quad[(q+l)%quad.size()].position(),scalarJacobians);
+
+      for (size_t i=0; i<scalarValues.size(); i++)
+        for (int c=0; c<ST::dimRange; c++) {
+          compare(Lanes::lane(values[i][c],l),scalarValues[i][c],name,"value",l);
+          compare(Lanes::lane(values2[i][c],l),scalarValues[i][c],name,"fused value",l);
+          for (int j=0; j<dim; j++) {
+            compare(Lanes::lane(jacobians[i][c][j],l),scalarJacobians[i][c][j],name,"derivative",l);
+            compare(Lanes::lane(jacobians2[i][c][j],l),scalarJacobians[i][c][j],name,"fused derivative",l);
+          }
+        }
+    }
+  }
+
+  // lane l interpolates l+1 times the function
+  typename VT::RangeFieldType a;
+  for (int l=0; l<lanes; l++)
+    Lanes::setLane(a,l,l+1);
+
+  std::vector<typename VT::RangeFieldType> coefficients;
+  fes.localInterpolation().interpolate(Func<VT>(a),coefficients);
+
+  for (int l=0; l<lanes; l++) {
+    std::vector<typename ST::RangeFieldType> scalarCoefficients;
+    fe.localInterpolation().interpolate(Func<ST>(l+1),scalarCoefficients);
+    for (size_t i=0; i<scalarCoefficients.size(); i++)
+      compare(Lanes::lane(coefficients[i],l),scalarCoefficients[i],name,"coefficient",l);
+  }
+}
+
+int main (int argc, char** argv)
+{
+  testSimd(P0LocalFiniteElement<V,V,2>(GeometryType::simplex),
+           P0LocalFiniteElement<double,double,2>(GeometryType::simplex),"P0");
+  testSimd(P1LocalFiniteElement<V,V,1>(),P1LocalFiniteElement<double,double,1>(),"P11D");
+  testSimd(P1LocalFiniteElement<V,V,2>(),P1LocalFiniteElement<double,double,2>(),"P12D");
+  testSimd(P1LocalFiniteElement<V,V,3>(),P1LocalFiniteElement<double,double,3>(),"P13D");
+  testSimd(P23DLocalFiniteElement<V,V>(),P23DLocalFiniteElement<double,double>(),"P23D");
+  testSimd(Pk2DLocalFiniteElement<V,V,1>(),Pk2DLocalFiniteElement<double,double,1>(),"Pk2D1");
+  testSimd(Pk2DLocalFiniteElement<V,V,3>(),Pk2DLocalFiniteElement<double,double,3>(),"Pk2D3");
+  testSimd(Pk2DLocalFiniteElement<V,V,6>(),Pk2DLocalFiniteElement<double,double,6>(),"Pk2D6");
+  testSimd(Pk3DLocalFiniteElement<V,V,1>(),Pk3DLocalFiniteElement<double,double,1>(),"Pk3D1");
+  testSimd(Pk3DLocalFiniteElement<V,V,3>(),Pk3DLocalFiniteElement<double,double,3>(),"Pk3D3");
+  testSimd(Q1LocalFiniteElement<V,V,2>(),Q1LocalFiniteElement<double,double,2>(),"Q12D");
+  testSimd(Q1LocalFiniteElement<V,V,3>(),Q1LocalFiniteElement<double,double,3>(),"Q13D");
+  testSimd(Q22DLocalFiniteElement<V,V>(),Q22DLocalFiniteElement<double,double>(),"Q22D");
+  testSimd(QkLocalFiniteElement<V,V,2,3>(),QkLocalFiniteElement<double,double,2,3>(),"Qk2D3");
+  testSimd(QkLocalFiniteElement<V,V,3,2>(),QkLocalFiniteElement<double,double,3,2>(),"Qk3D2");
+  testSimd(RT02DLocalFiniteElement<V,V>(),RT02DLocalFiniteElement<double,double>(),"RT02D");
+  testSimd(RT02DLocalFiniteElement<V,V>(5),RT02DLocalFiniteElement<double,double>(5),"RT02D(5)");
+  testSimd(EdgeR12DLocalFiniteElement<V,V>(),EdgeR12DLocalFiniteElement<double,double>(),"EdgeR12D");
+  testSimd(RefinedP1LocalFiniteElement<V,V>(),RefinedP1LocalFiniteElement<double,double>(),"RefinedP1");
+  testSimd(MonomLocalFiniteElement<V,V,2,3>(GeometryType::simplex),
+           MonomLocalFiniteElement<double,double,2,3>(GeometryType::simplex),"Monom<2,3>");
+  testSimd(MonomLocalFiniteElement<V,V,3,2>(GeometryType::cube),
+           MonomLocalFiniteElement<double,double,3,2>(GeometryType::cube),"Monom<3,2>");
+  testSimd(OrthonormalLocalFiniteElement<V,V,2,3,GeometryType::simplex>(),
+           OrthonormalLocalFiniteElement<double,double,2,3,GeometryType::simplex>(),"Orthonormal<2,3,simplex>");
+  testSimd(OrthonormalLocalFiniteElement<V,V,3,2,GeometryType::cube>(),
+           OrthonormalLocalFiniteElement<double,double,3,2,GeometryType::cube>(),"Orthonormal<3,2,cube>");
+
+  return success ? 0 : 1;
+}
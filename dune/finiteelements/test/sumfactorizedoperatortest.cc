@@ -0,0 +1,118 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+#include <config.h>
+
+#include <cmath>
+#include <iostream>
+#include <vector>
+
+#include <dune/finiteelements/common/sumfactorizedoperator.hh>
+#include <dune/finiteelements/q1.hh>
+#include <dune/finiteelements/q22d.hh>
+#include <dune/finiteelements/qk.hh>
+
+/** \file
+    \brief Checks the matrix-free sum-factorized operators against assembled matrices
+ */
+
+bool success = true;
+
+using namespace Dune;
+
+/** \brief Check the matrix-free operators against matrices assembled from the local basis
+
+    The geometry factors vary from point to point, as on a multilinear
+    element, and the operators are applied to a batch of elements.
+ */
+template <class FE>
+void testSumFactorizedOperator (const FE& fe, const char* name)
+{
+  typedef typename FE::Traits::LocalBasisType LB;
+  typedef typename LB::Traits Traits;
+  typedef SumFactorizedOperator<LB> Operator;
+  const int dim = Traits::dimDomain;
+  const int packedSize = Operator::packedSize;
+  const LB& lb = fe.localBasis();
+  const unsigned int n = lb.size();
+  const unsigned int elements = 3;
+
+  Operator op;
+  const unsigned int points = op.numPoints();
+  if (op.size() != n) {
+    std::cerr << name << ": sum-factorized operator has " << op.size()
+              << " shape functions instead of " << n << std::endl;
+    success = false;
+    return;
+  }
+
+  std::vector<double> x(elements*n), massFactors(elements*points), laplaceFactors(elements*points*packedSize);
+  std::vector<typename Operator::JacobianInverseTransposedType> jit(elements*points, typename Operator::JacobianInverseTransposedType(0.0));
+  std::vector<double> integrationElement(elements*points);
+  for (unsigned int i=0; i<x.size(); i++)
+    x[i] = std::sin(1.0+i);
+  for (unsigned int k=0; k<jit.size(); k++) {
+    integrationElement[k] = 1.0 + 0.3*std::cos(0.7*k);
+    for (int a=0; a<dim; a++)
+      for (int b=0; b<dim; b++)
+        jit[k][a][b] = (a==b ? 1.2 : 0.0) + 0.2*std::sin(1.0+k+a+2*b);
+  }
+  for (unsigned int e=0; e<elements; e++) {
+    op.massFactors(&integrationElement[e*points], &massFactors[e*points]);
+    op.laplaceFactors(&jit[e*points], &integrationElement[e*points], &laplaceFactors[e*points*packedSize]);
+  }
+
+  std::vector<double> mass, laplace, single(n);
+  op.applyMass(x, massFactors, mass);
+  op.applyLaplace(x, laplaceFactors, laplace);
+
+  std::vector<typename Traits::RangeType> values;
+  std::vector<typename Traits::JacobianType> jacobians;
+  for (unsigned int e=0; e<elements; e++) {
+    std::vector<double> expectedMass(n, 0.0), expectedLaplace(n, 0.0);
+    for (unsigned int q=0; q<points; q++) {
+      const unsigned int k = e*points+q;
+      lb.evaluateFunctionAndJacobian(op.position(q), values, jacobians);
+      const double weight = op.weight(q)*integrationElement[k];
+      for (unsigned int i=0; i<n; i++)
+        for (unsigned int j=0; j<n; j++) {
+          FieldVector<double,dim> gi, gj;
+          jit[k].mv(jacobians[i][0], gi);
+          jit[k].mv(jacobians[j][0], gj);
+          expectedMass[i] += weight*values[i][0]*values[j][0]*x[e*n+j];
+          expectedLaplace[i] += weight*(gi*gj)*x[e*n+j];
+        }
+    }
+
+    for (unsigned int i=0; i<n; i++)
+      if (std::abs(mass[e*n+i] - expectedMass[i]) > 1e-12
+          || std::abs(laplace[e*n+i] - expectedLaplace[i]) > 1e-12) {
+        std::cerr << name << ": sum-factorized operators differ from the assembled ones on element "
+                  << e << " in entry " << i << std::endl;
+        success = false;
+      }
+
+    op.applyLaplace(&x[e*n], &laplaceFactors[e*points*packedSize], &single[0]);
+    for (unsigned int i=0; i<n; i++)
+      if (single[i] != laplace[e*n+i]) {
+        std::cerr << name << ": sum-factorized Laplace operator differs between single and batched application"
+                  << std::endl;
+        success = false;
+      }
+  }
+}
+
+int main (int argc, char *argv[]) try
+{
+  testSumFactorizedOperator(Q1LocalFiniteElement<double,double,2>(), "Q12D");
+  testSumFactorizedOperator(Q1LocalFiniteElement<double,double,3>(), "Q13D");
+  testSumFactorizedOperator(Q22DLocalFiniteElement<double,double>(), "Q22D");
+  testSumFactorizedOperator(QkLocalFiniteElement<double,double,3,2>(), "Qk<3,2>");
+  testSumFactorizedOperator(QkLocalFiniteElement<double,double,2,4>(), "Qk<2,4>");
+
+  return success ? 0 : 1;
+}
+catch (Exception e) {
+
+  std::cout << e << std::endl;
+  return 1;
+}
@@ -12,7 +12,9 @@
 #include "../p12d.hh"
 #include "../p13d.hh"
 #include "../pk2d.hh"
+#include "../pk3d.hh"
 #include "../q1.hh"
+#include "../qk.hh"
 #include "../q12d.hh"
 #include "../q13d.hh"
 #include "../q22d.hh"
@@ -38,10 +40,12 @@ int main(int argc, char** argv)
   Dune::P12DLocalFiniteElement<double,double> p12dlfem;
   Dune::P13DLocalFiniteElement<double,double> p13dlfem;
   Dune::Pk2DLocalFiniteElement<double,double,5> pk2dlfem(3);
+  Dune::Pk3DLocalFiniteElement<double,double,4> pk3dlfem(5);
   Dune::Q1LocalFiniteElement<double,double,3> q1lfem;
   Dune::Q12DLocalFiniteElement<double,double> q12dlfem;
   Dune::Q12DLocalFiniteElement<double,double> q13dlfem;
   Dune::Q22DLocalFiniteElement<double,double> q22dlfem;
+  Dune::QkLocalFiniteElement<double,double,3,4> qklfem;
   Dune::RT02DLocalFiniteElement<double,double> rt02dlfem;
 
   std::vector<double> c;
@@ -52,10 +56,12 @@ int main(int argc, char** argv)
   p12dlfem.localInterpolation().interpolate(Func(),c);
   p13dlfem.localInterpolation().interpolate(Func(),c);
   pk2dlfem.localInterpolation().interpolate(Func(),c);
+  pk3dlfem.localInterpolation().interpolate(Func(),c);
   q1lfem.localInterpolation().interpolate(Func(),c);
   q12dlfem.localInterpolation().interpolate(Func(),c);
   q13dlfem.localInterpolation().interpolate(Func(),c);
   q22dlfem.localInterpolation().interpolate(Func(),c);
+  qklfem.localInterpolation().interpolate(Func(),c);
 
   return 0;
 }
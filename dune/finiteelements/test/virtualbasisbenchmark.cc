@@ -0,0 +1,285 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+#include <config.h>
+
+// this program compares static and dynamic dispatch, so it always
+// needs the virtual interface
+#ifndef DUNE_VIRTUAL_SHAPEFUNCTIONS
+#define DUNE_VIRTUAL_SHAPEFUNCTIONS 1
+#endif
+
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <dune/common/timer.hh>
+#include <dune/grid/common/quadraturerules.hh>
+
+#include <dune/finiteelements/p0.hh>
+#include <dune/finiteelements/pk2d.hh>
+#include <dune/finiteelements/pk3d.hh>
+#include <dune/finiteelements/q12d.hh>
+#include <dune/finiteelements/q13d.hh>
+#include <dune/finiteelements/q22d.hh>
+#include <dune/finiteelements/qk.hh>
+#include <dune/finiteelements/rt02d.hh>
+#include <dune/finiteelements/edger12d.hh>
+#include <dune/finiteelements/refinedp1.hh>
+
+/** \file
+    \brief Measures the cost of virtual shape functions
+
+    For several local bases the values and Jacobians at the points of the
+    quadrature rule of order 4 are computed in three ways:
+
+    - static: one call per point, bound at compile time, as with the
+      Barton-Nackman interface
+    - virtual: one virtual call per point through C1LocalBasisInterface
+    - virtualBatched: one virtual call of evaluateFunctionBatched() or
+      evaluateJacobianBatched() for all points
+
+    The results are printed in the format of localbasisbenchmark,
+
+    \code
+    element,operation,points,repetitions,ns
+    \endcode
+
+    where ns is the CPU time in nanoseconds per point.
+
+    Usage: virtualbasisbenchmark [repetitions [warmup]]
+ */
+
+using namespace Dune;
+
+/** \brief Number of measured and unmeasured runs of each operation */
+struct Options
+{
+  int repetitions;
+  int warmup;
+};
+
+/** \brief The quadrature order that determines the evaluation points */
+const int quadratureOrder = 4;
+
+/** \brief Results are accumulated here, so that the compiler cannot drop the benchmarked calls */
+volatile double sink = 0;
+
+/** \brief Print one line of the results */
+void report (const std::string& name, const char* operation,
+             int points, const Options& options, double seconds)
+{
+  std::cout << name << "," << operation << "," << points << ","
+            << options.repetitions << ","
+            << 1e9*seconds/(double(options.repetitions)*points) << std::endl;
+}
+
+/** \brief Values at all points, one call per point bound at compile time */
+template <class LB>
+double timeStaticFunction (const LB& lb,
+                           const std::vector<typename LB::Traits::DomainType>& points,
+                           int repetitions)
+{
+  std::vector<typename LB::Traits::RangeType> values;
+  double sum = 0;
+
+  Timer timer;
+  for (int r=0; r<repetitions; r++)
+    for (size_t p=0; p<points.size(); p++)
+    {
+      lb.LB::evaluateFunction(points[p],values);
+      sum += values[0][0];
+    }
+  const double seconds = timer.elapsed();
+
+  sink = sink + sum;
+  return seconds;
+}
+
+/** \brief Values at all points, one virtual call per point */
+template <class Interface>
+double timeVirtualFunction (const Interface* lb,
+                            const std::vector<typename Interface::Traits::DomainType>& points,
+                            int repetitions)
+{
+  std::vector<typename Interface::Traits::RangeType> values;
+  double sum = 0;
+
+  Timer timer;
+  for (int r=0; r<repetitions; r++)
+    for (size_t p=0; p<points.size(); p++)
+    {
+      lb->evaluateFunction(points[p],values);
+      sum += values[0][0];
+    }
+  const double seconds = timer.elapsed();
+
+  sink = sink + sum;
+  return seconds;
+}
+
+/** \brief Values at all points, one virtual call for all points */
+template <class Interface>
+double timeVirtualBatchedFunction (const Interface* lb,
+                                   const std::vector<typename Interface::Traits::DomainType>& points,
+                                   int repetitions)
+{
+  std::vector<typename Interface::Traits::RangeType> values;
+  double sum = 0;
+
+  Timer timer;
+  for (int r=0; r<repetitions; r++)
+  {
+    lb->evaluateFunctionBatched(points,values);
+    sum += values[0][0];
+  }
+  const double seconds = timer.elapsed();
+
+  sink = sink + sum;
+  return seconds;
+}
+
+/** \brief Jacobians at all points, one call per point bound at compile time */
+template <class LB>
+double timeStaticJacobian (const LB& lb,
+                           const std::vector<typename LB::Traits::DomainType>& points,
+                           int repetitions)
+{
+  std::vector<typename LB::Traits::JacobianType> jacobians;
+  double sum = 0;
+
+  Timer timer;
+  for (int r=0; r<repetitions; r++)
+    for (size_t p=0; p<points.size(); p++)
+    {
+      lb.LB::evaluateJacobian(points[p],jacobians);
+      sum += jacobians[0][0][0];
+    }
+  const double seconds = timer.elapsed();
+
+  sink = sink + sum;
+  return seconds;
+}
+
+/** \brief Jacobians at all points, one virtual call per point */
+template <class Interface>
+double timeVirtualJacobian (const Interface* lb,
+                            const std::vector<typename Interface::Traits::DomainType>& points,
+                            int repetitions)
+{
+  std::vector<typename Interface::Traits::JacobianType> jacobians;
+  double sum = 0;
+
+  Timer timer;
+  for (int r=0; r<repetitions; r++)
+    for (size_t p=0; p<points.size(); p++)
+    {
+      lb->evaluateJacobian(points[p],jacobians);
+      sum += jacobians[0][0][0];
+    }
+  const double seconds = timer.elapsed();
+
+  sink = sink + sum;
+  return seconds;
+}
+
+/** \brief Jacobians at all points, one virtual call for all points */
+template <class Interface>
+double timeVirtualBatchedJacobian (const Interface* lb,
+                                   const std::vector<typename Interface::Traits::DomainType>& points,
+                                   int repetitions)
+{
+  std::vector<typename Interface::Traits::JacobianType> jacobians;
+  double sum = 0;
+
+  Timer timer;
+  for (int r=0; r<repetitions; r++)
+  {
+    lb->evaluateJacobianBatched(points,jacobians);
+    sum += jacobians[0][0][0];
+  }
+  const double seconds = timer.elapsed();
+
+  sink = sink + sum;
+  return seconds;
+}
+
+/** \brief Compare static, virtual and batched virtual evaluation of a local basis */
+template <class FE>
+void benchmark (const FE& fe, const std::string& name, const Options& options)
+{
+  typedef typename FE::Traits::LocalBasisType LB;
+  typedef typename LB::Traits::DomainFieldType DF;
+  typedef C1LocalBasisInterface<typename LB::Traits> Interface;
+  const int dim = LB::Traits::dimDomain;
+
+  const QuadratureRule<DF,dim>& quad = QuadratureRules<DF,dim>::rule(fe.type(),quadratureOrder);
+  std::vector<typename LB::Traits::DomainType> points(quad.size());
+  for (size_t q=0; q<quad.size(); q++)
+    points[q] = quad[q].position();
+  const int n = points.size();
+
+  const LB& lb = fe.localBasis();
+
+  // hide the dynamic type from the compiler, as in code that selects
+  // the element at run time
+  const Interface* volatile handle = &lb;
+  const Interface* base = handle;
+
+  timeStaticFunction(lb,points,options.warmup);
+  report(name,"evaluateFunction/static",n,options,
+         timeStaticFunction(lb,points,options.repetitions));
+
+  timeVirtualFunction(base,points,options.warmup);
+  report(name,"evaluateFunction/virtual",n,options,
+         timeVirtualFunction(base,points,options.repetitions));
+
+  timeVirtualBatchedFunction(base,points,options.warmup);
+  report(name,"evaluateFunction/virtualBatched",n,options,
+         timeVirtualBatchedFunction(base,points,options.repetitions));
+
+  timeStaticJacobian(lb,points,options.warmup);
+  report(name,"evaluateJacobian/static",n,options,
+         timeStaticJacobian(lb,points,options.repetitions));
+
+  timeVirtualJacobian(base,points,options.warmup);
+  report(name,"evaluateJacobian/virtual",n,options,
+         timeVirtualJacobian(base,points,options.repetitions));
+
+  timeVirtualBatchedJacobian(base,points,options.warmup);
+  report(name,"evaluateJacobian/virtualBatched",n,options,
+         timeVirtualBatchedJacobian(base,points,options.repetitions));
+}
+
+int main (int argc, char** argv)
+{
+  Options options;
+  options.repetitions = (argc > 1) ? std::atoi(argv[1]) : 100000;
+  options.warmup = (argc > 2) ? std::atoi(argv[2]) : 1000;
+
+  if (options.repetitions < 1 || options.warmup < 0)
+  {
+    std::cerr << "Usage: " << argv[0] << " [repetitions [warmup]]" << std::endl;
+    return 1;
+  }
+
+  std::cout << "element,operation,points,repetitions,ns" << std::endl;
+
+  benchmark(P0LocalFiniteElement<double,double,2>(GeometryType::simplex),"P0",options);
+  benchmark(Pk2DLocalFiniteElement<double,double,1>(),"Pk2D1",options);
+  benchmark(Pk2DLocalFiniteElement<double,double,2>(),"Pk2D2",options);
+  benchmark(Pk2DLocalFiniteElement<double,double,4>(),"Pk2D4",options);
+  benchmark(Pk3DLocalFiniteElement<double,double,2>(),"Pk3D2",options);
+  benchmark(Q12DLocalFiniteElement<double,double>(),"Q12D",options);
+  benchmark(Q13DLocalFiniteElement<double,double>(),"Q13D",options);
+  benchmark(Q22DLocalFiniteElement<double,double>(),"Q22D",options);
+  benchmark(QkLocalFiniteElement<double,double,3,2>(),"Qk3D2",options);
+  benchmark(RT02DLocalFiniteElement<double,double>(),"RT02D",options);
+  benchmark(EdgeR12DLocalFiniteElement<double,double>(),"EdgeR12D",options);
+  benchmark(RefinedP1LocalFiniteElement<double,double>(),"RefinedP1",options);
+
+  // keep the accumulated results alive
+  std::cerr << "checksum " << sink << std::endl;
+
+  return 0;
+}
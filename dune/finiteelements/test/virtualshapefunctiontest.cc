@@ -119,28 +119,82 @@ void testShapeFunctionSet(const C1LocalBasisInterface<C1Traits>* localBasis,
 
 }
 
+/** \brief Test the batched evaluation through the virtual interface against the pointwise one */
+template <int dim>
+void testBatched(const C1LocalBasisInterface<C1Traits>* localBasis,
+                 const GeometryType& type)
+{
+  const QuadratureRule<double,dim> quad = QuadratureRules<double,dim>::rule(type,5);
+
+  std::vector<FieldVector<double,dim> > points(quad.size());
+  for (size_t i=0; i<quad.size(); i++)
+    points[i] = quad[i].position();
+
+  std::vector<FieldVector<double,1> > batchedValues, values;
+  std::vector<FieldVector<FieldVector<double,dim>,1> > batchedJacobians, jacobians;
+  localBasis->evaluateFunctionBatched(points, batchedValues);
+  localBasis->evaluateJacobianBatched(points, batchedJacobians);
+
+  const unsigned int n = localBasis->size();
+  if (batchedValues.size() != points.size()*n || batchedJacobians.size() != points.size()*n) {
+    std::cerr << "Batched evaluation returns the wrong number of entries for " << type << "." << std::endl;
+    success = false;
+    return;
+  }
+
+  for (size_t i=0; i<points.size(); i++) {
+
+    localBasis->evaluateFunction(points[i], values);
+    localBasis->evaluateJacobian(points[i], jacobians);
+
+    for (unsigned int j=0; j<n; j++) {
+
+      if (std::abs(batchedValues[i*n+j] - values[j]) > epsilon) {
+        std::cerr << "Batched value of shape function " << j << " at " << points[i]
+                  << " does not agree with evaluateFunction" << std::endl;
+        success = false;
+      }
+
+      for (int k=0; k<dim; k++)
+        if (std::abs(batchedJacobians[i*n+j][0][k] - jacobians[j][0][k]) > epsilon) {
+          std::cerr << "Batched derivative of shape function " << j << " at " << points[i]
+                    << " does not agree with evaluateJacobian" << std::endl;
+          success = false;
+        }
+
+    }
+
+  }
+
+}
+
 int main (int argc, char *argv[]) try
 {
 
   Pk2DLocalFiniteElement<double,double,1> testSetk1;
   testSumToOne<2>(&testSetk1.localBasis(), testSetk1.type());
   testShapeFunctionSet<2>(&testSetk1.localBasis(), testSetk1.type());
+  testBatched<2>(&testSetk1.localBasis(), testSetk1.type());
 
   Pk2DLocalFiniteElement<double,double,2> testSetk2;
   testSumToOne<2>(&testSetk2.localBasis(), testSetk2.type());
   testShapeFunctionSet<2>(&testSetk2.localBasis(), testSetk2.type());
+  testBatched<2>(&testSetk2.localBasis(), testSetk2.type());
 
   Pk2DLocalFiniteElement<double,double,3> testSetk3;
   testSumToOne<2>(&testSetk3.localBasis(), testSetk3.type());
   testShapeFunctionSet<2>(&testSetk3.localBasis(), testSetk3.type());
+  testBatched<2>(&testSetk3.localBasis(), testSetk3.type());
 
   Q12DLocalFiniteElement<double,double> testSetQ1;
   testSumToOne<2>(&testSetQ1.localBasis(), testSetQ1.type());
   testShapeFunctionSet<2>(&testSetQ1.localBasis(), testSetQ1.type());
+  testBatched<2>(&testSetQ1.localBasis(), testSetQ1.type());
 
   RefinedP1LocalFiniteElement<double,double> testSetRefinedP1;
   testSumToOne<2>(&testSetRefinedP1.localBasis(), testSetRefinedP1.type());
   testShapeFunctionSet<2>(&testSetRefinedP1.localBasis(), testSetRefinedP1.type());
+  testBatched<2>(&testSetRefinedP1.localBasis(), testSetRefinedP1.type());
 
   return success ? 0 : 1;
 }
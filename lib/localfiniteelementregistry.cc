@@ -0,0 +1,21 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <dune/finiteelements/localfiniteelementregistry.hh>
+
+namespace Dune
+{
+
+  template class LocalFiniteElementRegistry<double,double,1>;
+  template class LocalFiniteElementRegistry<double,double,2>;
+  template class LocalFiniteElementRegistry<double,double,3>;
+  template class LocalFiniteElementRegistry<double,double,2,2>;
+  template class LocalFiniteElementRegistry<float,float,1>;
+  template class LocalFiniteElementRegistry<float,float,2>;
+  template class LocalFiniteElementRegistry<float,float,3>;
+  template class LocalFiniteElementRegistry<float,float,2,2>;
+
+}
@@ -0,0 +1,37 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <dune/finiteelements/monom.hh>
+
+namespace Dune
+{
+
+  template class MonomLocalBasis<double,double,1,1>;
+  template class MonomLocalInterpolation<MonomLocalBasis<double,double,1,1>,MonomImp::Size<1,1>::val>;
+  template class MonomLocalBasis<double,double,1,2>;
+  template class MonomLocalInterpolation<MonomLocalBasis<double,double,1,2>,MonomImp::Size<1,2>::val>;
+  template class MonomLocalBasis<double,double,2,1>;
+  template class MonomLocalInterpolation<MonomLocalBasis<double,double,2,1>,MonomImp::Size<2,1>::val>;
+  template class MonomLocalBasis<double,double,2,2>;
+  template class MonomLocalInterpolation<MonomLocalBasis<double,double,2,2>,MonomImp::Size<2,2>::val>;
+  template class MonomLocalBasis<double,double,3,1>;
+  template class MonomLocalInterpolation<MonomLocalBasis<double,double,3,1>,MonomImp::Size<3,1>::val>;
+  template class MonomLocalBasis<double,double,3,2>;
+  template class MonomLocalInterpolation<MonomLocalBasis<double,double,3,2>,MonomImp::Size<3,2>::val>;
+  template class MonomLocalBasis<float,float,1,1>;
+  template class MonomLocalInterpolation<MonomLocalBasis<float,float,1,1>,MonomImp::Size<1,1>::val>;
+  template class MonomLocalBasis<float,float,1,2>;
+  template class MonomLocalInterpolation<MonomLocalBasis<float,float,1,2>,MonomImp::Size<1,2>::val>;
+  template class MonomLocalBasis<float,float,2,1>;
+  template class MonomLocalInterpolation<MonomLocalBasis<float,float,2,1>,MonomImp::Size<2,1>::val>;
+  template class MonomLocalBasis<float,float,2,2>;
+  template class MonomLocalInterpolation<MonomLocalBasis<float,float,2,2>,MonomImp::Size<2,2>::val>;
+  template class MonomLocalBasis<float,float,3,1>;
+  template class MonomLocalInterpolation<MonomLocalBasis<float,float,3,1>,MonomImp::Size<3,1>::val>;
+  template class MonomLocalBasis<float,float,3,2>;
+  template class MonomLocalInterpolation<MonomLocalBasis<float,float,3,2>,MonomImp::Size<3,2>::val>;
+
+}
@@ -0,0 +1,45 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <dune/finiteelements/orthonormal.hh>
+
+namespace Dune
+{
+
+  template class OrthonormalLocalBasis<double,double,2,1,GeometryType::simplex>;
+  template class OrthonormalLocalInterpolation<OrthonormalLocalBasis<double,double,2,1,GeometryType::simplex>,GeometryType::simplex>;
+  template class OrthonormalLocalBasis<double,double,2,2,GeometryType::simplex>;
+  template class OrthonormalLocalInterpolation<OrthonormalLocalBasis<double,double,2,2,GeometryType::simplex>,GeometryType::simplex>;
+  template class OrthonormalLocalBasis<double,double,3,1,GeometryType::simplex>;
+  template class OrthonormalLocalInterpolation<OrthonormalLocalBasis<double,double,3,1,GeometryType::simplex>,GeometryType::simplex>;
+  template class OrthonormalLocalBasis<double,double,3,2,GeometryType::simplex>;
+  template class OrthonormalLocalInterpolation<OrthonormalLocalBasis<double,double,3,2,GeometryType::simplex>,GeometryType::simplex>;
+  template class OrthonormalLocalBasis<double,double,2,1,GeometryType::cube>;
+  template class OrthonormalLocalInterpolation<OrthonormalLocalBasis<double,double,2,1,GeometryType::cube>,GeometryType::cube>;
+  template class OrthonormalLocalBasis<double,double,2,2,GeometryType::cube>;
+  template class OrthonormalLocalInterpolation<OrthonormalLocalBasis<double,double,2,2,GeometryType::cube>,GeometryType::cube>;
+  template class OrthonormalLocalBasis<double,double,3,1,GeometryType::cube>;
+  template class OrthonormalLocalInterpolation<OrthonormalLocalBasis<double,double,3,1,GeometryType::cube>,GeometryType::cube>;
+  template class OrthonormalLocalBasis<double,double,3,2,GeometryType::cube>;
+  template class OrthonormalLocalInterpolation<OrthonormalLocalBasis<double,double,3,2,GeometryType::cube>,GeometryType::cube>;
+  template class OrthonormalLocalBasis<float,float,2,1,GeometryType::simplex>;
+  template class OrthonormalLocalInterpolation<OrthonormalLocalBasis<float,float,2,1,GeometryType::simplex>,GeometryType::simplex>;
+  template class OrthonormalLocalBasis<float,float,2,2,GeometryType::simplex>;
+  template class OrthonormalLocalInterpolation<OrthonormalLocalBasis<float,float,2,2,GeometryType::simplex>,GeometryType::simplex>;
+  template class OrthonormalLocalBasis<float,float,3,1,GeometryType::simplex>;
+  template class OrthonormalLocalInterpolation<OrthonormalLocalBasis<float,float,3,1,GeometryType::simplex>,GeometryType::simplex>;
+  template class OrthonormalLocalBasis<float,float,3,2,GeometryType::simplex>;
+  template class OrthonormalLocalInterpolation<OrthonormalLocalBasis<float,float,3,2,GeometryType::simplex>,GeometryType::simplex>;
+  template class OrthonormalLocalBasis<float,float,2,1,GeometryType::cube>;
+  template class OrthonormalLocalInterpolation<OrthonormalLocalBasis<float,float,2,1,GeometryType::cube>,GeometryType::cube>;
+  template class OrthonormalLocalBasis<float,float,2,2,GeometryType::cube>;
+  template class OrthonormalLocalInterpolation<OrthonormalLocalBasis<float,float,2,2,GeometryType::cube>,GeometryType::cube>;
+  template class OrthonormalLocalBasis<float,float,3,1,GeometryType::cube>;
+  template class OrthonormalLocalInterpolation<OrthonormalLocalBasis<float,float,3,1,GeometryType::cube>,GeometryType::cube>;
+  template class OrthonormalLocalBasis<float,float,3,2,GeometryType::cube>;
+  template class OrthonormalLocalInterpolation<OrthonormalLocalBasis<float,float,3,2,GeometryType::cube>,GeometryType::cube>;
+
+}
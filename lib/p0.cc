@@ -0,0 +1,19 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <dune/finiteelements/p0.hh>
+
+namespace Dune
+{
+
+  template class P0LocalBasis<double,double,1>;
+  template class P0LocalBasis<double,double,2>;
+  template class P0LocalBasis<double,double,3>;
+  template class P0LocalBasis<float,float,1>;
+  template class P0LocalBasis<float,float,2>;
+  template class P0LocalBasis<float,float,3>;
+
+}
@@ -0,0 +1,17 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <dune/finiteelements/pk2d.hh>
+
+namespace Dune
+{
+
+  template class Pk2DLocalBasis<double,double,1>;
+  template class Pk2DLocalBasis<double,double,2>;
+  template class Pk2DLocalBasis<float,float,1>;
+  template class Pk2DLocalBasis<float,float,2>;
+
+}
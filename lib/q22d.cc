@@ -0,0 +1,15 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <dune/finiteelements/q22d.hh>
+
+namespace Dune
+{
+
+  template class Q22DLocalBasis<double,double>;
+  template class Q22DLocalBasis<float,float>;
+
+}
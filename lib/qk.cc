@@ -0,0 +1,25 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <dune/finiteelements/qk.hh>
+
+namespace Dune
+{
+
+  template class QkLocalBasis<double,double,1,1>;
+  template class QkLocalBasis<double,double,1,2>;
+  template class QkLocalBasis<double,double,2,1>;
+  template class QkLocalBasis<double,double,2,2>;
+  template class QkLocalBasis<double,double,3,1>;
+  template class QkLocalBasis<double,double,3,2>;
+  template class QkLocalBasis<float,float,1,1>;
+  template class QkLocalBasis<float,float,1,2>;
+  template class QkLocalBasis<float,float,2,1>;
+  template class QkLocalBasis<float,float,2,2>;
+  template class QkLocalBasis<float,float,3,1>;
+  template class QkLocalBasis<float,float,3,2>;
+
+}
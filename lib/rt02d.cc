@@ -0,0 +1,15 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <dune/finiteelements/rt02d.hh>
+
+namespace Dune
+{
+
+  template class RT02DLocalBasis<double,double>;
+  template class RT02DLocalBasis<float,float>;
+
+}
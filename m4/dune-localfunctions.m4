@@ -1,6 +1,10 @@
 AC_DEFUN([DUNE_LOCALFUNCTIONS_CHECKS],[
   AM_CONDITIONAL([DUNE_GRID], [test x"$with_dune_grid" = xyes])
   AC_REQUIRE([DUNE_VIRTUAL_BASIS])
+  AC_REQUIRE([DUNE_PRECOMPILED_LOCALFUNCTIONS])
+  # the caches shared between threads are locked with POSIX threads, see common/cachemutex.hh
+  AC_CHECK_HEADERS([pthread.h])
+  AC_SEARCH_LIBS([pthread_mutex_lock],[pthread])
 ])
 
 AC_DEFUN([DUNE_LOCALFUNCTIONS_CHECK_MODULE],[
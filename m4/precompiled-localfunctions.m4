@@ -0,0 +1,19 @@
+AC_DEFUN([DUNE_PRECOMPILED_LOCALFUNCTIONS],[
+  AC_REQUIRE([AC_PROG_CXX])
+  # explicit instantiations of the common local bases in libdunelocalfunctions
+  AC_ARG_ENABLE(precompiled-localfunctions,
+   AC_HELP_STRING([--enable-precompiled-localfunctions],[use the instantiations of the common local bases in libdunelocalfunctions]))
+  if test x$enable_precompiled_localfunctions = xyes; then
+    AC_DEFINE([DUNE_LOCALFUNCTIONS_PRECOMPILED], [1],
+      [Define to 1 if the common local bases are instantiated in libdunelocalfunctions.])
+  fi
+  AM_CONDITIONAL([PRECOMPILED_LOCALFUNCTIONS],
+    [test x$enable_precompiled_localfunctions = xyes])
+
+  # compiler flags for the instantiations, used in addition to CXXFLAGS
+  AC_ARG_VAR([LOCALFUNCTIONS_CXXFLAGS],
+    [C++ compiler flags for the evaluation kernels instantiated in libdunelocalfunctions, e.g. -O3 -march=native])
+  if test "x$LOCALFUNCTIONS_CXXFLAGS" = x && test x$GXX = xyes; then
+    LOCALFUNCTIONS_CXXFLAGS="-O3 -funroll-loops"
+  fi
+])